@@ -47,7 +47,9 @@
 #include "ContentFactory.h"
 #include "configuration/MasterConfiguration.h"
 #include "MasterToWallChannel.h"
+#include "MasterToWallMailbox.h"
 #include "MasterFromWallChannel.h"
+#include "MPINospin.h"
 #include "Options.h"
 #include "Markers.h"
 
@@ -58,6 +60,7 @@
 
 #include "localstreamer/PixelStreamerLauncher.h"
 #include "StateSerializationHelper.h"
+#include "PixelStreamTranscoder.h"
 #include "PixelStreamWindowManager.h"
 
 #include "SessionCommandHandler.h"
@@ -80,8 +83,10 @@ MasterApplication::MasterApplication( int& argc_, char** argv_,
                                       MPIChannelPtr worldChannel )
     : QApplication( argc_, argv_ )
     , masterToWallChannel_( new MasterToWallChannel( worldChannel ))
+    , masterToWallMailbox_( new MasterToWallMailbox )
     , masterFromWallChannel_( new MasterFromWallChannel( worldChannel ))
     , markers_( new Markers )
+    , wallProcessCount_( worldChannel->getSize() - 1 )
 {
     // don't create touch points for mouse events and vice versa
     setAttribute( Qt::AA_SynthesizeTouchForUnhandledMouseEvents, false );
@@ -107,7 +112,15 @@ MasterApplication::~MasterApplication()
 {
     deflectServer_.reset();
 
-    masterToWallChannel_->sendQuit();
+    // Queue the frames being transcoded before the quit message
+    pixelStreamTranscoder_.reset();
+
+    put_flog( LOG_INFO, "%s", masterToWallMailbox_->getStatistics().
+              toLocal8Bit().constData( ));
+
+    // Broadcasts must be issued from the send thread, in order
+    QMetaObject::invokeMethod( masterToWallChannel_.get(), "sendQuit",
+                               Qt::BlockingQueuedConnection );
 
     mpiSendThread_.quit();
     mpiSendThread_.wait();
@@ -115,6 +128,8 @@ MasterApplication::~MasterApplication()
     mpiReceiveThread_.quit();
     mpiReceiveThread_.wait();
 
+    put_flog( LOG_INFO, "%s", MPI_Nospin_GetStatistics().c_str( ));
+
     webServiceServer_->stop();
     webServiceServer_->wait();
 }
@@ -127,6 +142,8 @@ void MasterApplication::init()
     masterWindow_.reset( new MasterWindow( displayGroup_, *config_ ));
     pixelStreamWindowManager_.reset(
                 new PixelStreamWindowManager( *displayGroup_ ));
+    pixelStreamWindowManager_->setPacingPolicy( [this]( const QString& uri )
+        { return config_->getPixelStreamPacing( uri ); } );
 
     initPixelStreamLauncher();
     startDeflectServer();
@@ -150,6 +167,7 @@ bool MasterApplication::createConfig( const QString& filename )
         put_flog( LOG_FATAL, "Could not load configuration. '%s'", e.what( ));
         return false;
     }
+    MPI_Nospin_SetWaitPolicy( config_->getMPIWaitPolicy( ));
     return true;
 }
 
@@ -253,33 +271,92 @@ void MasterApplication::initPixelStreamLauncher()
              &PixelStreamerLauncher::openSessionLoader );
 }
 
+void MasterApplication::initPixelStreamTranscoder()
+{
+    pixelStreamTranscoder_.reset(
+                new PixelStreamTranscoder( config_->getPixelStreamTileSize(),
+                                           config_->getPixelStreamQuality( )));
+
+    deflect::FrameDispatcher& dispatcher =
+            deflectServer_->getPixelStreamDispatcher();
+
+    // The frames are transcoded by a pool of threads, which then hands them
+    // over to the send thread
+    connect( &dispatcher, &deflect::FrameDispatcher::sendFrame,
+             pixelStreamTranscoder_.get(), &PixelStreamTranscoder::transcode,
+             Qt::DirectConnection );
+    connect( pixelStreamTranscoder_.get(), &PixelStreamTranscoder::transcoded,
+             masterToWallChannel_.get(), &MasterToWallChannel::send,
+             Qt::QueuedConnection );
+    connect( &dispatcher, &deflect::FrameDispatcher::deletePixelStream,
+             pixelStreamTranscoder_.get(),
+             &PixelStreamTranscoder::removeStream );
+
+    connect( displayGroup_.get(), &DisplayGroup::modified,
+             pixelStreamTranscoder_.get(),
+             [this]( DisplayGroupPtr displayGroup )
+                { pixelStreamTranscoder_->updateWindows(
+                          displayGroup->getContentWindows( )); } );
+}
+
 void MasterApplication::initMPIConnection()
 {
+    if( config_->getPixelStreamRouting( ))
+        masterToWallChannel_->enablePixelStreamRouting(
+                    config_->getWallProcessAreas( ));
+    if( config_->getPixelStreamSkipUnchanged( ))
+        masterToWallChannel_->enableSegmentChangeTracking();
+
     masterToWallChannel_->moveToThread( &mpiSendThread_ );
     masterFromWallChannel_->moveToThread( &mpiReceiveThread_ );
 
+    masterToWallMailbox_->setMaxSendRate( config_->getMaxUpdateRate( ));
+
     connect( displayGroup_.get(), &DisplayGroup::modified,
+             masterToWallMailbox_.get(),
+             [this]( DisplayGroupPtr displayGroup )
+                { masterToWallMailbox_->post( displayGroup ); } );
+
+    connect( masterWindow_->getOptions().get(), &Options::updated,
+             masterToWallMailbox_.get(),
+             [this]( OptionsPtr options )
+                { masterToWallMailbox_->post( options ); } );
+
+    connect( markers_.get(), &Markers::updated,
+             masterToWallMailbox_.get(),
+             [this]( MarkersPtr markers )
+                { masterToWallMailbox_->post( markers ); } );
+
+    connect( masterToWallMailbox_.get(),
+             &MasterToWallMailbox::sendDisplayGroup,
              masterToWallChannel_.get(),
              [this]( DisplayGroupPtr displayGroup )
                 { masterToWallChannel_->sendAsync( displayGroup ); },
              Qt::DirectConnection );
 
-    connect( masterWindow_->getOptions().get(), &Options::updated,
+    connect( masterToWallMailbox_.get(), &MasterToWallMailbox::sendOptions,
              masterToWallChannel_.get(),
              [this]( OptionsPtr options )
                 { masterToWallChannel_->sendAsync( options ); },
              Qt::DirectConnection );
 
-    connect( markers_.get(), &Markers::updated,
+    connect( masterToWallMailbox_.get(), &MasterToWallMailbox::sendMarkers,
              masterToWallChannel_.get(),
              [this]( MarkersPtr markers )
                 { masterToWallChannel_->sendAsync( markers ); },
              Qt::DirectConnection );
 
+    if( config_->getPixelStreamTranscoding( ))
+        initPixelStreamTranscoder();
+    else
+        connect( &deflectServer_->getPixelStreamDispatcher(),
+                 &deflect::FrameDispatcher::sendFrame,
+                 masterToWallChannel_.get(),
+                 &MasterToWallChannel::send );
     connect( &deflectServer_->getPixelStreamDispatcher(),
-             &deflect::FrameDispatcher::sendFrame,
+             &deflect::FrameDispatcher::deletePixelStream,
              masterToWallChannel_.get(),
-             &MasterToWallChannel::send );
+             &MasterToWallChannel::closePixelStream );
     connect( &deflectServer_->getPixelStreamDispatcher(),
              &deflect::FrameDispatcher::sendFrame,
              pixelStreamWindowManager_.get(),
@@ -312,6 +389,20 @@ void MasterApplication::initMPIConnection()
              &deflectServer_->getPixelStreamDispatcher(),
              &deflect::FrameDispatcher::requestFrame );
 
+    connect( masterWindow_.get(), &MasterWindow::requestProfilingTrace,
+             this, [this]( const QString filename )
+    {
+        profileTraceFilename_ = filename;
+        profileTrace_.start( wallProcessCount_ );
+        QMetaObject::invokeMethod( masterToWallChannel_.get(),
+                                   "sendRequestProfile",
+                                   Qt::QueuedConnection );
+    });
+
+    connect( masterFromWallChannel_.get(),
+             &MasterFromWallChannel::receivedProfile,
+             this, &MasterApplication::addProfile );
+
     connect( &mpiReceiveThread_, &QThread::started,
              masterFromWallChannel_.get(),
              &MasterFromWallChannel::processMessages );
@@ -320,6 +411,28 @@ void MasterApplication::initMPIConnection()
     mpiReceiveThread_.start();
 }
 
+void MasterApplication::addProfile( const int rank,
+                                    const ProfileEvents& events )
+{
+    if( profileTraceFilename_.isEmpty( ))
+        return;
+
+    profileTrace_.add( rank, events );
+    if( !profileTrace_.isComplete( ))
+        return;
+
+    if( profileTrace_.save( profileTraceFilename_ ))
+        put_flog( LOG_INFO, "Saved profiling trace of %d processes (%d events)"
+                  " to: %s", (int)profileTrace_.getProcessCount(),
+                  (int)profileTrace_.getEventCount(),
+                  profileTraceFilename_.toLocal8Bit().constData( ));
+    else
+        put_flog( LOG_ERROR, "Could not save profiling trace to: %s",
+                  profileTraceFilename_.toLocal8Bit().constData( ));
+
+    profileTraceFilename_.clear();
+}
+
 #if ENABLE_TUIO_TOUCH_LISTENER
 void MasterApplication::initTouchListener()
 {
@@ -42,15 +42,18 @@
 
 #include "config.h"
 #include "types.h"
+#include "ProfileTrace.h"
 
 #include <QApplication>
 #include <QThread>
 #include <boost/scoped_ptr.hpp>
 
 class MasterToWallChannel;
+class MasterToWallMailbox;
 class MasterFromWallChannel;
 class MasterWindow;
 class PixelStreamerLauncher;
+class PixelStreamTranscoder;
 class PixelStreamWindowManager;
 class WebServiceServer;
 class TextInputDispatcher;
@@ -79,12 +82,14 @@ public:
 
 private:
     boost::scoped_ptr<MasterToWallChannel> masterToWallChannel_;
+    boost::scoped_ptr<MasterToWallMailbox> masterToWallMailbox_;
     boost::scoped_ptr<MasterFromWallChannel> masterFromWallChannel_;
     boost::scoped_ptr<MasterWindow> masterWindow_;
     boost::scoped_ptr<MasterConfiguration> config_;
     boost::scoped_ptr<deflect::Server> deflectServer_;
     boost::scoped_ptr<PixelStreamerLauncher> pixelStreamerLauncher_;
     boost::scoped_ptr<PixelStreamWindowManager> pixelStreamWindowManager_;
+    boost::scoped_ptr<PixelStreamTranscoder> pixelStreamTranscoder_;
     boost::scoped_ptr<WebServiceServer> webServiceServer_;
     boost::scoped_ptr<TextInputDispatcher> textInputDispatcher_;
 #if ENABLE_TUIO_TOUCH_LISTENER
@@ -94,6 +99,10 @@ private:
     DisplayGroupPtr displayGroup_;
     MarkersPtr markers_;
 
+    const size_t wallProcessCount_;
+    ProfileTrace profileTrace_;
+    QString profileTraceFilename_;
+
     QThread mpiSendThread_;
     QThread mpiReceiveThread_;
 
@@ -103,7 +112,9 @@ private:
     void startWebservice(const int webServicePort);
     void restoreBackground();
     void initPixelStreamLauncher();
+    void initPixelStreamTranscoder();
     void initMPIConnection();
+    void addProfile( int rank, const ProfileEvents& events );
 
 #if ENABLE_TUIO_TOUCH_LISTENER
     void initTouchListener();
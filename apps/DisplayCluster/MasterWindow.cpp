@@ -64,6 +64,7 @@
 namespace
 {
 const QString STATE_FILES_FILTER( "State files (*.dcx)" );
+const QString TRACE_FILES_FILTER( "Chrome trace files (*.json)" );
 const QSize DEFAULT_WINDOW_SIZE( 800, 600 );
 }
 
@@ -159,6 +160,14 @@ void MasterWindow::setupMasterWindowUI()
     computeImagePyramidAction->setStatusTip("Compute image pyramid");
     connect(computeImagePyramidAction, SIGNAL(triggered()), this, SLOT(computeImagePyramid()));
 
+    // save profiling trace action
+    QAction* saveProfilingTraceAction = new QAction( "Save Profiling Trace",
+                                                     this );
+    saveProfilingTraceAction->setStatusTip(
+           "Save the timings of the last frames of all wall processes" );
+    connect( saveProfilingTraceAction, &QAction::triggered,
+             this, &MasterWindow::saveProfilingTrace );
+
     // load background content action
     QAction * backgroundAction = new QAction("Background", this);
     backgroundAction->setStatusTip("Select the background color and content");
@@ -282,6 +291,7 @@ void MasterWindow::setupMasterWindowUI()
     viewMenu->addAction( enableAlphaBlendingAction );
     viewMenu->addAction( autoFocusPixelStreamsAction_ );
     toolsMenu->addAction( computeImagePyramidAction );
+    toolsMenu->addAction( saveProfilingTraceAction );
 
     helpMenu->addAction( showAboutDialog );
 
@@ -503,6 +513,21 @@ void MasterWindow::computeImagePyramid()
     put_flog( LOG_DEBUG, "done generating pyramid" );
 }
 
+void MasterWindow::saveProfilingTrace()
+{
+    QString filename = QFileDialog::getSaveFileName( this,
+                                                     "Save Profiling Trace",
+                                                     sessionFolder_,
+                                                     TRACE_FILES_FILTER );
+    if( filename.isEmpty( ))
+        return;
+
+    if( !filename.endsWith( ".json" ))
+        filename.append( ".json" );
+
+    emit requestProfilingTrace( filename );
+}
+
 void MasterWindow::estimateGridSize( unsigned int numElem, unsigned int &gridX,
                                      unsigned int &gridY )
 {
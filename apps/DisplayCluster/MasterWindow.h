@@ -95,6 +95,12 @@ signals:
     /** Emitted when users want to open an application. */
     void openAppLauncher( QPointF pos );
 
+    /**
+     * Emitted when users want to save a profiling trace of the wall.
+     * @param filename The destination file (Chrome trace-event format)
+     */
+    void requestProfilingTrace( QString filename );
+
 protected:
     /** @name Drag events re-implemented from QMainWindow */
     //@{
@@ -110,6 +116,7 @@ private slots:
     void loadState();
 
     void computeImagePyramid();
+    void saveProfilingTrace();
 
     void openAboutWidget();
 
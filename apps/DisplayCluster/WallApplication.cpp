@@ -43,12 +43,18 @@
 #include "CommandLineParameters.h"
 
 #include "MPIChannel.h"
+#include "MPINospin.h"
+#include "Profiler.h"
 #include "WallFromMasterChannel.h"
 #include "WallToMasterChannel.h"
 #include "WallToWallChannel.h"
 
 #include "configuration/WallConfiguration.h"
 
+#include "CopyCounter.h"
+#include "DecoderThreadBudget.h"
+#include "GLTextureUploader.h"
+#include "MovieStatistics.h"
 #include "RenderContext.h"
 
 #include <stdexcept>
@@ -60,6 +66,7 @@ WallApplication::WallApplication( int& argc_, char** argv_,
                                   MPIChannelPtr wallChannel )
     : QApplication( argc_, argv_ )
     , wallChannel_( new WallToWallChannel( wallChannel ))
+    , frameTimer_( &Profiler::global( ))
 {
     CommandLineParameters options( argc_, argv_ );
     if( options.getHelp( ))
@@ -80,6 +87,10 @@ WallApplication::~WallApplication()
 
     mpiSendThread_.quit();
     mpiSendThread_.wait();
+
+    put_flog( LOG_INFO, "%s", MPI_Nospin_GetStatistics().c_str( ));
+    put_flog( LOG_INFO, "%s",
+              frameTimer_.getStatistics().toLocal8Bit().constData( ));
 }
 
 bool WallApplication::createConfig( const QString& filename, const int rank )
@@ -93,6 +104,9 @@ bool WallApplication::createConfig( const QString& filename, const int rank )
         put_flog( LOG_FATAL, "Could not load configuration. '%s'", e.what( ));
         return false;
     }
+    MPI_Nospin_SetWaitPolicy( config_->getMPIWaitPolicy( ));
+    DecoderThreadBudget::global().setThreadCount(
+                config_->getMovieDecoderThreads( ));
     return true;
 }
 
@@ -112,6 +126,8 @@ void WallApplication::initRenderContext()
     }
 
     renderController_.reset( new RenderController( renderContext_ ));
+    renderController_->getPixelStreamUpdater().setSegmentBatching(
+                config_->getPixelStreamSegmentBatching( ));
 }
 
 void WallApplication::initMPIConnection( MPIChannelPtr worldChannel )
@@ -125,8 +141,9 @@ void WallApplication::initMPIConnection( MPIChannelPtr worldChannel )
     connect( fromMasterChannel_.get(), SIGNAL( receivedQuit( )),
              renderController_.get(), SLOT( updateQuit( )));
 
-    connect( fromMasterChannel_.get(), SIGNAL( received( DisplayGroupPtr )),
-             renderController_.get(), SLOT( updateDisplayGroup( DisplayGroupPtr )));
+    connect( fromMasterChannel_.get(), SIGNAL( received( DisplayGroupDeltaPtr )),
+             renderController_.get(),
+             SLOT( updateDisplayGroup( DisplayGroupDeltaPtr )));
 
     connect( fromMasterChannel_.get(), SIGNAL( received( OptionsPtr )),
              renderController_.get(), SLOT( updateOptions( OptionsPtr )));
@@ -149,6 +166,9 @@ void WallApplication::initMPIConnection( MPIChannelPtr worldChannel )
     connect( fromMasterChannel_.get(), SIGNAL( receivedQuit( )),
              toMasterChannel_.get(), SLOT( sendQuit( )));
 
+    connect( fromMasterChannel_.get(), SIGNAL( receivedRequestProfile( )),
+             toMasterChannel_.get(), SLOT( sendProfile( )));
+
     connect( &mpiReceiveThread_, SIGNAL( started( )),
              fromMasterChannel_.get(), SLOT( processMessages( )));
 
@@ -167,18 +187,55 @@ void WallApplication::startRendering()
 
 void WallApplication::renderFrame()
 {
-    wallChannel_->synchronizeClock();
+    frameTimer_.startFrame();
+
+    renderController_->synchronizeObjects( *wallChannel_ );
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_SYNC );
 
     renderController_->preRenderUpdate( *wallChannel_ );
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_CONTENT );
 
     renderContext_->updateGLWindows();
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_RENDER );
+
     wallChannel_->globalBarrier();
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_BARRIER );
+
     renderContext_->swapBuffers();
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_SWAP );
 
     renderController_->postRenderUpdate( *wallChannel_ );
+    frameTimer_.endPhase( FramePhaseTimer::PHASE_POST );
+
+    frameTimer_.endFrame();
+    CopyCounter::global().endFrame();
+    MovieStatistics::global().endFrame();
+    if( renderController_->getShowStatistics( ))
+        updateStatistics();
 
     if( renderController_->quitRendering( ))
         quit();
 
     emit( frameFinished( ));
 }
+
+void WallApplication::updateStatistics()
+{
+    const PixelStreamUpdater& updater =
+            renderController_->getPixelStreamUpdater();
+    QString statistics =
+            renderController_->getSyncRegistry().getStatistics() + '\n' +
+            frameTimer_.getStatistics() + '\n' +
+            updater.getDecodeStatistics() + '\n' +
+            GLTextureUploader::instance().getStatistics() + '\n' +
+            CopyCounter::global().getStatistics() + '\n' +
+            MovieStatistics::global().getStatistics();
+    const QString streamStatistics = updater.getFrameStatistics();
+    if( !streamStatistics.isEmpty( ))
+        statistics += '\n' + streamStatistics;
+    const QString movieStatistics =
+            MovieStatistics::global().getDecoderStatistics();
+    if( !movieStatistics.isEmpty( ))
+        statistics += '\n' + movieStatistics;
+    renderContext_->setStatistics( statistics );
+}
@@ -41,6 +41,7 @@
 #define WALLAPPLICATION_H
 
 #include "types.h"
+#include "FramePhaseTimer.h"
 #include "SwapSyncObject.h"
 #include "RenderController.h"
 
@@ -93,11 +94,14 @@ private:
     QThread mpiSendThread_;
     QThread mpiReceiveThread_;
 
+    FramePhaseTimer frameTimer_;
+
     bool createConfig(const QString& filename, const int rank);
     void initRenderContext();
     void initMPIConnection(MPIChannelPtr worldChannel);
 
     void startRendering();
+    void updateStatistics();
 };
 
 #endif // WALLAPPLICATION_H
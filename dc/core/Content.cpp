@@ -45,9 +45,28 @@ IMPLEMENT_SERIALIZE_FOR_XML( Content )
 
 qreal Content::maxScale_ = 3.0;
 
+Content::Content()
+    : _modified( true )
+    , _revision( 0 )
+{
+    _watchModifications();
+}
+
 Content::Content( const QString& uri )
     : _uri( uri )
+    , _modified( true )
+    , _revision( 0 )
+{
+    _watchModifications();
+}
+
+void Content::_watchModifications()
 {
+    connect( this, &Content::modified, [this]()
+    {
+        _modified = true;
+        _revision = 0;
+    } );
 }
 
 const QString& Content::getURI() const
@@ -99,6 +118,26 @@ void Content::setSizeHints( const deflect::SizeHints& sizeHints )
     emit modified();
 }
 
+bool Content::isModified() const
+{
+    return _modified;
+}
+
+void Content::clearModified()
+{
+    _modified = false;
+}
+
+uint64_t Content::getRevision() const
+{
+    return _revision;
+}
+
+void Content::setRevision( const uint64_t revision )
+{
+    _revision = revision;
+}
+
 void Content::setMaxScale( const qreal value )
 {
     if( value > 0 )
@@ -118,6 +118,24 @@ public:
     /** Set optional size hints to constrain resize/scale and 1:1 size. */
     void setSizeHints( const deflect::SizeHints& sizeHints );
 
+    /**
+     * @return true if the content has emitted modified() since the last call
+     *         to clearModified(), or since its creation.
+     */
+    bool isModified() const;
+
+    /** Clear the modified flag, once the content has been sent to the wall. */
+    void clearModified();
+
+    /**
+     * @return the revision of the content when it was last sent to the wall,
+     *         or 0 if it has been modified since.
+     */
+    uint64_t getRevision() const;
+
+    /** Set the revision of the content which is about to be sent. */
+    void setRevision( uint64_t revision );
+
     /** Set the maximum factor for zoom and resize; value times content size */
     static void setMaxScale( qreal value );
 
@@ -134,7 +152,7 @@ protected:
     friend class boost::serialization::access;
 
     // Default constructor required for boost::serialization
-    Content() {}
+    Content();
 
     /** Serialize for sending to Wall applications. */
     template< class Archive >
@@ -144,6 +162,7 @@ protected:
         ar & _size.rwidth();
         ar & _size.rheight();
         ar & _actions;
+        ar & _revision;
     }
 
     /** Serialize for saving to an xml file */
@@ -179,7 +198,12 @@ protected:
     QSize _size;
     ContentActionsModel _actions;
     deflect::SizeHints _sizeHints;
+    bool _modified;
+    uint64_t _revision;
     static qreal maxScale_;
+
+private:
+    void _watchModifications();
 };
 
 BOOST_CLASS_VERSION( Content, 2 )
@@ -39,7 +39,9 @@
 
 #include "ContentItem.h"
 
+#include "GLQuadRenderer.h"
 #include "log.h"
+#include "Profiler.h"
 #include "WallContent.h"
 
 #include <QtGui/QPainter>
@@ -62,17 +64,27 @@ void ContentItem::paint( QPainter* painter, const QStyleOptionGraphicsItem*,
     glPushMatrix();
     glScalef( width(), height(), 1.f );
 
-    switch ( role_ )
+    // The quads of the content are sorted to minimize state changes. They are
+    // drawn by GLQuadRenderer::end(), which is part of the profiled scope.
     {
-    case ROLE_CONTENT:
-        wallContent_->render();
-        break;
-    case ROLE_PREVIEW:
-        wallContent_->renderPreview();
-        break;
-    default:
-        put_flog( LOG_ERROR, "Unsupported ContentItem::Role : ", role_ );
-        break;
+        ProfileScope scope( PROFILE_CATEGORY_CONTENT,
+                            wallContent_->getProfileName( ));
+        GLQuadRenderer::instance().begin();
+
+        switch ( role_ )
+        {
+        case ROLE_CONTENT:
+            wallContent_->render();
+            break;
+        case ROLE_PREVIEW:
+            wallContent_->renderPreview();
+            break;
+        default:
+            put_flog( LOG_ERROR, "Unsupported ContentItem::Role : ", role_ );
+            break;
+        }
+
+        GLQuadRenderer::instance().end();
     }
 
     glPopMatrix();
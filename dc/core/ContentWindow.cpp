@@ -156,6 +156,7 @@ void ContentWindow::setZoomRect( const QRectF& zoomRect )
         return;
 
     zoomRect_ = zoomRect;
+    emit zoomRectChanged();
     emit modified();
 }
 
@@ -78,7 +78,7 @@ class ContentWindow : public Coordinates
     Q_PROPERTY( bool focused READ isFocused WRITE setFocused NOTIFY focusedChanged )
     Q_PROPERTY( QString label READ getLabel NOTIFY labelChanged )
     Q_PROPERTY( bool controlsVisible READ getControlsVisible WRITE setControlsVisible NOTIFY controlsVisibleChanged )
-    Q_PROPERTY( QRectF zoomRect READ getZoomRect CONSTANT )
+    Q_PROPERTY( QRectF zoomRect READ getZoomRect NOTIFY zoomRectChanged )
     Q_PROPERTY( ContentInteractionDelegate* delegate READ getInteractionDelegate CONSTANT )
     Q_PROPERTY( ContentWindowController* controller READ getController CONSTANT )
     Q_PROPERTY( QRectF focusedCoordinates READ getFocusedCoordinates
@@ -244,6 +244,7 @@ signals:
     void borderChanged();
     void focusedChanged();
     void focusedCoordinatesChanged();
+    void zoomRectChanged();
     void stateChanged();
     void labelChanged();
     void controlsVisibleChanged();
@@ -251,6 +252,7 @@ signals:
 
 private:
     friend class boost::serialization::access;
+    friend class DisplayGroupDelta;
 
     /** No-argument constructor required for serialization. */
     ContentWindow();
@@ -0,0 +1,99 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "CopyCounter.h"
+
+CopyCounter::CopyCounter()
+    : _copyCount( 0 )
+    , _copiedBytes( 0 )
+    , _frameStartCount( 0 )
+    , _frameStartBytes( 0 )
+    , _frameCount( 0 )
+    , _frameBytes( 0 )
+{
+}
+
+void CopyCounter::record( const uint64_t bytes )
+{
+    _copyCount.fetch_add( 1, std::memory_order_relaxed );
+    _copiedBytes.fetch_add( bytes, std::memory_order_relaxed );
+}
+
+void CopyCounter::endFrame()
+{
+    const uint64_t count = _copyCount.load( std::memory_order_relaxed );
+    const uint64_t bytes = _copiedBytes.load( std::memory_order_relaxed );
+
+    _frameCount = count - _frameStartCount;
+    _frameBytes = bytes - _frameStartBytes;
+    _frameStartCount = count;
+    _frameStartBytes = bytes;
+}
+
+uint64_t CopyCounter::getFrameCopyCount() const
+{
+    return _frameCount;
+}
+
+uint64_t CopyCounter::getFrameCopiedBytes() const
+{
+    return _frameBytes;
+}
+
+uint64_t CopyCounter::getTotalCopyCount() const
+{
+    return _copyCount.load( std::memory_order_relaxed );
+}
+
+uint64_t CopyCounter::getTotalCopiedBytes() const
+{
+    return _copiedBytes.load( std::memory_order_relaxed );
+}
+
+QString CopyCounter::getStatistics() const
+{
+    return QString( "memcpy: %1 per frame, %2 MB per frame" )
+            .arg( _frameCount )
+            .arg( _frameBytes / 1000000.0, 0, 'f', 2 );
+}
+
+CopyCounter& CopyCounter::global()
+{
+    static CopyCounter counter;
+    return counter;
+}
@@ -0,0 +1,98 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef COPYCOUNTER_H
+#define COPYCOUNTER_H
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * Count the memory copies of pixel data made by the application.
+ *
+ * Copies can be recorded from any thread with record(), which only takes two
+ * atomic increments. The render loop concludes each frame with endFrame(),
+ * which keeps the counts of the copies made since the previous frame.
+ */
+class CopyCounter : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    CopyCounter();
+
+    /**
+     * Record a copy.
+     * @param bytes The number of bytes copied
+     */
+    void record( uint64_t bytes );
+
+    /** End the current frame, keeping the counts of its copies. */
+    void endFrame();
+
+    /** @return the number of copies made during the last frame. */
+    uint64_t getFrameCopyCount() const;
+
+    /** @return the number of bytes copied during the last frame. */
+    uint64_t getFrameCopiedBytes() const;
+
+    /** @return the number of copies made since the creation. */
+    uint64_t getTotalCopyCount() const;
+
+    /** @return the number of bytes copied since the creation. */
+    uint64_t getTotalCopiedBytes() const;
+
+    /** @return a summary of the copies of the last frame. */
+    QString getStatistics() const;
+
+    /** @return the counter of the process. */
+    static CopyCounter& global();
+
+private:
+    std::atomic<uint64_t> _copyCount;
+    std::atomic<uint64_t> _copiedBytes;
+    uint64_t _frameStartCount;
+    uint64_t _frameStartBytes;
+    uint64_t _frameCount;
+    uint64_t _frameBytes;
+};
+
+#endif // COPYCOUNTER_H
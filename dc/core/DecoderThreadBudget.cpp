@@ -0,0 +1,108 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "DecoderThreadBudget.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <stdint.h>
+
+DecoderThreadBudget::DecoderThreadBudget( const unsigned int threadCount )
+    : _threadCount( threadCount )
+    , _usedThreads( 0 )
+{
+}
+
+void DecoderThreadBudget::setThreadCount( const unsigned int threadCount )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    _threadCount = threadCount;
+}
+
+unsigned int DecoderThreadBudget::getThreadCount() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _threadCount;
+}
+
+unsigned int DecoderThreadBudget::getUsedThreads() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _usedThreads;
+}
+
+unsigned int DecoderThreadBudget::acquire( const QSize& frameSize )
+{
+    // The first thread of a decoder is the one of its movie
+    const unsigned int requested = getRequestedThreads( frameSize ) - 1;
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    const unsigned int available = _threadCount > _usedThreads ?
+                                       _threadCount - _usedThreads : 0;
+    const unsigned int granted = std::min( requested, available );
+    _usedThreads += granted;
+    return granted + 1;
+}
+
+void DecoderThreadBudget::release( const unsigned int threads )
+{
+    if( threads <= 1 )
+        return;
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    _usedThreads -= std::min( threads - 1, _usedThreads );
+}
+
+unsigned int DecoderThreadBudget::getRequestedThreads( const QSize& frameSize )
+{
+    if( frameSize.isEmpty( ))
+        return 1;
+
+    const uint64_t pixels = uint64_t( frameSize.width( )) * frameSize.height();
+    const uint64_t threads = ( pixels + PIXELS_PER_THREAD - 1 ) /
+                             PIXELS_PER_THREAD;
+    return threads < MAX_THREADS_PER_DECODER ? unsigned( threads )
+                                             : MAX_THREADS_PER_DECODER;
+}
+
+DecoderThreadBudget& DecoderThreadBudget::global()
+{
+    static DecoderThreadBudget budget( std::thread::hardware_concurrency( ));
+    return budget;
+}
@@ -0,0 +1,120 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef DECODERTHREADBUDGET_H
+#define DECODERTHREADBUDGET_H
+
+#include <QSize>
+
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+
+/**
+ * Share a number of decoding threads among the movies of a process.
+ *
+ * Each movie decodes in a thread of its own, which the budget does not
+ * count. The frame and slice threads which libavcodec creates in addition
+ * are granted according to the frame size of the movie, so that a large
+ * movie gets the threads it needs to play in real time even if many small
+ * ones are open: those request no additional thread at all.
+ *
+ * The threads are granted when a decoder is opened and kept until it is
+ * closed, since libavcodec can not change them afterwards.
+ *
+ * All methods of this class are thread-safe.
+ */
+class DecoderThreadBudget : public boost::noncopyable
+{
+public:
+    /** The maximum number of threads of a decoder. */
+    static const unsigned int MAX_THREADS_PER_DECODER = 16;
+
+    /** The number of pixels per frame which one decoding thread handles. */
+    static const unsigned int PIXELS_PER_THREAD = 1280 * 720;
+
+    /**
+     * Constructor.
+     * @param threadCount The number of threads to share, in addition to the
+     *        decoding thread of each movie
+     */
+    explicit DecoderThreadBudget( unsigned int threadCount );
+
+    /**
+     * Change the number of threads to share.
+     *
+     * The decoders keep the threads which they have already been granted.
+     */
+    void setThreadCount( unsigned int threadCount );
+
+    /** @return the number of threads to share. */
+    unsigned int getThreadCount() const;
+
+    /** @return the number of threads granted to the open decoders. */
+    unsigned int getUsedThreads() const;
+
+    /**
+     * Get the threads for a new decoder.
+     * @param frameSize The dimensions of the frames of the movie
+     * @return the thread count of the decoder, at least 1 (its own thread);
+     *         to give back with release() when it is closed
+     */
+    unsigned int acquire( const QSize& frameSize );
+
+    /**
+     * Give back the threads of a closed decoder.
+     * @param threads The value returned by acquire()
+     */
+    void release( unsigned int threads );
+
+    /**
+     * @param frameSize The dimensions of the frames of a movie
+     * @return the number of threads needed to decode a movie in real time
+     */
+    static unsigned int getRequestedThreads( const QSize& frameSize );
+
+    /** @return the budget of the process. */
+    static DecoderThreadBudget& global();
+
+private:
+    mutable std::mutex _mutex;
+    unsigned int _threadCount;
+    unsigned int _usedThreads;
+};
+
+#endif // DECODERTHREADBUDGET_H
@@ -281,3 +281,15 @@ void DisplayGroup::_updateFocusedWindowsCoordinates()
     for( auto window : _focusedWindows )
         window->setFocusedCoordinates( engine.getFocusedCoord( *window ));
 }
+
+void DisplayGroup::_replaceContentWindows( const ContentWindowPtrs& windows,
+                                           const ContentWindowSet& focused )
+{
+    const bool hadFocusedWindows = hasFocusedWindows();
+
+    _contentWindows = windows;
+    _focusedWindows = focused;
+
+    if( hadFocusedWindows != hasFocusedWindows( ))
+        emit hasFocusedWindowsChanged();
+}
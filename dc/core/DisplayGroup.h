@@ -185,6 +185,7 @@ private:
     Q_DISABLE_COPY( DisplayGroup )
 
     friend class boost::serialization::access;
+    friend class DisplayGroupDelta;
 
     /** No-argument constructor required for serialization. */
     DisplayGroup();
@@ -236,6 +237,8 @@ private:
     void _watchChanges( ContentWindowPtr contentWindow );
     void _removeFocusedWindow( ContentWindowPtr window );
     void _updateFocusedWindowsCoordinates();
+    void _replaceContentWindows( const ContentWindowPtrs& windows,
+                                 const ContentWindowSet& focusedWindows );
 
     bool _showWindowTitles;
     ContentWindowPtrs _contentWindows;
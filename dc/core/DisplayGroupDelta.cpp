@@ -0,0 +1,293 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "DisplayGroupDelta.h"
+
+#include "ContentWindowController.h"
+#include "log.h"
+
+#include <QMap>
+
+namespace
+{
+typedef QMap<QUuid, ContentWindowPtr> WindowMap;
+
+WindowMap mapWindows( const ContentWindowPtrs& windows )
+{
+    WindowMap map;
+    for( ContentWindowPtr window : windows )
+        map[window->getID()] = window;
+    return map;
+}
+
+// The revision is set by the DisplayGroupDeltaBuilder each time it sends a
+// content, and reset when a content is modified.
+bool haveSameContent( const ContentWindow& window1,
+                      const ContentWindow& window2 )
+{
+    const uint64_t revision = window1.getContentPtr()->getRevision();
+    return window1.isPanel() == window2.isPanel() && revision != 0 &&
+           revision == window2.getContentPtr()->getRevision();
+}
+}
+
+DisplayGroupDelta::WindowFields::WindowFields()
+    : border( ContentWindow::NOBORDER )
+    , focused( false )
+    , state( ContentWindow::NONE )
+    , controlsVisible( false )
+{}
+
+DisplayGroupDelta::WindowFields::WindowFields( const ContentWindow& window )
+    : id( window.getID( ))
+    , coordinates( window.getCoordinates( ))
+    , zoomRect( window.getZoomRect( ))
+    , border( window.getBorder( ))
+    , focused( window.isFocused( ))
+    , focusedCoordinates( window.getFocusedCoordinates( ))
+    , state( window.getState( ))
+    , controlsVisible( window.getControlsVisible( ))
+{}
+
+void DisplayGroupDelta::WindowFields::apply( ContentWindow& window ) const
+{
+    window.setCoordinates( coordinates );
+    window.setZoomRect( zoomRect );
+    window.setBorder( border );
+    window.setFocusedCoordinates( focusedCoordinates );
+    // setFocused() also changes the state, which must be set afterwards
+    window.setFocused( focused );
+    window.setState( state );
+    window.setControlsVisible( controlsVisible );
+}
+
+bool DisplayGroupDelta::WindowFields::operator==(
+        const WindowFields& rhs ) const
+{
+    return id == rhs.id &&
+           coordinates == rhs.coordinates &&
+           zoomRect == rhs.zoomRect &&
+           border == rhs.border &&
+           focused == rhs.focused &&
+           focusedCoordinates == rhs.focusedCoordinates &&
+           state == rhs.state &&
+           controlsVisible == rhs.controlsVisible;
+}
+
+bool DisplayGroupDelta::WindowFields::operator!=(
+        const WindowFields& rhs ) const
+{
+    return !( *this == rhs );
+}
+
+DisplayGroupDelta::NewWindow::NewWindow()
+    : type( ContentWindow::DEFAULT )
+{}
+
+DisplayGroupDelta::NewWindow::NewWindow( const ContentWindow& window )
+    : type( window.isPanel() ? ContentWindow::PANEL : ContentWindow::DEFAULT )
+    , content( window.getContent( ))
+    , fields( window )
+{}
+
+DisplayGroupDelta::DisplayGroupDelta()
+    : version_( 0 )
+    , showWindowTitles_( true )
+    , orderChanged_( false )
+{}
+
+DisplayGroupDelta::DisplayGroupDelta( DisplayGroupPtr displayGroup,
+                                      const uint64_t version )
+    : version_( version )
+    , snapshot_( displayGroup )
+    , showWindowTitles_( true )
+    , orderChanged_( false )
+{}
+
+uint64_t DisplayGroupDelta::getVersion() const
+{
+    return version_;
+}
+
+void DisplayGroupDelta::setVersion( const uint64_t version )
+{
+    version_ = version;
+}
+
+bool DisplayGroupDelta::isSnapshot() const
+{
+    return !!snapshot_;
+}
+
+void DisplayGroupDelta::setDisplayGroupProperties( const DisplayGroup& group )
+{
+    showWindowTitles_ = group.getShowWindowTitles();
+    coordinates_ = group.getCoordinates();
+
+    focusedWindows_.clear();
+    for( ContentWindowPtr window : group.getFocusedWindows( ))
+        focusedWindows_.push_back( window->getID( ));
+}
+
+void DisplayGroupDelta::addNewWindow( const ContentWindow& window )
+{
+    newWindows_.push_back( NewWindow( window ));
+}
+
+void DisplayGroupDelta::addChangedWindow( const WindowFields& fields )
+{
+    changedWindows_.push_back( fields );
+}
+
+void DisplayGroupDelta::setWindowOrder( const std::vector<QUuid>& windowOrder )
+{
+    windowOrder_ = windowOrder;
+    orderChanged_ = true;
+}
+
+size_t DisplayGroupDelta::getNewWindowCount() const
+{
+    return newWindows_.size();
+}
+
+size_t DisplayGroupDelta::getChangedWindowCount() const
+{
+    return changedWindows_.size();
+}
+
+void DisplayGroupDelta::apply( DisplayGroup& displayGroup ) const
+{
+    if( snapshot_ )
+    {
+        applySnapshot( displayGroup );
+        return;
+    }
+
+    WindowMap windows = mapWindows( displayGroup.getContentWindows( ));
+
+    for( const NewWindow& newWindow : newWindows_ )
+        windows[newWindow.fields.id] = createWindow( newWindow, displayGroup );
+
+    for( const WindowFields& fields : changedWindows_ )
+    {
+        WindowMap::iterator it = windows.find( fields.id );
+        if( it == windows.end( ))
+        {
+            put_flog( LOG_WARN, "cannot update unknown window: %s",
+                      fields.id.toString().toLocal8Bit().constData( ));
+            continue;
+        }
+        fields.apply( **it );
+    }
+
+    ContentWindowPtrs orderedWindows;
+    if( orderChanged_ )
+    {
+        for( const QUuid& id : windowOrder_ )
+        {
+            WindowMap::const_iterator it = windows.find( id );
+            if( it != windows.end( ))
+                orderedWindows.push_back( *it );
+        }
+    }
+    else
+    {
+        // Keep the current order, replacing the windows whose content changed
+        for( ContentWindowPtr window : displayGroup.getContentWindows( ))
+            orderedWindows.push_back( windows[window->getID()] );
+    }
+
+    ContentWindowSet focusedWindows;
+    for( const QUuid& id : focusedWindows_ )
+    {
+        WindowMap::const_iterator it = windows.find( id );
+        if( it != windows.end( ))
+            focusedWindows.insert( *it );
+    }
+
+    displayGroup._replaceContentWindows( orderedWindows, focusedWindows );
+    displayGroup.setShowWindowTitles( showWindowTitles_ );
+    displayGroup.setCoordinates( coordinates_ );
+}
+
+void DisplayGroupDelta::applySnapshot( DisplayGroup& displayGroup ) const
+{
+    const WindowMap existingWindows =
+            mapWindows( displayGroup.getContentWindows( ));
+
+    // Reuse the existing windows which still have the same content
+    WindowMap windows;
+    ContentWindowPtrs orderedWindows;
+    for( ContentWindowPtr window : snapshot_->getContentWindows( ))
+    {
+        ContentWindowPtr existing = existingWindows.value( window->getID( ));
+        if( existing && haveSameContent( *existing, *window ))
+            WindowFields( *window ).apply( *existing );
+        else
+        {
+            existing = window;
+            existing->setController( make_unique<ContentWindowController>(
+                                         *existing, displayGroup ));
+        }
+        windows[existing->getID()] = existing;
+        orderedWindows.push_back( existing );
+    }
+
+    ContentWindowSet focusedWindows;
+    for( ContentWindowPtr window : snapshot_->getFocusedWindows( ))
+        focusedWindows.insert( windows.value( window->getID( )));
+
+    displayGroup._replaceContentWindows( orderedWindows, focusedWindows );
+    displayGroup.setShowWindowTitles( snapshot_->getShowWindowTitles( ));
+    displayGroup.setCoordinates( snapshot_->getCoordinates( ));
+}
+
+ContentWindowPtr
+DisplayGroupDelta::createWindow( const NewWindow& newWindow,
+                                 const DisplayGroup& displayGroup ) const
+{
+    ContentWindowPtr window( new ContentWindow );
+    window->uuid_ = newWindow.fields.id;
+    window->type_ = newWindow.type;
+    window->content_ = newWindow.content;
+    window->init();
+    window->setController( make_unique<ContentWindowController>(
+                               *window, displayGroup ));
+    newWindow.fields.apply( *window );
+    return window;
+}
@@ -0,0 +1,201 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef DISPLAYGROUPDELTA_H
+#define DISPLAYGROUPDELTA_H
+
+#include "types.h"
+#include "ContentWindow.h" // needed for serialization
+#include "DisplayGroup.h" // needed for serialization
+#include "serializationHelpers.h"
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <QRectF>
+#include <QUuid>
+
+/**
+ * The changes made to a DisplayGroup between two versions, keyed by window id.
+ *
+ * Used by the master application to replicate its DisplayGroup on the wall
+ * processes without re-sending and re-creating all the windows each time one
+ * of them changes. A delta can also be a full snapshot of the DisplayGroup,
+ * which is sent periodically to resynchronize the wall processes.
+ *
+ * @see DisplayGroupDeltaBuilder
+ */
+class DisplayGroupDelta
+{
+public:
+    /** The fields of a ContentWindow which change during interaction. */
+    struct WindowFields
+    {
+        WindowFields();
+
+        /** Copy the fields of a window. */
+        explicit WindowFields( const ContentWindow& window );
+
+        /** Update a window in place, emitting its change notifiers. */
+        void apply( ContentWindow& window ) const;
+
+        bool operator==( const WindowFields& rhs ) const;
+        bool operator!=( const WindowFields& rhs ) const;
+
+        QUuid id;
+        QRectF coordinates;
+        QRectF zoomRect;
+        ContentWindow::WindowBorder border;
+        bool focused;
+        QRectF focusedCoordinates;
+        ContentWindow::WindowState state;
+        bool controlsVisible;
+
+        template< class Archive >
+        void serialize( Archive & ar, const unsigned int )
+        {
+            ar & id;
+            ar & coordinates;
+            ar & zoomRect;
+            ar & border;
+            ar & focused;
+            ar & focusedCoordinates;
+            ar & state;
+            ar & controlsVisible;
+        }
+    };
+
+    /** A window which is new, or whose Content has changed. */
+    struct NewWindow
+    {
+        NewWindow();
+
+        /** Copy a window, without its controller. */
+        explicit NewWindow( const ContentWindow& window );
+
+        ContentWindow::WindowType type;
+        ContentPtr content;
+        WindowFields fields;
+
+        template< class Archive >
+        void serialize( Archive & ar, const unsigned int )
+        {
+            ar & type;
+            ar & content;
+            ar & fields;
+        }
+    };
+
+    /** Constructor for an empty delta. */
+    DisplayGroupDelta();
+
+    /**
+     * Create a full snapshot of a DisplayGroup.
+     * @param displayGroup The DisplayGroup to replicate
+     * @param version The version of the DisplayGroup
+     */
+    DisplayGroupDelta( DisplayGroupPtr displayGroup, uint64_t version );
+
+    /** @return the version of the DisplayGroup after applying this delta. */
+    uint64_t getVersion() const;
+
+    /** Set the version of the DisplayGroup after applying this delta. */
+    void setVersion( uint64_t version );
+
+    /** @return true if this is a full snapshot of the DisplayGroup. */
+    bool isSnapshot() const;
+
+    /** Set the global properties of the DisplayGroup. */
+    void setDisplayGroupProperties( const DisplayGroup& displayGroup );
+
+    /** Add a new window, or a window whose Content has changed. */
+    void addNewWindow( const ContentWindow& window );
+
+    /** Add the changed fields of an existing window. */
+    void addChangedWindow( const WindowFields& fields );
+
+    /** Set the ids of all the windows, in stacking order. */
+    void setWindowOrder( const std::vector<QUuid>& windowOrder );
+
+    /** @return the number of new windows in this delta. */
+    size_t getNewWindowCount() const;
+
+    /** @return the number of changed windows in this delta. */
+    size_t getChangedWindowCount() const;
+
+    /**
+     * Apply the delta to a DisplayGroup, modifying its windows in place.
+     * @param displayGroup The DisplayGroup to update, which must be at the
+     *        version preceding this delta unless it is a snapshot.
+     */
+    void apply( DisplayGroup& displayGroup ) const;
+
+private:
+    friend class boost::serialization::access;
+
+    template< class Archive >
+    void serialize( Archive & ar, const unsigned int )
+    {
+        ar & version_;
+        ar & snapshot_;
+        ar & showWindowTitles_;
+        ar & coordinates_;
+        ar & newWindows_;
+        ar & changedWindows_;
+        ar & orderChanged_;
+        ar & windowOrder_;
+        ar & focusedWindows_;
+    }
+
+    void applySnapshot( DisplayGroup& displayGroup ) const;
+    ContentWindowPtr createWindow( const NewWindow& newWindow,
+                                   const DisplayGroup& displayGroup ) const;
+
+    uint64_t version_;
+    DisplayGroupPtr snapshot_;
+
+    bool showWindowTitles_;
+    QRectF coordinates_;
+    std::vector<NewWindow> newWindows_;
+    std::vector<WindowFields> changedWindows_;
+    bool orderChanged_;
+    std::vector<QUuid> windowOrder_;
+    std::vector<QUuid> focusedWindows_;
+};
+
+#endif // DISPLAYGROUPDELTA_H
@@ -0,0 +1,122 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "DisplayGroupDeltaBuilder.h"
+
+#include "Content.h"
+
+#include <boost/make_shared.hpp>
+
+DisplayGroupDeltaBuilder::DisplayGroupDeltaBuilder(
+        const unsigned int snapshotInterval )
+    : snapshotInterval_( snapshotInterval )
+    , deltasSinceSnapshot_( 0 )
+    , snapshotRequested_( true )
+    , version_( 0 )
+    , snapshotCount_( 0 )
+    , deltaCount_( 0 )
+    , contentRevision_( 0 )
+{
+}
+
+DisplayGroupDeltaPtr
+DisplayGroupDeltaBuilder::update( DisplayGroupPtr displayGroup )
+{
+    DisplayGroupDeltaPtr delta = boost::make_shared<DisplayGroupDelta>();
+    delta->setDisplayGroupProperties( *displayGroup );
+
+    WindowStates windows;
+    std::vector<QUuid> windowOrder;
+    for( ContentWindowPtr window : displayGroup->getContentWindows( ))
+    {
+        const QUuid& id = window->getID();
+        windowOrder.push_back( id );
+
+        WindowState& state = windows[id];
+        state.fields = DisplayGroupDelta::WindowFields( *window );
+        state.isPanel = window->isPanel();
+        state.content = window->getContentPtr();
+
+        // A window with a new or modified content is sent in full
+        WindowStates::const_iterator previous = windows_.find( id );
+        if( previous == windows_.end() || previous->isPanel != state.isPanel ||
+            previous->content != state.content || state.content->isModified( ))
+        {
+            window->getContentPtr()->setRevision( ++contentRevision_ );
+            delta->addNewWindow( *window );
+        }
+        else if( previous->fields != state.fields )
+            delta->addChangedWindow( state.fields );
+    }
+    for( ContentWindowPtr window : displayGroup->getContentWindows( ))
+        window->getContentPtr()->clearModified();
+    if( windowOrder != windowOrder_ )
+        delta->setWindowOrder( windowOrder );
+
+    windows_.swap( windows );
+    windowOrder_.swap( windowOrder );
+
+    if( snapshotRequested_ || deltasSinceSnapshot_ >= snapshotInterval_ )
+    {
+        snapshotRequested_ = false;
+        deltasSinceSnapshot_ = 0;
+        ++snapshotCount_;
+        return boost::make_shared<DisplayGroupDelta>( displayGroup,
+                                                      ++version_ );
+    }
+
+    delta->setVersion( ++version_ );
+    ++deltasSinceSnapshot_;
+    ++deltaCount_;
+    return delta;
+}
+
+void DisplayGroupDeltaBuilder::requestSnapshot()
+{
+    snapshotRequested_ = true;
+}
+
+uint64_t DisplayGroupDeltaBuilder::getSnapshotCount() const
+{
+    return snapshotCount_;
+}
+
+uint64_t DisplayGroupDeltaBuilder::getDeltaCount() const
+{
+    return deltaCount_;
+}
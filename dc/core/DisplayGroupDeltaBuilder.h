@@ -0,0 +1,108 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef DISPLAYGROUPDELTABUILDER_H
+#define DISPLAYGROUPDELTABUILDER_H
+
+#include "types.h"
+#include "DisplayGroupDelta.h"
+
+#include <QMap>
+#include <QUuid>
+
+/**
+ * Compute the successive DisplayGroupDeltas to send to the wall processes.
+ *
+ * The builder remembers the state of the DisplayGroup that was last sent, so
+ * that only the windows which were added or modified since are included in
+ * the next delta. The contents are not compared but tracked with their
+ * modified flag, see Content::isModified(). A full snapshot is sent
+ * periodically for resynchronization, in which the wall processes keep the
+ * windows whose content has the same revision, see Content::getRevision().
+ *
+ * @note Rank0 only.
+ */
+class DisplayGroupDeltaBuilder
+{
+public:
+    /**
+     * Constructor
+     * @param snapshotInterval The number of deltas between two snapshots.
+     */
+    DisplayGroupDeltaBuilder( unsigned int snapshotInterval );
+
+    /**
+     * Compute the changes to a DisplayGroup since the previous call.
+     * @param displayGroup The current DisplayGroup
+     * @return a delta or a full snapshot. The properties of the DisplayGroup
+     *         and the focused windows are always included, as they are small.
+     */
+    DisplayGroupDeltaPtr update( DisplayGroupPtr displayGroup );
+
+    /** Send a full snapshot on the next update. */
+    void requestSnapshot();
+
+    /** @return the number of snapshots generated. */
+    uint64_t getSnapshotCount() const;
+
+    /** @return the number of (non-snapshot) deltas generated. */
+    uint64_t getDeltaCount() const;
+
+private:
+    struct WindowState
+    {
+        DisplayGroupDelta::WindowFields fields;
+        bool isPanel;
+        const Content* content;
+    };
+    typedef QMap<QUuid, WindowState> WindowStates;
+
+    const unsigned int snapshotInterval_;
+    unsigned int deltasSinceSnapshot_;
+    bool snapshotRequested_;
+
+    uint64_t version_;
+    uint64_t snapshotCount_;
+    uint64_t deltaCount_;
+    uint64_t contentRevision_;
+
+    WindowStates windows_;
+    std::vector<QUuid> windowOrder_;
+};
+
+#endif // DISPLAYGROUPDELTABUILDER_H
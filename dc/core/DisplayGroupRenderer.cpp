@@ -40,11 +40,13 @@
 #include "DisplayGroupRenderer.h"
 
 #include "DisplayGroup.h"
+#include "DisplayGroupDelta.h"
 #include "ContentWindow.h"
 #include "ContentWindowController.h"
 #include "RenderContext.h"
 #include "Options.h"
 #include "PixelStream.h"
+#include "log.h"
 
 #include <deflect/Frame.h>
 
@@ -66,11 +68,17 @@ DisplayGroupRenderer::DisplayGroupRenderer( RenderContextPtr renderContext )
     : _renderContext( renderContext )
     , _displayGroup( new DisplayGroup(
                         renderContext->getScene().sceneRect().size().toSize( )))
+    , _displayGroupVersion( 0 )
     , _displayGroupItem( 0 )
     , _options( new Options )
 {
     _setOptionInQmlContext( _options );
-    setDisplayGroup( _displayGroup );
+
+    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
+    engine.rootContext()->setContextProperty( "displaygroup",
+                                              _displayGroup.get( ));
+    _createDisplayGroupQmlItem();
+
     _setBackground( _options->getBackgroundContent( ));
 }
 
@@ -81,18 +89,40 @@ void DisplayGroupRenderer::setRenderingOptions( OptionsPtr options )
     _options = options; // Retain the new Options
 }
 
-void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
+DisplayGroupPtr DisplayGroupRenderer::getDisplayGroup() const
 {
-    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
+    return _displayGroup;
+}
 
-    // Update the scene with the new information
-    engine.rootContext()->setContextProperty( "displaygroup",
-                                              displayGroup.get( ));
+void DisplayGroupRenderer::update( const DisplayGroupDelta& delta )
+{
+    if( !delta.isSnapshot() && delta.getVersion() != _displayGroupVersion + 1 )
+    {
+        put_flog( LOG_WARN, "DisplayGroup version %llu does not follow %llu, "
+                            "waiting for the next snapshot",
+                  (unsigned long long)delta.getVersion(),
+                  (unsigned long long)_displayGroupVersion );
+        return;
+    }
 
-    if( !_displayGroupItem )
-        _createDisplayGroupQmlItem();
+    delta.apply( *_displayGroup );
+    _displayGroupVersion = delta.getVersion();
 
-    ContentWindowPtrs contentWindows = displayGroup->getContentWindows();
+    _updateWindowItems();
+}
+
+void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
+{
+    DisplayGroupDelta( displayGroup, _displayGroupVersion ).apply(
+                *_displayGroup );
+
+    _updateWindowItems();
+}
+
+void DisplayGroupRenderer::_updateWindowItems()
+{
+    const ContentWindowPtrs& contentWindows =
+            _displayGroup->getContentWindows();
 
     // Update windows, creating new ones if needed
     QSet<QUuid> updatedWindows;
@@ -103,10 +133,11 @@ void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
 
         updatedWindows.insert( id );
 
-        if( _windowItems.contains( id ))
-            _windowItems[id]->update( window );
-        else
+        if( !_windowItems.contains( id ))
             _createWindowQmlItem( window );
+        // Windows are modified in place, unless their content has changed
+        else if( _windowItems[id]->getContentWindow() != window )
+            _windowItems[id]->update( window );
 
         _windowItems[id]->setStackingOrder( stackingOrder++ );
     }
@@ -124,13 +155,10 @@ void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
         }
     }
 
-    // Retain the new DisplayGroup
-    _displayGroup = displayGroup;
-
     // Work around a bug in animation in Qt, where the opacity property
     // of the focus context may not always be restored to its original value.
     // See JIRA issue: DISCL-305
-    if( !displayGroup->hasFocusedWindows( ))
+    if( !_displayGroup->hasFocusedWindows( ))
     {
         for( QGraphicsItem* child : _displayGroupItem->childItems( ))
         {
@@ -146,15 +174,17 @@ void DisplayGroupRenderer::_setOptionInQmlContext( OptionsPtr options )
     engine.rootContext()->setContextProperty( "options", options.get( ));
 }
 
-void DisplayGroupRenderer::preRenderUpdate( WallToWallChannel& wallChannel )
+void DisplayGroupRenderer::preRenderUpdate( WallToWallChannel& wallChannel,
+                                            SwapSyncRegistry& registry )
 {
     const QRect& visibleWallArea = _renderContext->getVisibleWallArea();
     foreach( QmlWindowPtr window, _windowItems )
     {
-        window->preRenderUpdate( wallChannel, visibleWallArea );
+        window->preRenderUpdate( wallChannel, registry, visibleWallArea );
     }
     if( _backgroundWindowItem )
-        _backgroundWindowItem->preRenderUpdate( wallChannel, visibleWallArea );
+        _backgroundWindowItem->preRenderUpdate( wallChannel, registry,
+                                                visibleWallArea );
 }
 
 void DisplayGroupRenderer::postRenderUpdate( WallToWallChannel& wallChannel )
@@ -64,11 +64,29 @@ public:
     /** Set different options used for rendering. */
     void setRenderingOptions( OptionsPtr options );
 
-    void preRenderUpdate( WallToWallChannel& wallChannel );
+    void preRenderUpdate( WallToWallChannel& wallChannel,
+                          SwapSyncRegistry& registry );
     void postRenderUpdate( WallToWallChannel& wallChannel );
 
+    /** Get the DisplayGroup being rendered. */
+    DisplayGroupPtr getDisplayGroup() const;
+
+    /**
+     * Update the DisplayGroup with changes received from the master.
+     *
+     * A delta which does not follow the current version is ignored until the
+     * next snapshot resynchronizes the DisplayGroup.
+     * @param delta The changes or the snapshot to apply
+     */
+    void update( const DisplayGroupDelta& delta );
+
 public slots:
-    /** Set the DisplayGroup to render, replacing the previous one. */
+    /**
+     * Set the DisplayGroup to render.
+     *
+     * The windows of the current DisplayGroup are updated in place when
+     * possible, instead of being replaced.
+     */
     void setDisplayGroup( DisplayGroupPtr displayGroup );
 
 signals:
@@ -80,6 +98,7 @@ private:
 
     RenderContextPtr _renderContext;
     DisplayGroupPtr _displayGroup;
+    uint64_t _displayGroupVersion;
     QDeclarativeItem* _displayGroupItem;
 
     typedef QMap<QUuid,QmlWindowPtr> QmlWindows;
@@ -90,6 +109,7 @@ private:
 
     void _setOptionInQmlContext( OptionsPtr options );
     void _createDisplayGroupQmlItem();
+    void _updateWindowItems();
     void _createWindowQmlItem( ContentWindowPtr window );
     bool _hasBackgroundChanged( const QString& newUri ) const;
     void _setBackground( ContentPtr backgroundContent );
@@ -454,14 +454,9 @@ void DynamicTexture::drawTexture(const QRectF& texCoords)
 
 void DynamicTexture::renderTextureBorder()
 {
-    glPushAttrib( GL_CURRENT_BIT );
-
-    glColor4f( 0.f, 1.f, 0.f, 1.f );
-
+    quadBorder_.setColor( Qt::green );
     quadBorder_.setRenderMode( GL_LINE_LOOP );
     quadBorder_.render();
-
-    glPopAttrib();
 }
 
 void DynamicTexture::renderTexturedUnitQuad( const QRectF& texCoords )
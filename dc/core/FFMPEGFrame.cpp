@@ -41,6 +41,11 @@
 
 #include "log.h"
 
+#include <algorithm>
+
+#pragma clang diagnostic ignored "-Wdeprecated"
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
 FFMPEGFrame::FFMPEGFrame()
 #if(LIBAVCODEC_VERSION_INT < AV_VERSION_INT(55,28,0))
     : _avFrame( avcodec_alloc_frame( ))
@@ -72,24 +77,111 @@ const AVFrame& FFMPEGFrame::getAVFrame() const
     return *_avFrame;
 }
 
-const uint8_t* FFMPEGFrame::getData() const
+const uint8_t* FFMPEGFrame::getData( const unsigned int plane ) const
 {
-    return _avFrame->data[0];
+    return _avFrame->data[plane];
 }
 
 
 FFMPEGPicture::FFMPEGPicture( const unsigned int width,
                               const unsigned int height,
                               const PixelFormat format )
+    : FFMPEGPicture( QRect( 0, 0, width, height ), format )
+{
+}
+
+FFMPEGPicture::FFMPEGPicture( const QRect& region, const PixelFormat format )
+    : _region( region )
+    , _format( format )
+    , _buffer( 0 )
+    , _capacity( 0 )
 {
-    if( avpicture_alloc( (AVPicture*)_avFrame, format, width, height ) != 0 )
+    // A region which is not visible is not converted
+    if( _region.isEmpty( ))
+        return;
+
+    const int size = avpicture_get_size( format, _region.width(),
+                                         _region.height( ));
+    _buffer = size > 0 ? (uint8_t*)av_malloc( size ) : 0;
+    if( !_buffer )
     {
         put_flog( LOG_ERROR, "Error allocating picture buffer for AV frame" );
         return;
     }
+    _capacity = size;
+    _fillPlanes();
 }
 
 FFMPEGPicture::~FFMPEGPicture()
 {
-    avpicture_free( (AVPicture*)_avFrame );
+    av_free( _buffer );
+}
+
+const QRect& FFMPEGPicture::getRegion() const
+{
+    return _region;
+}
+
+bool FFMPEGPicture::setRegion( const QRect& region )
+{
+    if( !region.isEmpty() && avpicture_get_size( _format, region.width(),
+                                                 region.height( )) > _capacity )
+    {
+        return false;
+    }
+
+    _region = region;
+    _fillPlanes();
+    return true;
+}
+
+void FFMPEGPicture::_fillPlanes()
+{
+    AVPicture* picture = (AVPicture*)_avFrame;
+    if( _region.isEmpty() || !_buffer )
+    {
+        std::fill( picture->data, picture->data + AV_NUM_DATA_POINTERS,
+                   (uint8_t*)0 );
+        std::fill( picture->linesize, picture->linesize + AV_NUM_DATA_POINTERS,
+                   0 );
+        return;
+    }
+
+    // The planes are tightly packed in the buffer
+    avpicture_fill( picture, _buffer, _format, _region.width(),
+                    _region.height( ));
+}
+
+PixelFormat FFMPEGPicture::getFormat() const
+{
+    return _format;
+}
+
+QRect FFMPEGPicture::getPlaneRegion( const unsigned int plane ) const
+{
+    return getPlaneRegion( _region, _format, plane );
+}
+
+QRect FFMPEGPicture::getPlaneRegion( const QRect& region,
+                                     const PixelFormat format,
+                                     const unsigned int plane )
+{
+    if( plane != 1 && plane != 2 )
+        return region;
+
+    int shiftX = 0, shiftY = 0;
+    avcodec_get_chroma_sub_sample( format, &shiftX, &shiftY );
+
+    // Partial chroma samples at the right and bottom edges are rounded up
+    const int left = region.x() >> shiftX;
+    const int top = region.y() >> shiftY;
+    const int right = ( region.right() + ( 1 << shiftX )) >> shiftX;
+    const int bottom = ( region.bottom() + ( 1 << shiftY )) >> shiftY;
+    return QRect( left, top, right - left, bottom - top );
+}
+
+bool FFMPEGPicture::hasFullColorRange() const
+{
+    return _format == PIX_FMT_YUVJ420P || _format == PIX_FMT_YUVJ422P ||
+           _format == PIX_FMT_YUVJ444P;
 }
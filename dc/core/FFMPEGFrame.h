@@ -59,6 +59,8 @@ extern "C"
     #include <libavutil/mem.h>
 }
 
+#include <QRect>
+
 /** A frame of an FFMPEG movie. */
 class FFMPEGFrame
 {
@@ -72,8 +74,11 @@ public:
     /** @return the timestamp of the frame. */
     int64_t getTimestamp() const;
 
-    /** @return the frame raw data. */
-    const uint8_t* getData() const;
+    /**
+     * @param plane The index of the plane for planar formats
+     * @return the frame raw data.
+     */
+    const uint8_t* getData( unsigned int plane = 0 ) const;
 
     /** Get the FFMPEG frame. */
     AVFrame& getAVFrame();
@@ -92,8 +97,63 @@ public:
     FFMPEGPicture( unsigned int width, unsigned int height,
                    PixelFormat format );
 
+    /**
+     * Construct a picture for a region of a movie frame.
+     * @param region The region of the frame, no data is allocated if empty
+     * @param format The format of the picture data
+     */
+    FFMPEGPicture( const QRect& region, PixelFormat format );
+
     /** Destructor. */
     ~FFMPEGPicture();
+
+    /** @return the region of the movie frame contained in the picture. */
+    const QRect& getRegion() const;
+
+    /**
+     * Change the region of the picture, keeping its data buffer.
+     * @param region The new region, which must fit in the buffer allocated
+     *        for the region given at construction
+     * @return false if the region does not fit, in which case it is unchanged
+     */
+    bool setRegion( const QRect& region );
+
+    /** @return the format of the picture data. */
+    PixelFormat getFormat() const;
+
+    /**
+     * Get the dimensions of a plane of the picture data.
+     *
+     * The chroma planes of subsampled YUV formats are smaller than the region.
+     * The planes are tightly packed.
+     * @param plane The index of the plane
+     * @return the region of the plane, in plane pixel coordinates
+     */
+    QRect getPlaneRegion( unsigned int plane ) const;
+
+    /**
+     * Get the dimensions of a plane of a region of a frame.
+     * @param region The region of the frame
+     * @param format The format of the picture data
+     * @param plane The index of the plane
+     * @return the region of the plane, in plane pixel coordinates
+     */
+    static QRect getPlaneRegion( const QRect& region, PixelFormat format,
+                                 unsigned int plane );
+
+    /**
+     * @return true if the YUV data uses the full [0-255] range (JPEG formats),
+     *         false for the [16-235] range of video formats.
+     */
+    bool hasFullColorRange() const;
+
+private:
+    QRect _region;
+    PixelFormat _format;
+    uint8_t* _buffer;
+    int _capacity;
+
+    void _fillPlanes();
 };
 
 #endif // FFMPEGFRAME_H
@@ -45,12 +45,16 @@
 
 #define MIN_SEEK_DELTA_SEC  0.5
 #define VIDEO_QUEUE_SIZE    4
+// The queued pictures, plus the ones held by the decoding thread, the
+// consuming thread, the promise and the user of the movie
+#define PICTURE_POOL_SIZE   (VIDEO_QUEUE_SIZE + 4)
 #define UNDEFINED_PTS      -1.0
 
 #pragma clang diagnostic ignored "-Wdeprecated"
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
-FFMPEGMovie::FFMPEGMovie( const QString& uri )
+FFMPEGMovie::FFMPEGMovie( const QString& uri,
+                          const MoviePictureFormat format )
     : _avFormatContext( 0 )
     , _ptsPosition( UNDEFINED_PTS )
     , _streamPosition( 0.0 )
@@ -63,9 +67,12 @@ FFMPEGMovie::FFMPEGMovie( const QString& uri )
     , _seekPosition( 0.0 )
     , _targetTimestamp( 0.0 )
     , _targetChangedSent( false )
+    , _targetRefresh( false )
 {
     FFMPEGMovie::initGlobalState();
-    _isValid = _open( uri );
+    _isValid = _open( uri, format );
+    if( _isValid )
+        _visibleRegion = QRect( 0, 0, getWidth(), getHeight( ));
 }
 
 FFMPEGMovie::~FFMPEGMovie()
@@ -75,14 +82,15 @@ FFMPEGMovie::~FFMPEGMovie()
     _releaseAvFormatContext();
 }
 
-bool FFMPEGMovie::_open( const QString& uri )
+bool FFMPEGMovie::_open( const QString& uri, const MoviePictureFormat format )
 {
     if( !_createAvFormatContext( uri ))
         return false;
 
     try
     {
-        _videoStream.reset( new FFMPEGVideoStream( *_avFormatContext ));
+        _videoStream.reset( new FFMPEGVideoStream( *_avFormatContext, format,
+                                                   PICTURE_POOL_SIZE ));
     }
     catch( const std::runtime_error& e )
     {
@@ -151,6 +159,11 @@ unsigned int FFMPEGMovie::getHeight() const
     return _videoStream->getHeight();
 }
 
+PixelFormat FFMPEGMovie::getPictureFormat() const
+{
+    return _videoStream->getPictureFormat();
+}
+
 double FFMPEGMovie::getPosition() const
 {
     return _ptsPosition;
@@ -202,6 +215,11 @@ void FFMPEGMovie::stopDecoding()
     _queue.clear();
 }
 
+size_t FFMPEGMovie::getAllocatedPictures() const
+{
+    return _videoStream->getAllocatedPictures();
+}
+
 bool FFMPEGMovie::isDecoding() const
 {
     return !_stopDecoding;
@@ -221,6 +239,33 @@ std::future<PicturePtr> FFMPEGMovie::getFrame( const double posInSeconds )
     return _promise.get_future();
 }
 
+std::future<PicturePtr> FFMPEGMovie::refreshFrame()
+{
+    const double position = std::max( getPosition(), 0.0 );
+    if( !isDecoding( ))
+        return getFrame( position );
+
+    std::lock_guard<std::mutex> lock( _targetMutex );
+    _promise = std::promise<PicturePtr>();
+    _targetTimestamp = position;
+    _targetRefresh = true;
+    _targetChangedSent = true;
+    _targetChanged.notify_one();
+    return _promise.get_future();
+}
+
+void FFMPEGMovie::setVisibleRegion( const QRect& region )
+{
+    std::lock_guard<std::mutex> lock( _regionMutex );
+    _visibleRegion = region;
+}
+
+QRect FFMPEGMovie::_getVisibleRegion() const
+{
+    std::lock_guard<std::mutex> lock( _regionMutex );
+    return _visibleRegion;
+}
+
 void FFMPEGMovie::_decode()
 {
     while( !_stopDecoding )
@@ -266,8 +311,9 @@ void FFMPEGMovie::_consume()
             if( _stopConsuming )
                 return;
 
-            if( _seekTo( _targetTimestamp ))
+            if( _seekTo( _targetTimestamp, _targetRefresh ))
                 _ptsPosition = UNDEFINED_PTS; // Reset position after seeking
+            _targetRefresh = false;
         }
 
         PicturePtr frame;
@@ -288,7 +334,7 @@ void FFMPEGMovie::_consume()
     }
 }
 
-bool FFMPEGMovie::_seekTo( double posInSeconds )
+bool FFMPEGMovie::_seekTo( double posInSeconds, const bool force )
 {
     posInSeconds = std::max( 0.0, std::min( posInSeconds, getDuration( )));
 
@@ -296,7 +342,7 @@ bool FFMPEGMovie::_seekTo( double posInSeconds )
     const double streamDelta = fabs( posInSeconds - _streamPosition );
 
     // Don't seek forward if the delta is small. Always seek backwards.
-    if( ptsDelta >= 0.0 && streamDelta < MIN_SEEK_DELTA_SEC )
+    if( !force && ptsDelta >= 0.0 && streamDelta < MIN_SEEK_DELTA_SEC )
         return false;
 
     std::unique_lock<std::mutex> lock( _seekMutex );
@@ -319,11 +365,12 @@ bool FFMPEGMovie::_readVideoFrame()
     // keep reading frames until we decode a valid video frame
     while( (avReadStatus = av_read_frame( _avFormatContext, &packet )) >= 0 )
     {
-        auto picture = _videoStream->decode( packet );
+        auto picture = _videoStream->decode( packet, _getVisibleRegion( ));
         if( picture )
         {
             _queue.enqueue( picture );
-            _streamPosition = _videoStream->getPositionInSec( picture->getTimestamp( ));
+            _streamPosition = _videoStream->getPositionInSec(
+                                  picture->getTimestamp( ));
 
             // free the packet that was allocated by av_read_frame
             av_free_packet( &packet );
@@ -333,6 +380,20 @@ bool FFMPEGMovie::_readVideoFrame()
         av_free_packet( &packet );
     }
 
+    // At the end of the file, the frames delayed by the decoder (reordering,
+    // frame threads) remain to be decoded
+    if( avReadStatus < 0 )
+    {
+        auto picture = _videoStream->decodeDelayedFrame( _getVisibleRegion( ));
+        if( picture )
+        {
+            _queue.enqueue( picture );
+            _streamPosition = _videoStream->getPositionInSec(
+                                  picture->getTimestamp( ));
+            avReadStatus = 0;
+        }
+    }
+
     // False if file read error or EOF reached
     _isAtEOF = (avReadStatus < 0);
     return !_isAtEOF;
@@ -359,7 +420,8 @@ bool FFMPEGMovie::_seekFileTo( const double timePosInSeconds )
         const int64_t timestamp = _videoStream->decodeTimestamp( packet );
         if( timestamp >= targetTimestamp )
         {
-            auto picture = _videoStream->decodePictureForLastPacket();
+            auto picture = _videoStream->decodePictureForLastPacket(
+                               _getVisibleRegion( ));
             // This validity check is to prevent against rare decoding errors
             // and is not inherently part of the seeking process.
             if( picture )
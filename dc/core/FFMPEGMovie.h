@@ -64,6 +64,7 @@ extern "C"
 #include "types.h"
 #include <deflect/MTQueue.h>
 
+#include <QRect>
 #include <QString>
 
 #include <atomic>
@@ -79,8 +80,10 @@ public:
     /**
      * Constructor.
      * @param uri: the movie file to open.
+     * @param format: the format of the decoded pictures.
      */
-    FFMPEGMovie( const QString& uri );
+    FFMPEGMovie( const QString& uri,
+                 MoviePictureFormat format = MOVIE_PICTURE_RGBA );
 
     /** Destructor */
     ~FFMPEGMovie();
@@ -94,6 +97,9 @@ public:
     /** Get the frame height. */
     unsigned int getHeight() const;
 
+    /** Get the pixel format of the decoded pictures. */
+    PixelFormat getPictureFormat() const;
+
     /** Get the current time position in seconds. */
     double getPosition() const;
 
@@ -115,6 +121,14 @@ public:
     /** Check if the movie is currently decoding. */
     bool isDecoding() const;
 
+    /**
+     * Get the number of pictures allocated for decoding so far.
+     *
+     * The pictures are recycled once they are released by the user, so the
+     * count remains constant during playback.
+     */
+    size_t getAllocatedPictures() const;
+
     /**
      * Get a frame at the given position in seconds.
      *
@@ -125,6 +139,26 @@ public:
      */
     std::future<PicturePtr> getFrame( double posInSeconds );
 
+    /**
+     * Get the frame at the current position again.
+     *
+     * The frame is decoded again from the file, to convert a region which was
+     * not visible when it was first decoded. The same rules as getFrame()
+     * apply to the returned future.
+     */
+    std::future<PicturePtr> refreshFrame();
+
+    /**
+     * Set the region of the frames to convert.
+     *
+     * Only the part of the movie which is visible needs to be converted and
+     * uploaded. Frames which are already decoded keep their region, see
+     * FFMPEGPicture::getRegion().
+     * @param region The region in frame pixel coordinates, empty if the movie
+     *        is not visible (default: the full frame)
+     */
+    void setVisibleRegion( const QRect& region );
+
 private:
     AVFormatContext* _avFormatContext;
     std::unique_ptr<FFMPEGVideoStream> _videoStream;
@@ -152,12 +186,16 @@ private:
     std::mutex _targetMutex;
     double _targetTimestamp;
     bool _targetChangedSent;
+    bool _targetRefresh;
     std::condition_variable _targetChanged;
 
+    mutable std::mutex _regionMutex;
+    QRect _visibleRegion;
+
     /** Init the global FFMPEG context. */
     static void initGlobalState();
 
-    bool _open( const QString& uri );
+    bool _open( const QString& uri, MoviePictureFormat format );
     bool _createAvFormatContext( const QString& uri );
     void _releaseAvFormatContext();
 
@@ -166,7 +204,8 @@ private:
 
     double _getPtsDelta() const;
     void _consume();
-    bool _seekTo( double timePosInSeconds );
+    bool _seekTo( double timePosInSeconds, bool force );
+    QRect _getVisibleRegion() const;
 
     bool _readVideoFrame();
     bool _seekFileTo( double timePosInSeconds );
@@ -0,0 +1,104 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "FFMPEGPicturePool.h"
+
+FFMPEGPicturePool::FFMPEGPicturePool( const QSize& frameSize,
+                                      const PixelFormat format,
+                                      const size_t capacity )
+    : _frameSize( frameSize )
+    , _format( format )
+    , _capacity( capacity )
+    , _allocationCount( 0 )
+{
+    _freePictures.reserve( capacity );
+}
+
+PicturePtr FFMPEGPicturePool::getPicture( const QRect& region )
+{
+    std::unique_ptr<FFMPEGPicture> picture;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if( !_freePictures.empty( ))
+        {
+            picture = std::move( _freePictures.back( ));
+            _freePictures.pop_back();
+        }
+        else
+            ++_allocationCount;
+    }
+
+    if( !picture )
+    {
+        picture.reset( new FFMPEGPicture( QRect( QPoint(), _frameSize ),
+                                          _format ));
+        if( !picture->getData() && !_frameSize.isEmpty( ))
+            return PicturePtr();
+    }
+
+    if( !picture->setRegion( region ))
+        return PicturePtr();
+
+    return PicturePtr( picture.release(), Recycler{ shared_from_this( )});
+}
+
+size_t FFMPEGPicturePool::getAllocationCount() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _allocationCount;
+}
+
+size_t FFMPEGPicturePool::getFreeCount() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _freePictures.size();
+}
+
+void FFMPEGPicturePool::Recycler::operator()( FFMPEGPicture* picture ) const
+{
+    std::unique_ptr<FFMPEGPicture> owned( picture );
+    if( auto pictures = pool.lock( ))
+        pictures->_recycle( std::move( owned ));
+}
+
+void FFMPEGPicturePool::_recycle( std::unique_ptr<FFMPEGPicture> picture )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    if( _freePictures.size() < _capacity )
+        _freePictures.push_back( std::move( picture ));
+}
@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef FFMPEGPICTUREPOOL_H
+#define FFMPEGPICTUREPOOL_H
+
+#include "FFMPEGFrame.h"
+#include "types.h"
+
+#include <QRect>
+#include <QSize>
+
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Recycle the pictures of a movie to avoid allocating a frame buffer for each
+ * decoded frame.
+ *
+ * The pictures are returned to the pool when the last PicturePtr referencing
+ * them is released, whichever thread does it. Their buffers are allocated for
+ * the full frame, so that they can be reused for any visible region.
+ *
+ * The pool must be created with std::make_shared. All methods are
+ * thread-safe.
+ */
+class FFMPEGPicturePool :
+        public std::enable_shared_from_this<FFMPEGPicturePool>,
+        public boost::noncopyable
+{
+public:
+    /**
+     * Constructor.
+     * @param frameSize The dimensions of the frames of the movie
+     * @param format The format of the pictures
+     * @param capacity The maximum number of unused pictures kept for reuse,
+     *        which should match the number of pictures in flight
+     */
+    FFMPEGPicturePool( const QSize& frameSize, PixelFormat format,
+                       size_t capacity );
+
+    /**
+     * Get a picture for a region of the frame, recycled if one is available.
+     * @param region The region of the frame to hold in the picture
+     * @return the picture, or nullptr if it could not be allocated
+     */
+    PicturePtr getPicture( const QRect& region );
+
+    /** @return the number of pictures allocated since construction. */
+    size_t getAllocationCount() const;
+
+    /** @return the number of unused pictures kept for reuse. */
+    size_t getFreeCount() const;
+
+private:
+    struct Recycler
+    {
+        std::weak_ptr<FFMPEGPicturePool> pool;
+        void operator()( FFMPEGPicture* picture ) const;
+    };
+
+    const QSize _frameSize;
+    const PixelFormat _format;
+    const size_t _capacity;
+
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<FFMPEGPicture>> _freePictures;
+    size_t _allocationCount;
+
+    void _recycle( std::unique_ptr<FFMPEGPicture> picture );
+};
+
+#endif // FFMPEGPICTUREPOOL_H
@@ -40,16 +40,81 @@
 #include "FFMPEGVideoFrameConverter.h"
 
 #include "FFMPEGFrame.h"
+#include "MovieStatistics.h"
 #include "log.h"
 
+extern "C"
+{
+    #include <libavutil/imgutils.h>
+    #include <libavutil/pixdesc.h>
+}
+
+#include <algorithm>
+
 #pragma clang diagnostic ignored "-Wdeprecated"
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+#ifndef AV_PIX_FMT_FLAG_BITSTREAM
+    #define AV_PIX_FMT_FLAG_BITSTREAM PIX_FMT_BITSTREAM
+    #define AV_PIX_FMT_FLAG_PAL PIX_FMT_PAL
+    #define AV_PIX_FMT_FLAG_HWACCEL PIX_FMT_HWACCEL
+#endif
+
+namespace
+{
+const AVPixFmtDescriptor* getDescriptor( const PixelFormat format )
+{
+#if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(52,3,0)
+    return &av_pix_fmt_descriptors[format];
+#else
+    return av_pix_fmt_desc_get( format );
+#endif
+}
+
+int alignDown( const int value, const int shift )
+{
+    return ( value >> shift ) << shift;
+}
+
+int alignUp( const int value, const int shift )
+{
+    return alignDown( value + ( 1 << shift ) - 1, shift );
+}
+}
+
 FFMPEGVideoFrameConverter::FFMPEGVideoFrameConverter( const AVCodecContext&
                                                       videoCodecContext,
                                                       PixelFormat targetFormat )
     : swsContext_( 0 )
+    , frameSize_( videoCodecContext.width, videoCodecContext.height )
+    , sourceFormat_( videoCodecContext.pix_fmt )
+    , targetFormat_( targetFormat )
+    , chromaShiftX_( 0 )
+    , chromaShiftY_( 0 )
 {
+    // Regions of the frames can be converted by offsetting the planes, which
+    // is not possible for formats with less than one byte per pixel.
+    std::fill( planeSteps_, planeSteps_ + 4, 0 );
+    const AVPixFmtDescriptor* descriptor = getDescriptor( sourceFormat_ );
+    const int unsupportedFlags = AV_PIX_FMT_FLAG_BITSTREAM |
+                                 AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL;
+    if( descriptor && !( descriptor->flags & unsupportedFlags ))
+    {
+        av_image_fill_max_pixsteps( planeSteps_, NULL, descriptor );
+        chromaShiftX_ = descriptor->log2_chroma_w;
+        chromaShiftY_ = descriptor->log2_chroma_h;
+    }
+
+    // The chroma planes of a subsampled target are written from whole samples
+    regionShiftX_ = chromaShiftX_;
+    regionShiftY_ = chromaShiftY_;
+    const AVPixFmtDescriptor* target = getDescriptor( targetFormat_ );
+    if( target )
+    {
+        regionShiftX_ = std::max( regionShiftX_, int( target->log2_chroma_w ));
+        regionShiftY_ = std::max( regionShiftY_, int( target->log2_chroma_h ));
+    }
+
     // create sws scaler context
     swsContext_ = sws_getContext( videoCodecContext.width,
                                   videoCodecContext.height,
@@ -70,17 +135,70 @@ FFMPEGVideoFrameConverter::~FFMPEGVideoFrameConverter()
     sws_freeContext( swsContext_ );
 }
 
+QRect FFMPEGVideoFrameConverter::getConvertedRegion( const QRect& region ) const
+{
+    const QRect frame( QPoint(), frameSize_ );
+    const QRect clamped = region & frame;
+    if( clamped.isEmpty( ))
+        return QRect();
+
+    if( !planeSteps_[0] )
+        return frame;
+
+    // The chroma planes are offset by whole samples
+    const int left = alignDown( clamped.x(), regionShiftX_ );
+    const int top = alignDown( clamped.y(), regionShiftY_ );
+    const int right = std::min( alignUp( clamped.x() + clamped.width(),
+                                         regionShiftX_ ), frame.width( ));
+    const int bottom = std::min( alignUp( clamped.y() + clamped.height(),
+                                          regionShiftY_ ), frame.height( ));
+    return QRect( left, top, right - left, bottom - top );
+}
+
 bool FFMPEGVideoFrameConverter::convert( const FFMPEGFrame& srcFrame,
                                          FFMPEGPicture& dstFrame )
 {
     const AVFrame& avFrame = srcFrame.getAVFrame();
+    AVFrame& output = dstFrame.getAVFrame();
+
+    output.pkt_dts = avFrame.pkt_dts;
 
-    dstFrame.getAVFrame().pkt_dts = avFrame.pkt_dts;
+    const QRect& region = dstFrame.getRegion();
+    MovieStatistics::global().recordConversion(
+                region.width() * region.height(),
+                frameSize_.width() * frameSize_.height( ));
+    if( region.isEmpty( ))
+        return true;
+
+    // The context is only recreated when the size of the region changes
+    swsContext_ = sws_getCachedContext( swsContext_,
+                                        region.width(), region.height(),
+                                        sourceFormat_,
+                                        region.width(), region.height(),
+                                        targetFormat_, SWS_FAST_BILINEAR,
+                                        NULL, NULL, NULL );
+    if( !swsContext_ )
+    {
+        put_flog( LOG_ERROR, "Error allocating SwsContext" );
+        return false;
+    }
+
+    const uint8_t* source[4];
+    for( size_t plane = 0; plane < 4; ++plane )
+    {
+        source[plane] = avFrame.data[plane];
+        if( !source[plane] )
+            continue;
+
+        const bool isChroma = plane == 1 || plane == 2;
+        const int x = isChroma ? region.x() >> chromaShiftX_ : region.x();
+        const int y = isChroma ? region.y() >> chromaShiftY_ : region.y();
+        source[plane] += y * avFrame.linesize[plane] + x * planeSteps_[plane];
+    }
 
-    const int output_height = sws_scale( swsContext_, avFrame.data,
+    const int output_height = sws_scale( swsContext_, source,
                                          avFrame.linesize, 0,
-                                         avFrame.height,
-                                         dstFrame.getAVFrame().data,
-                                         dstFrame.getAVFrame().linesize );
-    return output_height == avFrame.height;
+                                         region.height(),
+                                         output.data, output.linesize );
+    return output_height == region.height();
 }
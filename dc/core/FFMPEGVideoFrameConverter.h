@@ -61,8 +61,13 @@ extern "C"
 
 #include "FFMPEGFrame.h"
 
+#include <QRect>
+
 /**
  * Converts FFMPEG's AVFrame format to a data buffer of user-defined format
+ *
+ * Only a region of the frames may be converted, for instance the part of a
+ * movie which is visible on the screens of a wall process.
  */
 class FFMPEGVideoFrameConverter
 {
@@ -77,16 +82,41 @@ public:
     /** Desturctor */
     ~FFMPEGVideoFrameConverter();
 
+    /**
+     * Get the region which is converted for a requested region.
+     *
+     * The region is extended to the chroma subsampling of the source and
+     * target formats and clamped to the frame. It is the full frame if the
+     * source format does not allow converting regions.
+     * @param region The requested region, in frame pixel coordinates
+     * @return the region to convert, empty if the requested one is empty
+     */
+    QRect getConvertedRegion( const QRect& region ) const;
+
     /**
      * Convert an AVFrame to the target data format
      * @param srcFrame The source frame
-     * @param dstFrame The destination picture
+     * @param dstFrame The destination picture, which contains the region of
+     *        the frame to convert (see getConvertedRegion())
      * @return true on success
      */
     bool convert( const FFMPEGFrame& srcFrame, FFMPEGPicture& dstFrame );
 
 private:
     SwsContext* swsContext_;           // Scaling context
+    const QSize frameSize_;
+    const PixelFormat sourceFormat_;
+    const PixelFormat targetFormat_;
+
+    // Pixel step of each plane of the source format in bytes, 0 if the format
+    // does not allow converting regions
+    int planeSteps_[4];
+    int chromaShiftX_;
+    int chromaShiftY_;
+
+    // Alignment of the regions, for the chroma subsampling of both formats
+    int regionShiftX_;
+    int regionShiftY_;
 };
 
 #endif // FFMPEGVIDEOFRAMECONVERTER_H
@@ -39,14 +39,35 @@
 
 #include "FFMPEGVideoStream.h"
 
+#include "DecoderThreadBudget.h"
+#include "FFMPEGPicturePool.h"
 #include "FFMPEGVideoFrameConverter.h"
+#include "MovieDecoderStatistics.h"
+#include "MovieStatistics.h"
+#include "Profiler.h"
 
 #include "log.h"
 
+#include <QFileInfo>
+
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
-FFMPEGVideoStream::FFMPEGVideoStream( AVFormatContext& avFormatContext )
+#ifndef AV_CODEC_CAP_FRAME_THREADS
+    #define AV_CODEC_CAP_FRAME_THREADS CODEC_CAP_FRAME_THREADS
+    #define AV_CODEC_CAP_SLICE_THREADS CODEC_CAP_SLICE_THREADS
+#endif
+
+namespace
+{
+// Bound the packets tracked for the latency, in case of decoding errors
+const size_t MAX_PENDING_PACKETS = 64;
+}
+
+FFMPEGVideoStream::FFMPEGVideoStream( AVFormatContext& avFormatContext,
+                                      const MoviePictureFormat format,
+                                      const size_t pooledPictures )
     : _avFormatContext( avFormatContext )
     , _videoCodecContext( 0 ) // shortcut to _videoStream->codec; don't free
     , _videoStream( 0 )  // shortcut to _avFormatContext->streams[i]; don't free
@@ -54,27 +75,44 @@ FFMPEGVideoStream::FFMPEGVideoStream( AVFormatContext& avFormatContext )
     , _numFrames( 0 )
     , _frameDuration( 0.0 )
     , _frameDurationInSeconds( 0.0 )
+    , _decoderThreads( 1 )
 {
     _findVideoStream();
     _openVideoStreamDecoder();
-    _generateSeekingParameters();
+    try
+    {
+        _generateSeekingParameters();
+    }
+    catch( const std::runtime_error& )
+    {
+        _closeVideoStreamDecoder();
+        throw;
+    }
 
+    const QString name = QFileInfo( _avFormatContext.filename ).fileName();
+    _statistics = MovieStatistics::global().addDecoder( name,
+                                                        _decoderThreads );
+
+    _pictureFormat = _getPixelFormat( format );
+    _picturePool = std::make_shared<FFMPEGPicturePool>(
+                       QSize( getWidth(), getHeight( )), _pictureFormat,
+                       pooledPictures );
     _frame.reset( new FFMPEGFrame );
     _frameConverter.reset( new FFMPEGVideoFrameConverter( *_videoCodecContext,
-                                                                PIX_FMT_RGBA ));
+                                                          _pictureFormat ));
 }
 
 FFMPEGVideoStream::~FFMPEGVideoStream()
 {
-    avcodec_close( _videoCodecContext );
+    _closeVideoStreamDecoder();
 }
 
-PicturePtr FFMPEGVideoStream::decode( AVPacket& packet )
+PicturePtr FFMPEGVideoStream::decode( AVPacket& packet, const QRect& region )
 {
     if( !_decodeToAvFrame( packet ))
         return PicturePtr();
 
-    return decodePictureForLastPacket();
+    return decodePictureForLastPacket( region );
 }
 
 int64_t FFMPEGVideoStream::decodeTimestamp( AVPacket& packet )
@@ -85,16 +123,27 @@ int64_t FFMPEGVideoStream::decodeTimestamp( AVPacket& packet )
     return _frame->getTimestamp();
 }
 
-PicturePtr FFMPEGVideoStream::decodePictureForLastPacket()
+PicturePtr FFMPEGVideoStream::decodePictureForLastPacket( const QRect& region )
 {
-    auto picture = std::make_shared<FFMPEGPicture>( getWidth(), getHeight(),
-                                                    PIX_FMT_RGBA );
-    if( _frameConverter->convert( *_frame, *picture ))
+    const QRect converted = _frameConverter->getConvertedRegion( region );
+    PicturePtr picture = _picturePool->getPicture( converted );
+    if( picture && _frameConverter->convert( *_frame, *picture ))
         return picture;
 
     return PicturePtr();
 }
 
+PicturePtr FFMPEGVideoStream::decodeDelayedFrame( const QRect& region )
+{
+    // An empty packet flushes the decoder
+    AVPacket packet;
+    av_init_packet( &packet );
+    packet.data = 0;
+    packet.size = 0;
+    packet.stream_index = _videoStream->index;
+    return decode( packet, region );
+}
+
 bool FFMPEGVideoStream::_isVideoPacket( const AVPacket& packet ) const
 {
     return packet.stream_index == _videoStream->index;
@@ -105,6 +154,14 @@ bool FFMPEGVideoStream::_decodeToAvFrame( AVPacket& packet )
     if( !_isVideoPacket( packet ))
         return false;
 
+    if( packet.size > 0 )
+    {
+        const PendingPacket pending = { packet.dts, Profiler::now() };
+        _pendingPackets.push_back( pending );
+        if( _pendingPackets.size() > MAX_PENDING_PACKETS )
+            _pendingPackets.pop_front();
+    }
+
     int frameDecodingComplete = 0;
     const int errCode = avcodec_decode_video2( _videoCodecContext,
                                                &_frame->getAVFrame(),
@@ -127,9 +184,47 @@ bool FFMPEGVideoStream::_decodeToAvFrame( AVPacket& packet )
         return false;
     }
 
+    _recordDecodedFrame();
     return true;
 }
 
+void FFMPEGVideoStream::_recordDecodedFrame()
+{
+    const int64_t now = Profiler::now();
+    if( _pendingPackets.empty( ))
+    {
+        _statistics->recordFrame( now, now );
+        return;
+    }
+
+    // The frame comes from the packet with the same timestamp, the packets
+    // given before it did not produce a frame of their own
+    const int64_t timestamp = _frame->getTimestamp();
+    auto it = std::find_if( _pendingPackets.begin(), _pendingPackets.end(),
+                            [timestamp]( const PendingPacket& packet )
+                            { return packet.timestamp == timestamp; } );
+    if( it == _pendingPackets.end( ))
+        it = _pendingPackets.begin();
+
+    _statistics->recordFrame( it->submitTime, now );
+    _pendingPackets.erase( _pendingPackets.begin(), it + 1 );
+}
+
+PixelFormat FFMPEGVideoStream::getPictureFormat() const
+{
+    return _pictureFormat;
+}
+
+size_t FFMPEGVideoStream::getAllocatedPictures() const
+{
+    return _picturePool->getAllocationCount();
+}
+
+unsigned int FFMPEGVideoStream::getDecoderThreads() const
+{
+    return _decoderThreads;
+}
+
 unsigned int FFMPEGVideoStream::getWidth() const
 {
     return _videoCodecContext->width;
@@ -220,6 +315,7 @@ bool FFMPEGVideoStream::seekToNearestFullframe( int64_t frameIndex )
     }
 
     avcodec_flush_buffers( _videoCodecContext );
+    _pendingPackets.clear();
     return true;
 }
 
@@ -247,11 +343,27 @@ void FFMPEGVideoStream::_openVideoStreamDecoder()
     if( !codec )
         throw std::runtime_error( "No decoder found for video stream" );
 
+    // Decode with several threads if the codec supports it, within the
+    // budget shared by the movies of the process
+    const int threadCapabilities = AV_CODEC_CAP_FRAME_THREADS |
+                                   AV_CODEC_CAP_SLICE_THREADS;
+    if( codec->capabilities & threadCapabilities )
+    {
+        const QSize frameSize( _videoCodecContext->width,
+                               _videoCodecContext->height );
+        _decoderThreads = DecoderThreadBudget::global().acquire( frameSize );
+        _videoCodecContext->thread_count = _decoderThreads;
+        _videoCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+
     // open codec
     const int ret = avcodec_open2( _videoCodecContext, codec, NULL );
 
     if( ret < 0 )
     {
+        DecoderThreadBudget::global().release( _decoderThreads );
+        _decoderThreads = 1;
+
         char errbuf[256];
         av_strerror( ret, errbuf, 256 );
 
@@ -262,6 +374,13 @@ void FFMPEGVideoStream::_openVideoStreamDecoder()
     }
 }
 
+void FFMPEGVideoStream::_closeVideoStreamDecoder()
+{
+    avcodec_close( _videoCodecContext );
+    DecoderThreadBudget::global().release( _decoderThreads );
+    _decoderThreads = 1;
+}
+
 void FFMPEGVideoStream::_generateSeekingParameters()
 {
     _numFrames = _videoStream->nb_frames;
@@ -291,3 +410,24 @@ void FFMPEGVideoStream::_generateSeekingParameters()
     put_flog( LOG_VERBOSE, "frameDurationInSeconds_ = %f",
               _frameDurationInSeconds );
 }
+
+PixelFormat
+FFMPEGVideoStream::_getPixelFormat( const MoviePictureFormat format ) const
+{
+    if( format == MOVIE_PICTURE_RGBA )
+        return PIX_FMT_RGBA;
+
+    // Planar 8-bit YUV frames are only copied, other formats are converted
+    switch( _videoCodecContext->pix_fmt )
+    {
+    case PIX_FMT_YUV420P:
+    case PIX_FMT_YUV422P:
+    case PIX_FMT_YUV444P:
+    case PIX_FMT_YUVJ420P:
+    case PIX_FMT_YUVJ422P:
+    case PIX_FMT_YUVJ444P:
+        return _videoCodecContext->pix_fmt;
+    default:
+        return PIX_FMT_YUV420P;
+    }
+}
@@ -63,16 +63,35 @@ extern "C"
 
 #include "types.h"
 
-/** A video stream from an FFMPEG file. */
+#include <deque>
+
+class FFMPEGPicturePool;
+class MovieDecoderStatistics;
+
+/**
+ * A video stream from an FFMPEG file.
+ *
+ * The decoder uses frame and slice threads if the codec supports them, as
+ * many as granted by the DecoderThreadBudget of the process for the frame
+ * size of the stream.
+ *
+ * The decoded pictures are recycled through a pool, which keeps the given
+ * number of unused pictures for reuse.
+ */
 class FFMPEGVideoStream
 {
 public:
     /**
      * Constructor.
      * @param avFormatContext The FFMPEG context.
+     * @param format The format of the decoded pictures
+     * @param pooledPictures The number of decoded pictures to recycle, which
+     *        should cover all the pictures in flight at any time
      * @throw std::runtime_error if an error occured during initialization
      */
-    FFMPEGVideoStream( AVFormatContext& avFormatContext );
+    FFMPEGVideoStream( AVFormatContext& avFormatContext,
+                       MoviePictureFormat format = MOVIE_PICTURE_RGBA,
+                       size_t pooledPictures = 0 );
 
     /** Destructor. */
     ~FFMPEGVideoStream();
@@ -81,10 +100,12 @@ public:
      * Decode a video packet.
      *
      * @param packet The av packet to decode
+     * @param region The region of the frame to convert to a picture
      * @return The decoded picture, or nullptr if the input is not a video
      *         packet or an error occured.
+     * @see FFMPEGVideoFrameConverter::getConvertedRegion()
      */
-    PicturePtr decode( AVPacket& packet );
+    PicturePtr decode( AVPacket& packet, const QRect& region );
 
     /**
      * Partially decode a video packet to determine its timestamp.
@@ -103,9 +124,30 @@ public:
 
     /**
      * Call after a successful decodeTimestamp to get the corresponding picture.
+     * @param region The region of the frame to convert to a picture
      * @return The decoded picture, or nullptr if an error occured.
      */
-    PicturePtr decodePictureForLastPacket();
+    PicturePtr decodePictureForLastPacket( const QRect& region );
+
+    /**
+     * Get a frame delayed by the decoder, once all the packets have been read.
+     *
+     * Decoders may return frames several packets after receiving them, for
+     * reordering or because of frame threading. The delayed frames have to be
+     * flushed when the end of the file is reached.
+     * @param region The region of the frame to convert to a picture
+     * @return The next delayed picture, or nullptr if there are no more.
+     */
+    PicturePtr decodeDelayedFrame( const QRect& region );
+
+    /** Get the pixel format of the decoded pictures. */
+    PixelFormat getPictureFormat() const;
+
+    /** Get the number of pictures allocated for decoding so far. */
+    size_t getAllocatedPictures() const;
+
+    /** Get the number of threads of the decoder. */
+    unsigned int getDecoderThreads() const;
 
     /** Get the width of the video stream. */
     unsigned int getWidth() const;
@@ -148,6 +190,19 @@ private:
 
     std::unique_ptr<FFMPEGFrame> _frame;
     std::unique_ptr<FFMPEGVideoFrameConverter> _frameConverter;
+    PixelFormat _pictureFormat;
+    std::shared_ptr<FFMPEGPicturePool> _picturePool;
+
+    unsigned int _decoderThreads;
+    std::shared_ptr<MovieDecoderStatistics> _statistics;
+
+    // The packets given to the decoder which have not come out as a frame yet
+    struct PendingPacket
+    {
+        int64_t timestamp;
+        int64_t submitTime;
+    };
+    std::deque<PendingPacket> _pendingPackets;
 
     // used for seeking
     int64_t _numFrames;
@@ -156,10 +211,13 @@ private:
 
     void _findVideoStream();
     void _openVideoStreamDecoder();
+    void _closeVideoStreamDecoder();
     void _generateSeekingParameters();
+    PixelFormat _getPixelFormat( MoviePictureFormat format ) const;
 
     bool _isVideoPacket( const AVPacket& packet ) const;
     bool _decodeToAvFrame( AVPacket& packet );
+    void _recordDecodedFrame();
 };
 
 #endif
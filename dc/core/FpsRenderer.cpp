@@ -39,6 +39,8 @@
 
 #include "FpsRenderer.h"
 
+#include <QStringList>
+
 #define TEXT_POS_X 10
 #define TEXT_POS_Y 32
 #define TEXT_SIZE_PX 32
@@ -62,4 +64,19 @@ void FpsRenderer::draw( QPainter* painter, const QRectF& rect )
 
     painter->drawText( QPoint( TEXT_POS_X, TEXT_POS_Y ) + offset,
                        fpsCounter_.toString( ));
+
+    if( statistics_.isEmpty( ))
+        return;
+
+    const QStringList lines = statistics_.split( '\n' );
+    for( int i = 0; i < lines.size(); ++i )
+    {
+        const QPoint pos( TEXT_POS_X, TEXT_POS_Y + ( i + 1 ) * TEXT_SIZE_PX );
+        painter->drawText( pos + offset, lines[i] );
+    }
+}
+
+void FpsRenderer::setStatistics( const QString& statistics )
+{
+    statistics_ = statistics;
 }
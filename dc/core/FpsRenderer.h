@@ -55,8 +55,12 @@ public:
     /** Render the object. */
     void draw( QPainter* painter, const QRectF& rect ) override;
 
+    /** Set additional statistics to display below the fps counter. */
+    void setStatistics( const QString& statistics );
+
 private:
     FpsCounter fpsCounter_;
+    QString statistics_;
 };
 
 #endif // FPSRENDERER_H
@@ -0,0 +1,144 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "FramePhaseTimer.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace
+{
+// Weight of the last frame in the moving average of the durations.
+const double AVERAGE_WEIGHT = 0.05;
+
+const char* PHASE_NAMES[FramePhaseTimer::PHASE_COUNT] =
+{
+    "sync", "content", "render", "barrier", "swap", "post"
+};
+}
+
+FramePhaseTimer::FramePhaseTimer( Profiler* profiler )
+    : _profiler( profiler )
+    , _frameStart( 0 )
+    , _phaseStart( 0 )
+    , _frameCount( 0 )
+{
+    std::fill( _durations, _durations + PHASE_COUNT, 0 );
+    std::fill( _lastDurations, _lastDurations + PHASE_COUNT, 0 );
+    std::fill( _averageDurations, _averageDurations + PHASE_COUNT, 0.0 );
+}
+
+void FramePhaseTimer::startFrame()
+{
+    std::fill( _durations, _durations + PHASE_COUNT, 0 );
+    _frameStart = Profiler::now();
+    _phaseStart = _frameStart;
+
+    if( _profiler )
+        _profiler->setFrame( _frameCount );
+}
+
+void FramePhaseTimer::endPhase( const Phase phase )
+{
+    assert( phase < PHASE_COUNT );
+
+    const int64_t now = Profiler::now();
+    _durations[phase] += now - _phaseStart;
+    if( _profiler )
+        _profiler->record( PROFILE_CATEGORY_PHASE, PHASE_NAMES[phase],
+                           _phaseStart, now - _phaseStart );
+    _phaseStart = now;
+}
+
+void FramePhaseTimer::endFrame()
+{
+    if( _profiler )
+        _profiler->record( PROFILE_CATEGORY_FRAME, "frame", _frameStart,
+                           Profiler::now() - _frameStart );
+
+    for( size_t i = 0; i < PHASE_COUNT; ++i )
+    {
+        _lastDurations[i] = _durations[i];
+        if( _frameCount == 0 )
+            _averageDurations[i] = _durations[i];
+        else
+            _averageDurations[i] += AVERAGE_WEIGHT *
+                                    ( _durations[i] - _averageDurations[i] );
+    }
+    ++_frameCount;
+}
+
+uint64_t FramePhaseTimer::getFrameCount() const
+{
+    return _frameCount;
+}
+
+int64_t FramePhaseTimer::getLastDuration( const Phase phase ) const
+{
+    return _lastDurations[phase];
+}
+
+double FramePhaseTimer::getAverageDuration( const Phase phase ) const
+{
+    return _averageDurations[phase];
+}
+
+int64_t FramePhaseTimer::getLastFrameDuration() const
+{
+    int64_t duration = 0;
+    for( size_t i = 0; i < PHASE_COUNT; ++i )
+        duration += _lastDurations[i];
+    return duration;
+}
+
+const char* FramePhaseTimer::getName( const Phase phase )
+{
+    return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "";
+}
+
+QString FramePhaseTimer::getStatistics() const
+{
+    QString statistics( "frame (us):" );
+    for( size_t i = 0; i < PHASE_COUNT; ++i )
+    {
+        statistics += QString( " %1 %2" ).arg( PHASE_NAMES[i] )
+                      .arg( _averageDurations[i], 0, 'f', 0 );
+    }
+    return statistics;
+}
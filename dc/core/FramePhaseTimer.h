@@ -0,0 +1,117 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef FRAMEPHASETIMER_H
+#define FRAMEPHASETIMER_H
+
+#include <QString>
+
+#include <stdint.h>
+
+class Profiler;
+
+/**
+ * Measure the duration of each phase of the wall render loop.
+ *
+ * A frame starts with startFrame(), each phase ends with endPhase() and the
+ * frame is concluded with endFrame(), which updates the statistics. The
+ * duration of a phase is the time elapsed since the end of the previous phase
+ * (or since the start of the frame).
+ *
+ * The frame and its phases can also be recorded as events in a Profiler.
+ */
+class FramePhaseTimer
+{
+public:
+    /** The phases of a frame, in execution order. */
+    enum Phase
+    {
+        PHASE_SYNC,    // clock and scene objects collective
+        PHASE_CONTENT, // window contents update and collective
+        PHASE_RENDER,  // rendering of the GL windows
+        PHASE_BARRIER, // wait for all processes before swapping
+        PHASE_SWAP,    // swap buffers
+        PHASE_POST,    // post-render updates
+        PHASE_COUNT
+    };
+
+    /**
+     * Constructor.
+     * @param profiler Optional profiler where the frames and phases are
+     *        recorded, which must outlive the timer
+     */
+    FramePhaseTimer( Profiler* profiler = 0 );
+
+    /** Start timing a new frame. */
+    void startFrame();
+
+    /** End a phase of the current frame. */
+    void endPhase( Phase phase );
+
+    /** End the current frame and update the statistics. */
+    void endFrame();
+
+    /** @return the number of frames timed so far. */
+    uint64_t getFrameCount() const;
+
+    /** @return the duration of a phase during the last frame in us. */
+    int64_t getLastDuration( Phase phase ) const;
+
+    /** @return the moving average of the duration of a phase in us. */
+    double getAverageDuration( Phase phase ) const;
+
+    /** @return the duration of the last frame in us. */
+    int64_t getLastFrameDuration() const;
+
+    /** @return the name of a phase. */
+    static const char* getName( Phase phase );
+
+    /** @return a summary of the average phase durations. */
+    QString getStatistics() const;
+
+private:
+    Profiler* _profiler;
+    int64_t _frameStart;
+    int64_t _phaseStart;
+    int64_t _durations[PHASE_COUNT];
+    int64_t _lastDurations[PHASE_COUNT];
+    double _averageDurations[PHASE_COUNT];
+    uint64_t _frameCount;
+};
+
+#endif // FRAMEPHASETIMER_H
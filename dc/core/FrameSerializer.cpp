@@ -0,0 +1,182 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "FrameSerializer.h"
+
+#include "CopyCounter.h"
+#include "SegmentChangeTracker.h"
+#include "SerializeBuffer.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+size_t _align( const size_t size )
+{
+    const size_t alignment = FrameSerializer::ALIGNMENT;
+    return ( size + alignment - 1 ) / alignment * alignment;
+}
+
+struct SegmentHeader
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    bool compressed;
+    bool unchanged;
+    uint64_t dataSize;
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & x;
+        ar & y;
+        ar & width;
+        ar & height;
+        ar & compressed;
+        ar & unchanged;
+        ar & dataSize;
+    }
+};
+
+struct FrameHeader
+{
+    std::string uri;
+    std::vector<SegmentHeader> segments;
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & uri;
+        ar & segments;
+    }
+};
+
+// A received frame sharing the ownership of the buffer holding its image data
+struct FrameStorage
+{
+    deflect::Frame frame;
+    SerializeBufferPtr buffer;
+};
+}
+
+void FrameSerializer::write( const deflect::Frame& frame,
+                             SerializeBuffer& buffer )
+{
+    FrameHeader header;
+    header.uri = frame.uri.toStdString();
+    header.segments.reserve( frame.segments.size( ));
+
+    size_t dataSize = 0;
+    for( const deflect::Segment& segment : frame.segments )
+    {
+        const deflect::SegmentParameters& params = segment.parameters;
+        SegmentHeader segmentHeader;
+        segmentHeader.x = params.x;
+        segmentHeader.y = params.y;
+        segmentHeader.width = params.width;
+        segmentHeader.height = params.height;
+        segmentHeader.compressed = params.compressed;
+        segmentHeader.unchanged = SegmentChangeTracker::isUnchanged( segment );
+        segmentHeader.dataSize = segment.imageData.size();
+        header.segments.push_back( segmentHeader );
+        dataSize += _align( segment.imageData.size( ));
+    }
+
+    buffer.write( header );
+    const size_t headerSize = _align( buffer.size( ));
+    buffer.setSize( headerSize + dataSize );
+
+    char* data = buffer.data() + headerSize;
+    for( const deflect::Segment& segment : frame.segments )
+    {
+        const size_t size = segment.imageData.size();
+        if( size == 0 )
+            continue;
+        std::memcpy( data, segment.imageData.constData(), size );
+        CopyCounter::global().record( size );
+        data += _align( size );
+    }
+}
+
+deflect::FramePtr FrameSerializer::read( SerializeBufferPtr buffer )
+{
+    FrameHeader header;
+    buffer->deserialize( header );
+
+    size_t dataSize = 0;
+    for( const SegmentHeader& segmentHeader : header.segments )
+        dataSize += _align( segmentHeader.dataSize );
+    if( dataSize > buffer->size( ))
+        throw std::runtime_error( "FrameSerializer: truncated frame" );
+
+    boost::shared_ptr<FrameStorage> storage =
+            boost::make_shared<FrameStorage>();
+    storage->buffer = buffer;
+
+    deflect::Frame& frame = storage->frame;
+    frame.uri = QString::fromStdString( header.uri );
+    frame.segments.resize( header.segments.size( ));
+
+    const char* data = buffer->data() + buffer->size() - dataSize;
+    for( size_t i = 0; i < header.segments.size(); ++i )
+    {
+        const SegmentHeader& segmentHeader = header.segments[i];
+        deflect::Segment& segment = frame.segments[i];
+        segment.parameters.x = segmentHeader.x;
+        segment.parameters.y = segmentHeader.y;
+        segment.parameters.width = segmentHeader.width;
+        segment.parameters.height = segmentHeader.height;
+        segment.parameters.compressed = segmentHeader.compressed;
+        const int size = segmentHeader.dataSize;
+        if( segmentHeader.unchanged )
+            SegmentChangeTracker::setUnchanged( segment );
+        else if( size > 0 )
+            segment.imageData = QByteArray::fromRawData( data, size );
+        data += _align( segmentHeader.dataSize );
+    }
+
+    // The frame shares the ownership of the storage, and thus of the buffer
+    return deflect::FramePtr( storage, &storage->frame );
+}
@@ -0,0 +1,88 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef FRAMESERIALIZER_H
+#define FRAMESERIALIZER_H
+
+#include "types.h"
+
+#include <deflect/Frame.h>
+
+/**
+ * Serialize pixel stream frames so that their image data can be used in place
+ * by the receiver.
+ *
+ * The message starts with a binary archive of the frame uri and the segment
+ * parameters, followed by the raw image data of the segments, each aligned to
+ * ALIGNMENT bytes. The segments of a frame read from a buffer reference its
+ * storage instead of copying it, and the frame keeps the buffer alive.
+ *
+ * The header flags the segments marked as unchanged by the
+ * SegmentChangeTracker, so that the receiver can tell them apart from the
+ * segments without image data which are not routed to it.
+ */
+class FrameSerializer
+{
+public:
+    /** The alignment of the image data of each segment in the message. */
+    static const size_t ALIGNMENT = 16;
+
+    /**
+     * Serialize a frame into a buffer, replacing its current content.
+     *
+     * The image data of the segments is copied once, directly into the
+     * buffer.
+     * @param frame The frame to serialize
+     * @param buffer The target buffer
+     */
+    static void write( const deflect::Frame& frame, SerializeBuffer& buffer );
+
+    /**
+     * Deserialize a frame without copying its image data.
+     *
+     * The image data of the segments points to the storage of the buffer,
+     * which must not be modified until the frame and all the copies of its
+     * segments have been released.
+     * @param buffer The buffer filled by write()
+     * @return the frame, which holds a reference to the buffer
+     * @throw std::runtime_error if the buffer does not contain a frame
+     */
+    static deflect::FramePtr read( SerializeBufferPtr buffer );
+};
+
+#endif // FRAMESERIALIZER_H
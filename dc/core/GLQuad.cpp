@@ -39,73 +39,37 @@
 
 #include "GLQuad.h"
 
-#include "types.h"
-
-#include <QtOpenGL/qgl.h>
-
 GLQuad::GLQuad()
-    : texCoords_( UNIT_RECTF )
-    , renderMode_( GL_QUADS )
-    , textureId_( 0 )
-    , alphaBlending_( false )
 {
 }
 
 void GLQuad::setTexCoords( const QRectF& texCoords )
 {
-    texCoords_ = texCoords;
+    quad_.texCoords = texCoords;
 }
 
 void GLQuad::setTexture( const GLuint textureId )
 {
-    textureId_ = textureId;
+    quad_.textureId = textureId;
 }
 
 void GLQuad::setRenderMode( const GLenum mode )
 {
     if( mode == GL_QUADS || mode == GL_LINE_LOOP )
-        renderMode_ = mode;
+        quad_.renderMode = mode;
 }
 
 void GLQuad::enableAlphaBlending( const bool value )
 {
-    alphaBlending_ = value;
+    quad_.alphaBlending = value;
 }
 
-void GLQuad::render()
+void GLQuad::setColor( const QColor& color )
 {
-    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT );
-
-    if( textureId_ )
-    {
-        glEnable( GL_TEXTURE_2D );
-        glBindTexture( GL_TEXTURE_2D, textureId_ );
-    }
-    else
-        glDisable( GL_TEXTURE_2D );
-
-    if( alphaBlending_ )
-    {
-        glEnable( GL_BLEND );
-        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-    }
-
-    glBegin( renderMode_ );
-
-    glTexCoord2f( texCoords_.x(), texCoords_.y( ));
-    glVertex2f( 0.f, 0.f );
-
-    glTexCoord2f( texCoords_.x() + texCoords_.width(), texCoords_.y( ));
-    glVertex2f( 1.f, 0.f );
-
-    glTexCoord2f( texCoords_.x() + texCoords_.width(),
-                  texCoords_.y() + texCoords_.height( ));
-    glVertex2f( 1.f, 1.f );
-
-    glTexCoord2f( texCoords_.x(), texCoords_.y() + texCoords_.height( ));
-    glVertex2f( 0.f, 1.f );
-
-    glEnd();
+    quad_.color = color;
+}
 
-    glPopAttrib();
+void GLQuad::render()
+{
+    GLQuadRenderer::instance().draw( quad_ );
 }
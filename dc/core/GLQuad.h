@@ -41,12 +41,16 @@
 #define GLQUAD_H
 
 #include "Renderable.h"
+#include "GLQuadRenderer.h"
 
 #include <QtCore/QRectF>
 #include <QtOpenGL/qgl.h>
 
 /**
  * A simple OpenGL textured quad.
+ *
+ * The quad is drawn by the GLQuadRenderer of the render thread, which batches
+ * the quads rendered between its begin() and end() calls.
  */
 class GLQuad : public Renderable
 {
@@ -69,12 +73,11 @@ public:
     /** Enable or disable alpha blending. (default: OFF)*/
     void enableAlphaBlending( bool value );
 
+    /** Set the color, which modulates the texture. (default: white) */
+    void setColor( const QColor& color );
+
 private:
-    QRectF texCoords_;
-    // Material properties (may go to a separate class)
-    GLenum renderMode_;
-    GLuint textureId_;
-    bool alphaBlending_;
+    GLQuadRenderer::Quad quad_;
 };
 
 #endif // GLQUAD_H
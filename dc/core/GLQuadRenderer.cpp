@@ -0,0 +1,270 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "GLQuadRenderer.h"
+
+#include "log.h"
+#include "types.h"
+
+#include <algorithm>
+
+namespace
+{
+// x, y, s, t for each vertex of the unit quad
+const size_t FLOATS_PER_VERTEX = 4;
+const GLsizei VERTEX_COUNT = 4;
+const GLfloat UNIT_QUAD[VERTEX_COUNT * FLOATS_PER_VERTEX] =
+{
+    0.f, 0.f, 0.f, 0.f,
+    1.f, 0.f, 1.f, 0.f,
+    1.f, 1.f, 1.f, 1.f,
+    0.f, 1.f, 0.f, 1.f
+};
+
+bool isTextured( const GLQuadRenderer::Quad& quad )
+{
+    return quad.textureId != 0;
+}
+
+/** Opaque quads first, then blended ones and lines, grouped by texture. */
+bool drawOrder( const GLQuadRenderer::Quad& a, const GLQuadRenderer::Quad& b )
+{
+    const bool aIsLine = a.renderMode == GL_LINE_LOOP;
+    const bool bIsLine = b.renderMode == GL_LINE_LOOP;
+    if( aIsLine != bIsLine )
+        return bIsLine;
+    if( a.alphaBlending != b.alphaBlending )
+        return b.alphaBlending;
+    return a.textureId < b.textureId;
+}
+}
+
+GLQuadRenderer::Quad::Quad()
+    : textureId( 0 )
+    , texCoords( UNIT_RECTF )
+    , renderMode( GL_QUADS )
+    , alphaBlending( false )
+    , color( Qt::white )
+{
+}
+
+GLQuadRenderer::GLQuadRenderer()
+    : _vertexBuffer( QGLBuffer::VertexBuffer )
+    , _support( SUPPORT_UNKNOWN )
+    , _batchDepth( 0 )
+    , _drawCount( 0 )
+    , _stateChangeCount( 0 )
+{
+}
+
+GLQuadRenderer::~GLQuadRenderer()
+{
+    // The QGLBuffer releases its storage if the context still exists
+}
+
+void GLQuadRenderer::begin()
+{
+    ++_batchDepth;
+}
+
+void GLQuadRenderer::draw( const Quad& quad )
+{
+    Draw draw;
+    draw.quad = quad;
+    glGetFloatv( GL_MODELVIEW_MATRIX, draw.modelView );
+    _queue.push_back( draw );
+
+    if( _batchDepth == 0 )
+        _flush();
+}
+
+void GLQuadRenderer::end()
+{
+    if( _batchDepth == 0 )
+        return;
+
+    if( --_batchDepth == 0 )
+        _flush();
+}
+
+uint64_t GLQuadRenderer::getDrawCount() const
+{
+    return _drawCount;
+}
+
+uint64_t GLQuadRenderer::getStateChangeCount() const
+{
+    return _stateChangeCount;
+}
+
+GLQuadRenderer& GLQuadRenderer::instance()
+{
+    static GLQuadRenderer renderer;
+    return renderer;
+}
+
+bool GLQuadRenderer::_createBuffer()
+{
+    if( !_vertexBuffer.create( ))
+    {
+        put_flog( LOG_WARN, "Vertex buffer objects are not supported, "
+                            "quads are drawn from client memory" );
+        _support = SUPPORT_NO;
+        return false;
+    }
+
+    _vertexBuffer.setUsagePattern( QGLBuffer::StaticDraw );
+    _vertexBuffer.bind();
+    _vertexBuffer.allocate( UNIT_QUAD, sizeof( UNIT_QUAD ));
+    _vertexBuffer.release();
+    _support = SUPPORT_YES;
+    return true;
+}
+
+void GLQuadRenderer::_flush()
+{
+    if( _queue.empty( ))
+        return;
+
+    if( _support == SUPPORT_UNKNOWN )
+        _createBuffer();
+
+    // Keep the drawing order of the quads which share the same state
+    std::stable_sort( _queue.begin(), _queue.end(),
+                      []( const Draw& a, const Draw& b )
+                      { return drawOrder( a.quad, b.quad ); } );
+
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT |
+                  GL_CURRENT_BIT | GL_TRANSFORM_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+    // The vertices are read from the bound buffer, or from client memory if
+    // the buffer does not belong to the current context
+    const bool bound = _support == SUPPORT_YES && _vertexBuffer.bind();
+    const GLfloat* vertices = bound ? 0 : UNIT_QUAD;
+
+    const GLsizei stride = FLOATS_PER_VERTEX * sizeof( GLfloat );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, stride, vertices );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glTexCoordPointer( 2, GL_FLOAT, stride, vertices + 2 );
+
+    glMatrixMode( GL_TEXTURE );
+    glPushMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+    // Only change the state which differs from the previous quad. Blending is
+    // left as inherited until a quad needs it, like texturing is.
+    GLuint textureId = 0;
+    bool texturing = false;
+    bool textureStateKnown = false;
+    bool blending = false;
+    QColor color;
+    QRectF texCoords;
+    bool texCoordsKnown = false;
+
+    for( std::vector<Draw>::const_iterator it = _queue.begin();
+         it != _queue.end(); ++it )
+    {
+        const Quad& quad = it->quad;
+
+        if( !textureStateKnown || isTextured( quad ) != texturing )
+        {
+            if( isTextured( quad ))
+                glEnable( GL_TEXTURE_2D );
+            else
+                glDisable( GL_TEXTURE_2D );
+            texturing = isTextured( quad );
+            textureStateKnown = true;
+            textureId = 0;
+        }
+        if( texturing && quad.textureId != textureId )
+        {
+            glBindTexture( GL_TEXTURE_2D, quad.textureId );
+            textureId = quad.textureId;
+            ++_stateChangeCount;
+        }
+
+        if( quad.alphaBlending != blending )
+        {
+            if( quad.alphaBlending )
+                glEnable( GL_BLEND );
+            else
+                glDisable( GL_BLEND );
+            blending = quad.alphaBlending;
+            ++_stateChangeCount;
+        }
+
+        if( quad.color != color || !color.isValid( ))
+        {
+            glColor4f( quad.color.redF(), quad.color.greenF(),
+                       quad.color.blueF(), quad.color.alphaF( ));
+            color = quad.color;
+        }
+
+        if( texturing && ( !texCoordsKnown || quad.texCoords != texCoords ))
+        {
+            glMatrixMode( GL_TEXTURE );
+            glLoadIdentity();
+            glTranslatef( quad.texCoords.x(), quad.texCoords.y(), 0.f );
+            glScalef( quad.texCoords.width(), quad.texCoords.height(), 1.f );
+            glMatrixMode( GL_MODELVIEW );
+            texCoords = quad.texCoords;
+            texCoordsKnown = true;
+        }
+
+        glLoadMatrixf( it->modelView );
+        glDrawArrays( quad.renderMode, 0, VERTEX_COUNT );
+        ++_drawCount;
+    }
+    _queue.clear();
+
+    glMatrixMode( GL_TEXTURE );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    glPopMatrix();
+
+    if( bound )
+        _vertexBuffer.release();
+
+    glPopClientAttrib();
+    glPopAttrib();
+}
@@ -0,0 +1,147 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef GLQUADRENDERER_H
+#define GLQUADRENDERER_H
+
+#include <QtOpenGL/QGLBuffer>
+#include <QtOpenGL/qgl.h>
+#include <QColor>
+#include <QRectF>
+
+#include <boost/noncopyable.hpp>
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Draw unit quads from a vertex buffer shared by all of them.
+ *
+ * The buffer holds a single unit quad, uploaded once. The texture coordinates
+ * of each quad are applied with the texture matrix, and its position with the
+ * modelview matrix captured when it is drawn.
+ *
+ * The quads drawn between begin() and end() are queued, then sorted by render
+ * mode, blending and texture, so that each texture is bound and the blending
+ * enabled only once per batch. The quads of a batch must not overlap, except
+ * for blended quads drawn on top of opaque ones and lines on top of both.
+ * Outside of a batch, quads are drawn immediately.
+ *
+ * All methods of this class must be called from the OpenGL thread, with a
+ * current context.
+ */
+class GLQuadRenderer : public boost::noncopyable
+{
+public:
+    /** The parameters of a quad to draw. */
+    struct Quad
+    {
+        Quad();
+
+        /** The texture to use for rendering (0 = no texturing). */
+        GLuint textureId;
+
+        /** The texture coordinates. */
+        QRectF texCoords;
+
+        /** The render mode [GL_QUADS|GL_LINE_LOOP]. */
+        GLenum renderMode;
+
+        /** Enable alpha blending. */
+        bool alphaBlending;
+
+        /** The color, which modulates the texture. */
+        QColor color;
+    };
+
+    /** Constructor. */
+    GLQuadRenderer();
+
+    /** Destructor. */
+    ~GLQuadRenderer();
+
+    /** Start queuing the quads drawn, batches can be nested. */
+    void begin();
+
+    /** Draw a quad with the current modelview matrix. */
+    void draw( const Quad& quad );
+
+    /** Draw the quads queued since begin(), at the end of the outer batch. */
+    void end();
+
+    /** @return the number of quads drawn since the creation. */
+    uint64_t getDrawCount() const;
+
+    /**
+     * @return the number of texture binds and blending changes since the
+     *         creation.
+     */
+    uint64_t getStateChangeCount() const;
+
+    /** @return the renderer of the render thread. */
+    static GLQuadRenderer& instance();
+
+private:
+    struct Draw
+    {
+        Quad quad;
+        GLfloat modelView[16];
+    };
+
+    enum Support
+    {
+        SUPPORT_UNKNOWN,
+        SUPPORT_YES,
+        SUPPORT_NO
+    };
+
+    QGLBuffer _vertexBuffer;
+    Support _support;
+
+    size_t _batchDepth;
+    std::vector<Draw> _queue;
+
+    uint64_t _drawCount;
+    uint64_t _stateChangeCount;
+
+    bool _createBuffer();
+    void _flush();
+};
+
+#endif // GLQUADRENDERER_H
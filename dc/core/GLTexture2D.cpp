@@ -39,6 +39,8 @@
 
 #include "GLTexture2D.h"
 
+#include "GLTextureUploader.h"
+
 #include <QImage>
 
 GLTexture2D::GLTexture2D()
@@ -56,6 +58,21 @@ bool GLTexture2D::init(const QImage image, const GLenum format, bool mipmaps)
     if(textureId_)
         return false;
 
+    return create(image.size(), GL_RGBA, format, image.bits(), mipmaps);
+}
+
+bool GLTexture2D::init(const QSize& size, const GLint internalFormat,
+                       const GLenum format, const void* data)
+{
+    if(textureId_)
+        return false;
+
+    return create(size, internalFormat, format, data, false);
+}
+
+bool GLTexture2D::create(const QSize& size, const GLint internalFormat,
+                         const GLenum format, const void* data, bool mipmaps)
+{
     glGenTextures(1, &textureId_);
     glBindTexture(GL_TEXTURE_2D, textureId_);
 
@@ -73,10 +90,11 @@ bool GLTexture2D::init(const QImage image, const GLenum format, bool mipmaps)
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width(), image.height(),
-                 0, format, GL_UNSIGNED_BYTE, image.bits());
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size.width(), size.height(),
+                 0, format, GL_UNSIGNED_BYTE, data);
 
-    size_ = image.size();
+    size_ = size;
+    allocatedSize_ = size_;
 
     return true;
 }
@@ -88,6 +106,7 @@ void GLTexture2D::free()
         glDeleteTextures(1, &textureId_);
         textureId_ = 0;
         size_ = QSize();
+        allocatedSize_ = QSize();
     }
 }
 
@@ -98,24 +117,29 @@ GLuint GLTexture2D::getTextureId() const
 
 void GLTexture2D::update(const QImage image, const GLenum format)
 {
-    if (size_ != image.size())
+    // The image may be in a pixel buffer, which only the uploader can read
+    if (!textureId_ || image.width() > allocatedSize_.width() ||
+        image.height() > allocatedSize_.height())
     {
         free();
-        init(image, format);
-    }
-    else
-    {
-        glBindTexture(GL_TEXTURE_2D, textureId_);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width(), image.height(),
-                        format, GL_UNSIGNED_BYTE, image.bits());
+        init(image.size(), GL_RGBA, format);
     }
+    size_ = image.size();
+    update(image.bits(), format);
 }
 
 void GLTexture2D::update(const void* data, const GLenum format)
 {
     glBindTexture(GL_TEXTURE_2D, textureId_);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size_.width(), size_.height(),
-                    format, GL_UNSIGNED_BYTE, data);
+    GLTextureUploader::instance().upload(data, size_, format);
+}
+
+void GLTexture2D::update(const void* data, const QRect& region,
+                         const GLenum format)
+{
+    glBindTexture(GL_TEXTURE_2D, textureId_);
+    GLTextureUploader::instance().upload(data, region.size(), format,
+                                         region.topLeft());
 }
 
 const QSize& GLTexture2D::getSize() const
@@ -123,6 +147,20 @@ const QSize& GLTexture2D::getSize() const
     return size_;
 }
 
+const QSize& GLTexture2D::getAllocatedSize() const
+{
+    return allocatedSize_;
+}
+
+QRectF GLTexture2D::getTexCoords() const
+{
+    if (allocatedSize_.isEmpty())
+        return QRectF(0.0, 0.0, 1.0, 1.0);
+
+    return QRectF(0.0, 0.0, (qreal)size_.width() / allocatedSize_.width(),
+                  (qreal)size_.height() / allocatedSize_.height());
+}
+
 void GLTexture2D::bind()
 {
     glBindTexture(GL_TEXTURE_2D, textureId_);
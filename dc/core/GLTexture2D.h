@@ -41,6 +41,7 @@
 #define GLTEXTURE2D_H
 
 #include <QtOpenGL/qgl.h>
+#include <QRectF>
 #include <boost/noncopyable.hpp>
 
 /**
@@ -59,7 +60,25 @@ public:
     /** Init the texture using the given image. */
     bool init(const QImage image, const GLenum format = GL_RGBA, bool mipmaps = false);
 
-    /** Update the texture using the given image. */
+    /**
+     * Init the texture storage.
+     * @param size The dimensions of the texture
+     * @param internalFormat The format of the storage, e.g. GL_LUMINANCE
+     * @param format The format of the data
+     * @param data The initial content, or 0 to leave the storage undefined
+     */
+    bool init(const QSize& size, const GLint internalFormat,
+              const GLenum format, const void* data = 0);
+
+    /**
+     * Update the texture using the given image.
+     *
+     * The texture is only reallocated if the image is larger than the storage.
+     * A smaller image is uploaded at the origin of the texture, see
+     * getTexCoords().
+     * The data is transferred through the GLTextureUploader, it may be the
+     * memory of one of its pixel buffers.
+     */
     void update(const QImage image, const GLenum format = GL_RGBA);
 
     /**
@@ -69,9 +88,24 @@ public:
      */
     void update(const void* data, const GLenum format = GL_RGBA);
 
-    /** Get the texture size. */
+    /**
+     * Update a region of the texture
+     * @param data A buffer of region dimensions with "format" bytes per pixels
+     * @param region The region of the image to update, within getSize()
+     * @param format The image format of the data buffer
+     */
+    void update(const void* data, const QRect& region,
+                const GLenum format = GL_RGBA);
+
+    /** Get the size of the image in the texture. */
     const QSize& getSize() const;
 
+    /** Get the size of the texture storage, which is at least getSize(). */
+    const QSize& getAllocatedSize() const;
+
+    /** Get the texture coordinates of the image in the texture. */
+    QRectF getTexCoords() const;
+
     /** Bind the texture. */
     void bind();
 
@@ -87,6 +121,10 @@ public:
 private:
     GLuint textureId_;
     QSize size_;
+    QSize allocatedSize_;
+
+    bool create(const QSize& size, const GLint internalFormat,
+                const GLenum format, const void* data, bool mipmaps);
 };
 
 #endif // GLTEXTURE2D_H
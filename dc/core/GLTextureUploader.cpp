@@ -0,0 +1,305 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "GLTextureUploader.h"
+
+#include "log.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace
+{
+const int64_t STATISTICS_WINDOW_US = 1000000;
+}
+
+GLTextureUploader::GLTextureUploader()
+    : _support( SUPPORT_UNKNOWN )
+    , _uploadedBytes( 0 )
+    , _windowStart( Profiler::now( ))
+    , _windowBytes( 0 )
+    , _windowStall( 0 )
+    , _throughput( 0.0 )
+    , _stallTime( 0.0 )
+{
+}
+
+GLTextureUploader::~GLTextureUploader()
+{
+    // The QGLBuffers release their storage if the context still exists, which
+    // also unmaps them
+}
+
+void* GLTextureUploader::map( const size_t bytes )
+{
+    if( !isSupported( ))
+        return 0;
+
+    PixelBuffer pixelBuffer;
+    if( !_takeFreeBuffer( bytes, pixelBuffer ))
+        return 0;
+
+    // The buffer remains mapped while it is not bound
+    void* data = pixelBuffer.buffer.map( QGLBuffer::WriteOnly );
+    pixelBuffer.buffer.release();
+    if( !data )
+    {
+        put_flog( LOG_DEBUG, "Could not map a pixel buffer of %d bytes",
+                  (int)bytes );
+        _freeBuffers.push_back( pixelBuffer );
+        return 0;
+    }
+
+    _mappedBuffers[data] = pixelBuffer;
+    return data;
+}
+
+void GLTextureUploader::release( void* data )
+{
+    auto it = _mappedBuffers.find( data );
+    if( it == _mappedBuffers.end( ))
+        return;
+
+    PixelBuffer pixelBuffer = it->second;
+    _mappedBuffers.erase( it );
+
+    // A buffer which can not be bound is deleted, which also unmaps it
+    if( !pixelBuffer.buffer.bind( ))
+        return;
+
+    pixelBuffer.buffer.unmap();
+    pixelBuffer.buffer.release();
+    _freeBuffers.push_back( pixelBuffer );
+}
+
+void GLTextureUploader::upload( const void* data, const QSize& size,
+                                const GLenum format, const QPoint& offset )
+{
+    ProfileScope scope( PROFILE_CATEGORY_GL, "texture upload" );
+    const int64_t start = Profiler::now();
+    const int bytes = size.width() * size.height() * getBytesPerPixel( format );
+
+    // Rows of formats with less than 4 bytes per pixel are not 4-byte aligned
+    glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    auto it = _mappedBuffers.find( data );
+    if( it == _mappedBuffers.end( ))
+        glTexSubImage2D( GL_TEXTURE_2D, 0, offset.x(), offset.y(),
+                         size.width(), size.height(), format,
+                         GL_UNSIGNED_BYTE, data );
+    else
+    {
+        PixelBuffer pixelBuffer = it->second;
+        _mappedBuffers.erase( it );
+
+        // The memory of a buffer which can not be bound is still mapped, it
+        // is read directly before the buffer is deleted.
+        if( !_uploadFromBuffer( pixelBuffer, size, format, offset ))
+            glTexSubImage2D( GL_TEXTURE_2D, 0, offset.x(), offset.y(),
+                             size.width(), size.height(), format,
+                             GL_UNSIGNED_BYTE, data );
+    }
+
+    glPopClientAttrib();
+
+    _updateStatistics( bytes, start, Profiler::now( ));
+}
+
+int GLTextureUploader::getBytesPerPixel( const GLenum format )
+{
+    switch( format )
+    {
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+    case GL_RED:
+        return 1;
+    case GL_LUMINANCE_ALPHA:
+        return 2;
+    case GL_RGB:
+    case GL_BGR:
+        return 3;
+    default:
+        return 4;
+    }
+}
+
+bool GLTextureUploader::isSupported()
+{
+    if( _support == SUPPORT_UNKNOWN )
+    {
+        PixelBuffer pixelBuffer;
+        if( pixelBuffer.buffer.create( ))
+        {
+            _support = SUPPORT_YES;
+            _freeBuffers.push_back( pixelBuffer );
+        }
+        else
+        {
+            put_flog( LOG_WARN, "Pixel buffer objects are not supported, "
+                                "textures are uploaded from client memory" );
+            _support = SUPPORT_NO;
+        }
+    }
+    return _support == SUPPORT_YES;
+}
+
+size_t GLTextureUploader::getMappedCount() const
+{
+    return _mappedBuffers.size();
+}
+
+uint64_t GLTextureUploader::getUploadedBytes() const
+{
+    return _uploadedBytes;
+}
+
+double GLTextureUploader::getThroughput() const
+{
+    return _isOutdated() ? 0.0 : _throughput;
+}
+
+double GLTextureUploader::getStallTime() const
+{
+    return _isOutdated() ? 0.0 : _stallTime;
+}
+
+QString GLTextureUploader::getStatistics() const
+{
+    return QString( "upload: %1 MB/s, render thread stall %2 ms/s" )
+            .arg( getThroughput(), 0, 'f', 1 )
+            .arg( getStallTime(), 0, 'f', 1 );
+}
+
+GLTextureUploader& GLTextureUploader::instance()
+{
+    static GLTextureUploader uploader;
+    return uploader;
+}
+
+bool GLTextureUploader::_takeFreeBuffer( const size_t bytes,
+                                         PixelBuffer& pixelBuffer )
+{
+    // Reuse a buffer which is large enough, otherwise grow one. The buffers
+    // are not orphaned, their last transfer was started at least one frame ago.
+    auto it = std::find_if( _freeBuffers.begin(), _freeBuffers.end(),
+                            [bytes]( const PixelBuffer& candidate )
+                            { return candidate.size >= bytes; } );
+    if( it == _freeBuffers.end() && !_freeBuffers.empty( ))
+        --it;
+
+    if( it != _freeBuffers.end( ))
+    {
+        pixelBuffer = *it;
+        _freeBuffers.erase( it );
+    }
+    else if( !pixelBuffer.buffer.create( ))
+    {
+        put_flog( LOG_WARN, "Could not create a pixel buffer" );
+        return false;
+    }
+
+    // A buffer which can not be bound is not returned to the free buffers, a
+    // new one is created on demand instead
+    if( !pixelBuffer.buffer.bind( ))
+    {
+        put_flog( LOG_WARN, "Could not bind a pixel buffer of %d bytes, "
+                            "destroying it", (int)pixelBuffer.size );
+        pixelBuffer.buffer.destroy();
+        return false;
+    }
+
+    if( pixelBuffer.size < bytes )
+    {
+        pixelBuffer.buffer.setUsagePattern( QGLBuffer::StreamDraw );
+        pixelBuffer.buffer.allocate( bytes );
+        pixelBuffer.size = bytes;
+    }
+    return true;
+}
+
+bool GLTextureUploader::_uploadFromBuffer( PixelBuffer& pixelBuffer,
+                                           const QSize& size,
+                                           const GLenum format,
+                                           const QPoint& offset )
+{
+    if( !pixelBuffer.buffer.bind( ))
+    {
+        put_flog( LOG_WARN, "Could not bind a pixel buffer, uploading from "
+                            "client memory" );
+        return false;
+    }
+
+    if( pixelBuffer.buffer.unmap( ))
+        glTexSubImage2D( GL_TEXTURE_2D, 0, offset.x(), offset.y(),
+                         size.width(), size.height(), format,
+                         GL_UNSIGNED_BYTE, 0 );
+    else
+        put_flog( LOG_WARN, "The content of a pixel buffer was lost, the "
+                            "texture is not updated" );
+
+    pixelBuffer.buffer.release();
+    _freeBuffers.push_back( pixelBuffer );
+    return true;
+}
+
+void GLTextureUploader::_updateStatistics( const uint64_t bytes,
+                                           const int64_t start,
+                                           const int64_t end )
+{
+    _uploadedBytes += bytes;
+    _windowBytes += bytes;
+    _windowStall += end - start;
+
+    const int64_t elapsed = end - _windowStart;
+    if( elapsed < STATISTICS_WINDOW_US )
+        return;
+
+    // bytes/us == MB/s and us/us * 1000 == ms/s
+    _throughput = _windowBytes / (double)elapsed;
+    _stallTime = _windowStall / (double)elapsed * 1000.0;
+    _windowStart = end;
+    _windowBytes = 0;
+    _windowStall = 0;
+}
+
+bool GLTextureUploader::_isOutdated() const
+{
+    // Nothing was uploaded since the last measure
+    return Profiler::now() - _windowStart > 2 * STATISTICS_WINDOW_US;
+}
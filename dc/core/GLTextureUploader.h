@@ -0,0 +1,173 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef GLTEXTUREUPLOADER_H
+#define GLTEXTUREUPLOADER_H
+
+#include <QtOpenGL/QGLBuffer>
+#include <QPoint>
+#include <QSize>
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Upload texture data, through pixel buffer objects filled by other threads.
+ *
+ * A pixel buffer is mapped with map() and its memory is handed to a decoding
+ * thread as its output. Once decoded, upload() unmaps the buffer and starts
+ * the transfer to the texture from it, so that the render thread neither
+ * copies the data nor waits for the GPU. The buffers are recycled.
+ *
+ * Other data is uploaded directly from client memory.
+ *
+ * All methods of this class must be called from the OpenGL thread, with a
+ * current context. Only the memory returned by map() may be accessed from
+ * other threads, until it is passed to upload() or release().
+ */
+class GLTextureUploader : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    GLTextureUploader();
+
+    /** Destructor. */
+    ~GLTextureUploader();
+
+    /**
+     * Map a pixel buffer to be filled with texture data.
+     * @param bytes The size of the buffer
+     * @return the mapped memory, or 0 if pixel buffers are not available or
+     *         the buffer could not be mapped
+     */
+    void* map( size_t bytes );
+
+    /**
+     * Unmap and recycle a pixel buffer without uploading it.
+     * @param data The memory returned by map()
+     */
+    void release( void* data );
+
+    /**
+     * Upload data to the GL_TEXTURE_2D which is currently bound.
+     *
+     * If the data is the memory of a pixel buffer returned by map(), the
+     * buffer is unmapped, the transfer is started from it and the buffer is
+     * recycled. Otherwise the data is uploaded directly from client memory.
+     * @param data The image data, tightly packed
+     * @param size The dimensions of the image
+     * @param format The format of the data, see getBytesPerPixel()
+     * @param offset The position of the image in the texture
+     */
+    void upload( const void* data, const QSize& size, GLenum format,
+                 const QPoint& offset = QPoint( ));
+
+    /**
+     * Get the size of a pixel of unsigned bytes in a given format.
+     * @param format The format of the data, e.g. GL_RGBA or GL_LUMINANCE
+     * @return the number of bytes per pixel, 4 for unknown formats
+     */
+    static int getBytesPerPixel( GLenum format );
+
+    /**
+     * Check if pixel buffers are available.
+     * @return true if map() can provide pixel buffers
+     */
+    bool isSupported();
+
+    /** @return the number of pixel buffers currently mapped. */
+    size_t getMappedCount() const;
+
+    /** @return the number of bytes uploaded since the creation. */
+    uint64_t getUploadedBytes() const;
+
+    /** @return the amount of data uploaded in the last second in MB/s. */
+    double getThroughput() const;
+
+    /**
+     * @return the time spent by the render thread in upload() during the last
+     *         second, in ms/s.
+     */
+    double getStallTime() const;
+
+    /** @return a summary of the upload statistics. */
+    QString getStatistics() const;
+
+    /** @return the uploader of the render thread. */
+    static GLTextureUploader& instance();
+
+private:
+    enum Support
+    {
+        SUPPORT_UNKNOWN,
+        SUPPORT_YES,
+        SUPPORT_NO
+    };
+
+    struct PixelBuffer
+    {
+        PixelBuffer() : buffer( QGLBuffer::PixelUnpackBuffer ), size( 0 ) {}
+
+        QGLBuffer buffer;
+        size_t size;
+    };
+
+    Support _support;
+    std::vector<PixelBuffer> _freeBuffers;
+    std::map<const void*, PixelBuffer> _mappedBuffers;
+
+    uint64_t _uploadedBytes;
+    int64_t _windowStart;
+    uint64_t _windowBytes;
+    int64_t _windowStall;
+    double _throughput;
+    double _stallTime;
+
+    bool _takeFreeBuffer( size_t bytes, PixelBuffer& pixelBuffer );
+    bool _uploadFromBuffer( PixelBuffer& pixelBuffer, const QSize& size,
+                            GLenum format, const QPoint& offset );
+    void _updateStatistics( uint64_t bytes, int64_t start, int64_t end );
+    bool _isOutdated() const;
+};
+
+#endif // GLTEXTUREUPLOADER_H
@@ -0,0 +1,235 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "GLYUVQuad.h"
+
+#include "log.h"
+#include "types.h"
+
+#include <QtOpenGL/QGLFunctions>
+#include <QtOpenGL/QGLShaderProgram>
+
+#include <vector>
+
+namespace
+{
+const GLsizei VERTEX_COUNT = 4;
+const GLfloat UNIT_QUAD[VERTEX_COUNT * 2] =
+{
+    0.f, 0.f,
+    1.f, 0.f,
+    1.f, 1.f,
+    0.f, 1.f
+};
+
+const char* VERTEX_SHADER =
+    "varying vec2 texCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    texCoord = gl_MultiTexCoord0.st;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+    "}\n";
+
+// ITU-R BT.601 YCbCr to RGB conversion
+const char* FRAGMENT_SHADER =
+    "uniform sampler2D yPlane;\n"
+    "uniform sampler2D uPlane;\n"
+    "uniform sampler2D vPlane;\n"
+    "uniform float lumaOffset;\n"
+    "uniform float lumaScale;\n"
+    "uniform float chromaScale;\n"
+    "varying vec2 texCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    float y = texture2D( yPlane, texCoord ).r;\n"
+    "    float u = texture2D( uPlane, texCoord ).r - 128.0 / 255.0;\n"
+    "    float v = texture2D( vPlane, texCoord ).r - 128.0 / 255.0;\n"
+    "    y = ( y - lumaOffset ) * lumaScale;\n"
+    "    u *= chromaScale;\n"
+    "    v *= chromaScale;\n"
+    "    gl_FragColor = vec4( y + 1.402 * v,\n"
+    "                         y - 0.344136 * u - 0.714136 * v,\n"
+    "                         y + 1.772 * u, 1.0 );\n"
+    "}\n";
+
+enum Support
+{
+    SUPPORT_UNKNOWN,
+    SUPPORT_YES,
+    SUPPORT_NO
+};
+
+/**
+ * @return the shader program, shared by the quads of all the contexts (which
+ *         share their objects), or 0 if it is not supported.
+ */
+QGLShaderProgram* getProgram()
+{
+    if( !QGLContext::currentContext( ))
+        return 0;
+
+    static Support support = SUPPORT_UNKNOWN;
+    static QGLShaderProgram program;
+    if( support == SUPPORT_UNKNOWN )
+    {
+        support = SUPPORT_NO;
+        if( !QGLShaderProgram::hasOpenGLShaderPrograms( ))
+            put_flog( LOG_WARN, "Shaders are not supported, movies are "
+                                "converted to RGB on the CPU" );
+        else if( !program.addShaderFromSourceCode( QGLShader::Vertex,
+                                                   VERTEX_SHADER ) ||
+                 !program.addShaderFromSourceCode( QGLShader::Fragment,
+                                                   FRAGMENT_SHADER ) ||
+                 !program.link( ))
+            put_flog( LOG_WARN, "Could not build the YUV shader: %s",
+                      program.log().toLocal8Bit().constData( ));
+        else
+            support = SUPPORT_YES;
+    }
+    return support == SUPPORT_YES ? &program : 0;
+}
+}
+
+GLYUVQuad::GLYUVQuad()
+    : _texCoords( UNIT_RECTF )
+    , _fullColorRange( false )
+{
+}
+
+bool GLYUVQuad::isSupported()
+{
+    return getProgram() != 0;
+}
+
+bool GLYUVQuad::init( const QSize& size, const QSize& chromaSize )
+{
+    if( isValid( ))
+        return false;
+
+    // Black in YUV, as the texture of the RGBA path
+    const QSize sizes[PLANE_COUNT] = { size, chromaSize, chromaSize };
+    const GLubyte values[PLANE_COUNT] = { 16, 128, 128 };
+    for( unsigned int i = 0; i < PLANE_COUNT; ++i )
+    {
+        const std::vector<GLubyte> data( sizes[i].width() * sizes[i].height(),
+                                         values[i] );
+        glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
+        glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+        const bool created = _planes[i].init( sizes[i], GL_LUMINANCE,
+                                              GL_LUMINANCE, data.data( ));
+        glPopClientAttrib();
+        if( !created )
+            return false;
+    }
+    return true;
+}
+
+bool GLYUVQuad::isValid() const
+{
+    return _planes[PLANE_COUNT - 1].isValid();
+}
+
+void GLYUVQuad::update( const unsigned int plane, const void* data,
+                        const QRect& region )
+{
+    if( plane < PLANE_COUNT )
+        _planes[plane].update( data, region, GL_LUMINANCE );
+}
+
+void GLYUVQuad::setTexCoords( const QRectF& texCoords )
+{
+    _texCoords = texCoords;
+}
+
+void GLYUVQuad::setFullColorRange( const bool value )
+{
+    _fullColorRange = value;
+}
+
+void GLYUVQuad::render()
+{
+    QGLShaderProgram* program = getProgram();
+    if( !isValid() || !program || !program->bind( ))
+        return;
+
+    program->setUniformValue( "yPlane", 0 );
+    program->setUniformValue( "uPlane", 1 );
+    program->setUniformValue( "vPlane", 2 );
+    if( _fullColorRange )
+    {
+        program->setUniformValue( "lumaOffset", 0.f );
+        program->setUniformValue( "lumaScale", 1.f );
+        program->setUniformValue( "chromaScale", 1.f );
+    }
+    else
+    {
+        program->setUniformValue( "lumaOffset", 16.f / 255.f );
+        program->setUniformValue( "lumaScale", 255.f / 219.f );
+        program->setUniformValue( "chromaScale", 255.f / 224.f );
+    }
+
+    // Leave the first texture unit active for the other quads
+    QGLFunctions gl( QGLContext::currentContext( ));
+    for( int i = PLANE_COUNT - 1; i >= 0; --i )
+    {
+        gl.glActiveTexture( GL_TEXTURE0 + i );
+        _planes[i].bind();
+    }
+
+    const GLfloat left = _texCoords.left();
+    const GLfloat right = _texCoords.right();
+    const GLfloat top = _texCoords.top();
+    const GLfloat bottom = _texCoords.bottom();
+    const GLfloat texCoords[VERTEX_COUNT * 2] =
+    {
+        left, top,
+        right, top,
+        right, bottom,
+        left, bottom
+    };
+
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, 0, UNIT_QUAD );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glTexCoordPointer( 2, GL_FLOAT, 0, texCoords );
+    glDrawArrays( GL_QUADS, 0, VERTEX_COUNT );
+    glPopClientAttrib();
+
+    program->release();
+}
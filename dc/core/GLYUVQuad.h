@@ -0,0 +1,114 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef GLYUVQUAD_H
+#define GLYUVQUAD_H
+
+#include "Renderable.h"
+#include "GLTexture2D.h"
+
+#include <QtCore/QRectF>
+
+/**
+ * A textured quad of planar YUV data, converted to RGB by a fragment shader.
+ *
+ * The luma and chroma planes are uploaded to separate single-channel
+ * textures, which is less data than the equivalent RGBA image (half of it for
+ * 4:2:0 subsampling) and saves the conversion on the CPU. The conversion uses
+ * the ITU-R BT.601 coefficients, like the swscale conversion to RGBA.
+ *
+ * Unlike the GLQuad, the quad is drawn immediately and not batched by the
+ * GLQuadRenderer.
+ *
+ * All methods of this class must be called from the OpenGL thread, with a
+ * current context.
+ */
+class GLYUVQuad : public Renderable
+{
+public:
+    /** The number of planes of the YUV data. */
+    static const unsigned int PLANE_COUNT = 3;
+
+    /** Construct an empty quad. */
+    GLYUVQuad();
+
+    /**
+     * Check if the shader can be used with the current context.
+     * @return false if there is no current context or the shader could not
+     *         be built.
+     */
+    static bool isSupported();
+
+    /**
+     * Allocate the textures of the planes.
+     * @param size The dimensions of the luma plane
+     * @param chromaSize The dimensions of the chroma planes
+     * @return true on success
+     */
+    bool init( const QSize& size, const QSize& chromaSize );
+
+    /** @return true if the textures have been allocated. */
+    bool isValid() const;
+
+    /**
+     * Update a region of a plane.
+     * @param plane The index of the plane: 0 for Y, 1 for U, 2 for V
+     * @param data The samples of the region, one byte each, tightly packed
+     * @param region The region to update, in plane pixel coordinates
+     */
+    void update( unsigned int plane, const void* data, const QRect& region );
+
+    /** Set the texture coordinates. */
+    void setTexCoords( const QRectF& texCoords );
+
+    /**
+     * Use the full [0-255] range of the JPEG formats instead of the [16-235]
+     * range of video formats. (default: OFF)
+     */
+    void setFullColorRange( bool value );
+
+    /** Draw the quad. */
+    void render() override;
+
+private:
+    GLTexture2D _planes[PLANE_COUNT];
+    QRectF _texCoords;
+    bool _fullColorRange;
+};
+
+#endif // GLYUVQUAD_H
@@ -41,9 +41,12 @@
 
 #include "MPIContext.h"
 #include "MPINospin.h"
+#include "SerializeBuffer.h"
 
 #include "log.h"
 
+#include <algorithm>
+
 // #define instead of a function so that put_flog() prints the correct reference
 #define MPI_CHECK( func ) {                                   \
     const int err = ( func );                                 \
@@ -51,11 +54,19 @@
         put_flog( LOG_ERROR, "Error detected! (%d)", err );   \
     }
 
+namespace
+{
+const size_t DEFAULT_MAX_PENDING_BROADCASTS = 2;
+}
+
 MPIChannel::MPIChannel( int argc, char* argv[] )
     : _mpiContext( new MPIContext( argc, argv ))
     , _mpiComm( MPI_COMM_WORLD)
     , _mpiRank( -1 )
     , _mpiSize( -1 )
+    , _maxPendingBroadcasts( DEFAULT_MAX_PENDING_BROADCASTS )
+    , _sentBytes( 0 )
+    , _receivedBytes( 0 )
 {
     MPI_Comm_rank( MPI_COMM_WORLD, &_mpiRank );
     MPI_Comm_size( MPI_COMM_WORLD, &_mpiSize );
@@ -67,6 +78,9 @@ MPIChannel::MPIChannel( const MPIChannel& parent, const int color,
     , _mpiComm( MPI_COMM_WORLD )
     , _mpiRank( -1 )
     , _mpiSize( -1 )
+    , _maxPendingBroadcasts( DEFAULT_MAX_PENDING_BROADCASTS )
+    , _sentBytes( 0 )
+    , _receivedBytes( 0 )
 {
     MPI_Comm_split( parent._mpiComm, color, key, &_mpiComm );
     MPI_Comm_rank( _mpiComm, &_mpiRank );
@@ -99,12 +113,19 @@ void MPIChannel::globalBarrier() const
     MPI_Barrier( _mpiComm );
 }
 
-int MPIChannel::globalSum( const int localValue ) const
+std::vector<uint64_t>
+MPIChannel::globalMax( const std::vector<uint64_t>& localValues ) const
 {
-    int globalValue = 0;
-    MPI_Allreduce( (void*)&localValue, (void*)&globalValue,
-                   1, MPI_INT, MPI_SUM, _mpiComm );
-    return globalValue;
+    std::vector<uint64_t> globalValues( localValues.size( ));
+    if( localValues.empty( ))
+        return globalValues;
+
+    MPI_CHECK( MPI_Allreduce( (void*)localValues.data(),
+                              (void*)globalValues.data(), localValues.size(),
+                              MPI_UNSIGNED_LONG_LONG, MPI_MAX, _mpiComm ));
+    _sentBytes += localValues.size() * sizeof( uint64_t );
+    _receivedBytes += globalValues.size() * sizeof( uint64_t );
+    return globalValues;
 }
 
 bool MPIChannel::isMessageAvailable( const int src )
@@ -125,6 +146,7 @@ void MPIChannel::send( const MPIMessageType type,
     MPI_CHECK( MPI_Send_Nospin( (void*)serializedData.data(),
                                 serializedData.size(), MPI_BYTE, dest,
                                 type, _mpiComm ));
+    _sentBytes += serializedData.size();
 }
 
 void MPIChannel::sendAll( const MPIMessageType type )
@@ -140,15 +162,73 @@ void MPIChannel::sendAll( const MPIMessageType type )
 void MPIChannel::broadcast( const MPIMessageType type,
                             const std::string& serializedData )
 {
-    MPIHeader mh;
-    mh.size = serializedData.size();
-    mh.type = type;
+    _broadcast( type, serializedData.data(), serializedData.size( ));
+}
+
+void MPIChannel::broadcast( const MPIMessageType type,
+                            const SerializeBuffer& buffer )
+{
+    _broadcast( type, buffer.data(), buffer.size( ));
+}
+
+void MPIChannel::broadcastNonblocking( const MPIMessageType type,
+                                       SerializeBufferPtr buffer )
+{
+    _completeBroadcasts( _maxPendingBroadcasts - 1 );
+
+    // std::deque::push_back() does not move the existing elements, whose
+    // header and data are in use by MPI
+    _pendingBroadcasts.push_back( PendingBroadcast( ));
+    PendingBroadcast& pending = _pendingBroadcasts.back();
+    pending.header.type = type;
+    pending.header.size = buffer ? buffer->size() : 0;
+    pending.buffer = buffer;
+    pending.requestsCount = 0;
+    _sentBytes += ( sizeof(MPIHeader) + pending.header.size ) *
+                  ( _mpiSize - 1 );
+
+    MPI_CHECK( MPI_Ibcast( (void*)&pending.header, sizeof(MPIHeader),
+                           MPI_BYTE, _mpiRank, _mpiComm,
+                           &pending.requests[pending.requestsCount++] ));
+    if( pending.header.size > 0 )
+        MPI_CHECK( MPI_Ibcast( (void*)buffer->data(), buffer->size(),
+                               MPI_BYTE, _mpiRank, _mpiComm,
+                               &pending.requests[pending.requestsCount++] ));
+}
+
+void MPIChannel::setMaxPendingBroadcasts( const size_t count )
+{
+    _maxPendingBroadcasts = std::max( count, size_t(1) );
+}
+
+void MPIChannel::waitForBroadcasts()
+{
+    _completeBroadcasts( 0 );
+}
+
+void MPIChannel::scatter( const MPIMessageType type,
+                          const std::vector<SerializeBufferPtr>& buffers )
+{
+    assert( buffers.size() == (size_t)_mpiSize );
+
+    std::vector<MPI_Request> requests;
+    requests.reserve( _mpiSize );
 
     for( int i = 0; i < _mpiSize; ++i )
-        _send( mh, i );
+    {
+        if( !_isValid( i ))
+            continue;
+
+        const SerializeBuffer& buffer = *buffers[i];
+
+        MPI_Request request;
+        MPI_CHECK( MPI_Isend( (void*)buffer.data(), buffer.size(), MPI_BYTE,
+                              i, type, _mpiComm, &request ));
+        requests.push_back( request );
+        _sentBytes += buffer.size();
+    }
 
-    MPI_CHECK( MPI_Bcast( (void*)serializedData.data(), serializedData.size(),
-                          MPI_BYTE, _mpiRank, _mpiComm ));
+    MPI_CHECK( MPI_Waitall_Nospin( requests.size(), requests.data( )));
 }
 
 MPIHeader MPIChannel::receiveHeader( const int src )
@@ -157,6 +237,18 @@ MPIHeader MPIChannel::receiveHeader( const int src )
     MPIHeader mh;
     MPI_CHECK( MPI_Recv_Nospin( (void*)&mh, sizeof(MPIHeader), MPI_BYTE, src,
                                 0, _mpiComm, &status ));
+    _receivedBytes += sizeof(MPIHeader);
+    return mh;
+}
+
+MPIHeader MPIChannel::receiveBroadcastHeader( const int src )
+{
+    MPIHeader mh;
+    MPI_Request request;
+    MPI_CHECK( MPI_Ibcast( (void*)&mh, sizeof(MPIHeader), MPI_BYTE, src,
+                           _mpiComm, &request ));
+    MPI_CHECK( MPI_Waitall_Nospin( 1, &request ));
+    _receivedBytes += sizeof(MPIHeader);
     return mh;
 }
 
@@ -185,6 +277,7 @@ void MPIChannel::receive( char* dataBuffer, const size_t messageSize,
     if( count != (int)messageSize )
         put_flog( LOG_ERROR, "incorrect bytes count: %d / %d", count,
                   messageSize );
+    _receivedBytes += count;
 }
 
 void MPIChannel::receiveBroadcast( char* dataBuffer, const size_t messageSize,
@@ -192,15 +285,28 @@ void MPIChannel::receiveBroadcast( char* dataBuffer, const size_t messageSize,
 {
     MPI_CHECK( MPI_Bcast( (void*)dataBuffer, messageSize, MPI_BYTE, src,
                           _mpiComm ));
+    _receivedBytes += messageSize;
 }
 
-std::vector<uint64_t> MPIChannel::gatherAll( const uint64_t value )
+void MPIChannel::receiveNonblockingBroadcast( char* dataBuffer,
+                                              const size_t messageSize,
+                                              const int src )
 {
-    std::vector<uint64_t> results( _mpiSize );
-    MPI_CHECK( MPI_Allgather( (void*)&value, 1, MPI_LONG_LONG_INT,
-                              (void*)results.data(), 1, MPI_LONG_LONG_INT,
-                              _mpiComm ));
-    return results;
+    MPI_Request request;
+    MPI_CHECK( MPI_Ibcast( (void*)dataBuffer, messageSize, MPI_BYTE, src,
+                           _mpiComm, &request ));
+    MPI_CHECK( MPI_Waitall_Nospin( 1, &request ));
+    _receivedBytes += messageSize;
+}
+
+uint64_t MPIChannel::getSentBytes() const
+{
+    return _sentBytes;
+}
+
+uint64_t MPIChannel::getReceivedBytes() const
+{
+    return _receivedBytes;
 }
 
 bool MPIChannel::_isValid( const int dest ) const
@@ -215,4 +321,42 @@ void MPIChannel::_send( const MPIHeader& header, const int dest )
 
     MPI_CHECK( MPI_Send_Nospin( (void*)&header, sizeof(MPIHeader), MPI_BYTE,
                                 dest, 0, _mpiComm ));
+    _sentBytes += sizeof(MPIHeader);
+}
+
+void MPIChannel::_broadcast( const MPIMessageType type, const char* data,
+                             const size_t size )
+{
+    MPIHeader mh;
+    mh.size = size;
+    mh.type = type;
+
+    for( int i = 0; i < _mpiSize; ++i )
+        _send( mh, i );
+
+    MPI_CHECK( MPI_Bcast( (void*)data, size, MPI_BYTE, _mpiRank, _mpiComm ));
+    _sentBytes += size * ( _mpiSize - 1 );
+}
+
+void MPIChannel::_completeBroadcasts( const size_t maxPending )
+{
+    // Release the broadcasts which are already completed, in order
+    while( !_pendingBroadcasts.empty( ))
+    {
+        PendingBroadcast& pending = _pendingBroadcasts.front();
+        int completed = 0;
+        MPI_CHECK( MPI_Testall( pending.requestsCount, pending.requests,
+                                &completed, MPI_STATUSES_IGNORE ));
+        if( !completed )
+            break;
+        _pendingBroadcasts.pop_front();
+    }
+
+    while( _pendingBroadcasts.size() > maxPending )
+    {
+        PendingBroadcast& pending = _pendingBroadcasts.front();
+        MPI_CHECK( MPI_Waitall_Nospin( pending.requestsCount,
+                                       pending.requests ));
+        _pendingBroadcasts.pop_front();
+    }
 }
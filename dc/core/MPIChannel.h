@@ -45,7 +45,11 @@
 
 #include <mpi.h>
 
+#include <atomic>
+#include <deque>
+
 class MPIContext;
+class SerializeBuffer;
 typedef boost::shared_ptr<MPIContext> MPIContextPtr;
 
 /**
@@ -109,11 +113,13 @@ public:
     void globalBarrier() const;
 
     /**
-     * Get the sum of the given local values across all processes.
-     * @param localValue The value to sum
-     * @return the sum of the localValues
+     * Get the element-wise maximum of the given local values across all
+     * processes. All processes must provide the same number of values.
+     * @param localValues The values to reduce
+     * @return the maximum of each value across all processes
      */
-    int globalSum( int localValue ) const;
+    std::vector<uint64_t> globalMax( const std::vector<uint64_t>& localValues )
+        const;
 
     /**
      * Send data to a single process
@@ -137,6 +143,56 @@ public:
      */
     void broadcast( MPIMessageType type, const std::string& serializedData );
 
+    /**
+     * Send a brodcast message to all other processes
+     * @param type The message type
+     * @param buffer The buffer containing the serialized data, which is sent
+     *        without being copied
+     */
+    void broadcast( MPIMessageType type, const SerializeBuffer& buffer );
+
+    /**
+     * Start a nonblocking broadcast of a message to all other processes.
+     *
+     * The header is broadcast in a fixed-size slot followed by the payload,
+     * both with MPI_Ibcast, so no point-to-point header is needed. Several
+     * broadcasts can be in flight, which lets the caller prepare the next
+     * message while the previous ones are transmitted. When the limit is
+     * reached, the oldest broadcast is completed before starting a new one.
+     *
+     * Receivers must use receiveBroadcastHeader() and
+     * receiveNonblockingBroadcast(). Blocking and nonblocking broadcasts do not
+     * match each other and must not be mixed on a channel.
+     * @param type The message type
+     * @param buffer The serialized data, which is kept until the broadcast is
+     *        completed. Can be empty to send only the header.
+     * @see setMaxPendingBroadcasts()
+     */
+    void broadcastNonblocking( MPIMessageType type, SerializeBufferPtr buffer );
+
+    /**
+     * Set the maximum number of nonblocking broadcasts in flight.
+     * @param count The number of broadcasts, at least 1 (default: 2)
+     */
+    void setMaxPendingBroadcasts( size_t count );
+
+    /** Block until all nonblocking broadcasts are completed. */
+    void waitForBroadcasts();
+
+    /**
+     * Send a different message to each of the other processes.
+     *
+     * The destinations must be notified beforehand, for instance with a
+     * header-only broadcastNonblocking(). They can then fetch their message
+     * with probe() and receive(), using the message type as tag.
+     * @param type The message type
+     * @param buffers The serialized data for each process, indexed by rank.
+     *        The entry for this process is ignored. The same buffer can be
+     *        given for several processes.
+     */
+    void scatter( MPIMessageType type,
+                  const std::vector<SerializeBufferPtr>& buffers );
+
     /** Nonblocking probe for messages from a given source */
     bool isMessageAvailable( int src );
 
@@ -157,6 +213,15 @@ public:
      */
     MPIHeader receiveHeader( int src );
 
+    /**
+     * Receive the header of a nonblocking broadcast.
+     * This call is blocking.
+     * @param src The source process
+     * @return The header containing the message type and size
+     * @see broadcastNonblocking()
+     */
+    MPIHeader receiveBroadcastHeader( int src );
+
     /**
      * Receive a message from a specific process.
      * This call is blocking.
@@ -179,11 +244,28 @@ public:
     void receiveBroadcast( char* dataBuffer, size_t messageSize, int src );
 
     /**
-     * Gather the values accross all the processes.
-     * @param value The local value
-     * @return A vector of values of size getSize(), ordered by process rank
+     * Receive the payload of a nonblocking broadcast.
+     * This call is blocking.
+     * @see receiveBroadcastHeader()
+     * @param dataBuffer The target data buffer
+     * @param messageSize The number of bytes to receive, must be > 0
+     * @param src The source process
+     */
+    void receiveNonblockingBroadcast( char* dataBuffer, size_t messageSize,
+                                      int src );
+
+    /**
+     * @return the number of bytes sent by this process on this channel,
+     *         including message headers. A broadcast is counted once per
+     *         destination. Collective operations count the local values.
      */
-    std::vector<uint64_t> gatherAll( uint64_t value );
+    uint64_t getSentBytes() const;
+
+    /**
+     * @return the number of bytes received by this process on this channel,
+     *         including message headers and the results of collectives.
+     */
+    uint64_t getReceivedBytes() const;
 
 private:
     MPIContextPtr _mpiContext;
@@ -191,8 +273,23 @@ private:
     int _mpiRank;
     int _mpiSize;
 
+    struct PendingBroadcast
+    {
+        MPIHeader header;
+        SerializeBufferPtr buffer;
+        MPI_Request requests[2];
+        int requestsCount;
+    };
+    std::deque<PendingBroadcast> _pendingBroadcasts;
+    size_t _maxPendingBroadcasts;
+
+    mutable std::atomic<uint64_t> _sentBytes;
+    mutable std::atomic<uint64_t> _receivedBytes;
+
     bool _isValid( const int dest ) const;
     void _send( const MPIHeader& header, const int dest );
+    void _broadcast( MPIMessageType type, const char* data, size_t size );
+    void _completeBroadcasts( size_t maxPending );
 };
 
 #endif // MPICHANNEL_H
@@ -40,6 +40,7 @@
 #include "MPIContext.h"
 
 #include "log.h"
+#include "MPINospin.h"
 
 #include <mpi.h>
 
@@ -59,6 +60,8 @@ MPIContext::MPIContext( int argc, char* argv[] )
 
 MPIContext::~MPIContext()
 {
+    // Stop the progress thread, if any
+    MPI_Nospin_SetWaitPolicy( MPIWaitPolicy( ));
     MPI_Finalize();
 }
 
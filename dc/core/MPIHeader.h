@@ -53,7 +53,10 @@ enum MPIMessageType
     MPI_MESSAGE_TYPE_OPTIONS,
     MPI_MESSAGE_TYPE_MARKERS,
     MPI_MESSAGE_TYPE_REQUEST_FRAME,
-    MPI_MESSAGE_TYPE_TIMESTAMP
+    MPI_MESSAGE_TYPE_TIMESTAMP,
+    MPI_MESSAGE_TYPE_PIXELSTREAM_ROUTED,
+    MPI_MESSAGE_TYPE_REQUEST_PROFILE,
+    MPI_MESSAGE_TYPE_PROFILE
 };
 
 /** Fixed-size message header. */
@@ -44,32 +44,207 @@
 
 #include "MPINospin.h"
 
+#include "log.h"
+
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 namespace
 {
-const size_t nsec_start = 1000;
-const size_t nsec_max = 100000;
-}
+const long nsec_start = 1000;
+const unsigned int maxSleepLimit = 999999; // timespec::tv_nsec < 1s
 
-int MPI_Probe_Nospin( const int source, const int tag, MPI_Comm comm,
-                      MPI_Status* status )
+typedef std::chrono::steady_clock Clock;
+
+/** Test an operation: set the flag on completion, return an MPI error code. */
+typedef std::function< int( int& ) > TestFunction;
+
+/** Pause between two tests of an operation, following a wait policy. */
+class Poller
 {
-    int flag = 0;
-    int ret = MPI_Iprobe( source, tag, comm, &flag, status );
-    if( ret != MPI_SUCCESS )
-        return ret;
+public:
+    explicit Poller( const MPIWaitPolicy& policy )
+        : _policy( policy )
+        , _spinEnd( Clock::now() + std::chrono::microseconds( policy.spinTime ))
+        , _sleep( std::min( nsec_start, long(policy.maxSleep) * 1000 ))
+    {}
 
-    timespec ts{ 0, nsec_start };
-    while( !flag )
+    void pause()
     {
+        if( _policy.spinTime > 0 && Clock::now() < _spinEnd )
+            return;
+
+        const long maxSleep = long(_policy.maxSleep) * 1000;
+        if( _policy.mode == MPI_WAIT_MODE_LATENCY_BUDGET )
+            _sleep = maxSleep;
+
+        timespec ts{ 0, _sleep };
         nanosleep( &ts, nullptr );
-        ts.tv_nsec = std::min( size_t(ts.tv_nsec << 1), nsec_max );
-        ret = MPI_Iprobe( source, tag, comm, &flag, status );
+        _sleep = std::min( _sleep << 1, maxSleep );
+    }
+
+private:
+    MPIWaitPolicy _policy;
+    Clock::time_point _spinEnd;
+    long _sleep;
+};
+
+/** Poll the operations of the waiting threads, which sleep meanwhile. */
+class ProgressThread
+{
+public:
+    explicit ProgressThread( const MPIWaitPolicy& policy )
+        : _policy( policy )
+        , _stop( false )
+        , _thread( &ProgressThread::_run, this )
+    {}
+
+    ~ProgressThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _stop = true;
+        }
+        _workCondition.notify_one();
+        _thread.join();
+    }
+
+    int wait( const TestFunction& test )
+    {
+        Task task( test );
+        std::unique_lock<std::mutex> lock( _mutex );
+        _tasks.push_back( &task );
+        _workCondition.notify_one();
+        _doneCondition.wait( lock, [&task] { return task.done; } );
+        return task.result;
+    }
+
+private:
+    struct Task
+    {
+        explicit Task( const TestFunction& test_ )
+            : test( test_ ), done( false ), result( MPI_SUCCESS ) {}
+        const TestFunction& test;
+        bool done;
+        int result;
+    };
+
+    const MPIWaitPolicy _policy;
+    std::mutex _mutex;
+    std::condition_variable _workCondition;
+    std::condition_variable _doneCondition;
+    std::vector<Task*> _tasks;
+    bool _stop;
+    std::thread _thread;
+
+    void _run()
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        for( ;; )
+        {
+            _workCondition.wait( lock, [this] {
+                return _stop || !_tasks.empty(); } );
+            // Complete the pending operations before stopping
+            if( _tasks.empty( ))
+                return;
+
+            Poller poller( _policy );
+            while( !_tasks.empty( ))
+            {
+                const std::vector<Task*> tasks( _tasks );
+                lock.unlock();
+
+                std::vector<std::pair<Task*, int>> completed;
+                for( Task* task : tasks )
+                {
+                    int flag = 0;
+                    const int result = task->test( flag );
+                    if( flag || result != MPI_SUCCESS )
+                        completed.push_back( std::make_pair( task, result ));
+                }
+
+                if( completed.empty( ))
+                    poller.pause();
+                else
+                    poller = Poller( _policy );
+
+                lock.lock();
+                // The completed tasks are destroyed by their thread once done
+                for( const auto& entry : completed )
+                {
+                    entry.first->result = entry.second;
+                    entry.first->done = true;
+                    _tasks.erase( std::find( _tasks.begin(), _tasks.end(),
+                                             entry.first ));
+                }
+                if( !completed.empty( ))
+                    _doneCondition.notify_all();
+            }
+        }
+    }
+};
+
+std::mutex policyMutex;
+MPIWaitPolicy currentPolicy;
+std::shared_ptr<ProgressThread> progressThread;
+
+std::mutex histogramsMutex;
+MPIWaitHistogram histograms[MPI_WAIT_CALL_COUNT];
+
+const char* callNames[MPI_WAIT_CALL_COUNT] = { "probe", "send", "recv",
+                                               "waitall" };
+const char* modeNames[] = { "backoff", "budget", "progress" };
+
+int waitFor( const MPIWaitCall call, const TestFunction& test )
+{
+    const Clock::time_point start = Clock::now();
+
+    MPIWaitPolicy policy;
+    std::shared_ptr<ProgressThread> thread;
+    {
+        std::lock_guard<std::mutex> lock( policyMutex );
+        policy = currentPolicy;
+        thread = progressThread;
+    }
+
+    int ret = MPI_SUCCESS;
+    if( thread )
+        ret = thread->wait( test );
+    else
+    {
+        Poller poller( policy );
+        int flag = 0;
+        ret = test( flag );
+        while( ret == MPI_SUCCESS && !flag )
+        {
+            poller.pause();
+            ret = test( flag );
+        }
     }
+
+    const uint64_t waitTime =
+       std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start ).count();
+    std::lock_guard<std::mutex> lock( histogramsMutex );
+    histograms[call].add( waitTime );
     return ret;
 }
+}
+
+int MPI_Probe_Nospin( const int source, const int tag, MPI_Comm comm,
+                      MPI_Status* status )
+{
+    return waitFor( MPI_WAIT_CALL_PROBE, [&]( int& flag ) {
+        return MPI_Iprobe( source, tag, comm, &flag, status ); } );
+}
 
 int MPI_Send_Nospin( void *buff, const int count, MPI_Datatype datatype,
                      const int dest, const int tag, MPI_Comm comm )
@@ -79,15 +254,9 @@ int MPI_Send_Nospin( void *buff, const int count, MPI_Datatype datatype,
     if( ret != MPI_SUCCESS )
         return ret;
 
-    timespec ts{ 0, nsec_start };
-    int flag = 0;
-    while( !flag )
-    {
-        nanosleep( &ts, nullptr );
-        ts.tv_nsec = std::min( size_t(ts.tv_nsec << 1), nsec_max );
-        // Always returns success. Status unused for single send operations.
-        MPI_Request_get_status( req, &flag, MPI_STATUS_IGNORE );
-    }
+    // Always returns success. Status unused for single send operations.
+    waitFor( MPI_WAIT_CALL_SEND, [&]( int& flag ) {
+        return MPI_Request_get_status( req, &flag, MPI_STATUS_IGNORE ); } );
     return MPI_Wait( &req, MPI_STATUS_IGNORE ); // release the request object
 }
 
@@ -100,13 +269,78 @@ int MPI_Recv_Nospin( void* buff, const int count, MPI_Datatype datatype,
     if( ret != MPI_SUCCESS )
         return ret;
 
-    timespec ts{ 0, nsec_start };
-    int flag = 0;
-    while( !flag )
+    // Always returns success
+    waitFor( MPI_WAIT_CALL_RECV, [&]( int& flag ) {
+        return MPI_Request_get_status( req, &flag, status ); } );
+    return MPI_Wait( &req, status ); // release the request object
+}
+
+int MPI_Waitall_Nospin( const int count, MPI_Request* requests )
+{
+    return waitFor( MPI_WAIT_CALL_WAITALL, [&]( int& flag ) {
+        return MPI_Testall( count, requests, &flag, MPI_STATUSES_IGNORE ); } );
+}
+
+void MPI_Nospin_SetWaitPolicy( const MPIWaitPolicy& policy )
+{
+    MPIWaitPolicy newPolicy( policy );
+    newPolicy.maxSleep = std::min( newPolicy.maxSleep, maxSleepLimit );
+
+    if( newPolicy.mode == MPI_WAIT_MODE_PROGRESS_THREAD )
     {
-        nanosleep( &ts, nullptr );
-        ts.tv_nsec = std::min( size_t(ts.tv_nsec << 1), nsec_max );
-        MPI_Request_get_status( req, &flag, status ); // Always returns success
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Query_thread( &provided );
+        if( provided < MPI_THREAD_MULTIPLE )
+        {
+            put_flog( LOG_WARN, "MPI progress thread requires "
+                      "MPI_THREAD_MULTIPLE, using backoff mode instead" );
+            newPolicy.mode = MPI_WAIT_MODE_BACKOFF;
+        }
     }
-    return MPI_Wait( &req, status ); // release the request object
+
+    std::shared_ptr<ProgressThread> oldThread;
+    {
+        std::lock_guard<std::mutex> lock( policyMutex );
+        currentPolicy = newPolicy;
+        oldThread.swap( progressThread );
+        if( newPolicy.mode == MPI_WAIT_MODE_PROGRESS_THREAD )
+            progressThread = std::make_shared<ProgressThread>( newPolicy );
+    }
+    // The previous thread stops once its pending operations are completed
+    // and the last waiting thread has released it.
+}
+
+MPIWaitPolicy MPI_Nospin_GetWaitPolicy()
+{
+    std::lock_guard<std::mutex> lock( policyMutex );
+    return currentPolicy;
+}
+
+MPIWaitHistogram MPI_Nospin_GetHistogram( const MPIWaitCall call )
+{
+    std::lock_guard<std::mutex> lock( histogramsMutex );
+    return histograms[call];
+}
+
+void MPI_Nospin_ResetHistograms()
+{
+    std::lock_guard<std::mutex> lock( histogramsMutex );
+    for( size_t i = 0; i < MPI_WAIT_CALL_COUNT; ++i )
+        histograms[i] = MPIWaitHistogram();
+}
+
+std::string MPI_Nospin_GetStatistics()
+{
+    const MPIWaitPolicy policy = MPI_Nospin_GetWaitPolicy();
+
+    std::ostringstream stats;
+    stats << "MPI wait policy: " << modeNames[policy.mode] << ", spin "
+          << policy.spinTime << " us, max sleep " << policy.maxSleep << " us";
+    for( size_t i = 0; i < MPI_WAIT_CALL_COUNT; ++i )
+    {
+        const MPIWaitHistogram histogram =
+                MPI_Nospin_GetHistogram( MPIWaitCall( i ));
+        stats << std::endl << callNames[i] << ": " << histogram.toString();
+    }
+    return stats.str();
 }
@@ -40,6 +40,8 @@
 #ifndef MPISENDRECV_H
 #define MPISENDRECV_H
 
+#include "MPIWaitPolicy.h"
+
 #include <mpi.h>
 
 /**
@@ -62,4 +64,36 @@ int MPI_Send_Nospin( void *buff, int count, MPI_Datatype datatype,
 int MPI_Recv_Nospin( void* buff, int count, MPI_Datatype datatype,
                      int from, int tag, MPI_Comm comm, MPI_Status* status );
 
+/**
+ * Implements a blocking, non-spinning MPI_Waitall to minimize CPU usage.
+ * @see MPI_Waitall
+ */
+int MPI_Waitall_Nospin( int count, MPI_Request* requests );
+
+/**
+ * Set the wait policy of all the MPI_*_Nospin functions.
+ *
+ * The MPI_WAIT_MODE_PROGRESS_THREAD mode falls back to MPI_WAIT_MODE_BACKOFF
+ * if MPI does not provide MPI_THREAD_MULTIPLE. This function is thread-safe,
+ * operations already waiting complete with the previous policy.
+ * @param policy The new wait policy
+ */
+void MPI_Nospin_SetWaitPolicy( const MPIWaitPolicy& policy );
+
+/** @return the current wait policy of the MPI_*_Nospin functions. */
+MPIWaitPolicy MPI_Nospin_GetWaitPolicy();
+
+/**
+ * Get the wait-time histogram of an operation since the last reset.
+ * @param call The operation
+ * @return a copy of the histogram
+ */
+MPIWaitHistogram MPI_Nospin_GetHistogram( MPIWaitCall call );
+
+/** Reset the wait-time histograms of all operations. */
+void MPI_Nospin_ResetHistograms();
+
+/** @return a multi-line summary of the policy and of all the histograms. */
+std::string MPI_Nospin_GetStatistics();
+
 #endif
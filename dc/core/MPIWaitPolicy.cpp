@@ -0,0 +1,104 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#include "MPIWaitPolicy.h"
+
+#include <algorithm>
+#include <sstream>
+
+bool MPIWaitPolicy::parseMode( const std::string& name, MPIWaitMode& mode )
+{
+    if( name == "backoff" )
+        mode = MPI_WAIT_MODE_BACKOFF;
+    else if( name == "budget" )
+        mode = MPI_WAIT_MODE_LATENCY_BUDGET;
+    else if( name == "progress" )
+        mode = MPI_WAIT_MODE_PROGRESS_THREAD;
+    else
+        return false;
+    return true;
+}
+
+MPIWaitHistogram::MPIWaitHistogram()
+    : calls( 0 )
+    , totalTime( 0 )
+{
+    std::fill( counts, counts + BUCKETS, 0 );
+}
+
+size_t MPIWaitHistogram::getBucket( uint64_t waitTime )
+{
+    size_t bucket = 0;
+    while( waitTime > 0 && bucket < BUCKETS - 1 )
+    {
+        waitTime >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void MPIWaitHistogram::add( const uint64_t waitTime )
+{
+    ++counts[getBucket( waitTime )];
+    ++calls;
+    totalTime += waitTime;
+}
+
+double MPIWaitHistogram::getAverage() const
+{
+    return calls > 0 ? double(totalTime) / calls : 0.0;
+}
+
+std::string MPIWaitHistogram::toString() const
+{
+    std::ostringstream stream;
+    stream << calls << " calls, avg " << getAverage() << " us";
+    for( size_t i = 0; i < BUCKETS; ++i )
+    {
+        if( counts[i] == 0 )
+            continue;
+        stream << " | ";
+        if( i == 0 )
+            stream << "<1";
+        else if( i == BUCKETS - 1 )
+            stream << ">=" << (uint64_t(1) << (i - 1));
+        else
+            stream << "<" << (uint64_t(1) << i);
+        stream << "us: " << counts[i];
+    }
+    return stream.str();
+}
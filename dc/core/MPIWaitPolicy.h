@@ -0,0 +1,138 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#ifndef MPIWAITPOLICY_H
+#define MPIWAITPOLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/** Strategies to wait for the completion of the MPI_*_Nospin operations. */
+enum MPIWaitMode
+{
+    /** Poll for spinTime, then sleep with an exponential backoff. */
+    MPI_WAIT_MODE_BACKOFF,
+
+    /** Poll for spinTime, then poll at a fixed interval of maxSleep. */
+    MPI_WAIT_MODE_LATENCY_BUDGET,
+
+    /**
+     * Block on a condition variable while a dedicated progress thread polls
+     * the operations of all the waiting threads, with the backoff policy.
+     * Requires MPI_THREAD_MULTIPLE.
+     */
+    MPI_WAIT_MODE_PROGRESS_THREAD
+};
+
+/** Parameters of the MPI_*_Nospin wait loops. */
+struct MPIWaitPolicy
+{
+    /** Default policy: backoff from 1 to 100 us without polling first. */
+    MPIWaitPolicy()
+        : mode( MPI_WAIT_MODE_BACKOFF )
+        , spinTime( 0 )
+        , maxSleep( 100 )
+    {}
+
+    /** The wait strategy. */
+    MPIWaitMode mode;
+
+    /** Duration of the initial busy polling in microseconds. */
+    unsigned int spinTime;
+
+    /**
+     * Maximum sleep time between two polls in microseconds, which is also the
+     * latency added to an operation in the worst case.
+     */
+    unsigned int maxSleep;
+
+    /**
+     * Parse a wait mode.
+     * @param name "backoff", "budget" or "progress"
+     * @param mode the result, unchanged if the name is not valid
+     * @return true if the name is valid
+     */
+    static bool parseMode( const std::string& name, MPIWaitMode& mode );
+};
+
+/** The blocking MPI_*_Nospin operations. */
+enum MPIWaitCall
+{
+    MPI_WAIT_CALL_PROBE,
+    MPI_WAIT_CALL_SEND,
+    MPI_WAIT_CALL_RECV,
+    MPI_WAIT_CALL_WAITALL,
+    MPI_WAIT_CALL_COUNT
+};
+
+/**
+ * Histogram of the time spent waiting in an operation, per call.
+ *
+ * Bucket 0 counts the waits shorter than 1 us, bucket i > 0 the waits in
+ * [2^(i-1), 2^i) us. The last bucket also counts all the longer waits.
+ */
+struct MPIWaitHistogram
+{
+    /** The number of buckets, the last one starts at 2^22 us (~4 s). */
+    static const size_t BUCKETS = 24;
+
+    MPIWaitHistogram();
+
+    /** @return the bucket for the given wait time in microseconds. */
+    static size_t getBucket( uint64_t waitTime );
+
+    /** Add a wait time in microseconds. */
+    void add( uint64_t waitTime );
+
+    /** @return the average wait time in microseconds. */
+    double getAverage() const;
+
+    /** @return a one-line summary of the non-empty buckets. */
+    std::string toString() const;
+
+    /** The number of waits in each bucket. */
+    uint64_t counts[BUCKETS];
+
+    /** The number of calls. */
+    uint64_t calls;
+
+    /** The total wait time in microseconds. */
+    uint64_t totalTime;
+};
+
+#endif // MPIWAITPOLICY_H
@@ -73,6 +73,13 @@ void MasterFromWallChannel::processMessages()
             emit receivedRequestFrame( uri );
             break;
         }
+        case MPI_MESSAGE_TYPE_PROFILE:
+        {
+            ProfileEvents events;
+            _buffer.deserialize( events );
+            emit receivedProfile( result.src, events );
+            break;
+        }
         case MPI_MESSAGE_TYPE_QUIT:
             _processMessages = false;
             break;
@@ -42,6 +42,7 @@
 
 #include "types.h"
 #include "MPIHeader.h"
+#include "Profiler.h"
 #include "SerializeBuffer.h"
 
 #include <QObject>
@@ -70,6 +71,13 @@ signals:
      */
     void receivedRequestFrame( QString uri );
 
+    /**
+     * Emitted when a wall process sent its profiling events
+     * @param rank The rank of the wall process
+     * @param events The events recorded by the process
+     */
+    void receivedProfile( int rank, ProfileEvents events );
+
 private:
     Q_DISABLE_COPY( MasterFromWallChannel )
 
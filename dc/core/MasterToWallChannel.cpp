@@ -41,40 +41,74 @@
 
 #include "MPIChannel.h"
 #include "DisplayGroup.h"
+#include "DisplayGroupDelta.h"
 #include "ContentWindow.h"
+#include "FrameSerializer.h"
+#include "log.h"
 #include "Options.h"
 #include "Markers.h"
+#include "PixelStreamRouter.h"
+#include "SegmentChangeTracker.h"
+#include "SerializeBuffer.h"
 
 #include <deflect/Frame.h>
 
+#include <map>
+
+namespace
+{
+const unsigned int DISPLAYGROUP_SNAPSHOT_INTERVAL = 100;
+// Buffers queued for the send thread or in flight in nonblocking broadcasts
+const size_t ASYNC_BUFFERS_COUNT = 4;
+}
+
 MasterToWallChannel::MasterToWallChannel( MPIChannelPtr mpiChannel )
     : _mpiChannel( mpiChannel )
+    , _bufferPool( mpiChannel->getSize() + ASYNC_BUFFERS_COUNT )
+    , _deltaBuilder( DISPLAYGROUP_SNAPSHOT_INTERVAL )
 {
 }
 
-template< typename T >
-void MasterToWallChannel::broadcast( const T& object,
-                                     const MPIMessageType type )
+MasterToWallChannel::~MasterToWallChannel() {}
+
+void MasterToWallChannel::enablePixelStreamRouting(
+        const std::vector<QRect>& wallProcessAreas )
 {
-    const std::string& serializedString = _buffer.serialize( object );
+    _router.reset( new PixelStreamRouter( wallProcessAreas ));
+}
 
-    _mpiChannel->broadcast( type, serializedString );
+void MasterToWallChannel::enableSegmentChangeTracking()
+{
+    _changeTracker.reset( new SegmentChangeTracker );
 }
 
 template< typename T >
 void MasterToWallChannel::broadcastAsync( const T& object,
                                           const MPIMessageType type )
 {
-    const std::string serializedStringCopy = _asyncBuffer.serialize( object );
+    SerializeBufferPtr buffer = _bufferPool.acquire();
+    buffer->write( object );
 
     QMetaObject::invokeMethod( this, "_broadcast", Qt::QueuedConnection,
                                Q_ARG( MPIMessageType, type ),
-                               Q_ARG( std::string, serializedStringCopy ));
+                               Q_ARG( SerializeBufferPtr, buffer ));
 }
 
 void MasterToWallChannel::sendAsync( DisplayGroupPtr displayGroup )
 {
-    broadcastAsync( displayGroup, MPI_MESSAGE_TYPE_DISPLAYGROUP );
+    broadcastAsync( _deltaBuilder.update( displayGroup ),
+                    MPI_MESSAGE_TYPE_DISPLAYGROUP );
+
+    if( !_router )
+        return;
+
+    // Windows may have moved onto screens which did not receive the segments
+    // of the last frame of their stream.
+    const QStringList outdated =
+            _router->updateWindows( displayGroup->getContentWindows( ));
+    foreach( const QString& uri, outdated )
+        QMetaObject::invokeMethod( this, "_resend", Qt::QueuedConnection,
+                                   Q_ARG( QString, uri ));
 }
 
 void MasterToWallChannel::sendAsync( OptionsPtr options )
@@ -90,17 +124,94 @@ void MasterToWallChannel::sendAsync( MarkersPtr markers )
 void MasterToWallChannel::send( deflect::FramePtr frame )
 {
     assert( !frame->segments.empty() && "received an empty frame" );
-    broadcast( frame, MPI_MESSAGE_TYPE_PIXELSTREAM );
+
+    std::vector<bool> changed;
+    if( _changeTracker )
+        changed = _changeTracker->update( *frame );
+
+    if( _router )
+        _route( frame, changed );
+    else
+    {
+        SerializeBufferPtr buffer = _bufferPool.acquire();
+        FrameSerializer::write(
+                *SegmentChangeTracker::removeUnchanged( frame, changed ),
+                *buffer );
+        _mpiChannel->broadcastNonblocking( MPI_MESSAGE_TYPE_PIXELSTREAM,
+                                           buffer );
+    }
+}
+
+// cppcheck-suppress passedByValue
+void MasterToWallChannel::closePixelStream( const QString uri )
+{
+    if( !_changeTracker )
+        return;
+
+    _changeTracker->removeStream( uri );
+    put_flog( LOG_INFO, "Unchanged pixel stream segments not sent: %llu of "
+                        "%llu (%.1f MB)",
+              (unsigned long long)_changeTracker->getUnchangedCount(),
+              (unsigned long long)_changeTracker->getSegmentCount(),
+              _changeTracker->getUnchangedBytes() / 1000000.0 );
+}
+
+void MasterToWallChannel::sendRequestProfile()
+{
+    _mpiChannel->broadcastNonblocking( MPI_MESSAGE_TYPE_REQUEST_PROFILE,
+                                       SerializeBufferPtr( ));
 }
 
 void MasterToWallChannel::sendQuit()
 {
-    _mpiChannel->sendAll( MPI_MESSAGE_TYPE_QUIT );
+    _mpiChannel->broadcastNonblocking( MPI_MESSAGE_TYPE_QUIT,
+                                       SerializeBufferPtr( ));
+    _mpiChannel->waitForBroadcasts();
 }
 
 // cppcheck-suppress passedByValue
 void MasterToWallChannel::_broadcast( const MPIMessageType type,
-                                      const std::string data )
+                                      SerializeBufferPtr buffer )
+{
+    _mpiChannel->broadcastNonblocking( type, buffer );
+}
+
+void MasterToWallChannel::_route( deflect::FramePtr frame,
+                                  const std::vector<bool>& changed )
+{
+    // The router keeps the complete frame to resend it if windows move, and
+    // marks the unchanged segments only for the processes which have them
+    const std::vector<deflect::FramePtr> frames =
+            _router->route( frame, changed );
+
+    // Serialize only once the frames shared by several processes. Processes
+    // missing from the configuration receive all the changed segments.
+    const deflect::FramePtr completeFrame =
+            SegmentChangeTracker::removeUnchanged( frame, changed );
+    std::map<deflect::Frame*, SerializeBufferPtr> serialized;
+    std::vector<SerializeBufferPtr> data( _mpiChannel->getSize( ));
+    for( size_t rank = 1; rank < data.size(); ++rank )
+    {
+        const deflect::FramePtr& routedFrame =
+                rank <= frames.size() ? frames[rank-1] : completeFrame;
+
+        SerializeBufferPtr& buffer = serialized[routedFrame.get()];
+        if( !buffer )
+        {
+            buffer = _bufferPool.acquire();
+            FrameSerializer::write( *routedFrame, *buffer );
+        }
+        data[rank] = buffer;
+    }
+    _mpiChannel->broadcastNonblocking( MPI_MESSAGE_TYPE_PIXELSTREAM_ROUTED,
+                                       SerializeBufferPtr( ));
+    _mpiChannel->scatter( MPI_MESSAGE_TYPE_PIXELSTREAM_ROUTED, data );
+}
+
+// cppcheck-suppress passedByValue
+void MasterToWallChannel::_resend( const QString uri )
 {
-    _mpiChannel->broadcast( type, data );
+    deflect::FramePtr frame = _router->getLastFrame( uri );
+    if( frame )
+        _route( frame );
 }
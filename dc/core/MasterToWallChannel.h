@@ -41,10 +41,17 @@
 #define MASTERTOWALLCHANNEL_H
 
 #include "types.h"
+#include "DisplayGroupDeltaBuilder.h"
 #include "MPIHeader.h"
-#include "SerializeBuffer.h"
+#include "SerializeBufferPool.h"
 
 #include <QObject>
+#include <QRect>
+
+#include <boost/scoped_ptr.hpp>
+
+class PixelStreamRouter;
+class SegmentChangeTracker;
 
 /**
  * Sending channel from the master application to the wall processes.
@@ -53,15 +60,18 @@
  *
  * The methods in this class are NOT thread-safe.
  *
- * The send() functions are fully synchronous and rely on Qt::QueuedConnection
- * for safe inter-thread communication.
+ * The send() functions serialize the object and start a nonblocking broadcast
+ * in the MasterToWallChannel's thread. They rely on Qt::QueuedConnection
+ * for safe inter-thread communication. Pixel stream frames are written with
+ * the FrameSerializer, so that the wall processes can use their image data in
+ * place.
  *
  * The sendAsync() functions are a workaround for objects that cannot be passed
  * by copy and also cannot provide a thread-safe serialize() function.
  * They can be called directly from the main thread (Qt::DirectConnection).
- * The given object is serialized synchronously (in the calling thread), then
- * the serialized data is sent asynchronously in the MasterToWallChannel's
- * thread.
+ * The given object is serialized synchronously (in the calling thread) into a
+ * pooled buffer, which is then handed over without copy to the
+ * MasterToWallChannel's thread to be sent asynchronously.
  */
 class MasterToWallChannel : public QObject
 {
@@ -71,9 +81,33 @@ public:
     /** Constructor */
     MasterToWallChannel( MPIChannelPtr mpiChannel );
 
+    /** Destructor */
+    ~MasterToWallChannel();
+
+    /**
+     * Send pixel stream segments only to the wall processes that display them.
+     *
+     * Must be called before the channel is moved to its thread.
+     * @param wallProcessAreas The area covered by each wall process
+     * @see MasterConfiguration::getWallProcessAreas()
+     */
+    void enablePixelStreamRouting( const std::vector<QRect>& wallProcessAreas );
+
+    /**
+     * Send pixel stream segments without their image data if it has not
+     * changed since the previous frame of the stream.
+     *
+     * Must be called before the channel is moved to its thread.
+     * @see SegmentChangeTracker
+     */
+    void enableSegmentChangeTracking();
+
 public slots:
     /**
      * Send the given DisplayGroup to the wall processes.
+     *
+     * Only the changes since the previous call are sent, with a periodic full
+     * snapshot of the DisplayGroup.
      * @param displayGroup The DisplayGroup to send
      */
     void sendAsync( DisplayGroupPtr displayGroup );
@@ -92,12 +126,34 @@ public slots:
 
     /**
      * Send pixel stream frame to the wall processes.
+     *
+     * If routing is enabled, each process only receives the image data of the
+     * segments which are visible on its screens. If change tracking is
+     * enabled, the unchanged segments are sent without image data to the
+     * processes which already have it.
      * @param frame The frame to send
      */
     void send( deflect::FramePtr frame );
 
+    /**
+     * Notify that a pixel stream was closed, so that the first frame of a new
+     * stream with the same uri is sent completely.
+     * @param uri The identifier of the stream
+     */
+    void closePixelStream( QString uri );
+
+    /**
+     * Request the profiling events of all the wall processes.
+     *
+     * Each process replies with a PROFILE message to the master.
+     * @see MasterFromWallChannel::receivedProfile()
+     */
+    void sendRequestProfile();
+
     /**
      * Send quit message to the wall processes, terminating the application.
+     *
+     * Returns once all the pending broadcasts are completed.
      */
     void sendQuit();
 
@@ -105,16 +161,19 @@ private:
     Q_DISABLE_COPY( MasterToWallChannel )
 
     MPIChannelPtr _mpiChannel;
-    SerializeBuffer _buffer;
-    SerializeBuffer _asyncBuffer;
+    SerializeBufferPool _bufferPool;
+    DisplayGroupDeltaBuilder _deltaBuilder;
+    boost::scoped_ptr<PixelStreamRouter> _router;
+    boost::scoped_ptr<SegmentChangeTracker> _changeTracker;
 
-    template< typename T >
-    void broadcast( const T& object, const MPIMessageType type );
     template< typename T >
     void broadcastAsync( const T& object, const MPIMessageType type );
 
 private slots:
-    void _broadcast( MPIMessageType type, std::string data );
+    void _broadcast( MPIMessageType type, SerializeBufferPtr buffer );
+    void _route( deflect::FramePtr frame,
+                 const std::vector<bool>& changed = std::vector<bool>( ));
+    void _resend( QString uri );
 };
 
 #endif // MASTERTOWALLCHANNEL_H
@@ -0,0 +1,167 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#include "MasterToWallMailbox.h"
+
+#include <algorithm>
+
+MasterToWallMailbox::MasterToWallMailbox()
+    : _minIntervalMs( 0 )
+{
+    _flushTimer.setSingleShot( true );
+    connect( &_flushTimer, &QTimer::timeout,
+             this, &MasterToWallMailbox::flush );
+}
+
+void MasterToWallMailbox::setMaxSendRate( const unsigned int rate )
+{
+    _minIntervalMs = rate > 0 ? 1000 / rate : 0;
+}
+
+size_t MasterToWallMailbox::getPostedCount( const MPIMessageType type ) const
+{
+    const auto it = _counters.find( type );
+    return it != _counters.end() ? it->second.posted : 0;
+}
+
+size_t MasterToWallMailbox::getSentCount( const MPIMessageType type ) const
+{
+    const auto it = _counters.find( type );
+    return it != _counters.end() ? it->second.sent : 0;
+}
+
+size_t MasterToWallMailbox::getCoalescedCount( const MPIMessageType type ) const
+{
+    // The update still waiting to be sent is not dropped yet
+    const size_t pending = _isPending( type ) ? 1 : 0;
+    return getPostedCount( type ) - getSentCount( type ) - pending;
+}
+
+bool MasterToWallMailbox::hasPendingUpdates() const
+{
+    return _displayGroup || _options || _markers;
+}
+
+QString MasterToWallMailbox::getStatistics() const
+{
+    QString stats( "updates sent / posted:" );
+    stats.append( QString( " displaygroup %1 / %2," )
+                  .arg( getSentCount( MPI_MESSAGE_TYPE_DISPLAYGROUP ))
+                  .arg( getPostedCount( MPI_MESSAGE_TYPE_DISPLAYGROUP )));
+    stats.append( QString( " options %1 / %2," )
+                  .arg( getSentCount( MPI_MESSAGE_TYPE_OPTIONS ))
+                  .arg( getPostedCount( MPI_MESSAGE_TYPE_OPTIONS )));
+    stats.append( QString( " markers %1 / %2" )
+                  .arg( getSentCount( MPI_MESSAGE_TYPE_MARKERS ))
+                  .arg( getPostedCount( MPI_MESSAGE_TYPE_MARKERS )));
+    return stats;
+}
+
+void MasterToWallMailbox::post( DisplayGroupPtr displayGroup )
+{
+    _displayGroup = displayGroup;
+    _schedule( MPI_MESSAGE_TYPE_DISPLAYGROUP );
+}
+
+void MasterToWallMailbox::post( OptionsPtr options )
+{
+    _options = options;
+    _schedule( MPI_MESSAGE_TYPE_OPTIONS );
+}
+
+void MasterToWallMailbox::post( MarkersPtr markers )
+{
+    _markers = markers;
+    _schedule( MPI_MESSAGE_TYPE_MARKERS );
+}
+
+void MasterToWallMailbox::flush()
+{
+    _flushTimer.stop();
+    _lastFlush.start();
+
+    // Reset the slots before emitting, a receiver may post a new update
+    if( _displayGroup )
+    {
+        DisplayGroupPtr displayGroup;
+        displayGroup.swap( _displayGroup );
+        ++_counters[MPI_MESSAGE_TYPE_DISPLAYGROUP].sent;
+        emit sendDisplayGroup( displayGroup );
+    }
+    if( _options )
+    {
+        OptionsPtr options;
+        options.swap( _options );
+        ++_counters[MPI_MESSAGE_TYPE_OPTIONS].sent;
+        emit sendOptions( options );
+    }
+    if( _markers )
+    {
+        MarkersPtr markers;
+        markers.swap( _markers );
+        ++_counters[MPI_MESSAGE_TYPE_MARKERS].sent;
+        emit sendMarkers( markers );
+    }
+}
+
+bool MasterToWallMailbox::_isPending( const MPIMessageType type ) const
+{
+    switch( type )
+    {
+    case MPI_MESSAGE_TYPE_DISPLAYGROUP:
+        return !!_displayGroup;
+    case MPI_MESSAGE_TYPE_OPTIONS:
+        return !!_options;
+    case MPI_MESSAGE_TYPE_MARKERS:
+        return !!_markers;
+    default:
+        return false;
+    }
+}
+
+void MasterToWallMailbox::_schedule( const MPIMessageType type )
+{
+    ++_counters[type].posted;
+
+    if( _flushTimer.isActive( ))
+        return;
+
+    int delay = 0;
+    if( _minIntervalMs > 0 && _lastFlush.isValid( ))
+        delay = std::max( 0, _minIntervalMs - int( _lastFlush.elapsed( )));
+    _flushTimer.start( delay );
+}
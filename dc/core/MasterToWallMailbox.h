@@ -0,0 +1,143 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#ifndef MASTERTOWALLMAILBOX_H
+#define MASTERTOWALLMAILBOX_H
+
+#include "types.h"
+#include "MPIHeader.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <map>
+
+/**
+ * Coalesce the updates of the DisplayGroup, Options and Markers before they
+ * are sent to the wall processes.
+ *
+ * Each message type has a latest-value-wins slot: posting an update only
+ * records it and arms a single flush, which happens on the next pass of the
+ * event loop or later if a maximum send rate is set. Intermediate states
+ * posted in the meantime are dropped and only the most recent state of each
+ * object is serialized and sent.
+ *
+ * This class lives in the main thread, like the objects it sends, which are
+ * not thread-safe and must be serialized there.
+ */
+class MasterToWallMailbox : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Constructor. */
+    MasterToWallMailbox();
+
+    /**
+     * Limit the rate at which each object is sent to the wall processes.
+     *
+     * Sending faster than the walls render only produces states that will be
+     * skipped, so this is typically set to the wall frame rate.
+     * @param rate The maximum rate in Hz, 0 to flush on every pass of the
+     *        event loop
+     */
+    void setMaxSendRate( unsigned int rate );
+
+    /** @return the number of updates posted for the given type. */
+    size_t getPostedCount( MPIMessageType type ) const;
+
+    /** @return the number of updates actually sent for the given type. */
+    size_t getSentCount( MPIMessageType type ) const;
+
+    /** @return the number of updates dropped for the given type. */
+    size_t getCoalescedCount( MPIMessageType type ) const;
+
+    /** @return true if updates are waiting to be sent. */
+    bool hasPendingUpdates() const;
+
+    /** @return a summary of the posted / sent counters. */
+    QString getStatistics() const;
+
+public slots:
+    /** Post a new state of the DisplayGroup. */
+    void post( DisplayGroupPtr displayGroup );
+
+    /** Post a new state of the Options. */
+    void post( OptionsPtr options );
+
+    /** Post a new state of the Markers. */
+    void post( MarkersPtr markers );
+
+    /** Send all pending updates immediately. */
+    void flush();
+
+signals:
+    /** Emitted by flush() with the latest state of the DisplayGroup. */
+    void sendDisplayGroup( DisplayGroupPtr displayGroup );
+
+    /** Emitted by flush() with the latest state of the Options. */
+    void sendOptions( OptionsPtr options );
+
+    /** Emitted by flush() with the latest state of the Markers. */
+    void sendMarkers( MarkersPtr markers );
+
+private:
+    Q_DISABLE_COPY( MasterToWallMailbox )
+
+    struct Counters
+    {
+        Counters() : posted( 0 ), sent( 0 ) {}
+        size_t posted;
+        size_t sent;
+    };
+
+    DisplayGroupPtr _displayGroup;
+    OptionsPtr _options;
+    MarkersPtr _markers;
+
+    std::map<MPIMessageType, Counters> _counters;
+
+    int _minIntervalMs;
+    QTimer _flushTimer;
+    QElapsedTimer _lastFlush;
+
+    bool _isPending( MPIMessageType type ) const;
+    void _schedule( MPIMessageType type );
+};
+
+#endif // MASTERTOWALLMAILBOX_H
@@ -42,6 +42,7 @@
 
 #include "ContentWindow.h"
 #include "MPIHeader.h"
+#include "Profiler.h"
 
 #include <QMetaType>
 
@@ -55,11 +56,14 @@ struct MetaTypeRegistration
         qRegisterMetaType< OptionsPtr >( "OptionsPtr" );
         qRegisterMetaType< MarkersPtr >( "MarkersPtr" );
         qRegisterMetaType< DisplayGroupPtr >( "DisplayGroupPtr" );
+        qRegisterMetaType< DisplayGroupDeltaPtr >( "DisplayGroupDeltaPtr" );
         qRegisterMetaType< ContentWindowPtr >( "ContentWindowPtr" );
         qRegisterMetaType< ContentWindow::WindowState >( "ContentWindow::WindowState" );
         qRegisterMetaType< ContentWindow::WindowBorder >( "ContentWindow::WindowBorder" );
         qRegisterMetaType< MPIMessageType >( "MPIMessageType" );
         qRegisterMetaType< std::string >( "std::string" );
+        qRegisterMetaType< SerializeBufferPtr >( "SerializeBufferPtr" );
+        qRegisterMetaType< ProfileEvents >( "ProfileEvents" );
         qRegisterMetaType< QUuid >( "QUuid" );
         qRegisterMetaTypeStreamOperators< QUuid >( "QUuid" );
     }
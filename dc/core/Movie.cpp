@@ -39,15 +39,42 @@
 #include "Movie.h"
 
 #include "log.h"
+#include "geometry.h"
 
 #include "ContentWindow.h"
 #include "FFMPEGMovie.h"
 #include "FFMPEGFrame.h"
 #include "MovieContent.h"
+#include "MovieDecoderCache.h"
+#include "SharedMovieDecoder.h"
+#include "SwapSyncRegistry.h"
 #include "WallToWallChannel.h"
 
+#include <boost/bind.hpp>
+
+namespace
+{
+// Bits of the leader election value used for the timestamp (in us).
+const unsigned int TIMESTAMP_BITS = 48;
+// Pixels converted around the visible region of the movie, for the linear
+// filtering of the texture and to follow small moves of the window.
+const int VISIBLE_REGION_MARGIN = 16;
+}
+
+namespace
+{
+MoviePictureFormat getPictureFormat()
+{
+    // The YUV to RGB conversion is done on the GPU when possible
+    return GLYUVQuad::isSupported() ? MOVIE_PICTURE_YUV : MOVIE_PICTURE_RGBA;
+}
+}
+
 Movie::Movie( const QString& uri )
-    : _ffmpegMovie( new FFMPEGMovie( uri ))
+    : _decoder( MovieDecoderCache::global().getDecoder( uri,
+                                                        getPictureFormat(),
+                                                        0.0 ))
+    , _decoderUser( _decoder->addUser( ))
     , _paused( false )
     , _loop( true )
     , _isVisible( true )
@@ -57,14 +84,15 @@ Movie::Movie( const QString& uri )
     // despite correctly reading metadata on the MasterProcess.
     // bool FFMPEGMovie::openVideoStreamDecoder(): could not open codec
     // error: -11 Resource temporarily unavailable
-    if( !_ffmpegMovie->isValid( ))
+    if( !_getMovie().isValid( ))
         put_flog( LOG_WARN, "Movie is invalid: %s",
                   uri.toLocal8Bit().constData( ));
-    else
-        _ffmpegMovie->startDecoding();
 }
 
-Movie::~Movie() {}
+Movie::~Movie()
+{
+    _decoder->removeUser( _decoderUser );
+}
 
 void Movie::setVisible( const bool isVisible )
 {
@@ -83,52 +111,115 @@ void Movie::setLoop( const bool loop )
 
 void Movie::render()
 {
-    if( !_texture.isValid( ))
-        return;
-
-    _quad.render();
+    if( _yuvQuad.isValid( ))
+    {
+        _yuvQuad.setTexCoords( _zoomRect );
+        _yuvQuad.render();
+    }
+    else if( _texture.isValid( ))
+        _quad.render();
 }
 
 void Movie::renderPreview()
 {
-    if( !_texture.isValid( ))
-        return;
-
-    _previewQuad.render();
+    if( _yuvQuad.isValid( ))
+    {
+        _yuvQuad.setTexCoords( UNIT_RECTF );
+        _yuvQuad.render();
+    }
+    else if( _texture.isValid( ))
+        _previewQuad.render();
 }
 
 void Movie::preRenderUpdate( ContentWindowPtr window, const QRect& wallArea )
 {
-    if( !_ffmpegMovie->isValid( ))
+    if( !_getMovie().isValid( ))
         return;
 
-    if( !_texture.isValid( ))
-    {
+    if( !_texture.isValid() && !_yuvQuad.isValid( ))
         _generateTexture();
-        _quad.setTexture( _texture.getTextureId( ));
-        _previewQuad.setTexture( _texture.getTextureId( ));
-    }
 
-    _quad.setTexCoords( window->getZoomRect( ));
+    const QRectF& zoomRect = window->getZoomRect();
+    _quad.setTexCoords( zoomRect );
+    _zoomRect = zoomRect;
 
     MovieContent& movie = static_cast<MovieContent&>( *window->getContent( ));
     setPause( movie.getControlState() & STATE_PAUSED );
     setLoop( movie.getControlState() & STATE_LOOP );
 
-    setVisible( QRectF( wallArea ).intersects( _qmlItem->getSceneRect( )));
+    const QRectF sceneRect = _qmlItem->getSceneRect();
+    setVisible( QRectF( wallArea ).intersects( sceneRect ));
+
+    _visibleRegion = _getVisibleRegion( sceneRect, zoomRect, wallArea );
+    _decoder->setVisibleRegion( _decoderUser, _visibleRegion );
+}
+
+QRect Movie::_getVisibleRegion( const QRectF& sceneRect,
+                                const QRectF& zoomRect,
+                                const QRectF& wallArea ) const
+{
+    if( zoomRect.isEmpty( ))
+        return QRect();
+
+    // The zoomed part of the movie fills the window
+    const QRectF movieRect(
+                sceneRect.x() - zoomRect.x() / zoomRect.width() *
+                                sceneRect.width(),
+                sceneRect.y() - zoomRect.y() / zoomRect.height() *
+                                sceneRect.height(),
+                sceneRect.width() / zoomRect.width(),
+                sceneRect.height() / zoomRect.height( ));
+
+    const QSize movieSize( _getMovie().getWidth(),
+                           _getMovie().getHeight( ));
+    const QRect region = geometry::getVisibleRegion(
+                             movieSize, movieRect, sceneRect & wallArea );
+    if( region.isEmpty( ))
+        return QRect();
+
+    return region.adjusted( -VISIBLE_REGION_MARGIN, -VISIBLE_REGION_MARGIN,
+                            VISIBLE_REGION_MARGIN, VISIBLE_REGION_MARGIN ) &
+           QRect( QPoint(), movieSize );
 }
 
-void Movie::preRenderSync( WallToWallChannel& wallToWallChannel )
+void Movie::preRenderSync( WallToWallChannel& wallToWallChannel,
+                           SwapSyncRegistry& registry )
 {
-    if( !_ffmpegMovie->isValid( ))
+    if( !_getMovie().isValid( ))
+        return;
+
+    if( _paused )
+    {
+        _updateFrame();
         return;
+    }
+
+    _timer.setCurrentTime( wallToWallChannel.getTime( ));
 
-    if( !_paused )
+    // Elect a leader among processes which have decoded a frame. The highest
+    // candidate rank is in the upper bits, so the maximum across processes
+    // also carries the timestamp of the leader in the lower bits.
+    uint64_t candidate = 0;
+    if( _isVisible )
     {
-        _updateTimestamp( wallToWallChannel );
-        _synchronizeTimestamp( wallToWallChannel );
+        const uint64_t rank = wallToWallChannel.getRank() + 1;
+        const uint64_t timestamp = ElapsedTimer::toTimeDuration(
+                                      _sharedTimestamp ).total_microseconds();
+        candidate = ( rank << TIMESTAMP_BITS ) |
+                    ( timestamp & (( uint64_t(1) << TIMESTAMP_BITS ) - 1 ));
     }
+    registry.addValue( candidate, boost::bind( &Movie::_synchronizeTimestamp,
+                                               this, _2 ));
+
+    // Don't increment the timestamp until all the processes have caught up
+    const bool isInSync = _getDelay() <= _getMovie().getFrameDuration();
+    const bool isReady = !_isVisible || isInSync;
+    registry.addValue( isReady ? 1 : 0, boost::bind( &Movie::_updateTimestamp,
+                                                     this, _1 ));
+}
 
+void Movie::_updateFrame()
+{
     if( !_isVisible )
         return;
 
@@ -136,62 +227,127 @@ void Movie::preRenderSync( WallToWallChannel& wallToWallChannel )
     {
         try
         {
-            _texture.update( _futurePicture.get()->getData(), GL_RGBA );
+            // Only the region visible when the frame was decoded is converted
+            const PicturePtr picture = _futurePicture.get();
+            _futurePicture = std::shared_future<PicturePtr>();
+            _pictureRegion = picture->getRegion();
+            if( !_pictureRegion.isEmpty( ))
+                _upload( *picture );
         }
         catch( const std::exception& e )
         {
+            _futurePicture = std::shared_future<PicturePtr>();
             put_flog( LOG_DEBUG, "Future was canceled: ", e.what( ));
         }
     }
 
-    if( _loop && (_ffmpegMovie->isAtEOF( ) ||
-                  _sharedTimestamp > _ffmpegMovie->getDuration( )))
+    if( _loop && (_getMovie().isAtEOF( ) ||
+                  _sharedTimestamp > _getMovie().getDuration( )))
         _sharedTimestamp = 0.0;
 
-    const bool needsFrame = _getDelay() >= _ffmpegMovie->getFrameDuration();
+    const bool needsFrame = _getDelay() >= _getMovie().getFrameDuration();
     if( !_futurePicture.valid() && needsFrame )
-        _futurePicture = _ffmpegMovie->getFrame( _sharedTimestamp );
+    {
+        _followDecoder();
+        _futurePicture = _decoder->getFrame( _decoderUser, _sharedTimestamp );
+    }
+
+    // A paused movie which has moved does not receive new frames, the current
+    // one is converted again for the region which has become visible.
+    if( !_futurePicture.valid() && _paused && !_visibleRegion.isEmpty() &&
+        !_pictureRegion.contains( _visibleRegion ))
+    {
+        _followDecoder();
+        _futurePicture = _decoder->refreshFrame( _decoderUser );
+    }
 }
 
 bool Movie::_generateTexture()
 {
-    QImage image( _ffmpegMovie->getWidth(), _ffmpegMovie->getHeight(),
-                  QImage::Format_RGB32 );
+    const QRect frame( 0, 0, _getMovie().getWidth(),
+                       _getMovie().getHeight( ));
+    const PixelFormat format = _getMovie().getPictureFormat();
+    if( format != PIX_FMT_RGBA )
+    {
+        const QRect chroma = FFMPEGPicture::getPlaneRegion( frame, format, 1 );
+        return _yuvQuad.init( frame.size(), chroma.size( ));
+    }
+
+    QImage image( frame.size(), QImage::Format_RGB32 );
     image.fill( 0 );
 
-    return _texture.init( image );
+    if( !_texture.init( image ))
+        return false;
+
+    _quad.setTexture( _texture.getTextureId( ));
+    _previewQuad.setTexture( _texture.getTextureId( ));
+    return true;
 }
 
-double Movie::_getDelay() const
+void Movie::_upload( const FFMPEGPicture& picture )
+{
+    if( picture.getFormat() == PIX_FMT_RGBA )
+    {
+        if( _texture.isValid( ))
+            _texture.update( picture.getData(), picture.getRegion(), GL_RGBA );
+        return;
+    }
+
+    if( !_yuvQuad.isValid( ))
+        return;
+
+    _yuvQuad.setFullColorRange( picture.hasFullColorRange( ));
+    for( unsigned int i = 0; i < GLYUVQuad::PLANE_COUNT; ++i )
+        _yuvQuad.update( i, picture.getData( i ), picture.getPlaneRegion( i ));
+}
+
+const FFMPEGMovie& Movie::_getMovie() const
 {
-    return fabs( _sharedTimestamp - _ffmpegMovie->getPosition( ));
+    return _decoder->getMovie();
 }
 
-void Movie::_updateTimestamp( WallToWallChannel& wallToWallChannel )
+void Movie::_followDecoder()
 {
-    _timer.setCurrentTime( wallToWallChannel.getTime( ));
+    if( _decoder->isInSync( _decoderUser, _sharedTimestamp ))
+        return;
 
-    // Don't increment the timestamp until all the processes have caught up
-    const bool isInSync = _getDelay() <= _ffmpegMovie->getFrameDuration();
-    if( !wallToWallChannel.allReady( !_isVisible || isInSync ))
+    // This window has diverged from the others playing the movie, it joins
+    // the decoder of other windows at its position or opens a new one
+    SharedMovieDecoderPtr decoder = MovieDecoderCache::global().getDecoder(
+                                        _decoder->getURI(),
+                                        _decoder->getFormat(),
+                                        _sharedTimestamp );
+    if( !decoder->getMovie().isValid( ))
         return;
 
-    _sharedTimestamp += ElapsedTimer::toSeconds( _timer.getElapsedTime( ));
+    _decoder->removeUser( _decoderUser );
+    _decoder = decoder;
+    _decoderUser = _decoder->addUser();
+    _decoder->setVisibleRegion( _decoderUser, _visibleRegion );
 }
 
-void Movie::_synchronizeTimestamp( WallToWallChannel& wallToWallChannel )
+double Movie::_getDelay() const
 {
-    // Elect a leader among processes which have decoded a frame
-    const bool isCandidate = _ffmpegMovie->isValid() && _isVisible;
-    const int leader = wallToWallChannel.electLeader( isCandidate );
+    return fabs( _sharedTimestamp - _getMovie().getPosition( ));
+}
 
-    if( leader < 0 )
+void Movie::_synchronizeTimestamp( const uint64_t leader )
+{
+    if( leader == 0 )
         return;
 
-    if( leader == wallToWallChannel.getRank( ))
-        wallToWallChannel.broadcast( ElapsedTimer::toTimeDuration(
-                                         _sharedTimestamp ));
-    else
-        _sharedTimestamp = ElapsedTimer::toSeconds(
-                         wallToWallChannel.receiveTimestampBroadcast( leader ));
+    const uint64_t timestampMask = ( uint64_t(1) << TIMESTAMP_BITS ) - 1;
+    const uint64_t timestamp = leader & timestampMask;
+    _sharedTimestamp = ElapsedTimer::toSeconds(
+                           boost::posix_time::microseconds( timestamp ));
+}
+
+void Movie::_updateTimestamp( const uint64_t allReady )
+{
+    // The elapsed time is the same on all processes, since their timers
+    // follow the synchronized clock.
+    if( allReady )
+        _sharedTimestamp += ElapsedTimer::toSeconds( _timer.getElapsedTime( ));
+
+    _updateFrame();
 }
@@ -43,12 +43,11 @@
 
 #include "GLTexture2D.h"
 #include "GLQuad.h"
+#include "GLYUVQuad.h"
 #include "ElapsedTimer.h"
 
 #include <future>
 
-class FFMPEGMovie;
-
 class Movie : public WallContent
 {
 public:
@@ -61,31 +60,49 @@ public:
     void setLoop( bool loop );
 
 private:
-    std::unique_ptr<FFMPEGMovie> _ffmpegMovie;
+    // The decoder may be shared with other windows playing the movie in sync
+    SharedMovieDecoderPtr _decoder;
+    unsigned int _decoderUser;
 
     GLTexture2D _texture;
     GLQuad _quad;
     GLQuad _previewQuad;
 
+    // Renders the YUV pictures, if the shader is supported
+    GLYUVQuad _yuvQuad;
+    QRectF _zoomRect;
+
     bool _paused;
     bool _loop;
     bool _isVisible;
 
     ElapsedTimer _timer;
     double _sharedTimestamp;
-    std::future<PicturePtr> _futurePicture;
+    std::shared_future<PicturePtr> _futurePicture;
+
+    // The region of the movie visible on this process and the region of the
+    // picture in the texture, in movie pixel coordinates
+    QRect _visibleRegion;
+    QRect _pictureRegion;
 
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
                           const QRect& wallArea ) override;
-    void preRenderSync( WallToWallChannel& wallToWallChannel ) override;
+    void preRenderSync( WallToWallChannel& wallToWallChannel,
+                        SwapSyncRegistry& registry ) override;
 
     bool _generateTexture();
+    void _upload( const FFMPEGPicture& picture );
+    QRect _getVisibleRegion( const QRectF& sceneRect, const QRectF& zoomRect,
+                             const QRectF& wallArea ) const;
 
+    const FFMPEGMovie& _getMovie() const;
+    void _followDecoder();
     double _getDelay() const;
-    void _updateTimestamp( WallToWallChannel& wallToWallChannel );
-    void _synchronizeTimestamp( WallToWallChannel& wallToWallChannel );
+    void _synchronizeTimestamp( uint64_t leader );
+    void _updateTimestamp( uint64_t allReady );
+    void _updateFrame();
     void _rewind();
 };
 
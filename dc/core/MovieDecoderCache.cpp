@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "MovieDecoderCache.h"
+
+#include "SharedMovieDecoder.h"
+
+#include <algorithm>
+
+namespace
+{
+bool isClosed( const std::weak_ptr<SharedMovieDecoder>& decoder )
+{
+    return decoder.expired();
+}
+}
+
+MovieDecoderCache::MovieDecoderCache() {}
+
+SharedMovieDecoderPtr
+MovieDecoderCache::getDecoder( const QString& uri,
+                               const MoviePictureFormat format,
+                               const double position )
+{
+    _purge();
+
+    Decoders& decoders = _decoders[uri];
+    for( const auto& weakDecoder : decoders )
+    {
+        SharedMovieDecoderPtr decoder = weakDecoder.lock();
+        if( decoder && decoder->getFormat() == format &&
+            decoder->getMovie().isValid() &&
+            decoder->getFrameIndex() == decoder->getFrameIndex( position ))
+        {
+            return decoder;
+        }
+    }
+
+    auto decoder = std::make_shared<SharedMovieDecoder>( uri, format,
+                                                         position );
+    // Opening a movie may fail on wall processes (see Movie), a later
+    // attempt opens a new decoder instead of reusing this one
+    if( decoder->getMovie().isValid( ))
+        decoders.push_back( decoder );
+    return decoder;
+}
+
+size_t MovieDecoderCache::getDecoderCount() const
+{
+    size_t count = 0;
+    for( const auto& decoders : _decoders )
+        count += decoders.second.size() -
+                 std::count_if( decoders.second.begin(),
+                                decoders.second.end(), isClosed );
+    return count;
+}
+
+MovieDecoderCache& MovieDecoderCache::global()
+{
+    static MovieDecoderCache cache;
+    return cache;
+}
+
+void MovieDecoderCache::_purge()
+{
+    for( auto it = _decoders.begin(); it != _decoders.end(); )
+    {
+        Decoders& decoders = it->second;
+        decoders.erase( std::remove_if( decoders.begin(), decoders.end(),
+                                        isClosed ), decoders.end( ));
+        if( decoders.empty( ))
+            it = _decoders.erase( it );
+        else
+            ++it;
+    }
+}
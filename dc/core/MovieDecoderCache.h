@@ -0,0 +1,96 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef MOVIEDECODERCACHE_H
+#define MOVIEDECODERCACHE_H
+
+#include "types.h"
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Share the movie decoders of a process among the windows playing the same
+ * files.
+ *
+ * The decoders are looked up by file and frame, so that windows opened at the
+ * same position share a decoder, and a window which diverges from the others
+ * either joins another decoder at its position or opens a new one. The number
+ * of decoders and decoding threads thus follows the number of distinct
+ * streams played rather than the number of windows.
+ *
+ * The decoders are closed when the last window using them releases them.
+ * Like the decoders, the cache is meant to be used from the render thread.
+ */
+class MovieDecoderCache : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    MovieDecoderCache();
+
+    /**
+     * Get a decoder for a movie at the given position.
+     * @param uri The movie file
+     * @param format The format of the decoded pictures
+     * @param position The playback position in seconds
+     * @return a decoder of the file at the same frame, or a new decoder
+     */
+    SharedMovieDecoderPtr getDecoder( const QString& uri,
+                                      MoviePictureFormat format,
+                                      double position );
+
+    /** @return the number of open decoders. */
+    size_t getDecoderCount() const;
+
+    /** @return the cache of the process. */
+    static MovieDecoderCache& global();
+
+private:
+    typedef std::vector<std::weak_ptr<SharedMovieDecoder>> Decoders;
+
+    std::map<QString, Decoders> _decoders;
+
+    void _purge();
+};
+
+#endif // MOVIEDECODERCACHE_H
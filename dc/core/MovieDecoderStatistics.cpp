@@ -0,0 +1,102 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "MovieDecoderStatistics.h"
+
+#include "Profiler.h"
+
+namespace
+{
+const int64_t STATISTICS_WINDOW_US = 1000000;
+}
+
+MovieDecoderStatistics::MovieDecoderStatistics( const QString& name,
+                                                const unsigned int threads )
+    : _name( name )
+    , _threads( threads )
+    , _windowStart( Profiler::now( ))
+    , _windowFrames( 0 )
+    , _windowLatency( 0 )
+    , _lastFrameTime( _windowStart )
+    , _fps( 0.0 )
+    , _latency( 0.0 )
+{
+}
+
+void MovieDecoderStatistics::recordFrame( const int64_t submitTime,
+                                          const int64_t decodeTime )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    ++_windowFrames;
+    _windowLatency += decodeTime - submitTime;
+    _lastFrameTime = decodeTime;
+
+    const int64_t elapsed = decodeTime - _windowStart;
+    if( elapsed < STATISTICS_WINDOW_US )
+        return;
+
+    _fps = _windowFrames * 1000000.0 / elapsed;
+    _latency = _windowLatency / 1000.0 / _windowFrames;
+    _windowStart = decodeTime;
+    _windowFrames = 0;
+    _windowLatency = 0;
+}
+
+double MovieDecoderStatistics::getFps() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    // Nothing was decoded since the last measure, e.g. the movie is paused
+    if( Profiler::now() - _lastFrameTime > 2 * STATISTICS_WINDOW_US )
+        return 0.0;
+    return _fps;
+}
+
+double MovieDecoderStatistics::getLatency() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _latency;
+}
+
+QString MovieDecoderStatistics::getStatistics() const
+{
+    return QString( "%1: decoded %2 fps, latency (ms) %3, %4 threads" )
+            .arg( _name )
+            .arg( getFps(), 0, 'f', 1 )
+            .arg( getLatency(), 0, 'f', 1 )
+            .arg( _threads );
+}
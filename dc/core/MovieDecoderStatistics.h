@@ -0,0 +1,96 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef MOVIEDECODERSTATISTICS_H
+#define MOVIEDECODERSTATISTICS_H
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <stdint.h>
+
+/**
+ * Measure the decoding rate and latency of a movie.
+ *
+ * The decoding thread of the movie records each decoded frame, the render
+ * thread reads the measures of the last second. All methods of this class are
+ * thread-safe.
+ */
+class MovieDecoderStatistics : public boost::noncopyable
+{
+public:
+    /**
+     * Constructor.
+     * @param name The name of the movie
+     * @param threads The number of threads of the decoder
+     */
+    MovieDecoderStatistics( const QString& name, unsigned int threads );
+
+    /**
+     * Record a decoded frame.
+     * @param submitTime The time at which the packet of the frame was given
+     *        to the decoder, from Profiler::now()
+     * @param decodeTime The time at which the frame came out of the decoder
+     */
+    void recordFrame( int64_t submitTime, int64_t decodeTime );
+
+    /** @return the number of frames decoded per second. */
+    double getFps() const;
+
+    /** @return the average decoding latency of the frames in ms. */
+    double getLatency() const;
+
+    /** @return a summary of the measures. */
+    QString getStatistics() const;
+
+private:
+    const QString _name;
+    const unsigned int _threads;
+
+    mutable std::mutex _mutex;
+    int64_t _windowStart;
+    uint64_t _windowFrames;
+    int64_t _windowLatency;
+    int64_t _lastFrameTime;
+    double _fps;
+    double _latency;
+};
+
+#endif // MOVIEDECODERSTATISTICS_H
@@ -0,0 +1,106 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "MovieDecoderUsers.h"
+
+MovieDecoderUsers::MovieDecoderUsers( const int64_t frameIndex )
+    : _nextUser( 0 )
+    , _frameIndex( frameIndex )
+{
+}
+
+unsigned int MovieDecoderUsers::add()
+{
+    const unsigned int user = _nextUser++;
+    _users[user] = User();
+    return user;
+}
+
+void MovieDecoderUsers::remove( const unsigned int user )
+{
+    _users.erase( user );
+}
+
+size_t MovieDecoderUsers::getCount() const
+{
+    return _users.size();
+}
+
+int64_t MovieDecoderUsers::getFrameIndex() const
+{
+    return _frameIndex;
+}
+
+bool MovieDecoderUsers::isInSync( const unsigned int user,
+                                  const int64_t frameIndex ) const
+{
+    if( _users.size() <= 1 || frameIndex == _frameIndex )
+        return true;
+
+    // Only a user which has caught up with the decoder may move it
+    const auto it = _users.find( user );
+    return it != _users.end() && it->second.frameIndex == _frameIndex;
+}
+
+bool MovieDecoderUsers::request( const unsigned int user,
+                                 const int64_t frameIndex )
+{
+    User& requester = _users[user];
+
+    // A user which requests the same frame again did not get it in time,
+    // for instance because another frame was requested meanwhile
+    const bool decode = frameIndex != _frameIndex ||
+                        requester.frameIndex == frameIndex;
+    requester.frameIndex = frameIndex;
+    _frameIndex = frameIndex;
+    return decode;
+}
+
+void MovieDecoderUsers::setVisibleRegion( const unsigned int user,
+                                          const QRect& region )
+{
+    _users[user].visibleRegion = region;
+}
+
+QRect MovieDecoderUsers::getVisibleRegion() const
+{
+    QRect region;
+    for( const auto& user : _users )
+        region |= user.second.visibleRegion;
+    return region;
+}
@@ -0,0 +1,117 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef MOVIEDECODERUSERS_H
+#define MOVIEDECODERUSERS_H
+
+#include <QRect>
+
+#include <map>
+
+#include <stdint.h>
+
+/**
+ * Follow the windows which share the decoder of a movie.
+ *
+ * The windows which play a movie in sync request the same sequence of frames.
+ * Any of them which has requested the current frame of the decoder may lead
+ * it to another frame, which the others then get without decoding it again.
+ * A window which requests another frame before having caught up with the
+ * current one has diverged from the others and needs a decoder of its own.
+ */
+class MovieDecoderUsers
+{
+public:
+    /**
+     * Constructor.
+     * @param frameIndex The initial frame of the decoder
+     */
+    explicit MovieDecoderUsers( int64_t frameIndex );
+
+    /**
+     * Add a user, which has not requested any frame yet.
+     * @return the identifier of the user
+     */
+    unsigned int add();
+
+    /** Remove a user. */
+    void remove( unsigned int user );
+
+    /** @return the number of users. */
+    size_t getCount() const;
+
+    /** @return the frame that the decoder was last requested to decode. */
+    int64_t getFrameIndex() const;
+
+    /**
+     * Check if a user can request a frame without disturbing the others.
+     * @param user The identifier of the user
+     * @param frameIndex The frame to request
+     * @return true if the frame can be requested from the shared decoder
+     */
+    bool isInSync( unsigned int user, int64_t frameIndex ) const;
+
+    /**
+     * Record the request of a frame by a user.
+     * @param user The identifier of the user
+     * @param frameIndex The frame requested
+     * @return true if the frame has to be decoded, false if the one decoded
+     *         for another user can be shared
+     */
+    bool request( unsigned int user, int64_t frameIndex );
+
+    /** Set the region of the movie visible to a user, in frame pixels. */
+    void setVisibleRegion( unsigned int user, const QRect& region );
+
+    /** @return the region covering the visible regions of all the users. */
+    QRect getVisibleRegion() const;
+
+private:
+    struct User
+    {
+        User() : frameIndex( -1 ) {}
+
+        int64_t frameIndex; // The last frame requested, -1 if none
+        QRect visibleRegion;
+    };
+    std::map<unsigned int, User> _users;
+    unsigned int _nextUser;
+    int64_t _frameIndex;
+};
+
+#endif // MOVIEDECODERUSERS_H
@@ -0,0 +1,134 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "MovieStatistics.h"
+
+#include "MovieDecoderStatistics.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+namespace
+{
+bool isClosed( const std::weak_ptr<MovieDecoderStatistics>& decoder )
+{
+    return decoder.expired();
+}
+}
+
+MovieStatistics::MovieStatistics()
+    : _convertedPixels( 0 )
+    , _decodedPixels( 0 )
+    , _frameStartConverted( 0 )
+    , _frameStartDecoded( 0 )
+    , _frameConverted( 0 )
+    , _frameDecoded( 0 )
+{
+}
+
+void MovieStatistics::recordConversion( const uint64_t convertedPixels,
+                                        const uint64_t framePixels )
+{
+    _convertedPixels.fetch_add( convertedPixels, std::memory_order_relaxed );
+    _decodedPixels.fetch_add( framePixels, std::memory_order_relaxed );
+}
+
+void MovieStatistics::endFrame()
+{
+    const uint64_t converted =
+            _convertedPixels.load( std::memory_order_relaxed );
+    const uint64_t decoded = _decodedPixels.load( std::memory_order_relaxed );
+
+    _frameConverted = converted - _frameStartConverted;
+    _frameDecoded = decoded - _frameStartDecoded;
+    _frameStartConverted = converted;
+    _frameStartDecoded = decoded;
+}
+
+uint64_t MovieStatistics::getFrameConvertedPixels() const
+{
+    return _frameConverted;
+}
+
+uint64_t MovieStatistics::getFrameDecodedPixels() const
+{
+    return _frameDecoded;
+}
+
+QString MovieStatistics::getStatistics() const
+{
+    const double ratio = _frameDecoded > 0 ?
+                100.0 * _frameConverted / _frameDecoded : 0.0;
+    return QString( "movies: converted %1 Mpixels per frame (%2% of decoded)" )
+            .arg( _frameConverted / 1000000.0, 0, 'f', 2 )
+            .arg( ratio, 0, 'f', 0 );
+}
+
+std::shared_ptr<MovieDecoderStatistics>
+MovieStatistics::addDecoder( const QString& name, const unsigned int threads )
+{
+    auto decoder = std::make_shared<MovieDecoderStatistics>( name, threads );
+
+    std::lock_guard<std::mutex> lock( _decodersMutex );
+    _decoders.push_back( decoder );
+    return decoder;
+}
+
+QString MovieStatistics::getDecoderStatistics() const
+{
+    std::lock_guard<std::mutex> lock( _decodersMutex );
+
+    // The statistics of the closed decoders are forgotten
+    _decoders.erase( std::remove_if( _decoders.begin(), _decoders.end(),
+                                     isClosed ), _decoders.end( ));
+
+    QStringList statistics;
+    for( const auto& decoder : _decoders )
+    {
+        if( const auto stats = decoder.lock( ))
+            statistics.append( stats->getStatistics( ));
+    }
+    return statistics.join( '\n' );
+}
+
+MovieStatistics& MovieStatistics::global()
+{
+    static MovieStatistics statistics;
+    return statistics;
+}
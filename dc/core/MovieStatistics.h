@@ -0,0 +1,115 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef MOVIESTATISTICS_H
+#define MOVIESTATISTICS_H
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+class MovieDecoderStatistics;
+
+/**
+ * Count the work done by the movies of a process.
+ *
+ * The decoding threads of the movies record their conversions from any thread
+ * with atomic increments. The render loop concludes each frame with
+ * endFrame(), which keeps the counts of the work done since the previous one.
+ */
+class MovieStatistics : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    MovieStatistics();
+
+    /**
+     * Record the conversion of a decoded frame.
+     * @param convertedPixels The number of pixels converted
+     * @param framePixels The number of pixels of the decoded frame
+     */
+    void recordConversion( uint64_t convertedPixels, uint64_t framePixels );
+
+    /** End the current frame, keeping the counts of its work. */
+    void endFrame();
+
+    /** @return the number of pixels converted during the last frame. */
+    uint64_t getFrameConvertedPixels() const;
+
+    /** @return the number of pixels decoded during the last frame. */
+    uint64_t getFrameDecodedPixels() const;
+
+    /** @return a summary of the work of the last frame. */
+    QString getStatistics() const;
+
+    /**
+     * Create the statistics of a movie decoder.
+     *
+     * The statistics are listed by getDecoderStatistics() until they are
+     * destroyed.
+     * @param name The name of the movie
+     * @param threads The number of threads of the decoder
+     */
+    std::shared_ptr<MovieDecoderStatistics>
+    addDecoder( const QString& name, unsigned int threads );
+
+    /** @return the statistics of each decoder, one per line. */
+    QString getDecoderStatistics() const;
+
+    /** @return the statistics of the process. */
+    static MovieStatistics& global();
+
+private:
+    std::atomic<uint64_t> _convertedPixels;
+    std::atomic<uint64_t> _decodedPixels;
+    uint64_t _frameStartConverted;
+    uint64_t _frameStartDecoded;
+    uint64_t _frameConverted;
+    uint64_t _frameDecoded;
+
+    mutable std::mutex _decodersMutex;
+    mutable std::vector<std::weak_ptr<MovieDecoderStatistics>> _decoders;
+};
+
+#endif // MOVIESTATISTICS_H
@@ -39,19 +39,63 @@
 #include "PixelStream.h"
 
 #include "ContentWindow.h"
-#include "WallToWallChannel.h"
+#include "SwapSyncRegistry.h"
 #include "log.h"
+#include "geometry.h"
+#include "PixelStreamDecodePool.h"
+#include "PixelStreamSegmentAtlas.h"
 #include "PixelStreamSegmentRenderer.h"
 #include "FpsCounter.h"
+#include "GLTextureUploader.h"
+#include "Profiler.h"
+#include "SegmentChangeTracker.h"
+#include "SegmentRegionDecoder.h"
 
 #include <deflect/Frame.h>
-#include <deflect/SegmentDecoder.h>
 #include <deflect/SegmentParameters.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <boost/make_shared.hpp>
 
+namespace
+{
+const double AVERAGE_WEIGHT = 0.05;
+
+typedef std::vector<deflect::FramePtr> SegmentOwners;
+
+/**
+ * Give the segments marked as unchanged the data of the previous frame, if
+ * both frames have the same layout. Segments which are not routed to this
+ * process keep their null image data.
+ * @return for each segment, true if it reuses the previous data
+ */
+std::vector<bool> reuseImageData( deflect::Segments& segments,
+                                  SegmentOwners& owners,
+                                  const deflect::Segments& previous,
+                                  const SegmentOwners& previousOwners )
+{
+    std::vector<bool> reused( segments.size(), false );
+    if( !SegmentChangeTracker::hasSameLayout( segments, previous ))
+        return reused;
+
+    for( size_t i = 0; i < segments.size(); ++i )
+    {
+        if( !SegmentChangeTracker::isUnchanged( segments[i] ) ||
+            previous[i].imageData.isEmpty( ))
+        {
+            continue;
+        }
+        segments[i].imageData = previous[i].imageData;
+        owners[i] = previousOwners[i];
+        reused[i] = true;
+    }
+    return reused;
+}
+}
+
 // false-positive on qt signals for Q_PROPERTY notifiers
 // cppcheck-suppress uninitMemberVar
 PixelStream::PixelStream( const QString& uri )
@@ -59,22 +103,99 @@ PixelStream::PixelStream( const QString& uri )
     , width_( 0 )
     , height_ ( 0 )
     , buffersSwapped_( false )
+    , frameIndex_( 0 )
+    , lastDecodedFrameIndex_( 0 )
+    , frontBufferReceiveTime_( 0 )
+    , backBufferReceiveTime_( 0 )
+    , receivedFrames_( 0 )
+    , decodedFrames_( 0 )
+    , displayedFrames_( 0 )
+    , droppedFrames_( 0 )
+    , averageLatency_( 0.0 )
+    , swappedSegments_( 0 )
+    , reusedSegments_( 0 )
+    , decodePriority_( 0 )
+    , segmentBatching_( false )
 {
 }
 
 PixelStream::~PixelStream()
 {
+    // The segments being decoded belong to the front buffer and their
+    // output to the decodedRegions_
+    if( decodePool_ )
+        decodePool_->cancel( this );
+    for( DecodedRegion& decoded : decodedRegions_ )
+        unmapPixelBuffer( decoded );
     qDeleteAll( segmentsList_ );
 }
 
-void PixelStream::setNewFrame( deflect::FramePtr frame )
+void PixelStream::setNewFrame( deflect::FramePtr frame,
+                               const int64_t receiveTime )
+{
+    deflect::Segments segments = frame->segments;
+    SegmentOwners owners( segments.size(), frame );
+
+    if( hasPendingFrame( ))
+    {
+        // Segments received as unchanged reuse the data of the frame which is
+        // dropped
+        ++droppedFrames_;
+        reuseImageData( segments, owners, backBuffer_, backOwners_ );
+    }
+
+    backBuffer_.swap( segments );
+    backOwners_.swap( owners );
+    backBufferReceiveTime_ = receiveTime;
+}
+
+bool PixelStream::hasPendingFrame() const
+{
+    return !backBuffer_.empty();
+}
+
+void PixelStream::addReceivedFrame()
+{
+    ++receivedFrames_;
+}
+
+QString PixelStream::getFrameStatistics() const
+{
+    const double reused = swappedSegments_ > 0 ?
+                100.0 * reusedSegments_ / swappedSegments_ : 0.0;
+    return QString( "received %1, decoded %2, displayed %3, dropped %4, "
+                    "latency (ms) %5, reused segments %6%" )
+            .arg( receivedFrames_ ).arg( decodedFrames_ )
+            .arg( displayedFrames_ ).arg( droppedFrames_ )
+            .arg( averageLatency_ / 1000.0, 0, 'f', 1 )
+            .arg( reused, 0, 'f', 0 );
+}
+
+void PixelStream::setDecodePool( PixelStreamDecodePoolPtr pool )
+{
+    if( decodePool_ )
+        decodePool_->cancel( this );
+
+    decodePool_ = pool;
+    if( decodePool_ )
+        decodePool_->setPriority( this, decodePriority_ );
+}
+
+void PixelStream::setDecodePriority( const int priority )
+{
+    decodePriority_ = priority;
+    if( decodePool_ )
+        decodePool_->setPriority( this, decodePriority_ );
+}
+
+void PixelStream::setSegmentBatching( const bool enabled )
 {
-    backBuffer_ = frame->segments;
+    segmentBatching_ = enabled;
 }
 
 QString PixelStream::getStatistics() const
 {
-    return fpsCounter_.toString();
+    return fpsCounter_.toString() + '\n' + getFrameStatistics();
 }
 
 QList<QObject*> PixelStream::getSegments() const
@@ -87,10 +208,25 @@ void PixelStream::render()
     glPushMatrix();
     glScalef( 1.f/(float)width_, 1.f/(float)height_, 0.f );
 
-    BOOST_FOREACH( PixelStreamSegmentRendererPtr renderer, segmentRenderers_ )
+    if( segmentAtlas_ )
     {
-        if( isVisible( renderer->getRect( )))
-            renderer->render();
+        std::vector<size_t> visibleSegments;
+        visibleSegments.reserve( segmentRenderers_.size( ));
+        for( size_t i = 0; i < segmentRenderers_.size(); ++i )
+        {
+            if( isVisible( segmentRenderers_[i]->getRect( )))
+                visibleSegments.push_back( i );
+        }
+        segmentAtlas_->render( visibleSegments );
+    }
+    else
+    {
+        BOOST_FOREACH( PixelStreamSegmentRendererPtr renderer,
+                       segmentRenderers_ )
+        {
+            if( isVisible( renderer->getRect( )))
+                renderer->render();
+        }
     }
 
     glPopMatrix();
@@ -107,9 +243,26 @@ void PixelStream::preRenderUpdate( ContentWindowPtr, const QRect& wallArea )
     wallArea_ = wallArea;
 }
 
-void PixelStream::preRenderSync( WallToWallChannel& wallToWallChannel )
+void PixelStream::preRenderSync( WallToWallChannel&,
+                                 SwapSyncRegistry& registry )
 {
-    if( isDecodingInProgress( wallToWallChannel ))
+    const uint64_t decodedFrameIndex = getDecodedFrameIndex();
+    if( decodedFrameIndex > lastDecodedFrameIndex_ )
+    {
+        decodedFrames_ += decodedFrameIndex - lastDecodedFrameIndex_;
+        lastDecodedFrameIndex_ = decodedFrameIndex;
+    }
+
+    // Each process reports the last frame it has finished decoding, in the
+    // collective shared with the other contents. The minimum is the last frame
+    // decoded by all the processes.
+    registry.addValue( decodedFrameIndex,
+                       boost::bind( &PixelStream::syncFrame, this, _1 ));
+}
+
+void PixelStream::syncFrame( const uint64_t globalDecodedFrameIndex )
+{
+    if( globalDecodedFrameIndex < frameIndex_ )
         return;
 
     // After swapping the buffers, wait until decoding has finished to update
@@ -117,10 +270,17 @@ void PixelStream::preRenderSync( WallToWallChannel& wallToWallChannel )
     if( buffersSwapped_ )
     {
         adjustSegmentRendererCount( frontBuffer_.size( ));
-        updateRenderers( frontBuffer_ );
+        updateSegmentAtlas( frontBuffer_ );
+        updateRenderers( frontBuffer_, updatedSegments_ );
         recomputeDimensions( frontBuffer_ );
         refreshSegmentsList( frontBuffer_ );
         buffersSwapped_ = false;
+
+        const double latency = Profiler::now() - frontBufferReceiveTime_;
+        if( displayedFrames_++ == 0 )
+            averageLatency_ = latency;
+        else
+            averageLatency_ += AVERAGE_WEIGHT * ( latency - averageLatency_ );
     }
 
     // The window may have moved, so always check if some segments have become
@@ -128,41 +288,35 @@ void PixelStream::preRenderSync( WallToWallChannel& wallToWallChannel )
     updateVisibleTextures();
 
     if( !backBuffer_.empty( ))
-    {
         swapBuffers();
-        adjustFrameDecodersCount( frontBuffer_.size( ));
-    }
 
     // The window may have moved, so always check if some segments have become
     // visible to decode them.
     decodeVisibleTextures();
 }
 
-bool PixelStream::isDecodingInProgress( WallToWallChannel& wallToWallChannel )
+uint64_t PixelStream::getDecodedFrameIndex() const
 {
-    // determine if threads are running on any processes for this PixelStream
-    int localThreadsRunning = 0;
-
-    std::vector<PixelStreamSegmentDecoderPtr>::const_iterator it;
-    for( it = frameDecoders_.begin(); it != frameDecoders_.end(); ++it )
-    {
-        if( (*it)->isRunning( ))
-            ++localThreadsRunning;
-    }
-
-    return wallToWallChannel.globalSum( localThreadsRunning ) > 0;
+    // Segments are only queued for the frame in the front buffer, including
+    // those which become visible after the window has moved.
+    const bool decoding = decodePool_ && decodePool_->getPendingCount( this );
+    return decoding && frameIndex_ > 0 ? frameIndex_ - 1 : frameIndex_;
 }
 
-void PixelStream::updateRenderers( const deflect::Segments& segments )
+void PixelStream::updateRenderers( const deflect::Segments& segments,
+                                   const std::vector<bool>& updatedSegments )
 {
     assert( segmentRenderers_.size() == segments.size( ));
+    assert( updatedSegments.size() == segments.size( ));
 
     for( size_t i=0; i<segments.size(); i++ )
     {
         // The parameters always need to be up to date to determine visibility
         // when rendering.
         segmentRenderers_[i]->setParameters( segments[i].parameters );
-        segmentRenderers_[i]->setTextureNeedsUpdate();
+        // The texture of unchanged segments is kept
+        if( updatedSegments[i] )
+            segmentRenderers_[i]->setTextureNeedsUpdate();
     }
 }
 
@@ -171,9 +325,39 @@ void PixelStream::updateVisibleTextures()
     bool textureWasUpdated = false;
     for( size_t i=0; i<frontBuffer_.size(); ++i )
     {
-        if( segmentRenderers_[i]->textureNeedsUpdate() &&
-            !frontBuffer_[i].parameters.compressed &&
-            isVisible( frontBuffer_[i] ))
+        if( !segmentRenderers_[i]->textureNeedsUpdate() ||
+            !hasImageData( frontBuffer_[i] ) || !isVisible( frontBuffer_[i] ))
+        {
+            continue;
+        }
+
+        if( frontBuffer_[i].parameters.compressed )
+        {
+            // Only the visible region of the segment has been decoded
+            DecodedRegion& decoded = decodedRegions_[i];
+            if( decoded.rect.isEmpty( ))
+                continue;
+
+            // The pixels of a pixel buffer can only be uploaded once, the
+            // region is decoded again if the texture needs another update.
+            if( decoded.buffered && !decoded.buffer )
+            {
+                queuedRegions_[i] = QRect();
+                continue;
+            }
+
+            const char* data = decoded.getData();
+            const QImage textureWrapper( (const uchar*)data,
+                                         decoded.rect.width(),
+                                         decoded.rect.height(),
+                                         QImage::Format_RGB32 );
+
+            segmentRenderers_[i]->updateTexture( textureWrapper,
+                                                 decoded.rect );
+            if( decoded.buffered )
+                unmapPixelBuffer( decoded );
+        }
+        else
         {
             const char* data = frontBuffer_[i].imageData.constData();
             const QImage textureWrapper( (const uchar*)data,
@@ -182,9 +366,8 @@ void PixelStream::updateVisibleTextures()
                                          QImage::Format_RGB32 );
 
             segmentRenderers_[i]->updateTexture( textureWrapper );
-
-            textureWasUpdated = true;
         }
+        textureWasUpdated = true;
     }
 
     if( textureWasUpdated )
@@ -198,8 +381,39 @@ void PixelStream::swapBuffers()
 {
     assert( !backBuffer_.empty( ));
 
-    frontBuffer_ = backBuffer_;
+    // Segments received as unchanged keep the data, decoded region and
+    // texture of the previous frame.
+    const std::vector<bool> reused = reuseImageData( backBuffer_, backOwners_,
+                                                     frontBuffer_,
+                                                     frontOwners_ );
+
+    // The previous frame is not used by the decoder anymore and its storage
+    // can be released, except for the reused segments
+    frontBuffer_.swap( backBuffer_ );
     backBuffer_.clear();
+    frontOwners_.swap( backOwners_ );
+    backOwners_.clear();
+    frontBufferReceiveTime_ = backBufferReceiveTime_;
+    ++frameIndex_;
+
+    // Nothing is being decoded, the regions of the new segments can be reset.
+    // Their image data is kept to be reused by the decoder.
+    updatedSegments_.resize( frontBuffer_.size( ));
+    for( size_t i = frontBuffer_.size(); i < decodedRegions_.size(); ++i )
+        unmapPixelBuffer( decodedRegions_[i] );
+    decodedRegions_.resize( frontBuffer_.size( ));
+    queuedRegions_.resize( frontBuffer_.size( ));
+    for( size_t i = 0; i < frontBuffer_.size(); ++i )
+    {
+        updatedSegments_[i] = !reused[i];
+        if( reused[i] )
+            continue;
+        decodedRegions_[i].rect = QRect();
+        queuedRegions_[i] = QRect();
+    }
+
+    swappedSegments_ += frontBuffer_.size();
+    reusedSegments_ += std::count( reused.begin(), reused.end(), true );
 
     buffersSwapped_ = true;
 }
@@ -219,24 +433,51 @@ void PixelStream::recomputeDimensions( const deflect::Segments &segments )
 
 void PixelStream::decodeVisibleTextures()
 {
-    assert( frameDecoders_.size() == frontBuffer_.size( ));
+    if( !decodePool_ )
+        return;
 
-    std::vector<PixelStreamSegmentDecoderPtr>::iterator frameDecoder_it = frameDecoders_.begin();
-    deflect::Segments::iterator segment_it = frontBuffer_.begin();
-    for( ; segment_it != frontBuffer_.end(); ++segment_it, ++frameDecoder_it )
+    for( size_t i = 0; i < frontBuffer_.size(); ++i )
     {
-        if( segment_it->parameters.compressed && isVisible( *segment_it ))
-            (*frameDecoder_it)->startDecoding( *segment_it );
+        const deflect::Segment& segment = frontBuffer_[i];
+        if( !segment.parameters.compressed || !hasImageData( segment ))
+            continue;
+
+        // Decode again if the window has moved and the part of the segment
+        // which is visible now has not been decoded.
+        const QRect region = getVisibleRegion( segment );
+        if( region.isEmpty() || queuedRegions_[i].contains( region ))
+            continue;
+
+        mapPixelBuffer( segment, region, decodedRegions_[i] );
+        decodePool_->decode( this, segment, region, decodedRegions_[i] );
+        queuedRegions_[i] = region;
+        if( i < segmentRenderers_.size( ))
+            segmentRenderers_[i]->setTextureNeedsUpdate();
     }
 }
 
-void PixelStream::adjustFrameDecodersCount( const size_t count )
+void PixelStream::mapPixelBuffer( const deflect::Segment& segment,
+                                  const QRect& region, DecodedRegion& output )
+{
+    // Nothing is being decoded for this stream, so the buffer of a previous
+    // decode which was not uploaded can be reused or replaced.
+    const QSize size( segment.parameters.width, segment.parameters.height );
+    const size_t bytes = SegmentRegionDecoder::getMaxOutputSize( size, region );
+    if( output.buffer && output.bufferSize >= bytes )
+        return;
+
+    unmapPixelBuffer( output );
+    output.buffer = (char*)GLTextureUploader::instance().map( bytes );
+    output.bufferSize = output.buffer ? bytes : 0;
+}
+
+void PixelStream::unmapPixelBuffer( DecodedRegion& output )
 {
-    // We need to insert NEW objects in the vector if it is smaller
-    for( size_t i=frameDecoders_.size(); i<count; ++i )
-        frameDecoders_.push_back( boost::make_shared<deflect::SegmentDecoder>( ));
-    // Or resize it if it is bigger
-    frameDecoders_.resize( count );
+    // Does nothing if the buffer has been uploaded
+    if( output.buffer )
+        GLTextureUploader::instance().release( output.buffer );
+    output.buffer = 0;
+    output.bufferSize = 0;
 }
 
 void PixelStream::adjustSegmentRendererCount( const size_t count )
@@ -250,6 +491,29 @@ void PixelStream::adjustSegmentRendererCount( const size_t count )
         segmentRenderers_.push_back( boost::make_shared<PixelStreamSegmentRenderer>( ));
 }
 
+void PixelStream::updateSegmentAtlas( const deflect::Segments& segments )
+{
+    if( segmentBatching_ && segments.size() > 1 )
+    {
+        QSize cellSize;
+        BOOST_FOREACH( const deflect::Segment& segment, segments )
+            cellSize = cellSize.expandedTo( QSize( segment.parameters.width,
+                                                   segment.parameters.height ));
+
+        if( !segmentAtlas_ )
+            segmentAtlas_.reset( new PixelStreamSegmentAtlas );
+
+        // Fall back to one texture per segment if they do not fit
+        if( !segmentAtlas_->resize( cellSize, segments.size( )))
+            segmentAtlas_.reset();
+    }
+    else
+        segmentAtlas_.reset();
+
+    for( size_t i = 0; i < segmentRenderers_.size(); ++i )
+        segmentRenderers_[i]->setAtlasCell( segmentAtlas_.get(), i );
+}
+
 void PixelStream::refreshSegmentsList( const deflect::Segments& segments )
 {
     // Update existing segments
@@ -298,9 +562,24 @@ bool PixelStream::isVisible( const QRect& segment ) const
     return wallArea_.intersects( getSceneCoordinates( segment ));
 }
 
+bool PixelStream::hasImageData( const deflect::Segment& segment ) const
+{
+    // Segments routed to other processes only carry their parameters
+    return !segment.imageData.isEmpty();
+}
+
 bool PixelStream::isVisible( const deflect::Segment& segment ) const
 {
     const deflect::SegmentParameters& param = segment.parameters;
     return isVisible( QRect( param.x, param.y, param.width, param.height ));
 }
 
+QRect PixelStream::getVisibleRegion( const deflect::Segment& segment ) const
+{
+    const deflect::SegmentParameters& param = segment.parameters;
+    const QRect rect( param.x, param.y, param.width, param.height );
+    return geometry::getVisibleRegion( rect.size(),
+                                                   getSceneCoordinates( rect ),
+                                                   wallArea_ );
+}
+
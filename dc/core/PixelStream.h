@@ -43,6 +43,7 @@
 
 #include "types.h"
 #include "FpsCounter.h"
+#include "SegmentRegionDecoder.h"
 
 #include <deflect/Segment.h>
 
@@ -51,8 +52,8 @@
 
 #include <boost/scoped_ptr.hpp>
 
+class PixelStreamSegmentAtlas;
 class PixelStreamSegmentRenderer;
-typedef boost::shared_ptr<deflect::SegmentDecoder> PixelStreamSegmentDecoderPtr;
 typedef boost::shared_ptr<PixelStreamSegmentRenderer> PixelStreamSegmentRendererPtr;
 
 /**
@@ -110,7 +111,63 @@ public:
     PixelStream( const QString& uri );
     ~PixelStream();
 
-    void setNewFrame( deflect::FramePtr frame );
+    /**
+     * Set the next frame to display, replacing (dropping) the previous one if
+     * it has not been processed yet.
+     * @param frame The new frame
+     * @param receiveTime The time at which the frame was received from the
+     *        master, from Profiler::now()
+     */
+    void setNewFrame( deflect::FramePtr frame, int64_t receiveTime );
+
+    /** @return true if the last frame set has not been processed yet. */
+    bool hasPendingFrame() const;
+
+    /** Count a frame received from the master for this stream. */
+    void addReceivedFrame();
+
+    /**
+     * @return the number of frames received, decoded, displayed and dropped,
+     *         the average latency from reception to display and the
+     *         proportion of segments which reused the previous texture.
+     */
+    QString getFrameStatistics() const;
+
+    /**
+     * Set the pool which decodes the compressed segments.
+     * @param pool The decoding pool shared by all the streams
+     */
+    void setDecodePool( PixelStreamDecodePoolPtr pool );
+
+    /**
+     * Set the decoding priority of the segments of this stream.
+     * @param priority The stacking order of the window, higher is on top
+     */
+    void setDecodePriority( int priority );
+
+    /**
+     * Render the segments from a single texture with one draw call.
+     *
+     * Only used if the stream has several segments and they fit in the
+     * maximum texture size, otherwise each segment has a texture of its own.
+     * @param enabled true to batch the segments (default: false)
+     */
+    void setSegmentBatching( bool enabled );
+
+    /**
+     * @return the index of the last frame whose visible segments this process
+     *         has finished decoding, incremented by each swap of the buffers.
+     */
+    uint64_t getDecodedFrameIndex() const;
+
+    /**
+     * Update the renderers and swap the buffers once all processes have
+     * decoded the front buffer.
+     * @param globalDecodedFrameIndex The minimum getDecodedFrameIndex() of
+     *        all processes; the front buffer is kept while it is lower than
+     *        the local one.
+     */
+    void syncFrame( uint64_t globalDecodedFrameIndex );
 
     QString getStatistics() const;
     QList<QObject*> getSegments() const;
@@ -126,19 +183,55 @@ private:
     unsigned int width_;
     unsigned int height_;
 
-    // The front buffer is decoded by the frameDecoders and then used to upload
+    // The front buffer is decoded by the decodePool and then used to upload
     // the frameRenderers. The back buffer contains the next frame to process
     // (last frame received).
     deflect::Segments frontBuffer_;
     deflect::Segments backBuffer_;
     bool buffersSwapped_;
 
-    // The list of decoded images for the next frame
-    std::vector<PixelStreamSegmentDecoderPtr> frameDecoders_;
+    // For each segment of the buffers, the frame which may own its image data
+    // (see FrameSerializer). Segments which are received marked as unchanged
+    // reuse the data of the previous frame (see SegmentChangeTracker).
+    std::vector<deflect::FramePtr> frontOwners_;
+    std::vector<deflect::FramePtr> backOwners_;
+
+    // For each segment of the front buffer, false if it reuses the image data
+    // and texture of the previous frame
+    std::vector<bool> updatedSegments_;
+
+    // The index of the frame in the front buffer, incremented by each swap
+    uint64_t frameIndex_;
+    uint64_t lastDecodedFrameIndex_;
+
+    // The reception time of the frames in each buffer
+    int64_t frontBufferReceiveTime_;
+    int64_t backBufferReceiveTime_;
+
+    uint64_t receivedFrames_;
+    uint64_t decodedFrames_;
+    uint64_t displayedFrames_;
+    uint64_t droppedFrames_;
+    double averageLatency_;
+    uint64_t swappedSegments_;
+    uint64_t reusedSegments_;
+
+    // Decodes the visible region of the segments of the front buffer
+    PixelStreamDecodePoolPtr decodePool_;
+    int decodePriority_;
+
+    // For each segment of the front buffer, the region decoded for this
+    // process and the last region which was queued for decoding
+    std::vector<DecodedRegion> decodedRegions_;
+    std::vector<QRect> queuedRegions_;
 
     // For each segment, object for image parameters, decoding and rendering
     std::vector<PixelStreamSegmentRendererPtr> segmentRenderers_;
 
+    // Stores and renders all the segments if batching is enabled and possible
+    bool segmentBatching_;
+    boost::scoped_ptr<PixelStreamSegmentAtlas> segmentAtlas_;
+
     QRectF sceneRect_;
     QRectF wallArea_;
 
@@ -150,22 +243,28 @@ private:
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
                           const QRect& wallArea ) override;
-    void preRenderSync( WallToWallChannel& wallToWallChannel ) override;
-    bool isDecodingInProgress( WallToWallChannel& wallToWallChannel );
+    void preRenderSync( WallToWallChannel& wallToWallChannel,
+                        SwapSyncRegistry& registry ) override;
 
-    void updateRenderers( const deflect::Segments& segments );
+    void updateRenderers( const deflect::Segments& segments,
+                          const std::vector<bool>& updatedSegments );
     void updateVisibleTextures();
     void swapBuffers();
     void recomputeDimensions( const deflect::Segments& segments );
     void decodeVisibleTextures();
+    void mapPixelBuffer( const deflect::Segment& segment, const QRect& region,
+                         DecodedRegion& output );
+    void unmapPixelBuffer( DecodedRegion& output );
 
-    void adjustFrameDecodersCount( const size_t count );
     void adjustSegmentRendererCount( const size_t count );
+    void updateSegmentAtlas( const deflect::Segments& segments );
     void refreshSegmentsList( const deflect::Segments& segments );
 
     QRectF getSceneCoordinates( const QRect& segment ) const;
     bool isVisible( const QRect& segment ) const;
     bool isVisible( const deflect::Segment& segment ) const;
+    QRect getVisibleRegion( const deflect::Segment& segment ) const;
+    bool hasImageData( const deflect::Segment& segment ) const;
 };
 
 
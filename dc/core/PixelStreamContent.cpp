@@ -61,3 +61,14 @@ bool PixelStreamContent::hasFixedAspectRatio() const
 {
     return _uri == "dock";
 }
+
+const PixelStreamPacing& PixelStreamContent::getPacing() const
+{
+    return _pacing;
+}
+
+void PixelStreamContent::setPacing( const PixelStreamPacing& pacing )
+{
+    _pacing = pacing;
+    emit modified();
+}
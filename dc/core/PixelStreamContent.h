@@ -40,6 +40,8 @@
 #define PIXEL_STREAM_CONTENT_H
 
 #include "Content.h"
+#include "PixelStreamPacing.h"
+
 #include <boost/serialization/base_object.hpp>
 
 class PixelStreamContent : public Content
@@ -63,6 +65,12 @@ public:
     /** @return true if the streamer can handle aspect ratio changes. */
     bool hasFixedAspectRatio() const override;
 
+    /** @return the pacing policy of the stream on the wall. */
+    const PixelStreamPacing& getPacing() const;
+
+    /** Set the pacing policy of the stream on the wall. */
+    void setPacing( const PixelStreamPacing& pacing );
+
 private:
     friend class boost::serialization::access;
 
@@ -70,11 +78,17 @@ private:
     PixelStreamContent() {}
 
     template<class Archive>
-    void serialize( Archive & ar, const unsigned int )
+    void serialize( Archive & ar, const unsigned int version )
     {
         // serialize base class information (with NVP for xml archives)
         ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP( Content );
+        if( version >= 1 )
+            ar & boost::serialization::make_nvp( "pacing", _pacing );
     }
+
+    PixelStreamPacing _pacing;
 };
 
+BOOST_CLASS_VERSION( PixelStreamContent, 1 )
+
 #endif
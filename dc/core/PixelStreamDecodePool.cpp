@@ -0,0 +1,255 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "PixelStreamDecodePool.h"
+
+#include "log.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+const double AVERAGE_WEIGHT = 0.05;
+const int64_t THROUGHPUT_WINDOW_US = 1000000;
+}
+
+PixelStreamDecodePool::PixelStreamDecodePool( size_t threadCount )
+    : _queueDepth( 0 )
+    , _stop( false )
+    , _decodedCount( 0 )
+    , _averageLatency( 0.0 )
+    , _averageDecodeTime( 0.0 )
+    , _windowStart( Profiler::now( ))
+    , _windowPixels( 0 )
+    , _throughput( 0.0 )
+{
+    if( threadCount == 0 )
+        threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+
+    for( size_t i = 0; i < threadCount; ++i )
+        _threads.push_back( std::thread( &PixelStreamDecodePool::_run, this ));
+}
+
+PixelStreamDecodePool::~PixelStreamDecodePool()
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _stop = true;
+    }
+    _taskAvailable.notify_all();
+
+    for( std::thread& thread : _threads )
+        thread.join();
+}
+
+size_t PixelStreamDecodePool::getThreadCount() const
+{
+    return _threads.size();
+}
+
+void PixelStreamDecodePool::decode( const void* owner,
+                                    const deflect::Segment& segment,
+                                    const QRect& region, DecodedRegion& output )
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _queues[owner].tasks.push_back( Task{ &segment, region, &output,
+                                              Profiler::now( )});
+        ++_queueDepth;
+    }
+    _taskAvailable.notify_one();
+}
+
+void PixelStreamDecodePool::setPriority( const void* owner,
+                                         const int priority )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    _queues[owner].priority = priority;
+}
+
+size_t PixelStreamDecodePool::getPendingCount( const void* owner ) const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    const auto it = _queues.find( owner );
+    if( it == _queues.end( ))
+        return 0;
+    return it->second.tasks.size() + it->second.running;
+}
+
+void PixelStreamDecodePool::cancel( const void* owner )
+{
+    std::unique_lock<std::mutex> lock( _mutex );
+    auto it = _queues.find( owner );
+    if( it == _queues.end( ))
+        return;
+
+    _queueDepth -= it->second.tasks.size();
+    it->second.tasks.clear();
+    _taskFinished.wait( lock, [&it]() { return it->second.running == 0; } );
+    _queues.erase( it );
+}
+
+size_t PixelStreamDecodePool::getQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _queueDepth;
+}
+
+uint64_t PixelStreamDecodePool::getDecodedCount() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _decodedCount;
+}
+
+double PixelStreamDecodePool::getThroughput() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    // The last measure is outdated if nothing was decoded since
+    if( Profiler::now() - _windowStart > 2 * THROUGHPUT_WINDOW_US )
+        return 0.0;
+    return _throughput;
+}
+
+double PixelStreamDecodePool::getAverageLatency() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _averageLatency;
+}
+
+double PixelStreamDecodePool::getAverageDecodeTime() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _averageDecodeTime;
+}
+
+QString PixelStreamDecodePool::getStatistics() const
+{
+    return QString( "decode: %1 MPix/s, queue %2, latency (us) %3, "
+                    "decode (us) %4, threads %5" )
+            .arg( getThroughput(), 0, 'f', 1 ).arg( getQueueDepth( ))
+            .arg( getAverageLatency(), 0, 'f', 0 )
+            .arg( getAverageDecodeTime(), 0, 'f', 0 ).arg( getThreadCount( ));
+}
+
+void PixelStreamDecodePool::_run()
+{
+    // Each thread has its own decompressor, which is not thread-safe
+    SegmentRegionDecoder decoder;
+
+    const void* owner = 0;
+    Task task;
+    while( _takeTask( owner, task ))
+    {
+        const int64_t start = Profiler::now();
+        {
+            ProfileScope scope( PROFILE_CATEGORY_CONTENT, "decode segment" );
+            try
+            {
+                decoder.decode( *task.segment, task.region, *task.output );
+            }
+            catch( const std::exception& e )
+            {
+                put_flog( LOG_ERROR, "Error decoding stream segment: '%s'",
+                          e.what( ));
+            }
+        }
+        _finishTask( owner, task, start );
+    }
+}
+
+bool PixelStreamDecodePool::_takeTask( const void*& owner, Task& task )
+{
+    std::unique_lock<std::mutex> lock( _mutex );
+    _taskAvailable.wait( lock, [this]() { return _stop || _queueDepth > 0; } );
+    if( _stop )
+        return false;
+
+    // The number of streams is small, a linear search is enough
+    auto next = _queues.end();
+    for( auto it = _queues.begin(); it != _queues.end(); ++it )
+    {
+        if( !it->second.tasks.empty() && ( next == _queues.end() ||
+                                it->second.priority > next->second.priority ))
+            next = it;
+    }
+    assert( next != _queues.end( ));
+
+    owner = next->first;
+    task = next->second.tasks.front();
+    next->second.tasks.pop_front();
+    ++next->second.running;
+    --_queueDepth;
+    return true;
+}
+
+void PixelStreamDecodePool::_finishTask( const void* owner, const Task& task,
+                                         const int64_t start )
+{
+    const int64_t end = Profiler::now();
+    const QRect& rect = task.output->rect;
+    const uint64_t pixels = rect.width() * rect.height();
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        --_queues[owner].running;
+
+        const double latency = end - task.queueTime;
+        const double decodeTime = end - start;
+        if( _decodedCount++ == 0 )
+        {
+            _averageLatency = latency;
+            _averageDecodeTime = decodeTime;
+        }
+        else
+        {
+            _averageLatency += AVERAGE_WEIGHT * ( latency - _averageLatency );
+            _averageDecodeTime += AVERAGE_WEIGHT *
+                                  ( decodeTime - _averageDecodeTime );
+        }
+
+        _windowPixels += pixels;
+        if( end - _windowStart >= THROUGHPUT_WINDOW_US )
+        {
+            _throughput = (double)_windowPixels / ( end - _windowStart );
+            _windowPixels = 0;
+            _windowStart = end;
+        }
+    }
+    _taskFinished.notify_all();
+}
@@ -0,0 +1,178 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMDECODEPOOL_H
+#define PIXELSTREAMDECODEPOOL_H
+
+#include "SegmentRegionDecoder.h"
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * A bounded pool of threads which decode the segments of all PixelStreams.
+ *
+ * Each stream has its own queue of segments, identified by an owner. Idle
+ * threads always take the next segment from the non-empty queue of highest
+ * priority, so that the streams on top of the stacking order are decoded
+ * first and no thread stays idle while work is pending.
+ *
+ * Only the region of a segment which is visible on the wall process is
+ * decoded. The segments and the outputs must remain valid until
+ * getPendingCount() returns 0 for their owner, or cancel() has returned.
+ *
+ * The methods of this class are thread-safe.
+ */
+class PixelStreamDecodePool : public boost::noncopyable
+{
+public:
+    /**
+     * Constructor.
+     * @param threadCount The number of decoding threads, 0 for one per core
+     */
+    explicit PixelStreamDecodePool( size_t threadCount = 0 );
+
+    /** Destructor, waits for the segments being decoded. */
+    ~PixelStreamDecodePool();
+
+    /** @return the number of decoding threads. */
+    size_t getThreadCount() const;
+
+    /**
+     * Queue a region of a compressed segment for decoding.
+     * @param owner The stream the segment belongs to
+     * @param segment The compressed segment
+     * @param region The region to decode, in segment pixel coordinates
+     * @param output The decoded region, its rect is empty if decoding failed
+     */
+    void decode( const void* owner, const deflect::Segment& segment,
+                 const QRect& region, DecodedRegion& output );
+
+    /**
+     * Set the priority of the queue of a stream.
+     * @param owner The stream
+     * @param priority The priority, higher values are decoded first
+     */
+    void setPriority( const void* owner, int priority );
+
+    /**
+     * @param owner The stream
+     * @return the number of segments queued or being decoded for the stream
+     */
+    size_t getPendingCount( const void* owner ) const;
+
+    /**
+     * Discard the queued segments of a stream and wait for the ones which are
+     * being decoded.
+     * @param owner The stream
+     */
+    void cancel( const void* owner );
+
+    /** @return the number of segments queued for all the streams. */
+    size_t getQueueDepth() const;
+
+    /** @return the number of segments processed (decoded or not) so far. */
+    uint64_t getDecodedCount() const;
+
+    /**
+     * @return the decoding throughput in the last second in MPixel/s, counting
+     *         only the pixels of the decoded regions.
+     */
+    double getThroughput() const;
+
+    /**
+     * @return the average latency of a segment in us, from the time it is
+     *         queued to the end of its decoding.
+     */
+    double getAverageLatency() const;
+
+    /** @return the average decoding time of a segment in us. */
+    double getAverageDecodeTime() const;
+
+    /** @return a summary of the decoding statistics. */
+    QString getStatistics() const;
+
+private:
+    struct Task
+    {
+        const deflect::Segment* segment;
+        QRect region;
+        DecodedRegion* output;
+        int64_t queueTime;
+    };
+
+    struct Queue
+    {
+        Queue() : priority( 0 ), running( 0 ) {}
+
+        int priority;
+        std::deque<Task> tasks;
+        size_t running;
+    };
+
+    mutable std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    std::condition_variable _taskFinished;
+    std::map<const void*, Queue> _queues;
+    std::vector<std::thread> _threads;
+    size_t _queueDepth;
+    bool _stop;
+
+    uint64_t _decodedCount;
+    double _averageLatency;
+    double _averageDecodeTime;
+    int64_t _windowStart;
+    uint64_t _windowPixels;
+    double _throughput;
+
+    void _run();
+    bool _takeTask( const void*& owner, Task& task );
+    void _finishTask( const void* owner, const Task& task, int64_t start );
+};
+
+#endif // PIXELSTREAMDECODEPOOL_H
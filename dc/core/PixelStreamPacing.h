@@ -0,0 +1,96 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMPACING_H
+#define PIXELSTREAMPACING_H
+
+#include <QString>
+
+#include <boost/serialization/nvp.hpp>
+
+/**
+ * How a wall displays the frames of a stream which arrive faster than the
+ * wall can display them.
+ */
+enum PixelStreamPacingMode
+{
+    /** Display the most recent frame, dropping the older ones. */
+    PACING_LATEST_FRAME,
+    /** Display every frame in order, never drop any. */
+    PACING_IN_ORDER,
+    /** Like PACING_LATEST_FRAME, but display at most maxFps frames/s. */
+    PACING_MAX_FPS
+};
+
+/**
+ * The pacing policy of a stream.
+ */
+struct PixelStreamPacing
+{
+    /** Default policy: display the latest frame. */
+    PixelStreamPacing()
+        : mode( PACING_LATEST_FRAME )
+        , maxFps( 0 )
+    {}
+
+    /** The pacing mode. */
+    PixelStreamPacingMode mode;
+
+    /** The maximum frame rate for PACING_MAX_FPS, 0 for unlimited. */
+    unsigned int maxFps;
+
+    /**
+     * Parse a pacing mode.
+     * @param name "latest", "inorder" or "maxfps"
+     * @param mode the result, unchanged if the name is not valid
+     * @return true if the name is valid
+     */
+    static bool parseMode( const QString& name, PixelStreamPacingMode& mode );
+
+    /** @return the name of a pacing mode, as accepted by parseMode(). */
+    static QString getModeName( PixelStreamPacingMode mode );
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & boost::serialization::make_nvp( "mode", mode );
+        ar & boost::serialization::make_nvp( "maxFps", maxFps );
+    }
+};
+
+#endif // PIXELSTREAMPACING_H
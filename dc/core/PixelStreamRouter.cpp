@@ -0,0 +1,270 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "PixelStreamRouter.h"
+
+#include "Content.h"
+#include "ContentWindow.h"
+#include "SegmentChangeTracker.h"
+
+#include <deflect/Frame.h>
+
+#include <boost/foreach.hpp>
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+/** What a process receives for a segment. */
+enum SegmentContent
+{
+    SEGMENT_DATA,
+    SEGMENT_UNCHANGED,
+    SEGMENT_NOT_ROUTED
+};
+typedef std::vector<SegmentContent> SegmentContents;
+
+std::vector<QRectF> toRectF( const std::vector<QRect>& rects )
+{
+    return std::vector<QRectF>( rects.begin(), rects.end( ));
+}
+
+QRectF getWindowArea( const ContentWindow& window )
+{
+    if( window.isFocused( ))
+        return window.getCoordinates().united( window.getFocusedCoordinates( ));
+    return window.getCoordinates();
+}
+
+bool wasRouted( const std::vector< std::vector<bool> >& routing,
+                const size_t process, const size_t segment )
+{
+    return process < routing.size() && segment < routing[process].size() &&
+           routing[process][segment];
+}
+
+deflect::FramePtr createFrame( deflect::FramePtr frame,
+                               const SegmentContents& contents )
+{
+    if( std::find( contents.begin(), contents.end(), SEGMENT_UNCHANGED ) ==
+            contents.end() &&
+        std::find( contents.begin(), contents.end(), SEGMENT_NOT_ROUTED ) ==
+            contents.end( ))
+    {
+        return frame;
+    }
+
+    deflect::FramePtr routedFrame =
+            boost::make_shared<deflect::Frame>( *frame );
+    for( size_t j = 0; j < contents.size(); ++j )
+    {
+        if( contents[j] == SEGMENT_NOT_ROUTED )
+            routedFrame->segments[j].imageData = QByteArray();
+        else if( contents[j] == SEGMENT_UNCHANGED )
+            SegmentChangeTracker::setUnchanged( routedFrame->segments[j] );
+    }
+    return routedFrame;
+}
+
+QRectF getSceneRect( const deflect::SegmentParameters& params,
+                     const QSize& frameSize, const QRectF& windowArea )
+{
+    const qreal scaleX = windowArea.width() / frameSize.width();
+    const qreal scaleY = windowArea.height() / frameSize.height();
+
+    return QRectF( windowArea.x() + params.x * scaleX,
+                   windowArea.y() + params.y * scaleY,
+                   params.width * scaleX, params.height * scaleY );
+}
+}
+
+PixelStreamRouter::PixelStreamRouter( const std::vector<QRect>& areas )
+    : wallProcessAreas_( toRectF( areas ))
+{
+}
+
+size_t PixelStreamRouter::getProcessCount() const
+{
+    return wallProcessAreas_.size();
+}
+
+QStringList PixelStreamRouter::updateWindows( const ContentWindowPtrs& windows )
+{
+    QMutexLocker lock( &mutex_ );
+
+    StreamStates streams;
+    BOOST_FOREACH( ContentWindowPtr window, windows )
+    {
+        const QString& uri = window->getContent()->getURI();
+        const QRectF area = getWindowArea( *window );
+
+        StreamState& state = streams[uri];
+        state.currentArea = area;
+        state.hidden = window->isHidden();
+
+        StreamStates::const_iterator previous = streams_.find( uri );
+        if( previous == streams_.end( ))
+        {
+            state.previousArea = area;
+            continue;
+        }
+        state.previousArea = previous->currentArea;
+        state.lastFrame = previous->lastFrame;
+        state.routedSegments = previous->routedSegments;
+    }
+    streams_.swap( streams );
+
+    QStringList outdatedStreams;
+    for( StreamStates::const_iterator it = streams_.begin();
+         it != streams_.end(); ++it )
+    {
+        if( !it->lastFrame )
+            continue;
+
+        const std::vector< std::vector<bool> > routing =
+                computeRouting( *it->lastFrame, &(*it) );
+
+        bool outdated = false;
+        for( size_t i = 0; i < routing.size() && !outdated; ++i )
+        {
+            for( size_t j = 0; j < routing[i].size() && !outdated; ++j )
+                outdated = routing[i][j] && !it->routedSegments[i][j];
+        }
+        if( outdated )
+            outdatedStreams.append( it.key( ));
+    }
+    return outdatedStreams;
+}
+
+std::vector<deflect::FramePtr>
+PixelStreamRouter::route( deflect::FramePtr frame,
+                          const std::vector<bool>& changed )
+{
+    assert( changed.empty() || changed.size() == frame->segments.size( ));
+
+    std::vector< std::vector<bool> > routing;
+    std::vector< std::vector<bool> > previousRouting;
+    {
+        QMutexLocker lock( &mutex_ );
+
+        StreamStates::iterator it = streams_.find( frame->uri );
+        StreamState* state = it != streams_.end() ? &(*it) : 0;
+        routing = computeRouting( *frame, state );
+
+        if( state )
+        {
+            previousRouting.swap( state->routedSegments );
+            state->lastFrame = frame;
+            state->routedSegments = routing;
+        }
+    }
+
+    // Processes that need the same segments share the same frame
+    typedef std::map< SegmentContents, deflect::FramePtr > UniqueFrames;
+    UniqueFrames uniqueFrames;
+
+    std::vector<deflect::FramePtr> frames;
+    frames.reserve( routing.size( ));
+    for( size_t i = 0; i < routing.size(); ++i )
+    {
+        SegmentContents contents( routing[i].size(), SEGMENT_DATA );
+        for( size_t j = 0; j < contents.size(); ++j )
+        {
+            if( !routing[i][j] )
+                contents[j] = SEGMENT_NOT_ROUTED;
+            else if( !changed.empty() && !changed[j] &&
+                     wasRouted( previousRouting, i, j ))
+                contents[j] = SEGMENT_UNCHANGED;
+        }
+
+        deflect::FramePtr& routedFrame = uniqueFrames[contents];
+        if( !routedFrame )
+            routedFrame = createFrame( frame, contents );
+        frames.push_back( routedFrame );
+    }
+    return frames;
+}
+
+deflect::FramePtr PixelStreamRouter::getLastFrame( const QString& uri ) const
+{
+    QMutexLocker lock( &mutex_ );
+
+    StreamStates::const_iterator it = streams_.find( uri );
+    return it != streams_.end() ? it->lastFrame : deflect::FramePtr();
+}
+
+std::vector< std::vector<bool> >
+PixelStreamRouter::computeRouting( const deflect::Frame& frame,
+                                   const StreamState* state ) const
+{
+    const size_t segmentCount = frame.segments.size();
+    const QSize frameSize = frame.computeDimensions();
+
+    // Without a known window, all processes may need all the segments
+    if( !state || frameSize.isEmpty( ))
+    {
+        return std::vector< std::vector<bool> >(
+                    wallProcessAreas_.size(),
+                    std::vector<bool>( segmentCount, true ));
+    }
+
+    std::vector< std::vector<bool> > routing(
+                wallProcessAreas_.size(),
+                std::vector<bool>( segmentCount, false ));
+    if( state->hidden )
+        return routing;
+
+    for( size_t j = 0; j < segmentCount; ++j )
+    {
+        const deflect::SegmentParameters& params = frame.segments[j].parameters;
+        const QRectF current = getSceneRect( params, frameSize,
+                                             state->currentArea );
+        const QRectF previous = getSceneRect( params, frameSize,
+                                              state->previousArea );
+
+        for( size_t i = 0; i < wallProcessAreas_.size(); ++i )
+        {
+            const QRectF& area = wallProcessAreas_[i];
+            routing[i][j] = area.intersects( current ) ||
+                            area.intersects( previous );
+        }
+    }
+    return routing;
+}
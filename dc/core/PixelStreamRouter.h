@@ -0,0 +1,135 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMROUTER_H
+#define PIXELSTREAMROUTER_H
+
+#include "types.h"
+
+#include <QMap>
+#include <QMutex>
+#include <QRect>
+#include <QStringList>
+
+/**
+ * Decide which pixel stream segments each wall process needs.
+ *
+ * The router keeps the area covered by each wall process and the last known
+ * geometry of the pixel stream windows. Frames are split so that each process
+ * only receives the image data of the segments that intersect its area.
+ *
+ * All processes still receive the parameters of all the segments, so that
+ * the frame layout and the swap-sync versions remain identical everywhere.
+ *
+ * This class is thread-safe: the windows are usually updated from the main
+ * thread while the frames are routed in the MPI send thread.
+ */
+class PixelStreamRouter
+{
+public:
+    /**
+     * Constructor
+     * @param wallProcessAreas The area covered by each wall process, the first
+     *        entry corresponding to MPI rank 1.
+     * @see MasterConfiguration::getWallProcessAreas()
+     */
+    PixelStreamRouter( const std::vector<QRect>& wallProcessAreas );
+
+    /** @return the number of wall processes. */
+    size_t getProcessCount() const;
+
+    /**
+     * Update the known geometry of the windows.
+     *
+     * Each stream is routed to the union of its previous and current window
+     * geometry, to cover the wall processes which are still animating a move.
+     * @param windows The current windows of the DisplayGroup
+     * @return the uris of the streams whose last frame must be routed again,
+     *         because some processes now need segments that they did not
+     *         receive.
+     */
+    QStringList updateWindows( const ContentWindowPtrs& windows );
+
+    /**
+     * Split a frame for each wall process.
+     *
+     * An unchanged segment is only marked as such for the processes which
+     * received it in the previous frame of the stream. The other processes
+     * which need it get its image data.
+     * @param frame The frame to route
+     * @param changed For each segment, true if its image data changed since
+     *        the previous frame, all the segments are changed if it is empty
+     * @return one frame per wall process, without the image data of the
+     *         segments that do not intersect the process area. Processes which
+     *         need the same segments share the same frame object. A stream
+     *         without a known window is routed entirely to all processes.
+     * @see SegmentChangeTracker
+     */
+    std::vector<deflect::FramePtr>
+    route( deflect::FramePtr frame,
+           const std::vector<bool>& changed = std::vector<bool>( ));
+
+    /**
+     * Get the last frame routed for a stream.
+     * @param uri The identifier of the stream
+     * @return the frame, or a null pointer if the stream is unknown
+     */
+    deflect::FramePtr getLastFrame( const QString& uri ) const;
+
+private:
+    struct StreamState
+    {
+        QRectF currentArea;
+        QRectF previousArea;
+        bool hidden;
+        deflect::FramePtr lastFrame;
+        std::vector< std::vector<bool> > routedSegments;
+    };
+    typedef QMap<QString, StreamState> StreamStates;
+
+    const std::vector<QRectF> wallProcessAreas_;
+
+    mutable QMutex mutex_;
+    StreamStates streams_;
+
+    std::vector< std::vector<bool> >
+    computeRouting( const deflect::Frame& frame,
+                    const StreamState* state ) const;
+};
+
+#endif // PIXELSTREAMROUTER_H
@@ -0,0 +1,278 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "PixelStreamSegmentAtlas.h"
+
+#include "GLTextureUploader.h"
+#include "log.h"
+
+#include <QImage>
+
+#include <cmath>
+
+namespace
+{
+// x, y, s, t for each of the 4 vertices of a quad
+const size_t FLOATS_PER_VERTEX = 4;
+const size_t FLOATS_PER_QUAD = 4 * FLOATS_PER_VERTEX;
+}
+
+PixelStreamSegmentAtlas::PixelStreamSegmentAtlas()
+    : _textureId( 0 )
+    , _vertexBuffer( QGLBuffer::VertexBuffer )
+    , _vertexBufferSupported( true )
+    , _verticesOutdated( true )
+{
+}
+
+PixelStreamSegmentAtlas::~PixelStreamSegmentAtlas()
+{
+    _free();
+}
+
+bool PixelStreamSegmentAtlas::resize( const QSize& cellSize,
+                                      const size_t cellCount )
+{
+    if( _textureId && cellSize == _cellSize && cellCount == _rects.size( ))
+        return true;
+
+    _free();
+
+    GLint maxTextureSize = 0;
+    glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize );
+
+    const QSize gridSize = computeGridSize( cellSize, cellCount,
+                                            maxTextureSize );
+    if( gridSize.isEmpty( ))
+        return false;
+
+    _cellSize = cellSize;
+    _gridSize = gridSize;
+    _textureSize = QSize( gridSize.width() * cellSize.width(),
+                          gridSize.height() * cellSize.height( ));
+    _rects.assign( cellCount, QRect( ));
+    _verticesOutdated = true;
+
+    glGenTextures( 1, &_textureId );
+    glBindTexture( GL_TEXTURE_2D, _textureId );
+    glTexParameteri( GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE );
+    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, _textureSize.width(),
+                  _textureSize.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
+    return true;
+}
+
+void PixelStreamSegmentAtlas::update( const size_t cell, const QImage& image,
+                                      const QRect& rect )
+{
+    if( cell >= _rects.size() || image.width() > _cellSize.width() ||
+        image.height() > _cellSize.height( ))
+    {
+        put_flog( LOG_WARN, "Segment image does not fit in atlas cell %d",
+                  (int)cell );
+        return;
+    }
+
+    glBindTexture( GL_TEXTURE_2D, _textureId );
+    GLTextureUploader::instance().upload( image.bits(), image.size(), GL_RGBA,
+                                          getCellPosition( cell ));
+
+    // Only the coordinates of the segment are in the vertex buffer
+    if( _rects[cell] != rect )
+    {
+        _rects[cell] = rect;
+        _verticesOutdated = true;
+    }
+}
+
+bool PixelStreamSegmentAtlas::render( const std::vector<size_t>& cells )
+{
+    if( !_textureId )
+        return false;
+
+    if( _verticesOutdated || cells != _renderedCells )
+        _updateVertices( cells );
+
+    const GLsizei vertexCount = _vertices.size() / FLOATS_PER_VERTEX;
+    if( vertexCount == 0 )
+        return false;
+
+    if( _vertexBufferSupported && !_vertexBuffer.isCreated( ))
+    {
+        _vertexBufferSupported = _vertexBuffer.create();
+        if( _vertexBufferSupported )
+            _vertexBuffer.setUsagePattern( QGLBuffer::DynamicDraw );
+        else
+            put_flog( LOG_WARN, "Vertex buffer objects are not supported, "
+                                "segments are drawn from client memory" );
+    }
+
+    // The vertices are read from the bound buffer, or from client memory
+    const GLfloat* vertices = 0;
+    if( _vertexBufferSupported )
+    {
+        _vertexBuffer.bind();
+        if( _verticesOutdated )
+            _vertexBuffer.allocate( _vertices.data(),
+                                    _vertices.size() * sizeof( GLfloat ));
+    }
+    else
+        vertices = _vertices.data();
+    _verticesOutdated = false;
+
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+    glEnable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, _textureId );
+
+    const GLsizei stride = FLOATS_PER_VERTEX * sizeof( GLfloat );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, stride, vertices );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glTexCoordPointer( 2, GL_FLOAT, stride, vertices + 2 );
+
+    glDrawArrays( GL_QUADS, 0, vertexCount );
+
+    glPopClientAttrib();
+    glPopAttrib();
+
+    if( _vertexBufferSupported )
+        _vertexBuffer.release();
+
+    return true;
+}
+
+size_t PixelStreamSegmentAtlas::getCellCount() const
+{
+    return _rects.size();
+}
+
+const QSize& PixelStreamSegmentAtlas::getGridSize() const
+{
+    return _gridSize;
+}
+
+QPoint PixelStreamSegmentAtlas::getCellPosition( const size_t cell ) const
+{
+    if( _gridSize.isEmpty( ))
+        return QPoint();
+
+    return QPoint( cell % _gridSize.width() * _cellSize.width(),
+                   cell / _gridSize.width() * _cellSize.height( ));
+}
+
+QSize PixelStreamSegmentAtlas::computeGridSize( const QSize& cellSize,
+                                                const size_t cellCount,
+                                                const int maxTextureSize )
+{
+    if( cellSize.isEmpty() || cellCount == 0 )
+        return QSize();
+
+    const int maxColumns = maxTextureSize / cellSize.width();
+    const int maxRows = maxTextureSize / cellSize.height();
+    if( maxColumns == 0 || maxRows == 0 )
+        return QSize();
+
+    // Close to a square texture, to stay far from the maximum dimensions
+    const double side = std::sqrt( double( cellCount ) * cellSize.width() *
+                                   cellSize.height( ));
+    int columns = std::ceil( side / cellSize.width( ));
+    columns = std::max( 1, std::min( columns, maxColumns ));
+    columns = std::min( columns, int( cellCount ));
+    const int rows = ( cellCount + columns - 1 ) / columns;
+    if( rows > maxRows )
+        return QSize();
+
+    return QSize( columns, rows );
+}
+
+void PixelStreamSegmentAtlas::_free()
+{
+    if( _textureId )
+    {
+        glDeleteTextures( 1, &_textureId );
+        _textureId = 0;
+    }
+    _cellSize = QSize();
+    _gridSize = QSize();
+    _textureSize = QSize();
+    _rects.clear();
+}
+
+void PixelStreamSegmentAtlas::_updateVertices(
+        const std::vector<size_t>& cells )
+{
+    _renderedCells = cells;
+    _vertices.clear();
+    _vertices.reserve( cells.size() * FLOATS_PER_QUAD );
+
+    const float width = _textureSize.width();
+    const float height = _textureSize.height();
+
+    for( size_t i = 0; i < cells.size(); ++i )
+    {
+        if( cells[i] >= _rects.size() || _rects[cells[i]].isEmpty( ))
+            continue;
+
+        const QRect& rect = _rects[cells[i]];
+        const QPoint pos = getCellPosition( cells[i] );
+
+        // Sample from the texel centers on the borders of the image, so that
+        // linear filtering does not blend it with the neighbouring cells.
+        const float s0 = ( pos.x() + 0.5f ) / width;
+        const float t0 = ( pos.y() + 0.5f ) / height;
+        const float s1 = ( pos.x() + rect.width() - 0.5f ) / width;
+        const float t1 = ( pos.y() + rect.height() - 0.5f ) / height;
+
+        const float x0 = rect.x();
+        const float y0 = rect.y();
+        const float x1 = rect.x() + rect.width();
+        const float y1 = rect.y() + rect.height();
+
+        const GLfloat quad[FLOATS_PER_QUAD] = { x0, y0, s0, t0,
+                                                x1, y0, s1, t0,
+                                                x1, y1, s1, t1,
+                                                x0, y1, s0, t1 };
+        _vertices.insert( _vertices.end(), quad, quad + FLOATS_PER_QUAD );
+    }
+    _verticesOutdated = true;
+}
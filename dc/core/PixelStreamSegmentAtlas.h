@@ -0,0 +1,140 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMSEGMENTATLAS_H
+#define PIXELSTREAMSEGMENTATLAS_H
+
+#include <QtOpenGL/QGLBuffer>
+#include <QtOpenGL/qgl.h>
+#include <QRect>
+
+#include <boost/noncopyable.hpp>
+
+#include <vector>
+
+class QImage;
+
+/**
+ * Store the segments of a PixelStream in a single texture and render them in
+ * one draw call.
+ *
+ * Each segment is stored in a cell of a grid in the atlas texture. All cells
+ * have the size of the largest segment, which is the nominal segment size of
+ * the stream (the segments on its right and bottom borders may be smaller).
+ * The visible segments are drawn as a batch of quads from a vertex buffer,
+ * instead of binding a texture and drawing a quad for each of them.
+ *
+ * All methods of this class must be called from the OpenGL thread.
+ */
+class PixelStreamSegmentAtlas : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    PixelStreamSegmentAtlas();
+
+    /** Free the texture. */
+    ~PixelStreamSegmentAtlas();
+
+    /**
+     * Set the dimensions and number of the cells.
+     *
+     * The texture is only reallocated if the layout changes, in which case
+     * the content of all cells is discarded.
+     * @param cellSize The size of the largest segment
+     * @param cellCount The number of segments
+     * @return false if the cells do not fit in the maximum texture size
+     */
+    bool resize( const QSize& cellSize, size_t cellCount );
+
+    /**
+     * Upload the image of a segment to its cell.
+     * @param cell The index of the segment
+     * @param image The pixels in (GL_)RGBA format, at most the cell size
+     * @param rect The coordinates of the image in the stream, in pixels
+     */
+    void update( size_t cell, const QImage& image, const QRect& rect );
+
+    /**
+     * Render some segments.
+     *
+     * Assume that the GL matrices have been set to the pixel coordinates of
+     * the stream. The cells which have no image yet are skipped.
+     * @param cells The indices of the segments to render
+     * @return true if a draw call was issued
+     */
+    bool render( const std::vector<size_t>& cells );
+
+    /** @return the number of cells. */
+    size_t getCellCount() const;
+
+    /** @return the number of columns and rows of cells in the texture. */
+    const QSize& getGridSize() const;
+
+    /** @return the position of a cell in the texture, in pixels. */
+    QPoint getCellPosition( size_t cell ) const;
+
+    /**
+     * Compute the layout of the cells in the texture, close to a square.
+     * @param cellSize The dimensions of a cell
+     * @param cellCount The number of cells
+     * @param maxTextureSize The maximum width and height of a texture
+     * @return the number of columns and rows, empty if the cells do not fit
+     */
+    static QSize computeGridSize( const QSize& cellSize, size_t cellCount,
+                                  int maxTextureSize );
+
+private:
+    GLuint _textureId;
+    QSize _cellSize;
+    QSize _gridSize;
+    QSize _textureSize;
+
+    // The coordinates in the stream of the image of each cell, empty if none
+    std::vector<QRect> _rects;
+
+    QGLBuffer _vertexBuffer;
+    bool _vertexBufferSupported;
+    std::vector<GLfloat> _vertices;
+    std::vector<size_t> _renderedCells;
+    bool _verticesOutdated;
+
+    void _free();
+    void _updateVertices( const std::vector<size_t>& cells );
+};
+
+#endif // PIXELSTREAMSEGMENTATLAS_H
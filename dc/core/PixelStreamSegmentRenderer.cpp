@@ -38,10 +38,14 @@
 
 #include "PixelStreamSegmentRenderer.h"
 
+#include "PixelStreamSegmentAtlas.h"
+
 #include <deflect/SegmentParameters.h>
 
 PixelStreamSegmentRenderer::PixelStreamSegmentRenderer()
-    : textureNeedsUpdate_( true )
+    : atlas_( 0 )
+    , atlasCell_( 0 )
+    , textureNeedsUpdate_( true )
 {
 }
 
@@ -52,7 +56,18 @@ const QRect& PixelStreamSegmentRenderer::getRect() const
 
 void PixelStreamSegmentRenderer::updateTexture(const QImage& image)
 {
-    texture_.update(image, GL_RGBA);
+    updateTexture(image, QRect(QPoint(), image.size()));
+}
+
+void PixelStreamSegmentRenderer::updateTexture(const QImage& image,
+                                               const QRect& region)
+{
+    if( atlas_ )
+        atlas_->update( atlasCell_, image,
+                        region.translated( rect_.topLeft( )));
+    else
+        texture_.update(image, GL_RGBA);
+    region_ = region;
     textureNeedsUpdate_ = false;
 }
 
@@ -74,6 +89,19 @@ void PixelStreamSegmentRenderer::setParameters( const deflect::SegmentParameters
     rect_.setHeight( param.height );
 }
 
+void PixelStreamSegmentRenderer::setAtlasCell( PixelStreamSegmentAtlas* atlas,
+                                               const size_t cell )
+{
+    if( atlas == atlas_ && cell == atlasCell_ )
+        return;
+
+    atlas_ = atlas;
+    atlasCell_ = cell;
+    if( atlas_ )
+        texture_.free();
+    textureNeedsUpdate_ = true;
+}
+
 bool PixelStreamSegmentRenderer::render()
 {
     if(!texture_.isValid())
@@ -82,11 +110,14 @@ bool PixelStreamSegmentRenderer::render()
     // OpenGL transformation
     glPushMatrix();
 
-    glTranslatef(rect_.x(), rect_.y(), 0.);
+    // The texture may only contain the region of the segment which is visible
+    glTranslatef(rect_.x() + region_.x(), rect_.y() + region_.y(), 0.);
     // The following draw calls assume normalized coordinates, so we must
-    // pre-multiply by this segment's dimensions
-    glScalef(rect_.width(), rect_.height(), 0.);
+    // pre-multiply by this region's dimensions
+    glScalef(region_.width(), region_.height(), 0.);
 
+    // The texture is only reallocated when the segment grows
+    quad_.setTexCoords( texture_.getTexCoords( ));
     quad_.setTexture( texture_.getTextureId( ));
     quad_.render();
 
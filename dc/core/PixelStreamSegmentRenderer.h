@@ -45,6 +45,8 @@
 
 #include <boost/noncopyable.hpp>
 
+class PixelStreamSegmentAtlas;
+
 /**
  * Render a single PixelStream Segment
  *
@@ -67,6 +69,15 @@ public:
      */
     void updateTexture(const QImage &image);
 
+    /**
+     * Update the texture with a region of the segment.
+     *
+     * Only this region of the segment is rendered until the next update.
+     * @param image The pixels of the region, in (GL_)RGBA format.
+     * @param region The region in segment pixel coordinates.
+     */
+    void updateTexture(const QImage &image, const QRect& region);
+
     /** Has the texture been marked as oudated with setTextureOutdated() */
     bool textureNeedsUpdate() const;
 
@@ -76,6 +87,15 @@ public:
     /** Set the position and size paramters. (0,0) == top-left of the stream. */
     void setParameters( const deflect::SegmentParameters& param );
 
+    /**
+     * Store the texture in a cell of an atlas instead of a texture of its own.
+     *
+     * The atlas renders the segment, render() must not be called.
+     * @param atlas The atlas shared by the segments, or 0 to use a texture
+     * @param cell The index of the cell of this segment in the atlas
+     */
+    void setAtlasCell( PixelStreamSegmentAtlas* atlas, size_t cell );
+
     /**
      * Render the current texture.
      *
@@ -87,7 +107,10 @@ public:
 private:
     GLTexture2D texture_;
     GLQuad quad_;
+    PixelStreamSegmentAtlas* atlas_;
+    size_t atlasCell_;
     QRect rect_;
+    QRect region_;
     bool textureNeedsUpdate_;
 };
 
@@ -0,0 +1,517 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "PixelStreamTranscoder.h"
+
+#include "Content.h"
+#include "ContentWindow.h"
+#include "log.h"
+#include "Profiler.h"
+#include "SegmentEncoder.h"
+#include "SegmentRegionDecoder.h"
+
+#include <QImage>
+#include <QStringList>
+#include <QtMath>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+const int BYTES_PER_PIXEL = 4;
+const int64_t STATISTICS_WINDOW_US = 1000000;
+
+uint64_t _getImageDataSize( const deflect::Frame& frame )
+{
+    uint64_t size = 0;
+    for( const deflect::Segment& segment : frame.segments )
+        size += segment.imageData.size();
+    return size;
+}
+
+QSize _getWindowSize( const ContentWindow& window )
+{
+    // Focused windows are larger, transcode for the largest of both sizes
+    QSizeF size = window.getCoordinates().size();
+    if( window.isFocused( ))
+        size = size.expandedTo( window.getFocusedCoordinates().size( ));
+    return QSize( qCeil( size.width( )), qCeil( size.height( )));
+}
+
+bool _hasValidSize( const deflect::Segment& segment )
+{
+    const deflect::SegmentParameters& params = segment.parameters;
+    const int size = params.width * params.height * BYTES_PER_PIXEL;
+    return segment.imageData.size() >= size;
+}
+
+// Copy the image data of all the segments of a frame into a single image
+QImage _assemble( SegmentRegionDecoder& decoder, const deflect::Frame& frame,
+                  const QSize& frameSize )
+{
+    QImage image( frameSize, QImage::Format_RGB32 );
+    image.fill( 0 );
+
+    DecodedRegion decoded;
+    for( const deflect::Segment& segment : frame.segments )
+    {
+        const deflect::SegmentParameters& params = segment.parameters;
+        const QRect rect( params.x, params.y, params.width, params.height );
+        if( segment.imageData.isEmpty() || rect.isEmpty( ))
+            continue;
+
+        const char* data = segment.imageData.constData();
+        if( params.compressed )
+        {
+            try
+            {
+                decoder.decode( segment, QRect( QPoint(), rect.size( )),
+                                decoded );
+            }
+            catch( const std::exception& e )
+            {
+                put_flog( LOG_ERROR, "Error decoding stream segment: '%s'",
+                          e.what( ));
+                continue;
+            }
+            data = decoded.imageData.constData();
+        }
+        else if( !_hasValidSize( segment ))
+            continue;
+
+        const int stride = rect.width() * BYTES_PER_PIXEL;
+        for( int y = 0; y < rect.height(); ++y )
+            std::memcpy( image.scanLine( rect.y() + y ) +
+                         rect.x() * BYTES_PER_PIXEL,
+                         data + y * stride, stride );
+    }
+    return image;
+}
+}
+
+struct PixelStreamTranscoder::Worker
+{
+    // The JPEG (de)compressors are not thread-safe
+    SegmentEncoder encoder;
+    SegmentRegionDecoder decoder;
+};
+
+struct PixelStreamTranscoder::Job
+{
+    QString uri;
+    deflect::FramePtr input;
+    deflect::FramePtr output;
+
+    // The retiled and downscaled frame, null if the segments are kept
+    QImage image;
+
+    std::atomic<size_t> remaining;
+};
+
+PixelStreamTranscoder::PixelStreamTranscoder( const unsigned int tileSize,
+                                              const unsigned int quality,
+                                              size_t threadCount )
+    : _tileSize( std::max( tileSize, 1u ))
+    , _quality( std::min( std::max( quality, 1u ), 100u ))
+    , _stop( false )
+    , _frameCount( 0 )
+    , _savedBytes( 0 )
+{
+    if( threadCount == 0 )
+        threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+
+    for( size_t i = 0; i < threadCount; ++i )
+        _threads.push_back( std::thread( &PixelStreamTranscoder::_run, this ));
+}
+
+PixelStreamTranscoder::~PixelStreamTranscoder()
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _stop = true;
+        // Only finish the frames which are being transcoded
+        for( StreamState& stream : _streams )
+            stream.frames.clear();
+    }
+    _taskAvailable.notify_all();
+
+    for( std::thread& thread : _threads )
+        thread.join();
+}
+
+void PixelStreamTranscoder::updateWindows( const ContentWindowPtrs& windows )
+{
+    QMap<QString, QSize> sizes;
+    for( ContentWindowPtr window : windows )
+        sizes[window->getContent()->getURI()] = _getWindowSize( *window );
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    _windowSizes.swap( sizes );
+}
+
+QSize PixelStreamTranscoder::getTargetSize( const QSize& frameSize,
+                                            const QSize& windowSize )
+{
+    if( windowSize.isEmpty() || frameSize.isEmpty( ))
+        return frameSize;
+
+    const qreal scale = std::min(
+                (qreal)windowSize.width() / frameSize.width(),
+                (qreal)windowSize.height() / frameSize.height( ));
+    if( scale >= 1.0 )
+        return frameSize;
+
+    return QSize( std::max( qRound( frameSize.width() * scale ), 1 ),
+                  std::max( qRound( frameSize.height() * scale ), 1 ));
+}
+
+uint64_t PixelStreamTranscoder::getFrameCount() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _frameCount;
+}
+
+int64_t PixelStreamTranscoder::getSavedBytes() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _savedBytes;
+}
+
+QString PixelStreamTranscoder::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    const int64_t now = Profiler::now();
+    QStringList statistics;
+    for( auto it = _streams.begin(); it != _streams.end(); ++it )
+    {
+        // The last measure is outdated if nothing was transcoded since
+        const bool outdated =
+                now - it->windowStart > 2 * STATISTICS_WINDOW_US;
+        const double input = outdated ? 0.0 : it->inputRate;
+        const double output = outdated ? 0.0 : it->outputRate;
+        const double saved = input > 0.0 ? 100.0 * ( 1.0 - output / input )
+                                         : 0.0;
+        statistics.append( QString( "transcode %1: in %2 MB/s, out %3 MB/s, "
+                                    "saved %4%, dropped %5" )
+                           .arg( it.key( ))
+                           .arg( input, 0, 'f', 1 ).arg( output, 0, 'f', 1 )
+                           .arg( saved, 0, 'f', 0 ).arg( it->droppedFrames ));
+    }
+    return statistics.join( '\n' );
+}
+
+void PixelStreamTranscoder::transcode( deflect::FramePtr frame )
+{
+    const QString uri = frame->uri;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        StreamState& stream = _streams[uri];
+        if( stream.windowStart == 0 )
+            stream.windowStart = Profiler::now();
+        stream.frames.push_back( frame );
+        if( stream.frames.size() > MAX_PENDING_FRAMES )
+        {
+            stream.frames.pop_front();
+            ++stream.droppedFrames;
+        }
+        if( stream.busy )
+            return;
+        stream.busy = true;
+    }
+    _start( uri );
+}
+
+void PixelStreamTranscoder::removeStream( const QString uri )
+{
+    StreamState stream;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto it = _streams.find( uri );
+        if( it == _streams.end( ))
+            return;
+        stream = *it;
+        _streams.erase( it );
+    }
+
+    if( stream.totalInput == 0 )
+        return;
+    put_flog( LOG_INFO, "Transcoded stream '%s': %.1f MB in, %.1f MB out, "
+                        "%llu frames dropped",
+              uri.toLocal8Bit().constData(), stream.totalInput / 1000000.0,
+              stream.totalOutput / 1000000.0,
+              (unsigned long long)stream.droppedFrames );
+}
+
+void PixelStreamTranscoder::_run()
+{
+    Worker worker;
+    while( true )
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _taskAvailable.wait( lock, [this]()
+                { return _stop || !_tasks.empty(); } );
+            // Finish the frames which are being transcoded before stopping
+            if( _tasks.empty( ))
+                return;
+            task = std::move( _tasks.front( ));
+            _tasks.pop_front();
+        }
+        task( worker );
+    }
+}
+
+void PixelStreamTranscoder::_push( Task task )
+{
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _tasks.push_back( std::move( task ));
+    }
+    _taskAvailable.notify_one();
+}
+
+void PixelStreamTranscoder::_start( const QString& uri )
+{
+    _push( [this, uri]( Worker& worker ) { _prepare( worker, uri ); } );
+}
+
+void PixelStreamTranscoder::_prepare( Worker& worker, const QString& uri )
+{
+    deflect::FramePtr frame;
+    QSize windowSize;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto it = _streams.find( uri );
+        if( it == _streams.end() || it->frames.empty( ))
+        {
+            if( it != _streams.end( ))
+                it->busy = false;
+            return;
+        }
+        frame = it->frames.front();
+        it->frames.pop_front();
+        windowSize = _windowSizes.value( uri );
+    }
+
+    ProfileScope scope( PROFILE_CATEGORY_CONTENT, "transcode frame" );
+
+    const QSize frameSize = frame->computeDimensions();
+    const QSize targetSize = getTargetSize( frameSize, windowSize );
+
+    bool retile = targetSize != frameSize;
+    bool compress = false;
+    for( const deflect::Segment& segment : frame->segments )
+    {
+        const deflect::SegmentParameters& params = segment.parameters;
+        if( (int)params.width > _tileSize || (int)params.height > _tileSize )
+            retile = true;
+        if( !params.compressed && !segment.imageData.isEmpty( ))
+            compress = true;
+    }
+
+    if( !retile && !compress )
+    {
+        _finish( uri, frame, frame );
+        return;
+    }
+
+    boost::shared_ptr<Job> job = boost::make_shared<Job>();
+    job->uri = uri;
+    job->input = frame;
+    job->output = boost::make_shared<deflect::Frame>();
+    job->output->uri = frame->uri;
+
+    std::vector<size_t> tiles;
+    if( retile )
+    {
+        job->image = _assemble( worker.decoder, *frame, frameSize );
+        if( targetSize != frameSize )
+            job->image = job->image.scaled( targetSize, Qt::IgnoreAspectRatio,
+                                            Qt::SmoothTransformation );
+
+        for( int y = 0; y < targetSize.height(); y += _tileSize )
+        {
+            for( int x = 0; x < targetSize.width(); x += _tileSize )
+            {
+                deflect::Segment segment;
+                segment.parameters.x = x;
+                segment.parameters.y = y;
+                segment.parameters.width =
+                        std::min( _tileSize, targetSize.width() - x );
+                segment.parameters.height =
+                        std::min( _tileSize, targetSize.height() - y );
+                segment.parameters.compressed = true;
+                tiles.push_back( job->output->segments.size( ));
+                job->output->segments.push_back( segment );
+            }
+        }
+    }
+    else
+    {
+        // Only compress the raw segments, keeping the layout of the frame
+        job->output->segments = frame->segments;
+        for( size_t i = 0; i < frame->segments.size(); ++i )
+        {
+            const deflect::Segment& segment = frame->segments[i];
+            if( !segment.parameters.compressed && _hasValidSize( segment ))
+                tiles.push_back( i );
+        }
+    }
+
+    job->remaining = tiles.size();
+    if( tiles.empty( ))
+    {
+        _finish( uri, frame, job->output );
+        return;
+    }
+
+    // Compress the first tile in this thread, the others in the pool
+    for( size_t i = 1; i < tiles.size(); ++i )
+    {
+        const size_t index = tiles[i];
+        _push( [this, job, index]( Worker& w ) { _compress( w, job, index ); });
+    }
+    _compress( worker, job, tiles[0] );
+}
+
+void PixelStreamTranscoder::_compress( Worker& worker,
+                                       boost::shared_ptr<Job> job,
+                                       const size_t index )
+{
+    deflect::Segment& segment = job->output->segments[index];
+    const deflect::SegmentParameters& params = segment.parameters;
+    const QSize size( params.width, params.height );
+
+    const char* data = 0;
+    int stride = 0;
+    if( job->image.isNull( ))
+    {
+        data = segment.imageData.constData();
+        stride = params.width * BYTES_PER_PIXEL;
+    }
+    else
+    {
+        const QImage& image = job->image;
+        data = (const char*)image.constScanLine( params.y ) +
+               params.x * BYTES_PER_PIXEL;
+        stride = image.bytesPerLine();
+    }
+
+    try
+    {
+        segment.imageData = worker.encoder.encode( data, size, stride,
+                                                   _quality );
+        segment.parameters.compressed = true;
+    }
+    catch( const std::exception& e )
+    {
+        put_flog( LOG_ERROR, "Error compressing stream segment: '%s'",
+                  e.what( ));
+        // Send the tile uncompressed, tightly packed
+        if( !job->image.isNull( ))
+        {
+            QByteArray raw( size.width() * size.height() * BYTES_PER_PIXEL,
+                            Qt::Uninitialized );
+            const int rowSize = size.width() * BYTES_PER_PIXEL;
+            for( int y = 0; y < size.height(); ++y )
+                std::memcpy( raw.data() + y * rowSize, data + y * stride,
+                             rowSize );
+            segment.imageData = raw;
+            segment.parameters.compressed = false;
+        }
+    }
+
+    if( --job->remaining == 0 )
+        _finish( job->uri, job->input, job->output );
+}
+
+void PixelStreamTranscoder::_finish( const QString& uri,
+                                     deflect::FramePtr input,
+                                     deflect::FramePtr output )
+{
+    const uint64_t inputSize = _getImageDataSize( *input );
+    const uint64_t outputSize = _getImageDataSize( *output );
+    const int64_t now = Profiler::now();
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        ++_frameCount;
+        _savedBytes += (int64_t)inputSize - (int64_t)outputSize;
+
+        auto it = _streams.find( uri );
+        if( it != _streams.end( ))
+        {
+            StreamState& stream = *it;
+            stream.totalInput += inputSize;
+            stream.totalOutput += outputSize;
+            stream.windowInput += inputSize;
+            stream.windowOutput += outputSize;
+            const int64_t elapsed = now - stream.windowStart;
+            if( elapsed >= STATISTICS_WINDOW_US )
+            {
+                // bytes/us == MB/s
+                stream.inputRate = stream.windowInput / (double)elapsed;
+                stream.outputRate = stream.windowOutput / (double)elapsed;
+                stream.windowStart = now;
+                stream.windowInput = 0;
+                stream.windowOutput = 0;
+            }
+        }
+    }
+
+    // Emit before starting the next frame of the stream to keep the order
+    emit transcoded( output );
+
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto it = _streams.find( uri );
+        if( it == _streams.end( ))
+            return;
+        if( it->frames.empty( ))
+        {
+            it->busy = false;
+            return;
+        }
+    }
+    _start( uri );
+}
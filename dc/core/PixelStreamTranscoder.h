@@ -0,0 +1,202 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMTRANSCODER_H
+#define PIXELSTREAMTRANSCODER_H
+
+#include "types.h"
+
+#include <QObject>
+#include <QMap>
+#include <QSize>
+#include <QString>
+
+#include <deflect/Frame.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Transcode pixel stream frames on the master before they are sent to the
+ * wall processes.
+ *
+ * Uncompressed segments are compressed to JPEG. Frames whose segments are
+ * larger than the tile size are split into tiles of that size, and frames
+ * larger than their window on the wall are downscaled to the size of the
+ * window. Frames which are already compressed, well segmented and not too
+ * large are forwarded unchanged.
+ *
+ * The frames of a stream are transcoded in order, one at a time, while the
+ * tiles of a frame and the frames of different streams are processed in
+ * parallel by a pool of threads. The transcoded() signal is emitted from
+ * these threads.
+ *
+ * The methods of this class are thread-safe.
+ */
+class PixelStreamTranscoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** The maximum number of frames waiting to be transcoded per stream. */
+    static const size_t MAX_PENDING_FRAMES = 2;
+
+    /**
+     * Constructor.
+     * @param tileSize The maximum size of the segments of transcoded frames
+     * @param quality The JPEG quality, from 1 to 100
+     * @param threadCount The number of threads, 0 for one per core
+     */
+    PixelStreamTranscoder( unsigned int tileSize, unsigned int quality,
+                           size_t threadCount = 0 );
+
+    /** Destructor, waits for the frames being transcoded. */
+    ~PixelStreamTranscoder();
+
+    /**
+     * Update the size of the windows of the streams, in wall pixels.
+     * @param windows The current windows of the DisplayGroup
+     */
+    void updateWindows( const ContentWindowPtrs& windows );
+
+    /**
+     * Get the dimensions of a frame once transcoded.
+     * @param frameSize The dimensions of the frame
+     * @param windowSize The size of the window of the stream on the wall,
+     *        empty if unknown
+     * @return the frame size, downscaled to fit in the window size
+     */
+    static QSize getTargetSize( const QSize& frameSize,
+                                const QSize& windowSize );
+
+    /** @return the number of frames transcoded or forwarded so far. */
+    uint64_t getFrameCount() const;
+
+    /**
+     * @return the number of bytes of image data saved by the transcoding
+     *         since the creation.
+     */
+    int64_t getSavedBytes() const;
+
+    /**
+     * @return for each stream, the input and output bandwidth of its image
+     *         data in the last second and the proportion saved.
+     */
+    QString getStatistics() const;
+
+public slots:
+    /**
+     * Queue a frame to be transcoded.
+     *
+     * If the frames of the stream are not transcoded fast enough, the oldest
+     * queued frame is dropped to keep MAX_PENDING_FRAMES.
+     * @param frame The frame received from the stream
+     */
+    void transcode( deflect::FramePtr frame );
+
+    /**
+     * Forget a stream which was closed.
+     * @param uri The identifier of the stream
+     */
+    void removeStream( QString uri );
+
+signals:
+    /**
+     * Emitted from a thread of the pool when a frame is ready to be sent.
+     * @param frame The transcoded frame, or the original one if it did not
+     *        need to be transcoded
+     */
+    void transcoded( deflect::FramePtr frame );
+
+private:
+    Q_DISABLE_COPY( PixelStreamTranscoder )
+
+    struct Worker;
+    struct Job;
+    typedef std::function<void( Worker& )> Task;
+
+    struct StreamState
+    {
+        StreamState() : busy( false ), droppedFrames( 0 ), totalInput( 0 ),
+                        totalOutput( 0 ), windowStart( 0 ), windowInput( 0 ),
+                        windowOutput( 0 ), inputRate( 0.0 ),
+                        outputRate( 0.0 ) {}
+
+        std::deque<deflect::FramePtr> frames;
+        bool busy;
+        uint64_t droppedFrames;
+        uint64_t totalInput;
+        uint64_t totalOutput;
+        int64_t windowStart;
+        uint64_t windowInput;
+        uint64_t windowOutput;
+        double inputRate;
+        double outputRate;
+    };
+
+    const int _tileSize;
+    const int _quality;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    std::deque<Task> _tasks;
+    QMap<QString, StreamState> _streams;
+    QMap<QString, QSize> _windowSizes;
+    std::vector<std::thread> _threads;
+    bool _stop;
+
+    uint64_t _frameCount;
+    int64_t _savedBytes;
+
+    void _run();
+    void _push( Task task );
+    void _start( const QString& uri );
+    void _prepare( Worker& worker, const QString& uri );
+    void _compress( Worker& worker, boost::shared_ptr<Job> job,
+                    size_t index );
+    void _finish( const QString& uri, deflect::FramePtr input,
+                  deflect::FramePtr output );
+};
+
+#endif // PIXELSTREAMTRANSCODER_H
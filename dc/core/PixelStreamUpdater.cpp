@@ -44,33 +44,180 @@
 #include "QmlWindowRenderer.h"
 #include "ContentWindow.h"
 #include "PixelStream.h"
+#include "PixelStreamContent.h"
+#include "PixelStreamDecodePool.h"
+#include "Profiler.h"
+#include "SegmentChangeTracker.h"
+#include "SwapSyncRegistry.h"
+#include "WallToWallChannel.h"
 
 #include <deflect/Frame.h>
 
+#include <QStringList>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
 PixelStreamUpdater::PixelStreamUpdater()
+    : _decodePool( boost::make_shared<PixelStreamDecodePool>( ))
+    , _segmentBatching( false )
 {
 }
 
-void PixelStreamUpdater::synchronizeFramesSwap( const SyncFunction&
-                                                versionCheckFunc )
+void PixelStreamUpdater::synchronizeFramesSwap(
+        SwapSyncRegistry& registry, const WallToWallChannel& wallChannel )
 {
+    // All processes receive the frames of a stream in the same order, but
+    // not at the same time. The frames that all of them can swap go from the
+    // maximum of the first queued frame to the minimum of the number of
+    // frames received.
     PixelStreamMap::const_iterator streamIt = _pixelStreamMap.begin();
     for( ; streamIt != _pixelStreamMap.end(); ++streamIt )
     {
         const QString& uri = streamIt.key();
+        const FrameQueue& queue = _frameQueues[uri];
+        registry.addValue( queue.getFirstIndex(), boost::bind(
+                               &PixelStreamUpdater::_onFirstFrameSynchronized,
+                               this, uri, _2 ));
+        registry.addValue( queue.receivedCount, boost::bind(
+                               &PixelStreamUpdater::_onFramesSynchronized,
+                               this, uri, boost::cref( wallChannel ), _1 ));
+    }
+}
+
+void PixelStreamUpdater::setSegmentBatching( const bool enabled )
+{
+    _segmentBatching = enabled;
+}
+
+QString PixelStreamUpdater::getDecodeStatistics() const
+{
+    return _decodePool->getStatistics();
+}
+
+QString PixelStreamUpdater::getFrameStatistics() const
+{
+    QStringList statistics;
+    PixelStreamMap::const_iterator streamIt = _pixelStreamMap.begin();
+    for( ; streamIt != _pixelStreamMap.end(); ++streamIt )
+    {
+        const FrameQueueMap::const_iterator queueIt =
+                _frameQueues.find( streamIt.key( ));
+        const PixelStreamPacingMode mode = queueIt != _frameQueues.end() ?
+                    queueIt->pacing.mode : PACING_LATEST_FRAME;
+        statistics.append( QString( "%1 [%2]: %3" ).arg( streamIt.key( ))
+                           .arg( PixelStreamPacing::getModeName( mode ))
+                           .arg( streamIt.value()->getFrameStatistics( )));
+    }
+    return statistics.join( '\n' );
+}
 
-        SwapSyncFrame& swapSyncFrame = _swapSyncFrames[uri];
-        if( swapSyncFrame.sync( versionCheckFunc ))
+void PixelStreamUpdater::updatePixelStream( deflect::FramePtr frame )
+{
+    FrameQueue& queue = _frameQueues[frame->uri];
+    queue.frames.push_back( ReceivedFrame{ frame, Profiler::now( )});
+    ++queue.receivedCount;
+
+    PixelStreamMap::const_iterator it = _pixelStreamMap.find( frame->uri );
+    if( it != _pixelStreamMap.end( ))
+        it.value()->addReceivedFrame();
+    else
+    {
+        // Until the window is opened, only the most recent frame is kept,
+        // completed with the unchanged segments of the previous one. The
+        // processes may keep different frames, the first one that they all
+        // swap is agreed on once the window is opened.
+        const size_t count = queue.frames.size();
+        if( count > 1 )
+            SegmentChangeTracker::fillUnchanged(
+                        *frame, *queue.frames[count - 2].frame );
+        queue.frames.erase( queue.frames.begin(), queue.frames.end() - 1 );
+    }
+}
+
+void PixelStreamUpdater::_onFirstFrameSynchronized(
+        const QString& uri, const uint64_t maxFirstIndex )
+{
+    if( _frameQueues.contains( uri ))
+        _frameQueues[uri].commonFirstIndex = maxFirstIndex;
+}
+
+void PixelStreamUpdater::_onFramesSynchronized(
+        const QString& uri, const WallToWallChannel& wallChannel,
+        const uint64_t globalReceivedCount )
+{
+    // The stream may have been closed by the DisplayGroup update which was
+    // synchronized in the same frame.
+    if( !_pixelStreamMap.contains( uri ))
+        return;
+
+    // The frames which all processes have received and still queue. The
+    // ones before are only queued by the processes which received them before
+    // the window was opened.
+    FrameQueue& queue = _frameQueues[uri];
+    if( globalReceivedCount < queue.commonFirstIndex )
+        return;
+
+    const uint64_t firstIndex = queue.getFirstIndex();
+    const size_t first = queue.commonFirstIndex - firstIndex;
+    const size_t last = globalReceivedCount - firstIndex;
+    PixelStreamPtr stream = _pixelStreamMap[uri];
+
+    // These conditions depend only on values which are identical on all
+    // processes, so that they all swap the same frame.
+    size_t next = last;
+    switch( queue.pacing.mode )
+    {
+    case PACING_IN_ORDER:
+        if( stream->hasPendingFrame( ))
+            return;
+        next = first;
+        break;
+    case PACING_MAX_FPS:
+        if( queue.pacing.maxFps > 0 && !queue.lastSwapTime.is_not_a_date_time()
+            && wallChannel.getTime() - queue.lastSwapTime <
+               boost::posix_time::microseconds( 1000000 / queue.pacing.maxFps ))
         {
-            streamIt.value()->setNewFrame( swapSyncFrame.get( ));
-            emit requestFrame( uri );
+            return;
         }
+        break;
+    case PACING_LATEST_FRAME:
+    default:
+        break;
     }
+
+    // The skipped frames are also set, in order, so that the stream counts
+    // them as dropped and reuses the image data of the segments which are not
+    // repeated in the following frames.
+    for( size_t i = 0; i <= next; ++i )
+        stream->setNewFrame( queue.frames[i].frame,
+                             queue.frames[i].receiveTime );
+    queue.frames.erase( queue.frames.begin(),
+                        queue.frames.begin() + next + 1 );
+    queue.lastSwapTime = wallChannel.getTime();
+
+    emit requestFrame( uri );
 }
 
-void PixelStreamUpdater::updatePixelStream( deflect::FramePtr frame )
+void PixelStreamUpdater::addPixelStream( const QString& uri,
+                                         PixelStreamPtr stream,
+                                         const PixelStreamPacing& pacing )
+{
+    _pixelStreamMap[uri] = stream;
+    stream->setDecodePool( _decodePool );
+    stream->setSegmentBatching( _segmentBatching );
+    _frameQueues[uri].pacing = pacing;
+}
+
+void PixelStreamUpdater::removePixelStream( const QString& uri )
 {
-    _swapSyncFrames[frame->uri].update( frame );
+    PixelStreamMap::iterator it = _pixelStreamMap.find( uri );
+    if( it != _pixelStreamMap.end( ))
+    {
+        disconnect( it.value().get( ));
+        _pixelStreamMap.erase( it );
+    }
+    _frameQueues.remove( uri );
 }
 
 void PixelStreamUpdater::onWindowAdded( QmlWindowPtr qmlWindow )
@@ -80,9 +227,11 @@ void PixelStreamUpdater::onWindowAdded( QmlWindowPtr qmlWindow )
         return;
 
     WallContentPtr stream = qmlWindow->getWallContent();
-
-    const QString& uri = window->getContent()->getURI();
-    _pixelStreamMap[uri] = boost::static_pointer_cast<PixelStream>( stream );
+    const PixelStreamContent& content =
+            static_cast<const PixelStreamContent&>( *window->getContent( ));
+    addPixelStream( content.getURI(),
+                    boost::static_pointer_cast<PixelStream>( stream ),
+                    content.getPacing( ));
 }
 
 void PixelStreamUpdater::onWindowRemoved( QmlWindowPtr qmlWindow )
@@ -91,8 +240,5 @@ void PixelStreamUpdater::onWindowRemoved( QmlWindowPtr qmlWindow )
     if( window->getContent()->getType() != CONTENT_TYPE_PIXEL_STREAM )
         return;
 
-    const QString& uri = window->getContent()->getURI();
-    disconnect( _pixelStreamMap[uri].get( ));
-    _pixelStreamMap.remove( uri );
-    _swapSyncFrames.remove( uri );
+    removePixelStream( window->getContent()->getURI( ));
 }
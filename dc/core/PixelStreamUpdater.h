@@ -42,13 +42,24 @@
 
 #include "types.h"
 
-#include "SwapSyncObject.h"
+#include "PixelStreamPacing.h"
+
+class SwapSyncRegistry;
 
 #include <QtCore/QObject>
 #include <QtCore/QMap>
 
+#include <boost/date_time/posix_time/ptime.hpp>
+
+#include <deque>
+
 /**
  * Synchronize the update of PixelStreams and send new frame requests.
+ *
+ * The frames received for each stream are queued until all processes have
+ * received them. The frame which is then swapped depends on the pacing of the
+ * stream: the latest one (the older ones are dropped), the next one in order,
+ * or the latest one if enough time has elapsed since the last swap.
  */
 class PixelStreamUpdater : public QObject
 {
@@ -58,8 +69,41 @@ public:
     /** Constructor. */
     PixelStreamUpdater();
 
-    /** Synchronize the update of the PixelStreams. */
-    void synchronizeFramesSwap( const SyncFunction& versionCheckFunc );
+    /**
+     * Synchronize the update of the PixelStreams.
+     * @param registry The registry in which to add the frames to synchronize.
+     *        New frames are swapped when the registry is synchronized.
+     * @param wallChannel The channel whose synchronized clock paces the
+     *        streams with a maximum frame rate
+     */
+    void synchronizeFramesSwap( SwapSyncRegistry& registry,
+                                const WallToWallChannel& wallChannel );
+
+    /**
+     * Render the segments of each stream from a single texture.
+     * @param enabled true to batch the segments, applied to the streams
+     *        opened after this call
+     */
+    void setSegmentBatching( bool enabled );
+
+    /** @return the statistics of the pool decoding the stream segments. */
+    QString getDecodeStatistics() const;
+
+    /** @return the pacing mode and frame counters of each stream. */
+    QString getFrameStatistics() const;
+
+    /**
+     * Receive the frames of a stream and swap them in sync with the other
+     * processes.
+     * @param uri The identifier of the stream
+     * @param stream The stream in which the frames are set
+     * @param pacing The pacing of the frames of the stream
+     */
+    void addPixelStream( const QString& uri, PixelStreamPtr stream,
+                         const PixelStreamPacing& pacing );
+
+    /** Stop updating a stream and drop its queued frames. */
+    void removePixelStream( const QString& uri );
 
 public slots:
     /** Update the appropriate PixelStream with the given frame. */
@@ -78,12 +122,44 @@ signals:
 private:
     Q_DISABLE_COPY( PixelStreamUpdater )
 
+    PixelStreamDecodePoolPtr _decodePool;
+    bool _segmentBatching;
+
     typedef QMap<QString,PixelStreamPtr> PixelStreamMap;
     PixelStreamMap _pixelStreamMap;
 
-    typedef SwapSyncObject<deflect::FramePtr> SwapSyncFrame;
-    typedef QMap<QString,SwapSyncFrame> SwapSyncFramesMap;
-    SwapSyncFramesMap _swapSyncFrames;
+    struct ReceivedFrame
+    {
+        deflect::FramePtr frame;
+        int64_t receiveTime;
+    };
+
+    struct FrameQueue
+    {
+        FrameQueue() : receivedCount( 0 ), commonFirstIndex( 0 ) {}
+
+        /** @return the index of the first queued frame, counted from 1. */
+        uint64_t getFirstIndex() const
+        {
+            return receivedCount - frames.size() + 1;
+        }
+
+        // The frames not swapped yet, the last one is the receivedCount-th
+        std::deque<ReceivedFrame> frames;
+        uint64_t receivedCount;
+        // The first frame that all processes have in their queue
+        uint64_t commonFirstIndex;
+        PixelStreamPacing pacing;
+        boost::posix_time::ptime lastSwapTime;
+    };
+    typedef QMap<QString,FrameQueue> FrameQueueMap;
+    FrameQueueMap _frameQueues;
+
+    void _onFirstFrameSynchronized( const QString& uri,
+                                    uint64_t maxFirstIndex );
+    void _onFramesSynchronized( const QString& uri,
+                                const WallToWallChannel& wallChannel,
+                                uint64_t globalReceivedCount );
 };
 
 #endif // PIXELSTREAMUPDATER_H
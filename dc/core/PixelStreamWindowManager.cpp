@@ -46,6 +46,7 @@
 #include "localstreamer/DockPixelStreamer.h"
 #include "localstreamer/PixelStreamerLauncher.h"
 #include "log.h"
+#include "PixelStreamContent.h"
 #include "PixelStreamInteractionDelegate.h"
 
 #include <deflect/Frame.h>
@@ -121,6 +122,11 @@ void PixelStreamWindowManager::openWindow( const QString& uri,
     ContentPtr content = ContentFactory::getPixelStreamContent( uri );
     if( size.isValid( ))
         content->setDimensions( size );
+    if( _pacingPolicy )
+    {
+        auto& stream = static_cast<PixelStreamContent&>( *content );
+        stream.setPacing( _pacingPolicy( uri ));
+    }
     ContentWindowPtr window( new ContentWindow( content, type ));
 
     ContentWindowController controller( *window, _displayGroup );
@@ -212,6 +218,11 @@ bool PixelStreamWindowManager::getAutoFocusNewWindows() const
     return _autoFocusNewWindows;
 }
 
+void PixelStreamWindowManager::setPacingPolicy( const PacingPolicy& policy )
+{
+    _pacingPolicy = policy;
+}
+
 void PixelStreamWindowManager::setAutoFocusNewWindows( const bool set )
 {
     _autoFocusNewWindows = set;
@@ -47,8 +47,11 @@
 #include <map>
 
 #include "types.h"
+#include "PixelStreamPacing.h"
 #include <deflect/SizeHints.h>
 
+#include <functional>
+
 /**
  * Handles window creation, association and updates for pixel streamers, both
  * local and external. The association is one streamer to one window.
@@ -100,6 +103,16 @@ public:
     /** Check if new windows open in focus mode. */
     bool getAutoFocusNewWindows() const;
 
+    /** Function returning the pacing policy of a stream from its URI. */
+    typedef std::function< PixelStreamPacing( const QString& ) > PacingPolicy;
+
+    /**
+     * Set the policy which gives the pacing of the new streams.
+     *
+     * @param policy the function called when a window is opened
+     */
+    void setPacingPolicy( const PacingPolicy& policy );
+
 public slots:
     /**
      * Open a window for a new external PixelStream.
@@ -177,6 +190,7 @@ private:
     ContentWindowMap _streamerWindows;
 
     bool _autoFocusNewWindows;
+    PacingPolicy _pacingPolicy;
 
     bool _isPanel( const QString& uri ) const;
 };
@@ -0,0 +1,149 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "ProfileTrace.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+void _writeString( std::ostream& output, const char* string )
+{
+    output << '"';
+    for( const char* c = string; *c != '\0'; ++c )
+    {
+        switch( *c )
+        {
+        case '"':
+            output << "\\\"";
+            break;
+        case '\\':
+            output << "\\\\";
+            break;
+        default:
+            if( (unsigned char)*c < 0x20 )
+            {
+                char escaped[8];
+                std::snprintf( escaped, sizeof( escaped ), "\\u%04x", *c );
+                output << escaped;
+            }
+            else
+                output << *c;
+            break;
+        }
+    }
+    output << '"';
+}
+}
+
+ProfileTrace::ProfileTrace()
+    : _expectedCount( 0 )
+{
+}
+
+void ProfileTrace::start( const size_t expectedCount )
+{
+    _profiles.clear();
+    _expectedCount = expectedCount;
+}
+
+void ProfileTrace::add( const int rank, const ProfileEvents& events )
+{
+    _profiles[rank] = events;
+}
+
+bool ProfileTrace::isComplete() const
+{
+    return _profiles.size() >= _expectedCount;
+}
+
+size_t ProfileTrace::getProcessCount() const
+{
+    return _profiles.size();
+}
+
+size_t ProfileTrace::getEventCount() const
+{
+    size_t count = 0;
+    for( const auto& profile : _profiles )
+        count += profile.second.size();
+    return count;
+}
+
+void ProfileTrace::writeChromeTrace( std::ostream& output ) const
+{
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for( const auto& profile : _profiles )
+    {
+        const int rank = profile.first;
+
+        if( !first )
+            output << ",";
+        first = false;
+        output << "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+               << ",\"tid\":0,\"args\":{\"name\":\"rank " << rank << "\"}}";
+        output << ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":"
+               << rank << ",\"tid\":0,\"args\":{\"sort_index\":" << rank
+               << "}}";
+
+        for( const ProfileEvent& event : profile.second )
+        {
+            output << ",\n{\"name\":";
+            _writeString( output, event.name );
+            output << ",\"cat\":\"" << event.getCategoryName()
+                   << "\",\"ph\":\"X\",\"ts\":" << event.start
+                   << ",\"dur\":" << event.duration
+                   << ",\"pid\":" << rank << ",\"tid\":0"
+                   << ",\"args\":{\"frame\":" << event.frame << "}}";
+        }
+    }
+    output << "\n]}\n";
+}
+
+bool ProfileTrace::save( const QString& filename ) const
+{
+    std::ofstream file( filename.toLocal8Bit().constData( ));
+    if( !file.is_open( ))
+        return false;
+
+    writeChromeTrace( file );
+    return file.good();
+}
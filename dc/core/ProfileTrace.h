@@ -0,0 +1,99 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PROFILETRACE_H
+#define PROFILETRACE_H
+
+#include "Profiler.h"
+
+#include <QString>
+
+#include <map>
+#include <ostream>
+
+/**
+ * Collect the profiles of several processes into a single trace.
+ *
+ * The trace is exported in the Chrome trace-event format (JSON), which can be
+ * loaded in chrome://tracing. Each process appears as a separate row, with
+ * the nested timings of its render loop.
+ */
+class ProfileTrace
+{
+public:
+    /** Constructor. */
+    ProfileTrace();
+
+    /**
+     * Start collecting a new trace.
+     * @param expectedCount The number of processes expected to send a profile
+     */
+    void start( size_t expectedCount );
+
+    /**
+     * Add the profile of a process.
+     * @param rank The MPI rank of the process
+     * @param events The profiled events of the process
+     */
+    void add( int rank, const ProfileEvents& events );
+
+    /** @return true if the profiles of all expected processes were added. */
+    bool isComplete() const;
+
+    /** @return the number of processes in the trace. */
+    size_t getProcessCount() const;
+
+    /** @return the total number of events in the trace. */
+    size_t getEventCount() const;
+
+    /** Write the trace in the Chrome trace-event JSON format. */
+    void writeChromeTrace( std::ostream& output ) const;
+
+    /**
+     * Save the trace in the Chrome trace-event JSON format.
+     * @param filename The destination file
+     * @return true on success
+     */
+    bool save( const QString& filename ) const;
+
+private:
+    std::map<int, ProfileEvents> _profiles;
+    size_t _expectedCount;
+};
+
+#endif // PROFILETRACE_H
@@ -0,0 +1,189 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+const uint64_t INVALID_SEQUENCE = ~uint64_t(0);
+
+size_t _roundToPowerOfTwo( const size_t value )
+{
+    size_t result = 1;
+    while( result < value )
+        result <<= 1;
+    return result;
+}
+}
+
+/**
+ * A slot of the ring buffer.
+ *
+ * The sequence is the index of the event stored in the slot. It is
+ * invalidated while the event is being written, so that readers can detect
+ * and skip partially written events (seqlock).
+ */
+struct Profiler::Slot
+{
+    Slot() : sequence( INVALID_SEQUENCE ) {}
+
+    std::atomic<uint64_t> sequence;
+    ProfileEvent event;
+};
+
+const char* ProfileEvent::getCategoryName() const
+{
+    switch( category )
+    {
+    case PROFILE_CATEGORY_FRAME:
+        return "frame";
+    case PROFILE_CATEGORY_PHASE:
+        return "phase";
+    case PROFILE_CATEGORY_CONTENT:
+        return "content";
+    case PROFILE_CATEGORY_MPI:
+        return "mpi";
+    case PROFILE_CATEGORY_GL:
+        return "gl";
+    default:
+        return "unknown";
+    }
+}
+
+Profiler::Profiler( const size_t capacity )
+    : _slots( new Slot[_roundToPowerOfTwo( std::max( capacity, size_t(1) ))] )
+    , _mask( _roundToPowerOfTwo( std::max( capacity, size_t(1) )) - 1 )
+    , _next( 0 )
+    , _frame( 0 )
+{
+}
+
+Profiler::~Profiler() {}
+
+void Profiler::record( const ProfileCategory category, const char* name,
+                       const int64_t start, const int64_t duration )
+{
+    const uint64_t index = _next.fetch_add( 1, std::memory_order_relaxed );
+    Slot& slot = _slots[index & _mask];
+
+    slot.sequence.store( INVALID_SEQUENCE, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    ProfileEvent& event = slot.event;
+    std::strncpy( event.name, name, PROFILE_NAME_SIZE - 1 );
+    event.name[PROFILE_NAME_SIZE - 1] = '\0';
+    event.category = category;
+    event.frame = _frame.load( std::memory_order_relaxed );
+    event.start = start;
+    event.duration = duration;
+
+    slot.sequence.store( index, std::memory_order_release );
+}
+
+void Profiler::setFrame( const uint32_t frame )
+{
+    _frame.store( frame, std::memory_order_relaxed );
+}
+
+uint32_t Profiler::getFrame() const
+{
+    return _frame.load( std::memory_order_relaxed );
+}
+
+size_t Profiler::getCapacity() const
+{
+    return _mask + 1;
+}
+
+uint64_t Profiler::getRecordedCount() const
+{
+    return _next.load( std::memory_order_acquire );
+}
+
+ProfileEvents Profiler::getEvents() const
+{
+    const uint64_t end = _next.load( std::memory_order_acquire );
+    const uint64_t begin = end > getCapacity() ? end - getCapacity() : 0;
+
+    ProfileEvents events;
+    events.reserve( end - begin );
+    for( uint64_t index = begin; index < end; ++index )
+    {
+        const Slot& slot = _slots[index & _mask];
+        if( slot.sequence.load( std::memory_order_acquire ) != index )
+            continue;
+
+        const ProfileEvent event = slot.event;
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if( slot.sequence.load( std::memory_order_relaxed ) == index )
+            events.push_back( event );
+    }
+    return events;
+}
+
+int64_t Profiler::now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+                system_clock::now().time_since_epoch( )).count();
+}
+
+Profiler& Profiler::global()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+ProfileScope::ProfileScope( const ProfileCategory category, const char* name,
+                            Profiler& profiler )
+    : _profiler( profiler )
+    , _category( category )
+    , _name( name )
+    , _start( Profiler::now( ))
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    _profiler.record( _category, _name, _start, Profiler::now() - _start );
+}
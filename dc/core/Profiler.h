@@ -0,0 +1,187 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+/** The category of a profiled event. */
+enum ProfileCategory
+{
+    PROFILE_CATEGORY_FRAME,   // a complete frame
+    PROFILE_CATEGORY_PHASE,   // a phase of the render loop
+    PROFILE_CATEGORY_CONTENT, // the update or rendering of a WallContent
+    PROFILE_CATEGORY_MPI,     // a collective MPI operation
+    PROFILE_CATEGORY_GL       // an OpenGL operation
+};
+
+/** The maximum length of the name of a ProfileEvent, including the '\0'. */
+const size_t PROFILE_NAME_SIZE = 48;
+
+/** A timed event recorded by the Profiler. */
+struct ProfileEvent
+{
+    /** The name of the event, truncated to PROFILE_NAME_SIZE. */
+    char name[PROFILE_NAME_SIZE];
+
+    /** The category of the event. */
+    ProfileCategory category;
+
+    /** The frame during which the event occured. */
+    uint32_t frame;
+
+    /** The start time of the event in us since the Unix epoch. */
+    int64_t start;
+
+    /** The duration of the event in us. */
+    int64_t duration;
+
+    /** @return the name of the category of the event. */
+    const char* getCategoryName() const;
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & boost::serialization::make_array( name, PROFILE_NAME_SIZE );
+        ar & category;
+        ar & frame;
+        ar & start;
+        ar & duration;
+    }
+};
+
+typedef std::vector<ProfileEvent> ProfileEvents;
+
+/**
+ * Record timed events in a lock-free ring buffer.
+ *
+ * Events are always recorded, the oldest ones being overwritten when the
+ * buffer is full. Recording only takes a clock read and an atomic increment,
+ * and can be done from any thread. getEvents() can be called concurrently
+ * from another thread; the events which are overwritten while they are being
+ * read are discarded.
+ */
+class Profiler : public boost::noncopyable
+{
+public:
+    /** The default number of events kept by the profiler. */
+    static const size_t DEFAULT_CAPACITY = 16384;
+
+    /**
+     * Constructor.
+     * @param capacity The maximum number of events kept, rounded up to the
+     *        next power of two
+     */
+    explicit Profiler( size_t capacity = DEFAULT_CAPACITY );
+
+    /** Destructor. */
+    ~Profiler();
+
+    /**
+     * Record an event.
+     * @param category The category of the event
+     * @param name The name of the event, copied and truncated if needed
+     * @param start The start time of the event in us, see now()
+     * @param duration The duration of the event in us
+     */
+    void record( ProfileCategory category, const char* name, int64_t start,
+                 int64_t duration );
+
+    /** Set the frame number assigned to the next recorded events. */
+    void setFrame( uint32_t frame );
+
+    /** @return the current frame number. */
+    uint32_t getFrame() const;
+
+    /** @return the maximum number of events kept. */
+    size_t getCapacity() const;
+
+    /** @return the number of events recorded since the creation. */
+    uint64_t getRecordedCount() const;
+
+    /** @return a copy of the events in the buffer, from oldest to newest. */
+    ProfileEvents getEvents() const;
+
+    /** @return the current time in us since the Unix epoch. */
+    static int64_t now();
+
+    /** @return the profiler of the process used by ProfileScope. */
+    static Profiler& global();
+
+private:
+    struct Slot;
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask;
+    std::atomic<uint64_t> _next;
+    std::atomic<uint32_t> _frame;
+};
+
+/**
+ * Record the duration of a scope in a Profiler.
+ */
+class ProfileScope : public boost::noncopyable
+{
+public:
+    /**
+     * Start timing the scope.
+     * @param category The category of the event
+     * @param name The name of the event, which must outlive the scope
+     * @param profiler The profiler where the event is recorded
+     */
+    ProfileScope( ProfileCategory category, const char* name,
+                  Profiler& profiler = Profiler::global( ));
+
+    /** Record the event. */
+    ~ProfileScope();
+
+private:
+    Profiler& _profiler;
+    const ProfileCategory _category;
+    const char* _name;
+    const int64_t _start;
+};
+
+#endif // PROFILER_H
@@ -43,6 +43,7 @@
 #include "ContentWindow.h"
 #include "ContentWindowController.h"
 #include "PixelStream.h"
+#include "Profiler.h"
 
 #include <QtDeclarative/QDeclarativeComponent>
 
@@ -102,13 +103,21 @@ void QmlWindowRenderer::update( ContentWindowPtr contentWindow )
 void QmlWindowRenderer::setStackingOrder( const int value )
 {
     windowItem_->setProperty( "stackingOrder", value );
+
+    // Decode the segments of the streams on top first
+    if( contentWindow_->getContent()->getType() == CONTENT_TYPE_PIXEL_STREAM )
+        static_cast<PixelStream*>( wallContent_.get( ))->setDecodePriority(
+                    value );
 }
 
 void QmlWindowRenderer::preRenderUpdate( WallToWallChannel& wallChannel,
+                                         SwapSyncRegistry& registry,
                                          const QRect& visibleWallArea )
 {
+    ProfileScope scope( PROFILE_CATEGORY_CONTENT,
+                        wallContent_->getProfileName( ));
     wallContent_->preRenderUpdate( contentWindow_, visibleWallArea );
-    wallContent_->preRenderSync( wallChannel );
+    wallContent_->preRenderSync( wallChannel, registry );
 }
 
 void QmlWindowRenderer::postRenderUpdate( WallToWallChannel& wallChannel )
@@ -71,6 +71,7 @@ public:
     void setStackingOrder( int value );
 
     void preRenderUpdate( WallToWallChannel& wallChannel,
+                          SwapSyncRegistry& registry,
                           const QRect& visibleWallArea );
     void postRenderUpdate( WallToWallChannel& wallChannel );
 
@@ -40,6 +40,7 @@
 
 #include "configuration/WallConfiguration.h"
 #include "GLWindow.h"
+#include "Profiler.h"
 #include "TestPattern.h"
 #include "WallWindow.h"
 #include "log.h"
@@ -126,6 +127,7 @@ void RenderContext::updateGLWindows()
         window->setBlockDrawCalls( true );
 #endif
     }
+    ProfileScope scope( PROFILE_CATEGORY_GL, "glFinish" );
     glFinish();
 }
 
@@ -161,6 +163,14 @@ void RenderContext::displayFps( const bool value )
     }
 }
 
+void RenderContext::setStatistics( const QString& statistics )
+{
+    BOOST_FOREACH( WallWindowPtr window, windows_ )
+    {
+        window->setStatistics( statistics );
+    }
+}
+
 void RenderContext::displayTestPattern( const bool value )
 {
     BOOST_FOREACH( WallWindowPtr window, windows_ )
@@ -86,6 +86,9 @@ public:
     /** Display or hide the fps counter. */
     void displayFps( bool value );
 
+    /** Set additional statistics to display below the fps counter. */
+    void setStatistics( const QString& statistics );
+
 private:
     void setupOpenGLWindows( const WallConfiguration& config );
     void setupVSync();
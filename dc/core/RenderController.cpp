@@ -47,94 +47,96 @@
 #include "Options.h"
 #include "WallToWallChannel.h"
 
-#include <boost/make_shared.hpp>
 #include <boost/bind.hpp>
 
 RenderController::RenderController( RenderContextPtr renderContext )
     : renderContext_( renderContext )
     , displayGroupRenderer_( new DisplayGroupRenderer( renderContext ))
-    , syncQuit_( false )
-    , syncDisplayGroup_( boost::make_shared<DisplayGroup>( QSize( )))
-    , syncOptions_( boost::make_shared<Options>( ))
 {
-    syncDisplayGroup_.setCallback( boost::bind(
-                                       &DisplayGroupRenderer::setDisplayGroup,
-                                       displayGroupRenderer_.get(), _1 ));
-
     MarkerRenderer& markers = renderContext_->getScene().getMarkersRenderer();
-    syncMarkers_.setCallback( boost::bind( &MarkerRenderer::setMarkers,
-                                           &markers, _1 ));
+    sceneSynchronizer_.setMarkersCallback(
+                boost::bind( &MarkerRenderer::setMarkers, &markers, _1 ));
+
+    sceneSynchronizer_.setOptionsCallback(
+                boost::bind( &RenderController::setRenderOptions, this, _1 ));
 
-    syncOptions_.setCallback( boost::bind( &RenderController::setRenderOptions,
-                                          this, _1 ));
+    sceneSynchronizer_.setDisplayGroupCallback(
+                boost::bind( &DisplayGroupRenderer::update,
+                             displayGroupRenderer_.get(), _1 ));
+
+    PixelStreamUpdater& pixelStreamUpdater =
+            sceneSynchronizer_.getPixelStreamUpdater();
 
     connect( displayGroupRenderer_.get(),
              SIGNAL( windowAdded( QmlWindowPtr )),
-             &pixelStreamUpdater_, SLOT( onWindowAdded( QmlWindowPtr )));
+             &pixelStreamUpdater, SLOT( onWindowAdded( QmlWindowPtr )));
 
     connect( displayGroupRenderer_.get(),
              SIGNAL( windowRemoved( QmlWindowPtr )),
-             &pixelStreamUpdater_, SLOT( onWindowRemoved( QmlWindowPtr )));
+             &pixelStreamUpdater, SLOT( onWindowRemoved( QmlWindowPtr )));
 }
 
 DisplayGroupPtr RenderController::getDisplayGroup() const
 {
-    return syncDisplayGroup_.get();
+    return displayGroupRenderer_->getDisplayGroup();
 }
 
 PixelStreamUpdater& RenderController::getPixelStreamUpdater()
 {
-    return pixelStreamUpdater_;
+    return sceneSynchronizer_.getPixelStreamUpdater();
 }
 
-void RenderController::preRenderUpdate( WallToWallChannel& wallChannel )
+const SwapSyncRegistry& RenderController::getSyncRegistry() const
 {
-    const SyncFunction& versionCheckFunc =
-        boost::bind( &WallToWallChannel::checkVersion, &wallChannel, _1 );
+    return sceneSynchronizer_.getSyncRegistry();
+}
 
-    synchronizeObjects( versionCheckFunc );
+void RenderController::synchronizeObjects( WallToWallChannel& wallChannel )
+{
+    sceneSynchronizer_.synchronizeObjects( wallChannel );
+}
 
-    displayGroupRenderer_->preRenderUpdate( wallChannel );
+void RenderController::preRenderUpdate( WallToWallChannel& wallChannel )
+{
+    SwapSyncRegistry& registry = sceneSynchronizer_.getSyncRegistry();
+    displayGroupRenderer_->preRenderUpdate( wallChannel, registry );
+    registry.synchronize( wallChannel );
 }
 
 void RenderController::postRenderUpdate( WallToWallChannel& wallChannel )
 {
     displayGroupRenderer_->postRenderUpdate( wallChannel );
+    sceneSynchronizer_.getSyncRegistry().endFrame();
 }
 
 bool RenderController::quitRendering() const
 {
-    return syncQuit_.get();
+    return sceneSynchronizer_.quitRendering();
 }
 
-void RenderController::updateQuit()
+bool RenderController::getShowStatistics() const
 {
-    syncQuit_.update( true );
+    return sceneSynchronizer_.getOptions()->getShowStatistics();
 }
 
-void RenderController::updateDisplayGroup( DisplayGroupPtr displayGroup )
+void RenderController::updateQuit()
 {
-    syncDisplayGroup_.update( displayGroup );
+    sceneSynchronizer_.updateQuit();
 }
 
-void RenderController::updateOptions( OptionsPtr options )
+void RenderController::updateDisplayGroup( DisplayGroupDeltaPtr delta )
 {
-    syncOptions_.update( options );
+    sceneSynchronizer_.updateDisplayGroup( delta );
 }
 
-void RenderController::updateMarkers( MarkersPtr markers )
+void RenderController::updateOptions( OptionsPtr options )
 {
-    syncMarkers_.update( markers );
+    sceneSynchronizer_.updateOptions( options );
 }
 
-void RenderController::synchronizeObjects( const SyncFunction&
-                                           versionCheckFunc )
+void RenderController::updateMarkers( MarkersPtr markers )
 {
-    syncQuit_.sync( versionCheckFunc );
-    syncDisplayGroup_.sync( versionCheckFunc );
-    syncMarkers_.sync( versionCheckFunc );
-    syncOptions_.sync( versionCheckFunc );
-    pixelStreamUpdater_.synchronizeFramesSwap( versionCheckFunc );
+    sceneSynchronizer_.updateMarkers( markers );
 }
 
 void RenderController::setRenderOptions( OptionsPtr options )
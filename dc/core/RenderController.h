@@ -42,8 +42,7 @@
 
 #include "types.h"
 
-#include "SwapSyncObject.h"
-#include "PixelStreamUpdater.h"
+#include "SceneSynchronizer.h"
 
 #include <QObject>
 
@@ -64,7 +63,23 @@ public:
     /** Get the PixelStream updater. */
     PixelStreamUpdater& getPixelStreamUpdater();
 
-    /** Update and synchronize scene objects before rendering a frame. */
+    /** Get the registry used to synchronize the scene objects. */
+    const SwapSyncRegistry& getSyncRegistry() const;
+
+    /**
+     * Synchronize the clock and swap the scene objects before a frame.
+     *
+     * The frame clock, the quit flag, the DisplayGroup, Options, Markers and
+     * all pixel stream frames are resolved by a single collective.
+     */
+    void synchronizeObjects( WallToWallChannel& wallChannel );
+
+    /**
+     * Update and synchronize the window contents before rendering a frame.
+     *
+     * The decoding status of the pixel streams and the timestamps of the
+     * movies are resolved by a single collective.
+     */
     void preRenderUpdate( WallToWallChannel& wallChannel );
 
     /** Update and synchronize scene objects after rendering a frame. */
@@ -73,9 +88,12 @@ public:
     /** Do we need to stop rendering. */
     bool quitRendering() const;
 
+    /** Are the statistics shown on the wall. */
+    bool getShowStatistics() const;
+
 public slots:
     void updateQuit();
-    void updateDisplayGroup( DisplayGroupPtr displayGroup );
+    void updateDisplayGroup( DisplayGroupDeltaPtr delta );
     void updateOptions( OptionsPtr options );
     void updateMarkers( MarkersPtr markers );
 
@@ -85,14 +103,8 @@ private:
     RenderContextPtr renderContext_;
 
     DisplayGroupRendererPtr displayGroupRenderer_;
-    PixelStreamUpdater pixelStreamUpdater_;
-
-    SwapSyncObject<bool> syncQuit_;
-    SwapSyncObject<DisplayGroupPtr> syncDisplayGroup_;
-    SwapSyncObject<OptionsPtr> syncOptions_;
-    SwapSyncObject<MarkersPtr> syncMarkers_;
+    SceneSynchronizer sceneSynchronizer_;
 
-    void synchronizeObjects( const SyncFunction& versionCheckFunc );
     void setRenderOptions( OptionsPtr options );
 };
 
@@ -0,0 +1,145 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SceneSynchronizer.h"
+
+#include "DisplayGroupDelta.h"
+#include "Options.h"
+#include "WallToWallChannel.h"
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
+SceneSynchronizer::SceneSynchronizer()
+    : _syncQuit( false )
+    , _displayGroupVersion( 0 )
+    , _syncOptions( boost::make_shared<Options>( ))
+{
+}
+
+void SceneSynchronizer::setDisplayGroupCallback( const DeltaCallback& callback )
+{
+    _displayGroupCallback = callback;
+}
+
+void SceneSynchronizer::setOptionsCallback(
+        const SwapSyncObject<OptionsPtr>::SyncCallbackFunction& callback )
+{
+    _syncOptions.setCallback( callback );
+}
+
+void SceneSynchronizer::setMarkersCallback(
+        const SwapSyncObject<MarkersPtr>::SyncCallbackFunction& callback )
+{
+    _syncMarkers.setCallback( callback );
+}
+
+PixelStreamUpdater& SceneSynchronizer::getPixelStreamUpdater()
+{
+    return _pixelStreamUpdater;
+}
+
+SwapSyncRegistry& SceneSynchronizer::getSyncRegistry()
+{
+    return _syncRegistry;
+}
+
+const SwapSyncRegistry& SceneSynchronizer::getSyncRegistry() const
+{
+    return _syncRegistry;
+}
+
+void SceneSynchronizer::synchronizeObjects( WallToWallChannel& wallChannel )
+{
+    wallChannel.synchronizeClock( _syncRegistry );
+    _syncRegistry.add( _syncQuit );
+    _syncRegistry.add( _displayGroupVersion, boost::bind(
+                           &SceneSynchronizer::_applyDisplayGroupDeltas,
+                           this, _1 ));
+    _syncRegistry.add( _syncMarkers );
+    _syncRegistry.add( _syncOptions );
+    _pixelStreamUpdater.synchronizeFramesSwap( _syncRegistry, wallChannel );
+
+    _syncRegistry.synchronize( wallChannel );
+}
+
+bool SceneSynchronizer::quitRendering() const
+{
+    return _syncQuit.get();
+}
+
+OptionsPtr SceneSynchronizer::getOptions() const
+{
+    return _syncOptions.get();
+}
+
+void SceneSynchronizer::updateQuit()
+{
+    _syncQuit.update( true );
+}
+
+void SceneSynchronizer::updateDisplayGroup( DisplayGroupDeltaPtr delta )
+{
+    if( delta->isSnapshot( ))
+        _displayGroupDeltas.clear();
+    _displayGroupDeltas.push_back( delta );
+    ++_displayGroupVersion;
+}
+
+void SceneSynchronizer::updateOptions( OptionsPtr options )
+{
+    _syncOptions.update( options );
+}
+
+void SceneSynchronizer::updateMarkers( MarkersPtr markers )
+{
+    _syncMarkers.update( markers );
+}
+
+void SceneSynchronizer::_applyDisplayGroupDeltas( const bool versionInSync )
+{
+    if( !versionInSync || _displayGroupDeltas.empty( ))
+        return;
+
+    if( _displayGroupCallback )
+    {
+        for( DisplayGroupDeltaPtr delta : _displayGroupDeltas )
+            _displayGroupCallback( *delta );
+    }
+    _displayGroupDeltas.clear();
+}
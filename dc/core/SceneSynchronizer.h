@@ -0,0 +1,128 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef SCENESYNCHRONIZER_H
+#define SCENESYNCHRONIZER_H
+
+#include "types.h"
+
+#include "PixelStreamUpdater.h"
+#include "SwapSyncObject.h"
+#include "SwapSyncRegistry.h"
+
+#include <boost/function/function1.hpp>
+#include <boost/noncopyable.hpp>
+
+/**
+ * Synchronize the scene objects received from the master across the wall
+ * processes.
+ *
+ * The frame clock, the quit flag, the DisplayGroup, Options, Markers and the
+ * pixel stream frames are resolved by a single collective before each frame.
+ * This does not render anything, the updates are applied through callbacks.
+ */
+class SceneSynchronizer : public boost::noncopyable
+{
+public:
+    /** Callback applying a DisplayGroup delta received by all processes. */
+    typedef boost::function< void( const DisplayGroupDelta& ) > DeltaCallback;
+
+    /** Constructor. */
+    SceneSynchronizer();
+
+    /** Set the function which applies the synchronized DisplayGroup deltas. */
+    void setDisplayGroupCallback( const DeltaCallback& callback );
+
+    /** Set the function called when new Options are swapped. */
+    void setOptionsCallback(
+            const SwapSyncObject<OptionsPtr>::SyncCallbackFunction& callback );
+
+    /** Set the function called when new Markers are swapped. */
+    void setMarkersCallback(
+            const SwapSyncObject<MarkersPtr>::SyncCallbackFunction& callback );
+
+    /** Get the PixelStream updater. */
+    PixelStreamUpdater& getPixelStreamUpdater();
+
+    /** Get the registry used to synchronize the scene objects. */
+    SwapSyncRegistry& getSyncRegistry();
+
+    /** @copydoc getSyncRegistry() */
+    const SwapSyncRegistry& getSyncRegistry() const;
+
+    /** Synchronize the clock and swap the scene objects before a frame. */
+    void synchronizeObjects( WallToWallChannel& wallChannel );
+
+    /** Do we need to stop rendering. */
+    bool quitRendering() const;
+
+    /** Get the current (synchronized) Options. */
+    OptionsPtr getOptions() const;
+
+    /** Request to quit after the next synchronization. */
+    void updateQuit();
+
+    /**
+     * Queue a DisplayGroup delta.
+     *
+     * Unlike other objects, deltas can not be dropped. They are queued until
+     * all processes have received them.
+     */
+    void updateDisplayGroup( DisplayGroupDeltaPtr delta );
+
+    /** Update the Options, swapped at the next synchronization. */
+    void updateOptions( OptionsPtr options );
+
+    /** Update the Markers, swapped at the next synchronization. */
+    void updateMarkers( MarkersPtr markers );
+
+private:
+    PixelStreamUpdater _pixelStreamUpdater;
+    SwapSyncRegistry _syncRegistry;
+
+    SwapSyncObject<bool> _syncQuit;
+    std::vector<DisplayGroupDeltaPtr> _displayGroupDeltas;
+    uint64_t _displayGroupVersion;
+    DeltaCallback _displayGroupCallback;
+    SwapSyncObject<OptionsPtr> _syncOptions;
+    SwapSyncObject<MarkersPtr> _syncMarkers;
+
+    void _applyDisplayGroupDeltas( bool versionInSync );
+};
+
+#endif // SCENESYNCHRONIZER_H
@@ -0,0 +1,232 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SegmentChangeTracker.h"
+
+#include "CopyCounter.h"
+
+#include <cstring>
+
+namespace
+{
+const uint64_t HASH_SEED = 0x9e3779b97f4a7c15ULL;
+const uint64_t HASH_PRIME = 0xff51afd7ed558ccdULL;
+
+inline uint64_t mix( uint64_t value, const uint64_t word )
+{
+    value ^= word;
+    value *= HASH_PRIME;
+    return value ^ ( value >> 29 );
+}
+
+bool haveSameParameters( const deflect::SegmentParameters& params1,
+                         const deflect::SegmentParameters& params2 )
+{
+    return params1.x == params2.x && params1.y == params2.y &&
+           params1.width == params2.width &&
+           params1.height == params2.height &&
+           params1.compressed == params2.compressed;
+}
+}
+
+SegmentChangeTracker::SegmentChangeTracker()
+    : _segmentCount( 0 )
+    , _unchangedCount( 0 )
+    , _unchangedBytes( 0 )
+{
+}
+
+std::vector<bool> SegmentChangeTracker::update( const deflect::Frame& frame )
+{
+    const deflect::Segments& segments = frame.segments;
+    std::vector<bool> changed( segments.size(), true );
+
+    StreamState& stream = _streams[frame.uri];
+    bool sameLayout = stream.layout.size() == segments.size();
+    for( size_t i = 0; sameLayout && i < segments.size(); ++i )
+        sameLayout = haveSameParameters( stream.layout[i],
+                                         segments[i].parameters );
+
+    const bool keyframe = stream.frameCount++ % KEYFRAME_INTERVAL == 0;
+
+    stream.layout.resize( segments.size( ));
+    stream.hashes.resize( segments.size( ));
+    for( size_t i = 0; i < segments.size(); ++i )
+    {
+        const uint64_t dataHash = hash( segments[i].imageData );
+        if( sameLayout && !keyframe && dataHash == stream.hashes[i] &&
+            !segments[i].imageData.isEmpty( ))
+        {
+            changed[i] = false;
+            ++_unchangedCount;
+            _unchangedBytes += segments[i].imageData.size();
+        }
+        stream.layout[i] = segments[i].parameters;
+        stream.hashes[i] = dataHash;
+    }
+    _segmentCount += segments.size();
+
+    return changed;
+}
+
+void SegmentChangeTracker::removeStream( const QString& uri )
+{
+    _streams.remove( uri );
+}
+
+uint64_t SegmentChangeTracker::getSegmentCount() const
+{
+    return _segmentCount;
+}
+
+uint64_t SegmentChangeTracker::getUnchangedCount() const
+{
+    return _unchangedCount;
+}
+
+uint64_t SegmentChangeTracker::getUnchangedBytes() const
+{
+    return _unchangedBytes;
+}
+
+deflect::FramePtr SegmentChangeTracker::removeUnchanged(
+        deflect::FramePtr frame, const std::vector<bool>& changed )
+{
+    assert( changed.empty() || changed.size() == frame->segments.size( ));
+
+    bool allChanged = true;
+    for( size_t i = 0; allChanged && i < changed.size(); ++i )
+        allChanged = changed[i] || frame->segments[i].imageData.isEmpty();
+    if( allChanged )
+        return frame;
+
+    // The frame may be shared (with the PixelStreamRouter), only its copy is
+    // modified. The image data of the changed segments is not copied.
+    deflect::FramePtr stripped( new deflect::Frame( *frame ));
+    for( size_t i = 0; i < changed.size(); ++i )
+    {
+        if( !changed[i] )
+            setUnchanged( stripped->segments[i] );
+    }
+    return stripped;
+}
+
+void SegmentChangeTracker::setUnchanged( deflect::Segment& segment )
+{
+    // Unchanged segments have empty but non-null image data, while the
+    // segments which are not routed have null image data.
+    segment.imageData = QByteArray( "" );
+}
+
+bool SegmentChangeTracker::isUnchanged( const deflect::Segment& segment )
+{
+    return segment.imageData.isEmpty() && !segment.imageData.isNull();
+}
+
+size_t SegmentChangeTracker::fillUnchanged( deflect::Frame& frame,
+                                            const deflect::Frame& previous )
+{
+    if( !hasSameLayout( frame.segments, previous.segments ))
+        return 0;
+
+    size_t count = 0;
+    for( size_t i = 0; i < frame.segments.size(); ++i )
+    {
+        QByteArray& data = frame.segments[i].imageData;
+        const QByteArray& previousData = previous.segments[i].imageData;
+        if( !isUnchanged( frame.segments[i] ) || previousData.isEmpty( ))
+            continue;
+
+        // The previous data may be a view of a receive buffer which is
+        // released with the previous frame
+        data = QByteArray( previousData.constData(), previousData.size( ));
+        CopyCounter::global().record( previousData.size( ));
+        ++count;
+    }
+    return count;
+}
+
+bool SegmentChangeTracker::hasSameLayout( const deflect::Segments& segments1,
+                                          const deflect::Segments& segments2 )
+{
+    if( segments1.size() != segments2.size( ))
+        return false;
+
+    for( size_t i = 0; i < segments1.size(); ++i )
+    {
+        if( !haveSameParameters( segments1[i].parameters,
+                                 segments2[i].parameters ))
+            return false;
+    }
+    return true;
+}
+
+uint64_t SegmentChangeTracker::hash( const QByteArray& data )
+{
+    const char* bytes = data.constData();
+    const size_t size = data.size();
+
+    // Four independent lanes of 64-bit words, to hash several bytes per cycle
+    uint64_t lanes[4] = { HASH_SEED, HASH_SEED + 1, HASH_SEED + 2,
+                          HASH_SEED + 3 };
+    const size_t blockSize = sizeof( lanes );
+    size_t offset = 0;
+    for( ; offset + blockSize <= size; offset += blockSize )
+    {
+        uint64_t words[4];
+        std::memcpy( words, bytes + offset, blockSize );
+        for( size_t lane = 0; lane < 4; ++lane )
+            lanes[lane] = mix( lanes[lane], words[lane] );
+    }
+
+    uint64_t value = size;
+    for( ; offset + sizeof( uint64_t ) <= size; offset += sizeof( uint64_t ))
+    {
+        uint64_t word;
+        std::memcpy( &word, bytes + offset, sizeof( uint64_t ));
+        value = mix( value, word );
+    }
+
+    uint64_t tail = 0;
+    std::memcpy( &tail, bytes + offset, size - offset );
+    value = mix( value, tail );
+
+    for( size_t lane = 0; lane < 4; ++lane )
+        value = mix( value, lanes[lane] );
+    return value;
+}
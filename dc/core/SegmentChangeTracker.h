@@ -0,0 +1,162 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef SEGMENTCHANGETRACKER_H
+#define SEGMENTCHANGETRACKER_H
+
+#include "types.h"
+
+#include <deflect/Frame.h>
+#include <deflect/SegmentParameters.h>
+
+#include <QMap>
+#include <QString>
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * Detect the segments of pixel stream frames which did not change since the
+ * previous frame of their stream.
+ *
+ * The image data of each segment is hashed on the master, so that unchanged
+ * segments can be sent without their image data. Such segments carry an
+ * explicit unchanged marker (see setUnchanged()), which tells the wall
+ * processes to reuse the data and texture they already have. It is distinct
+ * from the null image data of the segments which are not routed to a
+ * process, which must never be filled with older data.
+ *
+ * A complete frame is sent every KEYFRAME_INTERVAL frames of a stream, to
+ * resynchronize processes which may have missed an update.
+ */
+class SegmentChangeTracker
+{
+public:
+    /** The number of frames of a stream between two complete frames. */
+    static const unsigned int KEYFRAME_INTERVAL = 100;
+
+    /** Constructor. */
+    SegmentChangeTracker();
+
+    /**
+     * Update the hashes of the segments of a stream with a new frame.
+     * @param frame The new frame of the stream
+     * @return for each segment, true if its image data must be sent
+     */
+    std::vector<bool> update( const deflect::Frame& frame );
+
+    /**
+     * Forget a stream, so that its next frame is sent completely.
+     * @param uri The identifier of the stream
+     */
+    void removeStream( const QString& uri );
+
+    /** @return the number of segments processed by update(). */
+    uint64_t getSegmentCount() const;
+
+    /** @return the number of segments found unchanged by update(). */
+    uint64_t getUnchangedCount() const;
+
+    /** @return the image data of the unchanged segments, in bytes. */
+    uint64_t getUnchangedBytes() const;
+
+    /**
+     * Remove the image data of the unchanged segments of a frame.
+     * @param frame The frame to send
+     * @param changed The result of update() for the frame, all the segments
+     *        are changed if it is empty
+     * @return the frame if all its segments changed, otherwise a copy of the
+     *         frame where the unchanged segments are marked as such
+     */
+    static deflect::FramePtr removeUnchanged(
+            deflect::FramePtr frame, const std::vector<bool>& changed );
+
+    /**
+     * Mark a segment as unchanged, replacing its image data.
+     * @param segment The segment to mark
+     */
+    static void setUnchanged( deflect::Segment& segment );
+
+    /**
+     * @return true if a segment is marked as unchanged, false if it has image
+     *         data or is not routed.
+     */
+    static bool isUnchanged( const deflect::Segment& segment );
+
+    /**
+     * Fill the segments of a frame which are marked as unchanged with the data
+     * of the segments of a previous frame, if both have the same layout.
+     *
+     * This is used when the previous frame is dropped. The image data is
+     * copied, so that the frame does not depend on the storage of the
+     * previous one.
+     * @param frame The frame to complete
+     * @param previous The frame which is dropped
+     * @return the number of segments filled
+     */
+    static size_t fillUnchanged( deflect::Frame& frame,
+                                 const deflect::Frame& previous );
+
+    /**
+     * @return true if the segments of two frames have the same position,
+     *         size and compression.
+     */
+    static bool hasSameLayout( const deflect::Segments& segments1,
+                               const deflect::Segments& segments2 );
+
+    /** @return the hash of the image data of a segment. */
+    static uint64_t hash( const QByteArray& data );
+
+private:
+    struct StreamState
+    {
+        StreamState() : frameCount( 0 ) {}
+
+        std::vector<deflect::SegmentParameters> layout;
+        std::vector<uint64_t> hashes;
+        uint64_t frameCount;
+    };
+
+    QMap<QString, StreamState> _streams;
+    uint64_t _segmentCount;
+    uint64_t _unchangedCount;
+    uint64_t _unchangedBytes;
+};
+
+#endif // SEGMENTCHANGETRACKER_H
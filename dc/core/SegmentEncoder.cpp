@@ -0,0 +1,184 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SegmentEncoder.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include <jpeglib.h>
+
+namespace
+{
+// Compressed segments are usually an order of magnitude smaller than raw ones
+const int INITIAL_COMPRESSION_RATIO = 8;
+const int BYTES_PER_PIXEL = 4;
+const int MIN_OUTPUT_SIZE = 1024;
+
+struct ErrorManager
+{
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void onError( j_common_ptr info )
+{
+    ErrorManager* error = reinterpret_cast<ErrorManager*>( info->err );
+    ( *info->err->format_message )( info, error->message );
+    longjmp( error->jump, 1 );
+}
+
+void ignoreMessage( j_common_ptr )
+{
+    // Warnings are not fatal and would be printed for every segment
+}
+
+// Write the compressed data directly into a growing QByteArray
+struct Destination
+{
+    jpeg_destination_mgr pub;
+    QByteArray* output;
+};
+
+void initDestination( j_compress_ptr info )
+{
+    Destination* dest = reinterpret_cast<Destination*>( info->dest );
+    dest->pub.next_output_byte = (JOCTET*)dest->output->data();
+    dest->pub.free_in_buffer = dest->output->size();
+}
+
+boolean emptyOutputBuffer( j_compress_ptr info )
+{
+    // The buffer is full when this is called
+    Destination* dest = reinterpret_cast<Destination*>( info->dest );
+    const int used = dest->output->size();
+    dest->output->resize( 2 * used );
+    dest->pub.next_output_byte = (JOCTET*)dest->output->data() + used;
+    dest->pub.free_in_buffer = dest->output->size() - used;
+    return TRUE;
+}
+
+void terminateDestination( j_compress_ptr info )
+{
+    Destination* dest = reinterpret_cast<Destination*>( info->dest );
+    dest->output->resize( dest->output->size() - dest->pub.free_in_buffer );
+}
+}
+
+struct SegmentEncoder::Impl
+{
+    Impl()
+    {
+        info.err = jpeg_std_error( &error.pub );
+        error.pub.error_exit = onError;
+        error.pub.output_message = ignoreMessage;
+        if( setjmp( error.jump ))
+            throw std::runtime_error( error.message );
+        jpeg_create_compress( &info );
+
+        destination.pub.init_destination = initDestination;
+        destination.pub.empty_output_buffer = emptyOutputBuffer;
+        destination.pub.term_destination = terminateDestination;
+        destination.output = &output;
+        info.dest = &destination.pub;
+    }
+
+    ~Impl()
+    {
+        jpeg_destroy_compress( &info );
+    }
+
+    jpeg_compress_struct info;
+    ErrorManager error;
+    Destination destination;
+    QByteArray output;
+};
+
+SegmentEncoder::SegmentEncoder()
+    : _impl( new Impl )
+{
+}
+
+SegmentEncoder::~SegmentEncoder()
+{
+}
+
+QByteArray SegmentEncoder::encode( const char* data, const QSize& size,
+                                   const int stride, const int quality )
+{
+    if( size.isEmpty( ))
+        throw std::runtime_error( "Cannot compress an empty image" );
+
+    // The output is not a local variable, which would be indeterminate after
+    // the longjmp of an error
+    QByteArray& output = _impl->output;
+    output.resize( std::max( size.width() * size.height() * BYTES_PER_PIXEL /
+                             INITIAL_COMPRESSION_RATIO, MIN_OUTPUT_SIZE ));
+
+    jpeg_compress_struct& info = _impl->info;
+    if( setjmp( _impl->error.jump ))
+    {
+        jpeg_abort_compress( &info );
+        throw std::runtime_error( _impl->error.message );
+    }
+
+    info.image_width = size.width();
+    info.image_height = size.height();
+    info.input_components = BYTES_PER_PIXEL;
+    info.in_color_space = JCS_EXT_RGBX;
+    jpeg_set_defaults( &info );
+    jpeg_set_quality( &info, quality, TRUE );
+
+    jpeg_start_compress( &info, TRUE );
+    std::vector<JSAMPROW> rows( size.height( ));
+    for( size_t i = 0; i < rows.size(); ++i )
+        rows[i] = (JSAMPROW)data + i * stride;
+
+    JDIMENSION row = 0;
+    while( row < rows.size( ))
+        row += jpeg_write_scanlines( &info, &rows[row], rows.size() - row );
+    jpeg_finish_compress( &info );
+
+    QByteArray result;
+    result.swap( output );
+    return result;
+}
@@ -0,0 +1,202 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SegmentRegionDecoder.h"
+
+#include <csetjmp>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include <jpeglib.h>
+#include <jerror.h>
+
+namespace
+{
+const int BYTES_PER_PIXEL = 4;
+
+// The chroma of the pixels on the border of a partial decode is upsampled
+// without their outer neighbours, so the region is extended by this margin
+const int UPSAMPLING_MARGIN = 1;
+
+struct ErrorManager
+{
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+    char message[JMSG_LENGTH_MAX];
+};
+
+void onError( j_common_ptr info )
+{
+    ErrorManager* error = reinterpret_cast<ErrorManager*>( info->err );
+    ( *info->err->format_message )( info, error->message );
+    longjmp( error->jump, 1 );
+}
+
+void onMessage( j_common_ptr info, const int level )
+{
+    // Warnings are not fatal and would be printed for every segment, except
+    // for truncated data, which libjpeg would complete with gray pixels
+    if( level < 0 && info->err->msg_code == JWRN_JPEG_EOF )
+        onError( info );
+}
+
+QRect addUpsamplingMargin( const QRect& region, const QRect& segmentRect )
+{
+    return region.adjusted( -UPSAMPLING_MARGIN, -UPSAMPLING_MARGIN,
+                            UPSAMPLING_MARGIN, UPSAMPLING_MARGIN ) &
+           segmentRect;
+}
+}
+
+struct SegmentRegionDecoder::Impl
+{
+    Impl()
+    {
+        info.err = jpeg_std_error( &error.pub );
+        error.pub.error_exit = onError;
+        error.pub.emit_message = onMessage;
+        if( setjmp( error.jump ))
+            throw std::runtime_error( error.message );
+        jpeg_create_decompress( &info );
+    }
+
+    ~Impl()
+    {
+        jpeg_destroy_decompress( &info );
+    }
+
+    jpeg_decompress_struct info;
+    ErrorManager error;
+
+    // Kept here, as no object with a destructor may be skipped by longjmp
+    std::vector<JSAMPROW> rows;
+};
+
+SegmentRegionDecoder::SegmentRegionDecoder()
+    : _impl( new Impl )
+{
+}
+
+SegmentRegionDecoder::~SegmentRegionDecoder()
+{
+}
+
+void SegmentRegionDecoder::decode( const deflect::Segment& segment,
+                                   const QRect& region, DecodedRegion& output )
+{
+    const deflect::SegmentParameters& params = segment.parameters;
+    const QRect segmentRect( 0, 0, params.width, params.height );
+
+    output.rect = QRect();
+    output.buffered = false;
+    if( ( region & segmentRect ).isEmpty( ))
+    {
+        output.imageData.clear();
+        return;
+    }
+
+    const QRect roi = addUpsamplingMargin( region, segmentRect );
+
+    jpeg_decompress_struct& info = _impl->info;
+    if( setjmp( _impl->error.jump ))
+    {
+        jpeg_abort_decompress( &info );
+        throw std::runtime_error( _impl->error.message );
+    }
+
+    jpeg_mem_src( &info, (unsigned char*)segment.imageData.constData(),
+                  segment.imageData.size( ));
+    jpeg_read_header( &info, TRUE );
+    info.out_color_space = JCS_EXT_RGBX;
+    jpeg_start_decompress( &info );
+
+    if( info.output_width != params.width ||
+        info.output_height != params.height )
+    {
+        jpeg_abort_decompress( &info );
+        throw std::runtime_error( "Segment dimensions do not match its image" );
+    }
+
+    // Columns can only be skipped in whole MCUs, the region is extended
+    JDIMENSION x = roi.x();
+    JDIMENSION width = roi.width();
+    if( width < info.output_width )
+        jpeg_crop_scanline( &info, &x, &width );
+
+    const QRect decoded( x, roi.y(), width, roi.height( ));
+    const size_t stride = decoded.width() * BYTES_PER_PIXEL;
+    const size_t size = stride * decoded.height();
+    char* data = output.buffer;
+    output.buffered = data && size <= output.bufferSize;
+    if( !output.buffered )
+    {
+        output.imageData.resize( size );
+        data = output.imageData.data();
+    }
+
+    std::vector<JSAMPROW>& rows = _impl->rows;
+    rows.resize( decoded.height( ));
+    for( size_t i = 0; i < rows.size(); ++i )
+        rows[i] = (JSAMPROW)data + i * stride;
+
+    // The rows above the region are skipped without being fully decoded
+    if( decoded.y() > 0 )
+        jpeg_skip_scanlines( &info, decoded.y( ));
+
+    JDIMENSION row = 0;
+    while( row < rows.size( ))
+        row += jpeg_read_scanlines( &info, &rows[row], rows.size() - row );
+
+    // The rows below the region are not decoded at all
+    if( info.output_scanline < info.output_height )
+        jpeg_abort_decompress( &info );
+    else
+        jpeg_finish_decompress( &info );
+
+    output.rect = decoded;
+}
+
+size_t SegmentRegionDecoder::getMaxOutputSize( const QSize& segmentSize,
+                                               const QRect& region )
+{
+    // The decoded columns depend on the MCU size, at most the whole rows
+    const QRect roi = addUpsamplingMargin( region,
+                                           QRect( QPoint(), segmentSize ));
+    return roi.height() * segmentSize.width() * BYTES_PER_PIXEL;
+}
@@ -0,0 +1,128 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef SEGMENTREGIONDECODER_H
+#define SEGMENTREGIONDECODER_H
+
+#include <deflect/Segment.h>
+
+#include <QByteArray>
+#include <QRect>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+/**
+ * The pixels decoded from a region of a compressed segment.
+ */
+struct DecodedRegion
+{
+    DecodedRegion() : buffer( 0 ), bufferSize( 0 ), buffered( false ) {}
+
+    /** The region in segment pixel coordinates, empty if not decoded. */
+    QRect rect;
+
+    /** The RGBX pixels of the region, tightly packed. */
+    QByteArray imageData;
+
+    /**
+     * Optional memory in which the pixels are decoded instead of imageData,
+     * for instance a mapped pixel buffer. Only used if it is large enough.
+     */
+    char* buffer;
+
+    /** The size of the buffer in bytes. */
+    size_t bufferSize;
+
+    /** true if the pixels of the region are in the buffer. */
+    bool buffered;
+
+    /** @return the pixels of the region. */
+    const char* getData() const
+    {
+        return buffered ? buffer : imageData.constData();
+    }
+};
+
+/**
+ * Decode a region of a JPEG-compressed segment.
+ *
+ * Only the MCU rows and columns which intersect the region are decompressed,
+ * so that a wall process which displays a part of a segment does not pay for
+ * the whole segment. This class is not thread-safe, use one per thread.
+ */
+class SegmentRegionDecoder : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    SegmentRegionDecoder();
+
+    /** Destructor. */
+    ~SegmentRegionDecoder();
+
+    /**
+     * Decode a region of a segment.
+     *
+     * The region is clamped to the segment and extended by a margin, as well
+     * as to the left up to the previous MCU boundary. The pixels of the
+     * requested region are identical to the ones of a full decode.
+     * @param segment The JPEG-compressed segment
+     * @param region The region to decode, in segment pixel coordinates
+     * @param output The decoded region, which contains the requested one. The
+     *        pixels are written to its buffer if it is large enough.
+     * @throw std::runtime_error if the segment could not be decoded
+     */
+    void decode( const deflect::Segment& segment, const QRect& region,
+                 DecodedRegion& output );
+
+    /**
+     * Get the maximum size of the pixels decoded for a region of a segment.
+     * @param segmentSize The dimensions of the segment in pixels
+     * @param region The region to decode, in segment pixel coordinates
+     * @return the size in bytes, which a DecodedRegion::buffer of this size
+     *         can always hold
+     */
+    static size_t getMaxOutputSize( const QSize& segmentSize,
+                                    const QRect& region );
+
+private:
+    struct Impl;
+    boost::scoped_ptr<Impl> _impl;
+};
+
+#endif // SEGMENTREGIONDECODER_H
@@ -40,16 +40,27 @@
 #ifndef SERIALIZEBUFFER_H
 #define SERIALIZEBUFFER_H
 
-#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <sstream>
+#include <streambuf>
+#include <vector>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
 /**
  * Utility class to ease and optimize (de)serialization of any object using
  * boost.serialization.
+ *
+ * The archives read and write the buffer's storage directly, which can be
+ * passed to MPI without intermediate copies. The storage only grows, so a
+ * buffer reused for successive messages stops allocating once it has reached
+ * the size of the largest message.
  */
 class SerializeBuffer : boost::noncopyable
 {
@@ -78,12 +89,24 @@ public:
         return size_;
     }
 
+    /** @return the size of the allocated storage */
+    size_t capacity() const
+    {
+        return buffer_.size();
+    }
+
     /** Direct write access to the buffer, don't write beyond size() */
     char* data()
     {
         return buffer_.data();
     }
 
+    /** Direct read access to the buffer, don't read beyond size() */
+    const char* data() const
+    {
+        return buffer_.data();
+    }
+
     /**
      * Serialize the given object using a binary archive to a string
      * @param object the object which should be serialized
@@ -99,6 +122,24 @@ public:
         return oss.str();
     }
 
+    /**
+     * Serialize the given object using a binary archive into this buffer,
+     * replacing its current content. The result is accessible through data()
+     * and size().
+     * @param object the object which should be serialized
+     */
+    template <typename T>
+    void write(const T& object)
+    {
+        OutputStreamBuf streamBuf(buffer_);
+        {
+            std::ostream os(&streamBuf);
+            boost::archive::binary_oarchive oa(os);
+            oa << object;
+        }
+        size_ = streamBuf.size();
+    }
+
     /**
      * Deserialize the current buffer into the given object
      * @param object the target object for deserializing the current buffer
@@ -106,22 +147,73 @@ public:
     template <typename T>
     void deserialize(T& object)
     {
-        std::istringstream iss(std::istringstream::binary);
-#ifdef __APPLE__
-        // pubsetbuf() does nothing on OSX (and probably on Windows too).
-        // so an intermediate copy of the data is required.
-        std::string dataStr(buffer_.data(), buffer_.size());
-        iss.str(dataStr);
-#else
-        iss.rdbuf()->pubsetbuf(buffer_.data(), size_);
-#endif
-        boost::archive::binary_iarchive ia(iss);
+        InputStreamBuf streamBuf(buffer_.data(), size_);
+        std::istream is(&streamBuf);
+        boost::archive::binary_iarchive ia(is);
         ia >> object;
     }
 
 private:
     std::vector<char> buffer_;
     size_t size_;
+
+    /** Stream buffer writing to a growing vector. */
+    class OutputStreamBuf : public std::streambuf
+    {
+    public:
+        explicit OutputStreamBuf(std::vector<char>& storage)
+            : storage_(storage)
+        {
+            setp(storage_.data(), storage_.data() + storage_.size());
+        }
+
+        /** @return the number of bytes written */
+        size_t size() const
+        {
+            return pptr() - storage_.data();
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof()))
+                return traits_type::not_eof(c);
+            grow(1);
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+            return c;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            if (epptr() - pptr() < n)
+                grow(n);
+            std::memcpy(pptr(), s, n);
+            // Move the put area rather than pbump(), which is limited to int
+            setp(pptr() + n, epptr());
+            return n;
+        }
+
+    private:
+        std::vector<char>& storage_;
+
+        void grow(const size_t count)
+        {
+            const size_t used = size();
+            storage_.resize(std::max(used + count, 2 * storage_.size()));
+            setp(storage_.data() + used, storage_.data() + storage_.size());
+        }
+    };
+
+    /** Stream buffer reading from existing memory, without copying it. */
+    class InputStreamBuf : public std::streambuf
+    {
+    public:
+        InputStreamBuf(char* data, const size_t size)
+        {
+            setg(data, data, data + size);
+        }
+    };
 };
 
 #endif // SERIALIZEBUFFER_H
@@ -0,0 +1,116 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#include "SerializeBufferPool.h"
+
+#include "SerializeBuffer.h"
+
+#include <boost/bind.hpp>
+
+#include <mutex>
+
+struct SerializeBufferPool::Impl
+{
+    explicit Impl( const size_t maxIdle )
+        : maxIdleBuffers( maxIdle )
+        , allocatedCount( 0 )
+    {}
+
+    ~Impl()
+    {
+        for( SerializeBuffer* buffer : idleBuffers )
+            delete buffer;
+    }
+
+    // Deleter of the acquired buffers, which also keeps the pool alive
+    static void release( boost::shared_ptr<Impl> impl, SerializeBuffer* buffer )
+    {
+        {
+            std::lock_guard<std::mutex> lock( impl->mutex );
+            if( impl->idleBuffers.size() < impl->maxIdleBuffers )
+            {
+                impl->idleBuffers.push_back( buffer );
+                return;
+            }
+        }
+        delete buffer;
+    }
+
+    mutable std::mutex mutex;
+    std::vector<SerializeBuffer*> idleBuffers;
+    const size_t maxIdleBuffers;
+    size_t allocatedCount;
+};
+
+SerializeBufferPool::SerializeBufferPool( const size_t maxIdleBuffers )
+    : _impl( new Impl( maxIdleBuffers ))
+{
+}
+
+SerializeBufferPool::~SerializeBufferPool() {}
+
+SerializeBufferPtr SerializeBufferPool::acquire()
+{
+    SerializeBuffer* buffer = 0;
+    {
+        std::lock_guard<std::mutex> lock( _impl->mutex );
+        if( !_impl->idleBuffers.empty( ))
+        {
+            buffer = _impl->idleBuffers.back();
+            _impl->idleBuffers.pop_back();
+        }
+        else
+            ++_impl->allocatedCount;
+    }
+    if( !buffer )
+        buffer = new SerializeBuffer;
+
+    return SerializeBufferPtr( buffer, boost::bind( &Impl::release,
+                                                    _impl, _1 ));
+}
+
+size_t SerializeBufferPool::getIdleCount() const
+{
+    std::lock_guard<std::mutex> lock( _impl->mutex );
+    return _impl->idleBuffers.size();
+}
+
+size_t SerializeBufferPool::getAllocatedCount() const
+{
+    std::lock_guard<std::mutex> lock( _impl->mutex );
+    return _impl->allocatedCount;
+}
@@ -0,0 +1,82 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#ifndef SERIALIZEBUFFERPOOL_H
+#define SERIALIZEBUFFERPOOL_H
+
+#include "types.h"
+
+#include <boost/noncopyable.hpp>
+
+/**
+ * A pool of SerializeBuffers which can be handed over to another thread.
+ *
+ * The buffers are returned to the pool when their last reference is released,
+ * from any thread, so that their storage is reused for the next messages
+ * instead of being reallocated. Buffers may outlive the pool.
+ */
+class SerializeBufferPool : boost::noncopyable
+{
+public:
+    /**
+     * Constructor.
+     * @param maxIdleBuffers The maximum number of released buffers to keep
+     */
+    explicit SerializeBufferPool( size_t maxIdleBuffers );
+
+    /** Destructor. */
+    ~SerializeBufferPool();
+
+    /**
+     * Get a buffer from the pool, or a new one if the pool is empty.
+     * This method is thread-safe.
+     * @return a buffer which returns to the pool when it is released
+     */
+    SerializeBufferPtr acquire();
+
+    /** @return the number of buffers waiting in the pool. */
+    size_t getIdleCount() const;
+
+    /** @return the number of buffers allocated since the pool was created. */
+    size_t getAllocatedCount() const;
+
+private:
+    struct Impl;
+    boost::shared_ptr<Impl> _impl;
+};
+
+#endif // SERIALIZEBUFFERPOOL_H
@@ -0,0 +1,126 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SharedMovieDecoder.h"
+
+#include <cmath>
+
+SharedMovieDecoder::SharedMovieDecoder( const QString& uri,
+                                        const MoviePictureFormat format,
+                                        const double position )
+    : _uri( uri )
+    , _format( format )
+    , _movie( uri, format )
+    , _users( getFrameIndex( position ))
+{
+    if( _movie.isValid( ))
+        _movie.startDecoding();
+}
+
+const QString& SharedMovieDecoder::getURI() const
+{
+    return _uri;
+}
+
+MoviePictureFormat SharedMovieDecoder::getFormat() const
+{
+    return _format;
+}
+
+const FFMPEGMovie& SharedMovieDecoder::getMovie() const
+{
+    return _movie;
+}
+
+unsigned int SharedMovieDecoder::addUser()
+{
+    return _users.add();
+}
+
+void SharedMovieDecoder::removeUser( const unsigned int user )
+{
+    _users.remove( user );
+    _movie.setVisibleRegion( _users.getVisibleRegion( ));
+}
+
+size_t SharedMovieDecoder::getUserCount() const
+{
+    return _users.getCount();
+}
+
+int64_t SharedMovieDecoder::getFrameIndex() const
+{
+    return _users.getFrameIndex();
+}
+
+int64_t SharedMovieDecoder::getFrameIndex( const double position ) const
+{
+    if( !_movie.isValid() || _movie.getFrameDuration() <= 0.0 )
+        return 0;
+
+    return int64_t( std::floor( position / _movie.getFrameDuration( )));
+}
+
+bool SharedMovieDecoder::isInSync( const unsigned int user,
+                                   const double position ) const
+{
+    return _users.isInSync( user, getFrameIndex( position ));
+}
+
+std::shared_future<PicturePtr>
+SharedMovieDecoder::getFrame( const unsigned int user, const double position )
+{
+    if( _users.request( user, getFrameIndex( position )) || !_frame.valid( ))
+        _frame = _movie.getFrame( position ).share();
+    return _frame;
+}
+
+std::shared_future<PicturePtr>
+SharedMovieDecoder::refreshFrame( const unsigned int user )
+{
+    _users.request( user, _users.getFrameIndex( ));
+    _frame = _movie.refreshFrame().share();
+    return _frame;
+}
+
+void SharedMovieDecoder::setVisibleRegion( const unsigned int user,
+                                           const QRect& region )
+{
+    _users.setVisibleRegion( user, region );
+    _movie.setVisibleRegion( _users.getVisibleRegion( ));
+}
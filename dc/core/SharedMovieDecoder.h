@@ -0,0 +1,132 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef SHAREDMOVIEDECODER_H
+#define SHAREDMOVIEDECODER_H
+
+#include "FFMPEGMovie.h"
+#include "MovieDecoderUsers.h"
+#include "types.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <future>
+
+/**
+ * A movie decoder shared by the windows which play the same file in sync.
+ *
+ * The frames are decoded once for all the windows, with the region covering
+ * what is visible in each of them. A window which requests a frame out of
+ * sync with the others must get another decoder from the MovieDecoderCache,
+ * see isInSync().
+ *
+ * This class is not thread-safe, it is meant to be used from the render
+ * thread.
+ */
+class SharedMovieDecoder : public boost::noncopyable
+{
+public:
+    /**
+     * Open a movie and start decoding it.
+     * @param uri The movie file to open
+     * @param format The format of the decoded pictures
+     * @param position The initial position in seconds
+     */
+    SharedMovieDecoder( const QString& uri, MoviePictureFormat format,
+                        double position );
+
+    /** @return the movie file. */
+    const QString& getURI() const;
+
+    /** @return the format of the decoded pictures requested at creation. */
+    MoviePictureFormat getFormat() const;
+
+    /** @return the decoded movie. */
+    const FFMPEGMovie& getMovie() const;
+
+    /** @return a new user identifier for a window playing the movie. */
+    unsigned int addUser();
+
+    /** Remove a user, once its window no longer plays the movie. */
+    void removeUser( unsigned int user );
+
+    /** @return the number of users. */
+    size_t getUserCount() const;
+
+    /** @return the frame that the decoder was last requested to decode. */
+    int64_t getFrameIndex() const;
+
+    /** @return the frame at the given position in seconds. */
+    int64_t getFrameIndex( double position ) const;
+
+    /**
+     * Check if a user can get a frame without disturbing the others.
+     * @see MovieDecoderUsers::isInSync()
+     */
+    bool isInSync( unsigned int user, double position ) const;
+
+    /**
+     * Get a frame at the given position in seconds.
+     *
+     * The frame is shared with the users which request the same one.
+     * @see FFMPEGMovie::getFrame()
+     */
+    std::shared_future<PicturePtr> getFrame( unsigned int user,
+                                             double position );
+
+    /**
+     * Get the current frame again, for the region which is now visible.
+     * @see FFMPEGMovie::refreshFrame()
+     */
+    std::shared_future<PicturePtr> refreshFrame( unsigned int user );
+
+    /**
+     * Set the region of the movie visible to a user.
+     * @see FFMPEGMovie::setVisibleRegion()
+     */
+    void setVisibleRegion( unsigned int user, const QRect& region );
+
+private:
+    const QString _uri;
+    const MoviePictureFormat _format;
+    FFMPEGMovie _movie;
+    MovieDecoderUsers _users;
+    std::shared_future<PicturePtr> _frame;
+};
+
+#endif // SHAREDMOVIEDECODER_H
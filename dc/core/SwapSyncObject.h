@@ -82,12 +82,28 @@ public:
         ++version_;
     }
 
+    /** Get the version of the object, incremented by each update(). */
+    uint64_t getVersion() const
+    {
+        return version_;
+    }
+
     /** Synchronize the object. */
     bool sync(const SyncFunction& syncFunc)
     {
         assert(syncFunc);
 
-        if (syncFunc(version_) && frontObject_ != backObject_)
+        return trySwap(syncFunc(version_));
+    }
+
+    /**
+     * Synchronize the object using the result of an external version check.
+     * @param versionInSync true if all processes have the same getVersion()
+     * @return true if the object was swapped
+     */
+    bool trySwap(const bool versionInSync)
+    {
+        if (versionInSync && frontObject_ != backObject_)
         {
             swap();
             if (callback_)
@@ -0,0 +1,168 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "SwapSyncRegistry.h"
+
+#include "WallToWallChannel.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace
+{
+void _resolveVersion( const SwapSyncRegistry::ResolveFunction& resolveFunc,
+                      const uint64_t minVersion, const uint64_t maxVersion )
+{
+    resolveFunc( minVersion == maxVersion );
+}
+}
+
+SwapSyncRegistry::SwapSyncRegistry()
+    : _objectCount( 0 )
+    , _collectiveCount( 0 )
+    , _syncLatency( 0 )
+    , _lastObjectCount( 0 )
+    , _lastCollectiveCount( 0 )
+    , _lastSyncLatency( 0 )
+    , _totalSyncLatency( 0 )
+    , _frameCount( 0 )
+{
+}
+
+void SwapSyncRegistry::add( const uint64_t version,
+                            const ResolveFunction& resolveFunc )
+{
+    assert( resolveFunc );
+
+    addValue( version, boost::bind( &_resolveVersion, resolveFunc, _1, _2 ));
+}
+
+void SwapSyncRegistry::addValue( const uint64_t value,
+                                 const ValueFunction& valueFunc )
+{
+    assert( valueFunc );
+
+    _values.push_back( value );
+    _valueFunctions.push_back( valueFunc );
+}
+
+size_t SwapSyncRegistry::getPendingCount() const
+{
+    return _values.size();
+}
+
+const std::vector<uint64_t>& SwapSyncRegistry::getPendingValues() const
+{
+    return _values;
+}
+
+void SwapSyncRegistry::synchronize( WallToWallChannel& wallChannel )
+{
+    if( _values.empty( ))
+        return;
+
+    typedef boost::posix_time::microsec_clock Clock;
+    const boost::posix_time::ptime start = Clock::universal_time();
+
+    std::vector<uint64_t> minValues, maxValues;
+    wallChannel.globalMinMax( _values, minValues, maxValues );
+
+    _syncLatency += ( Clock::universal_time() - start ).total_microseconds();
+    _objectCount += _values.size();
+    ++_collectiveCount;
+
+    resolve( minValues, maxValues );
+}
+
+void SwapSyncRegistry::resolve( const std::vector<uint64_t>& minValues,
+                                const std::vector<uint64_t>& maxValues )
+{
+    assert( minValues.size() == _values.size( ));
+    assert( maxValues.size() == _values.size( ));
+
+    // Move the functions out first, so that they may register new objects
+    // for the next synchronization while being resolved.
+    std::vector<ValueFunction> valueFunctions;
+    valueFunctions.swap( _valueFunctions );
+    _values.clear();
+
+    for( size_t i = 0; i < valueFunctions.size(); ++i )
+        valueFunctions[i]( minValues[i], maxValues[i] );
+}
+
+void SwapSyncRegistry::endFrame()
+{
+    _lastObjectCount = _objectCount;
+    _lastCollectiveCount = _collectiveCount;
+    _lastSyncLatency = _syncLatency;
+    _totalSyncLatency += _syncLatency;
+    ++_frameCount;
+
+    _objectCount = 0;
+    _collectiveCount = 0;
+    _syncLatency = 0;
+}
+
+size_t SwapSyncRegistry::getLastObjectCount() const
+{
+    return _lastObjectCount;
+}
+
+size_t SwapSyncRegistry::getLastCollectiveCount() const
+{
+    return _lastCollectiveCount;
+}
+
+int64_t SwapSyncRegistry::getLastSyncLatency() const
+{
+    return _lastSyncLatency;
+}
+
+double SwapSyncRegistry::getAverageSyncLatency() const
+{
+    if( _frameCount == 0 )
+        return 0.0;
+    return (double)_totalSyncLatency / (double)_frameCount;
+}
+
+QString SwapSyncRegistry::getStatistics() const
+{
+    return QString( "sync: %1 objects, %2 collective(s), %3 us (avg %4 us)" )
+            .arg( _lastObjectCount ).arg( _lastCollectiveCount )
+            .arg( _lastSyncLatency )
+            .arg( getAverageSyncLatency(), 0, 'f', 1 );
+}
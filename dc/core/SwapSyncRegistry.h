@@ -0,0 +1,161 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef SWAPSYNCREGISTRY_H
+#define SWAPSYNCREGISTRY_H
+
+#include "types.h"
+#include "SwapSyncObject.h"
+
+#include <QString>
+
+#include <boost/bind.hpp>
+#include <boost/function/function1.hpp>
+#include <boost/function/function2.hpp>
+
+/**
+ * Resolve the per-frame synchronization of many objects in one collective.
+ *
+ * Values are registered before each synchronization, in the same order on all
+ * processes. A single collective operation then reduces all of them across
+ * processes, and each registered function is called with the global minimum
+ * and maximum of its value.
+ *
+ * This covers the versions of SwapSyncObjects (in sync if min == max), the
+ * frame clock (only rank 0 contributes a non-zero value), the decoding status
+ * of the pixel streams (busy if max > 0) and the readiness and leader
+ * candidacy of the movies. It replaces one collective per object with one or
+ * two per frame.
+ */
+class SwapSyncRegistry
+{
+public:
+    /** Function called with the result of the version check of an object. */
+    typedef boost::function< void( bool ) > ResolveFunction;
+
+    /** Function called with the global minimum and maximum of a value. */
+    typedef boost::function< void( uint64_t, uint64_t ) > ValueFunction;
+
+    /** Constructor. */
+    SwapSyncRegistry();
+
+    /**
+     * Register an object to synchronize in the next call to synchronize().
+     * @param object The object, which must outlive the call to synchronize()
+     */
+    template< typename T >
+    void add( SwapSyncObject<T>& object )
+    {
+        add( object.getVersion(),
+             boost::bind( &SwapSyncObject<T>::trySwap, &object, _1 ));
+    }
+
+    /**
+     * Register a version to check in the next call to synchronize().
+     * @param version The local version of the object
+     * @param resolveFunc Called with the result of the version check
+     */
+    void add( uint64_t version, const ResolveFunction& resolveFunc );
+
+    /**
+     * Register a value to reduce in the next call to synchronize().
+     * @param value The local value
+     * @param valueFunc Called with the global minimum and maximum of the value
+     */
+    void addValue( uint64_t value, const ValueFunction& valueFunc );
+
+    /** @return the number of objects registered for the next synchronize(). */
+    size_t getPendingCount() const;
+
+    /** @return the values registered for the next synchronize(). */
+    const std::vector<uint64_t>& getPendingValues() const;
+
+    /**
+     * Reduce the values of all registered objects in a single collective
+     * operation, resolve them and clear the registry.
+     *
+     * The functions are called in registration order, and may register new
+     * objects for the next synchronization.
+     * @param wallChannel The channel used for the collective operation
+     */
+    void synchronize( WallToWallChannel& wallChannel );
+
+    /**
+     * Resolve the registered objects with values already reduced across
+     * processes and clear the registry, as synchronize() does after its
+     * collective operation.
+     * @param minValues The global minimum of each of the pending values
+     * @param maxValues The global maximum of each of the pending values
+     */
+    void resolve( const std::vector<uint64_t>& minValues,
+                  const std::vector<uint64_t>& maxValues );
+
+    /** Finish the current frame and update the per-frame statistics. */
+    void endFrame();
+
+    /** @return the number of objects synchronized during the last frame. */
+    size_t getLastObjectCount() const;
+
+    /** @return the number of collectives used during the last frame. */
+    size_t getLastCollectiveCount() const;
+
+    /** @return the synchronization duration of the last frame in us. */
+    int64_t getLastSyncLatency() const;
+
+    /** @return the average synchronization duration in microseconds. */
+    double getAverageSyncLatency() const;
+
+    /** @return a summary of the synchronization statistics. */
+    QString getStatistics() const;
+
+private:
+    std::vector<uint64_t> _values;
+    std::vector<ValueFunction> _valueFunctions;
+
+    size_t _objectCount;
+    size_t _collectiveCount;
+    int64_t _syncLatency;
+
+    size_t _lastObjectCount;
+    size_t _lastCollectiveCount;
+    int64_t _lastSyncLatency;
+    int64_t _totalSyncLatency;
+    uint64_t _frameCount;
+};
+
+#endif // SWAPSYNCREGISTRY_H
@@ -51,6 +51,8 @@
 
 #include <boost/make_shared.hpp>
 
+#include <QFileInfo>
+
 WallContent::WallContent()
     : _qmlItem( 0 )
 {
@@ -60,7 +62,9 @@ WallContent::~WallContent()
 {
 }
 
-WallContentPtr WallContent::create( const Content& content )
+namespace
+{
+WallContentPtr _createWallContent( const Content& content )
 {
     switch( content.getType( ))
     {
@@ -82,8 +86,26 @@ WallContentPtr WallContent::create( const Content& content )
         return WallContentPtr();
     }
 }
+}
+
+WallContentPtr WallContent::create( const Content& content )
+{
+    WallContentPtr wallContent = _createWallContent( content );
+    if( wallContent )
+    {
+        const QString name = getContentTypeString( content.getType( )) + " " +
+                             QFileInfo( content.getURI( )).fileName();
+        wallContent->_profileName = name.toUtf8();
+    }
+    return wallContent;
+}
 
 void WallContent::setQmlItem( ContentItem* qmlItem )
 {
     _qmlItem = qmlItem;
 }
+
+const char* WallContent::getProfileName() const
+{
+    return _profileName.constData();
+}
@@ -44,6 +44,8 @@
 
 #include "ContentItem.h"
 
+#include <QByteArray>
+
 /**
  * A content to be rendered by Wall processes.
  *
@@ -65,10 +67,19 @@ public:
     virtual void preRenderUpdate( ContentWindowPtr window,
                                   const QRect& visibleWallArea ) = 0;
 
-    /** Optional synchronization step before rendering. */
-    virtual void preRenderSync( WallToWallChannel& wallToWallChannel )
+    /**
+     * Optional synchronization step before rendering.
+     *
+     * Values which must agree across processes are registered in the registry
+     * and resolved together with those of all the other contents.
+     * @param wallToWallChannel The channel, whose clock is synchronized
+     * @param registry The registry of the frame synchronization
+     */
+    virtual void preRenderSync( WallToWallChannel& wallToWallChannel,
+                                SwapSyncRegistry& registry )
     {
         Q_UNUSED( wallToWallChannel )
+        Q_UNUSED( registry )
     }
 
     /** Optional synchronization step after rendering. */
@@ -80,6 +91,9 @@ public:
     /** Set a reference to the Qml item using this content. */
     void setQmlItem( ContentItem* content );
 
+    /** @return the name identifying this content in profiling traces. */
+    const char* getProfileName() const;
+
     /** Create an object corresponding to the given content. */
     static WallContentPtr create( const Content& content );
 
@@ -88,6 +102,9 @@ protected:
     WallContent();
 
     ContentItem* _qmlItem;
+
+private:
+    QByteArray _profileName;
 };
 
 #endif // WALLCONTENT_H
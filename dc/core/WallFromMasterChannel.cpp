@@ -41,7 +41,9 @@
 
 #include "MPIChannel.h"
 #include "DisplayGroup.h"
+#include "DisplayGroupDelta.h"
 #include "ContentWindow.h"
+#include "FrameSerializer.h"
 #include "Options.h"
 #include "Markers.h"
 
@@ -49,25 +51,28 @@
 
 #define RANK0 0
 
-WallFromMasterChannel::WallFromMasterChannel( MPIChannelPtr mpiChannel )
-    : _mpiChannel( mpiChannel )
-    , _processMessages( true )
+namespace
 {
+// Received frames waiting to be displayed, or in the front and back buffers
+// of the streams, each keep their buffer
+const size_t IDLE_FRAME_BUFFERS_COUNT = 8;
 }
 
-bool WallFromMasterChannel::isMessageAvailable()
+WallFromMasterChannel::WallFromMasterChannel( MPIChannelPtr mpiChannel )
+    : _mpiChannel( mpiChannel )
+    , _frameBufferPool( IDLE_FRAME_BUFFERS_COUNT )
+    , _processMessages( true )
 {
-    return _mpiChannel->isMessageAvailable( RANK0 );
 }
 
 void WallFromMasterChannel::receiveMessage()
 {
-    MPIHeader mh = _mpiChannel->receiveHeader( RANK0 );
+    MPIHeader mh = _mpiChannel->receiveBroadcastHeader( RANK0 );
 
     switch( mh.type )
     {
     case MPI_MESSAGE_TYPE_DISPLAYGROUP:
-        emit received( receiveBroadcast<DisplayGroupPtr>( mh.size ));
+        emit received( receiveBroadcast<DisplayGroupDeltaPtr>( mh.size ));
         break;
     case MPI_MESSAGE_TYPE_OPTIONS:
         emit received( receiveBroadcast<OptionsPtr>( mh.size ));
@@ -76,7 +81,13 @@ void WallFromMasterChannel::receiveMessage()
         emit received( receiveBroadcast<MarkersPtr>( mh.size ));
         break;
     case MPI_MESSAGE_TYPE_PIXELSTREAM:
-        emit received( receiveBroadcast<deflect::FramePtr>( mh.size ));
+        emit received( receiveFrameBroadcast( mh.size ));
+        break;
+    case MPI_MESSAGE_TYPE_PIXELSTREAM_ROUTED:
+        emit received( receiveFrame( mh.type ));
+        break;
+    case MPI_MESSAGE_TYPE_REQUEST_PROFILE:
+        emit receivedRequestProfile();
         break;
     case MPI_MESSAGE_TYPE_QUIT:
         _processMessages = false;
@@ -99,8 +110,33 @@ T WallFromMasterChannel::receiveBroadcast( const size_t messageSize )
     T object;
 
     _buffer.setSize( messageSize );
-    _mpiChannel->receiveBroadcast( _buffer.data(), messageSize, RANK0 );
+    if( messageSize > 0 )
+        _mpiChannel->receiveNonblockingBroadcast( _buffer.data(), messageSize,
+                                                  RANK0 );
     _buffer.deserialize( object );
 
     return object;
 }
+
+deflect::FramePtr
+WallFromMasterChannel::receiveFrameBroadcast( const size_t messageSize )
+{
+    // Receive into a buffer of its own which the frame keeps, so that the
+    // image data of the segments can be used without copy
+    SerializeBufferPtr buffer = _frameBufferPool.acquire();
+    buffer->setSize( messageSize );
+    if( messageSize > 0 )
+        _mpiChannel->receiveNonblockingBroadcast( buffer->data(), messageSize,
+                                                  RANK0 );
+    return FrameSerializer::read( buffer );
+}
+
+deflect::FramePtr
+WallFromMasterChannel::receiveFrame( const MPIMessageType type )
+{
+    SerializeBufferPtr buffer = _frameBufferPool.acquire();
+    const ProbeResult result = _mpiChannel->probe( RANK0, type );
+    buffer->setSize( result.size );
+    _mpiChannel->receive( buffer->data(), result.size, RANK0, type );
+    return FrameSerializer::read( buffer );
+}
@@ -42,6 +42,7 @@
 
 #include "types.h"
 #include "SerializeBuffer.h"
+#include "SerializeBufferPool.h"
 
 #include <QObject>
 
@@ -56,9 +57,6 @@ public:
     /** Constructor */
     WallFromMasterChannel( MPIChannelPtr mpiChannel );
 
-    /** Check if a message is available from the Master process. */
-    bool isMessageAvailable();
-
     /**
      * Receive a message.
      * A received() signal will be emitted according to the message type.
@@ -74,11 +72,11 @@ public slots:
 
 signals:
     /**
-     * Emitted when a displayGroup was recieved
+     * Emitted when an update of the DisplayGroup was recieved
      * @see receiveMessage()
-     * @param displayGroup The DisplayGroup that was received
+     * @param delta The changes or snapshot of the DisplayGroup
      */
-    void received( DisplayGroupPtr displayGroup );
+    void received( DisplayGroupDeltaPtr delta );
 
     /**
      * Emitted when new Options were recieved
@@ -107,15 +105,24 @@ signals:
      */
     void receivedQuit();
 
+    /**
+     * Emitted when the master requested the profiling events of the process
+     * @see receiveMessage()
+     */
+    void receivedRequestProfile();
+
 private:
     Q_DISABLE_COPY( WallFromMasterChannel )
 
     MPIChannelPtr _mpiChannel;
     SerializeBuffer _buffer;
+    SerializeBufferPool _frameBufferPool;
     bool _processMessages;
 
     template <typename T>
     T receiveBroadcast( const size_t messageSize );
+    deflect::FramePtr receiveFrameBroadcast( size_t messageSize );
+    deflect::FramePtr receiveFrame( MPIMessageType type );
 };
 
 #endif // WALLFROMMASTERCHANNEL_H
@@ -40,6 +40,7 @@
 #include "WallToMasterChannel.h"
 
 #include "MPIChannel.h"
+#include "Profiler.h"
 #include "SerializeBuffer.h"
 #include "serializationHelpers.h"
 
@@ -55,6 +56,13 @@ void WallToMasterChannel::sendRequestFrame( const QString uri )
     _mpiChannel->send( MPI_MESSAGE_TYPE_REQUEST_FRAME, data, 0 );
 }
 
+void WallToMasterChannel::sendProfile()
+{
+    const std::string& data =
+            SerializeBuffer::serialize( Profiler::global().getEvents( ));
+    _mpiChannel->send( MPI_MESSAGE_TYPE_PROFILE, data, 0 );
+}
+
 void WallToMasterChannel::sendQuit()
 {
     _mpiChannel->send( MPI_MESSAGE_TYPE_QUIT, "", 0 );
@@ -62,6 +62,11 @@ public slots:
      */
     void sendRequestFrame( QString uri );
 
+    /**
+     * Send the events recorded by the global Profiler to the master.
+     */
+    void sendProfile();
+
     /**
      * Send quit message to the master application to stop the receiver.
      */
@@ -40,30 +40,28 @@
 #include "WallToWallChannel.h"
 
 #include "MPIChannel.h"
+#include "Profiler.h"
+#include "SwapSyncRegistry.h"
 #include "log.h"
 
-#include <boost/date_time/posix_time/time_serialize.hpp>
-
 #define RANK0 0
 
-WallToWallChannel::WallToWallChannel( MPIChannelPtr mpiChannel )
-    : _mpiChannel( mpiChannel )
+namespace
 {
-}
-
-int WallToWallChannel::getRank() const
+boost::posix_time::ptime _getEpoch()
 {
-    return _mpiChannel->getRank();
+    return boost::posix_time::ptime( boost::gregorian::date( 1970, 1, 1 ));
+}
 }
 
-int WallToWallChannel::globalSum( const int localValue ) const
+WallToWallChannel::WallToWallChannel( MPIChannelPtr mpiChannel )
+    : _mpiChannel( mpiChannel )
 {
-    return _mpiChannel->globalSum(localValue);
 }
 
-bool WallToWallChannel::allReady( const bool isReady ) const
+int WallToWallChannel::getRank() const
 {
-    return _mpiChannel->globalSum( isReady ? 1 : 0 ) == _mpiChannel->getSize();
+    return _mpiChannel->getRank();
 }
 
 boost::posix_time::ptime WallToWallChannel::getTime() const
@@ -71,91 +69,52 @@ boost::posix_time::ptime WallToWallChannel::getTime() const
     return _timestamp;
 }
 
-void WallToWallChannel::synchronizeClock()
+void WallToWallChannel::synchronizeClock( SwapSyncRegistry& registry )
 {
+    // Only rank 0 contributes its clock, all others take the maximum.
+    uint64_t localTime = 0;
     if( _mpiChannel->getRank() == RANK0 )
-        _sendClock();
-    else
-        _receiveClock();
+    {
+        const boost::posix_time::ptime now =
+                boost::posix_time::microsec_clock::universal_time();
+        localTime = ( now - _getEpoch( )).total_microseconds();
+    }
+    registry.addValue( localTime, boost::bind( &WallToWallChannel::_setClock,
+                                               this, _1, _2 ));
 }
 
 void WallToWallChannel::globalBarrier() const
 {
+    ProfileScope scope( PROFILE_CATEGORY_MPI, "globalBarrier" );
     _mpiChannel->globalBarrier();
 }
 
-bool WallToWallChannel::checkVersion( const uint64_t version ) const
-{
-    std::vector<uint64_t> versions = _mpiChannel->gatherAll( version );
-
-    for( std::vector<uint64_t>::const_iterator it = versions.begin();
-         it != versions.end(); ++it )
-    {
-        if( *it != version )
-            return false;
-    }
-    return true;
-}
-
-int WallToWallChannel::electLeader( const bool isCandidate )
+void WallToWallChannel::globalMinMax( const std::vector<uint64_t>& values,
+                                      std::vector<uint64_t>& minValues,
+                                      std::vector<uint64_t>& maxValues ) const
 {
-    const int status = isCandidate ? (1 << getRank()) : 0;
-    int globalStatus = globalSum( status );
-
-    if( globalStatus <= 0 )
-        return -1;
+    // Append the complement of each value, so that a single MAX reduction
+    // yields both the maximum and the minimum (~max(~v) == min(v)).
+    const size_t count = values.size();
+    std::vector<uint64_t> reduced( values );
+    reduced.reserve( 2 * count );
+    for( size_t i = 0; i < count; ++i )
+        reduced.push_back( ~values[i] );
 
-    int leader = 0;
-    while( globalStatus > 1 )
     {
-        globalStatus = globalStatus >> 1;
-        ++leader;
+        ProfileScope scope( PROFILE_CATEGORY_MPI, "globalMinMax" );
+        reduced = _mpiChannel->globalMax( reduced );
     }
-    return leader;
-}
-
-void WallToWallChannel::broadcast( boost::posix_time::time_duration timestamp )
-{
-    const std::string& serializedString = _buffer.serialize( timestamp );
 
-    _mpiChannel->broadcast( MPI_MESSAGE_TYPE_TIMESTAMP, serializedString );
+    maxValues.assign( reduced.begin(), reduced.begin() + count );
+    minValues.resize( count );
+    for( size_t i = 0; i < count; ++i )
+        minValues[i] = ~reduced[count + i];
 }
 
-boost::posix_time::time_duration
-WallToWallChannel::receiveTimestampBroadcast( const int src )
+void WallToWallChannel::_setClock( const uint64_t minTime,
+                                   const uint64_t maxTime )
 {
-    MPIHeader header = _mpiChannel->receiveHeader( src );
-    assert( header.type == MPI_MESSAGE_TYPE_TIMESTAMP );
-
-    _buffer.setSize( header.size );
-    _mpiChannel->receiveBroadcast( _buffer.data(), _buffer.size(), src );
-
-    boost::posix_time::time_duration timestamp;
-    _buffer.deserialize( timestamp );
-    return timestamp;
+    Q_UNUSED( minTime );
+    _timestamp = _getEpoch() + boost::posix_time::microseconds( maxTime );
 }
-
-void WallToWallChannel::_sendClock()
-{
-    assert( _mpiChannel->getRank() == RANK0 );
-
-    _timestamp = boost::posix_time::ptime(
-                     boost::posix_time::microsec_clock::universal_time( ));
-
-    const std::string& serializedString = _buffer.serialize( _timestamp );
-
-    _mpiChannel->broadcast( MPI_MESSAGE_TYPE_FRAME_CLOCK, serializedString );
-}
-
-void WallToWallChannel::_receiveClock()
-{
-    assert( _mpiChannel->getRank() != RANK0 );
-
-    MPIHeader header = _mpiChannel->receiveHeader( RANK0 );
-    assert( header.type == MPI_MESSAGE_TYPE_FRAME_CLOCK );
-
-    _buffer.setSize( header.size );
-    _mpiChannel->receiveBroadcast( _buffer.data(), _buffer.size(), RANK0 );
-    _buffer.deserialize( _timestamp );
-}
-
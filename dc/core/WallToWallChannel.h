@@ -41,7 +41,6 @@
 #define WALLTOWALLCHANNEL_H
 
 #include "types.h"
-#include "SerializeBuffer.h"
 
 #include <QObject>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -60,53 +59,39 @@ public:
     /** @return The rank of this process. */
     int getRank() const;
 
-    /**
-     * Get the sum of the given local values across all processes.
-     * @param localValue The value to sum
-     * @return the sum of the localValues
-     */
-    int globalSum( int localValue ) const;
-
-    /** Check if all processes are ready to perform a common action. */
-    bool allReady( bool isReady ) const;
-
     /** Get the current timestamp, synchronized accross processes. */
     boost::posix_time::ptime getTime() const;
 
-    /** Synchronize clock time across all processes. */
-    void synchronizeClock();
+    /**
+     * Synchronize clock time across all processes.
+     *
+     * The clock of rank 0 is registered in the given registry, so that it is
+     * distributed by the same collective as the other per-frame values.
+     * The new time is available with getTime() after registry.synchronize().
+     * @param registry The registry of the frame synchronization
+     */
+    void synchronizeClock( SwapSyncRegistry& registry );
 
     /** Block execution until all programs have reached the barrier. */
     void globalBarrier() const;
 
-    /** Check that all processes have the same version of an object. */
-    bool checkVersion( uint64_t version ) const;
-
     /**
-     * Elect a leader amongst wall processes.
-     * @param isCandidate Is this process a candidate.
-     * @return the rank of the leader, or -1 if no leader could be elected.
+     * Get the minimum and maximum of multiple values in a single collective.
+     * @param values The local values, in the same order on all processes
+     * @param minValues Output: the minimum of each value across processes
+     * @param maxValues Output: the maximum of each value across processes
      */
-    int electLeader( bool isCandidate );
-
-    /**
-     * Broadcast a timestamp.
-     * All other processes must recieve it with receiveTimestampBroadcast().
-     */
-    void broadcast( boost::posix_time::time_duration timestamp );
-
-    /** Receive a timestamp broadcasted by broadcast(timestamp). */
-    boost::posix_time::time_duration receiveTimestampBroadcast( int src );
+    void globalMinMax( const std::vector<uint64_t>& values,
+                       std::vector<uint64_t>& minValues,
+                       std::vector<uint64_t>& maxValues ) const;
 
 private:
     Q_DISABLE_COPY( WallToWallChannel )
 
     MPIChannelPtr _mpiChannel;
     boost::posix_time::ptime _timestamp;
-    SerializeBuffer _buffer;
 
-    void _sendClock();
-    void _receiveClock();
+    void _setClock( uint64_t minTime, uint64_t maxTime );
 };
 
 #endif // WALLTOWALLCHANNEL_H
@@ -76,6 +76,11 @@ void WallWindow::setShowFps( const bool value )
     fpsRenderer_.setVisible( value );
 }
 
+void WallWindow::setStatistics( const QString& statistics )
+{
+    fpsRenderer_.setStatistics( statistics );
+}
+
 void WallWindow::setBlockDrawCalls( const bool enable )
 {
     blockUpdates_ = enable;
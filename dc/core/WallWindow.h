@@ -68,6 +68,9 @@ public:
     /** Show or hide the fps counter. */
     void setShowFps( bool value );
 
+    /** Set additional statistics to display with the fps counter. */
+    void setStatistics( const QString& statistics );
+
     /** Block all the update() and repaint() calls. */
     void setBlockDrawCalls( bool enable );
 
@@ -55,6 +55,7 @@ Configuration::Configuration(const QString &filename)
     , mullionWidth_(0)
     , mullionHeight_(0)
     , fullscreen_(false)
+    , pixelStreamSegmentBatching_(false)
 {
     load();
 }
@@ -99,6 +100,28 @@ void Configuration::load()
     query.setQuery("string(/configuration/content/@maxScale)");
     if(query.evaluateTo(&queryResult))
         Content::setMaxScale( queryResult.toDouble( ));
+
+    // get MPI wait policy
+    query.setQuery("string(/configuration/mpi/@waitMode)");
+    if(query.evaluateTo(&queryResult) && !queryResult.trimmed().isEmpty())
+    {
+        if(!MPIWaitPolicy::parseMode(queryResult.trimmed().toStdString(),
+                                     mpiWaitPolicy_.mode))
+            throw std::runtime_error("Invalid MPI wait mode: " +
+                                     queryResult.toStdString());
+    }
+
+    query.setQuery("string(/configuration/mpi/@spinTime)");
+    if(query.evaluateTo(&queryResult) && !queryResult.trimmed().isEmpty())
+        mpiWaitPolicy_.spinTime = queryResult.toUInt();
+
+    query.setQuery("string(/configuration/mpi/@maxSleep)");
+    if(query.evaluateTo(&queryResult) && !queryResult.trimmed().isEmpty())
+        mpiWaitPolicy_.maxSleep = queryResult.toUInt();
+
+    query.setQuery("string(/configuration/pixelstreams/@batchSegments)");
+    if(query.evaluateTo(&queryResult))
+        pixelStreamSegmentBatching_ = queryResult.toInt() != 0;
 }
 
 int Configuration::getTotalScreenCountX() const
@@ -168,3 +191,13 @@ bool Configuration::getFullscreen() const
 {
     return fullscreen_;
 }
+
+const MPIWaitPolicy& Configuration::getMPIWaitPolicy() const
+{
+    return mpiWaitPolicy_;
+}
+
+bool Configuration::getPixelStreamSegmentBatching() const
+{
+    return pixelStreamSegmentBatching_;
+}
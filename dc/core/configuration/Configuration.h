@@ -44,6 +44,7 @@
 #include <QRectF>
 
 #include "types.h"
+#include "MPIWaitPolicy.h"
 
 /**
  * @brief The Configuration class manages all the settings needed by a
@@ -131,6 +132,19 @@ public:
     /** Display the windows in fullscreen mode. */
     bool getFullscreen() const;
 
+    /**
+     * Get the policy used to wait for MPI operations.
+     * @return the policy, with default values for unspecified parameters
+     */
+    const MPIWaitPolicy& getMPIWaitPolicy() const;
+
+    /**
+     * Render the segments of each PixelStream from a single texture with one
+     * draw call, instead of one texture and draw call per segment.
+     * @return true if enabled (default: false)
+     */
+    bool getPixelStreamSegmentBatching() const;
+
 protected:
     /** The path to the xml configuration file. */
     QString filename_;
@@ -143,6 +157,8 @@ private:
     int mullionWidth_;
     int mullionHeight_;
     bool fullscreen_;
+    MPIWaitPolicy mpiWaitPolicy_;
+    bool pixelStreamSegmentBatching_;
 
     void load();
 };
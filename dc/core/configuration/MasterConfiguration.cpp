@@ -43,19 +43,48 @@
 
 #include <QDomElement>
 #include <QtXmlPatterns>
+#include <algorithm>
 #include <stdexcept>
 
 namespace
 {
 const int DEFAULT_WEBSERVICE_PORT = 8888;
+const unsigned int DEFAULT_PIXELSTREAM_TILE_SIZE = 512;
+const unsigned int DEFAULT_PIXELSTREAM_QUALITY = 75;
 const QRegExp TRIM_REGEX( "[\\n\\t\\r]" );
 const QString DEFAULT_URL( "http://www.google.com" );
+
+PixelStreamPacing loadPacing( QXmlQuery& query, const QString& element,
+                              PixelStreamPacing pacing )
+{
+    QString queryResult;
+
+    query.setQuery( QString( "string(%1/@pacing)" ).arg( element ));
+    if( query.evaluateTo( &queryResult ) && !queryResult.trimmed().isEmpty( ))
+    {
+        if( !PixelStreamPacing::parseMode( queryResult.trimmed(), pacing.mode ))
+            throw std::runtime_error( "Invalid pixel stream pacing: " +
+                                      queryResult.toStdString( ));
+    }
+
+    query.setQuery( QString( "string(%1/@maxFps)" ).arg( element ));
+    if( query.evaluateTo( &queryResult ) && !queryResult.trimmed().isEmpty( ))
+        pacing.maxFps = queryResult.toUInt();
+
+    return pacing;
+}
 }
 
 MasterConfiguration::MasterConfiguration( const QString& filename )
     : Configuration( filename )
     , dcWebServicePort_( DEFAULT_WEBSERVICE_PORT )
     , backgroundColor_( Qt::black )
+    , pixelStreamRouting_( false )
+    , pixelStreamSkipUnchanged_( false )
+    , pixelStreamTranscoding_( false )
+    , pixelStreamTileSize_( DEFAULT_PIXELSTREAM_TILE_SIZE )
+    , pixelStreamQuality_( DEFAULT_PIXELSTREAM_QUALITY )
+    , maxUpdateRate_( 0 )
 {
     loadMasterSettings();
 }
@@ -73,6 +102,12 @@ void MasterConfiguration::loadMasterSettings()
     loadAppLauncher( query );
     loadWebBrowserStartURL( query );
     loadBackgroundProperties( query );
+    loadWallProcessAreas( query );
+    loadPixelStreamRouting( query );
+    loadPixelStreamSkipUnchanged( query );
+    loadPixelStreamPacing( query );
+    loadPixelStreamTranscoding( query );
+    loadMaxUpdateRate( query );
 }
 
 void MasterConfiguration::loadDockStartDirectory( QXmlQuery& query )
@@ -144,6 +179,122 @@ void MasterConfiguration::loadBackgroundProperties( QXmlQuery& query )
     }
 }
 
+void MasterConfiguration::loadWallProcessAreas( QXmlQuery& query )
+{
+    QString queryResult;
+    int processCount = 0;
+    query.setQuery( "string(count(//process))" );
+    if( query.evaluateTo( &queryResult ))
+        processCount = queryResult.toInt();
+
+    // xpath indices start from 1
+    for( int process = 1; process <= processCount; ++process )
+    {
+        int screenCount = 0;
+        query.setQuery( QString( "string(count(//process[%1]/screen))" )
+                        .arg( process ));
+        if( query.evaluateTo( &queryResult ))
+            screenCount = queryResult.toInt();
+
+        QRect area;
+        for( int screen = 1; screen <= screenCount; ++screen )
+        {
+            QPoint screenIndex;
+
+            query.setQuery( QString( "string(//process[%1]/screen[%2]/@i)" )
+                            .arg( process ).arg( screen ));
+            if( query.evaluateTo( &queryResult ))
+                screenIndex.setX( queryResult.toInt( ));
+
+            query.setQuery( QString( "string(//process[%1]/screen[%2]/@j)" )
+                            .arg( process ).arg( screen ));
+            if( query.evaluateTo( &queryResult ))
+                screenIndex.setY( queryResult.toInt( ));
+
+            area = area.united( getScreenRect( screenIndex ));
+        }
+        wallProcessAreas_.push_back( area );
+    }
+}
+
+void MasterConfiguration::loadPixelStreamRouting( QXmlQuery& query )
+{
+    QString queryResult;
+    query.setQuery( "string(/configuration/pixelstreams/@routing)" );
+    if( query.evaluateTo( &queryResult ))
+        pixelStreamRouting_ = queryResult.toInt() != 0;
+}
+
+void MasterConfiguration::loadPixelStreamSkipUnchanged( QXmlQuery& query )
+{
+    QString queryResult;
+    query.setQuery( "string(/configuration/pixelstreams/@skipUnchanged)" );
+    if( query.evaluateTo( &queryResult ))
+        pixelStreamSkipUnchanged_ = queryResult.toInt() != 0;
+}
+
+void MasterConfiguration::loadPixelStreamPacing( QXmlQuery& query )
+{
+    const QString streams( "/configuration/pixelstreams" );
+    pixelStreamPacing_ = loadPacing( query, streams, PixelStreamPacing( ));
+
+    QString queryResult;
+    int streamCount = 0;
+    query.setQuery( QString( "string(count(%1/stream))" ).arg( streams ));
+    if( query.evaluateTo( &queryResult ))
+        streamCount = queryResult.toInt();
+
+    // xpath indices start from 1
+    for( int i = 1; i <= streamCount; ++i )
+    {
+        const QString stream = QString( "%1/stream[%2]" ).arg( streams )
+                                                        .arg( i );
+        query.setQuery( QString( "string(%1/@uri)" ).arg( stream ));
+        if( !query.evaluateTo( &queryResult ) ||
+            queryResult.trimmed().isEmpty( ))
+        {
+            continue;
+        }
+        const QString uri = queryResult.trimmed();
+        streamPacings_[uri] = loadPacing( query, stream, pixelStreamPacing_ );
+    }
+}
+
+void MasterConfiguration::loadPixelStreamTranscoding( QXmlQuery& query )
+{
+    QString queryResult;
+    query.setQuery( "string(/configuration/pixelstreams/@transcode)" );
+    if( query.evaluateTo( &queryResult ))
+        pixelStreamTranscoding_ = queryResult.toInt() != 0;
+
+    query.setQuery( "string(/configuration/pixelstreams/@tileSize)" );
+    if( query.evaluateTo( &queryResult ))
+    {
+        const int tileSize = queryResult.toInt();
+        if( tileSize > 0 )
+            pixelStreamTileSize_ = tileSize;
+    }
+
+    query.setQuery( "string(/configuration/pixelstreams/@quality)" );
+    if( query.evaluateTo( &queryResult ))
+    {
+        const int quality = queryResult.toInt();
+        if( quality > 0 )
+            pixelStreamQuality_ = std::min( quality, 100 );
+    }
+}
+
+void MasterConfiguration::loadMaxUpdateRate( QXmlQuery& query )
+{
+    QString queryResult;
+    query.setQuery( "string(/configuration/mpi/@maxUpdateRate)" );
+    if( query.evaluateTo( &queryResult ))
+    {
+        const int rate = queryResult.toInt();
+        maxUpdateRate_ = rate > 0 ? rate : 0;
+    }
+}
+
 const QString& MasterConfiguration::getDockStartDir() const
 {
     return dockStartDir_;
@@ -179,6 +330,49 @@ const QColor& MasterConfiguration::getBackgroundColor() const
     return backgroundColor_;
 }
 
+const std::vector<QRect>& MasterConfiguration::getWallProcessAreas() const
+{
+    return wallProcessAreas_;
+}
+
+bool MasterConfiguration::getPixelStreamRouting() const
+{
+    return pixelStreamRouting_;
+}
+
+bool MasterConfiguration::getPixelStreamSkipUnchanged() const
+{
+    return pixelStreamSkipUnchanged_;
+}
+
+const PixelStreamPacing&
+MasterConfiguration::getPixelStreamPacing( const QString& uri ) const
+{
+    QMap<QString, PixelStreamPacing>::const_iterator it =
+            streamPacings_.find( uri );
+    return it != streamPacings_.end() ? *it : pixelStreamPacing_;
+}
+
+bool MasterConfiguration::getPixelStreamTranscoding() const
+{
+    return pixelStreamTranscoding_;
+}
+
+unsigned int MasterConfiguration::getPixelStreamTileSize() const
+{
+    return pixelStreamTileSize_;
+}
+
+unsigned int MasterConfiguration::getPixelStreamQuality() const
+{
+    return pixelStreamQuality_;
+}
+
+unsigned int MasterConfiguration::getMaxUpdateRate() const
+{
+    return maxUpdateRate_;
+}
+
 void MasterConfiguration::setBackgroundColor( const QColor& color )
 {
     backgroundColor_ = color;
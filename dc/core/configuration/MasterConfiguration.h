@@ -41,6 +41,9 @@
 #define MASTERCONFIGURATION_H
 
 #include "Configuration.h"
+#include "PixelStreamPacing.h"
+
+#include <QMap>
 
 class QXmlQuery;
 
@@ -102,6 +105,63 @@ public:
      */
     const QColor& getBackgroundColor() const;
 
+    /**
+     * Get the area of the wall covered by each wall process.
+     * @return the union of the screens of each process, ordered by process
+     *         index (the first entry corresponds to MPI rank 1)
+     */
+    const std::vector<QRect>& getWallProcessAreas() const;
+
+    /**
+     * Should pixel stream segments only be sent to the wall processes whose
+     * screens they intersect.
+     * @return defaults to false if unspecified
+     */
+    bool getPixelStreamRouting() const;
+
+    /**
+     * Should pixel stream segments be sent without their image data when it
+     * has not changed since the previous frame of the stream.
+     * @return defaults to false if unspecified
+     * @see SegmentChangeTracker
+     */
+    bool getPixelStreamSkipUnchanged() const;
+
+    /**
+     * Get the pacing policy of a pixel stream.
+     * @param uri The identifier of the stream
+     * @return the policy of the stream if it has one, otherwise the default
+     *         policy of all streams (PACING_LATEST_FRAME if unspecified)
+     */
+    const PixelStreamPacing& getPixelStreamPacing( const QString& uri ) const;
+
+    /**
+     * Should pixel stream frames be transcoded on the master before they are
+     * sent to the wall processes.
+     * @return defaults to false if unspecified
+     * @see PixelStreamTranscoder
+     */
+    bool getPixelStreamTranscoding() const;
+
+    /**
+     * Get the maximum size of the segments of transcoded pixel streams.
+     * @return the size in pixels, defaults to 512 if unspecified
+     */
+    unsigned int getPixelStreamTileSize() const;
+
+    /**
+     * Get the JPEG quality of transcoded pixel streams.
+     * @return the quality from 1 to 100, defaults to 75 if unspecified
+     */
+    unsigned int getPixelStreamQuality() const;
+
+    /**
+     * Get the maximum rate at which the DisplayGroup, Options and Markers are
+     * sent to the wall processes, typically the frame rate of the wall.
+     * @return the rate in Hz, defaults to 0 (unlimited) if unspecified
+     */
+    unsigned int getMaxUpdateRate() const;
+
     /**
      * Set the background color
      * @param color
@@ -135,6 +195,12 @@ private:
     void loadAppLauncher( QXmlQuery& query );
     void loadWebBrowserStartURL( QXmlQuery& query );
     void loadBackgroundProperties( QXmlQuery& query );
+    void loadWallProcessAreas( QXmlQuery& query );
+    void loadPixelStreamRouting( QXmlQuery& query );
+    void loadPixelStreamSkipUnchanged( QXmlQuery& query );
+    void loadPixelStreamPacing( QXmlQuery& query );
+    void loadPixelStreamTranscoding( QXmlQuery& query );
+    void loadMaxUpdateRate( QXmlQuery& query );
 
     QString dockStartDir_;
     QString sessionsDir_;
@@ -145,6 +211,16 @@ private:
 
     QString backgroundUri_;
     QColor backgroundColor_;
+
+    std::vector<QRect> wallProcessAreas_;
+    bool pixelStreamRouting_;
+    bool pixelStreamSkipUnchanged_;
+    PixelStreamPacing pixelStreamPacing_;
+    QMap<QString, PixelStreamPacing> streamPacings_;
+    bool pixelStreamTranscoding_;
+    unsigned int pixelStreamTileSize_;
+    unsigned int pixelStreamQuality_;
+    unsigned int maxUpdateRate_;
 };
 
 #endif // MASTERCONFIGURATION_H
@@ -40,12 +40,16 @@
 #include "WallConfiguration.h"
 
 #include <QtXmlPatterns>
+#include <algorithm>
 #include <stdexcept>
+#include <thread>
 
 WallConfiguration::WallConfiguration(const QString &filename, const int processIndex)
     : Configuration(filename)
     , processIndex_( processIndex )
     , screenCountForCurrentProcess_(0)
+    , processCountForHost_(1)
+    , hostDecoderThreads_(0)
 {
     loadWallSettings(processIndex);
 }
@@ -74,6 +78,16 @@ void WallConfiguration::loadWallSettings(const int processIndex)
     else
         display_ = QString("default (:0)"); // the default
 
+    // get number of processes sharing the host
+    query.setQuery( QString("string(count(//process[@host='%1']))")
+                    .arg(host_) );
+    if (query.evaluateTo(&queryResult))
+        processCountForHost_ = std::max(queryResult.toInt(), 1);
+
+    query.setQuery("string(/configuration/movies/@decoderThreads)");
+    if (query.evaluateTo(&queryResult))
+        hostDecoderThreads_ = queryResult.toUInt();
+
     // get number of tiles for my process
     query.setQuery( QString("string(count(//process[%1]/screen))").arg(xpathIndex) );
     if (query.evaluateTo(&queryResult))
@@ -137,3 +151,15 @@ int WallConfiguration::getProcessIndex() const
 {
     return processIndex_;
 }
+
+int WallConfiguration::getProcessCountForHost() const
+{
+    return processCountForHost_;
+}
+
+unsigned int WallConfiguration::getMovieDecoderThreads() const
+{
+    const unsigned int hostThreads = hostDecoderThreads_ > 0 ?
+                hostDecoderThreads_ : std::thread::hardware_concurrency();
+    return std::max(hostThreads / processCountForHost_, 1u);
+}
@@ -85,12 +85,28 @@ public:
     /** Get the index of the process. */
     int getProcessIndex() const;
 
+    /** Get the number of wall processes running on the host of this one. */
+    int getProcessCountForHost() const;
+
+    /**
+     * Get the number of threads which the movie decoders of this process may
+     * use, in addition to the decoding thread of each movie.
+     *
+     * The <movies decoderThreads=""/> budget applies to each host and is
+     * shared by the wall processes which run on it.
+     * @return the number of threads, at least 1 (default: the number of cores
+     *         of the host divided by the number of processes)
+     */
+    unsigned int getMovieDecoderThreads() const;
+
 private:
     QString host_;
     QString display_;
 
     const int processIndex_;
     int screenCountForCurrentProcess_;
+    int processCountForHost_;
+    unsigned int hostDecoderThreads_;
     std::vector<QPoint> screenPosition_;
     std::vector<QPoint> screenGlobalIndex_;
 
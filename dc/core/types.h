@@ -54,6 +54,7 @@ class ContentWindow;
 class ContentWindowController;
 class DisplayGroup;
 class DisplayGroupAdapter;
+class DisplayGroupDelta;
 class DisplayGroupRenderer;
 class DynamicTexture;
 class FFMPEGFrame;
@@ -68,11 +69,15 @@ class MPIChannel;
 class Options;
 class PDF;
 class PixelStream;
+class PixelStreamDecodePool;
 class PixelStreamWindowManager;
 class QmlWindowRenderer;
 class Renderable;
 class RenderContext;
+class SerializeBuffer;
+class SharedMovieDecoder;
 class SVG;
+class SwapSyncRegistry;
 class TestPattern;
 class WallContent;
 class WallWindow;
@@ -84,6 +89,7 @@ typedef boost::shared_ptr< ContentWindow > ContentWindowPtr;
 typedef std::unique_ptr<ContentWindowController> ContentWindowControllerPtr;
 typedef boost::shared_ptr< DisplayGroupAdapter > DisplayGroupAdapterPtr;
 typedef boost::shared_ptr< DisplayGroup > DisplayGroupPtr;
+typedef boost::shared_ptr< DisplayGroupDelta > DisplayGroupDeltaPtr;
 typedef boost::shared_ptr< DisplayGroupRenderer > DisplayGroupRendererPtr;
 typedef boost::shared_ptr< DynamicTexture > DynamicTexturePtr;
 typedef std::shared_ptr<FFMPEGPicture> PicturePtr;
@@ -92,10 +98,13 @@ typedef boost::shared_ptr< Markers > MarkersPtr;
 typedef boost::shared_ptr< MPIChannel > MPIChannelPtr;
 typedef boost::shared_ptr< Options > OptionsPtr;
 typedef boost::shared_ptr< PixelStream > PixelStreamPtr;
+typedef boost::shared_ptr< PixelStreamDecodePool > PixelStreamDecodePoolPtr;
 typedef boost::shared_ptr< PDF > PDFPtr;
 typedef boost::shared_ptr< QmlWindowRenderer > QmlWindowPtr;
 typedef boost::shared_ptr< Renderable > RenderablePtr;
 typedef boost::shared_ptr< RenderContext > RenderContextPtr;
+typedef boost::shared_ptr< SerializeBuffer > SerializeBufferPtr;
+typedef std::shared_ptr<SharedMovieDecoder> SharedMovieDecoderPtr;
 typedef boost::shared_ptr< SVG > SVGPtr;
 typedef boost::shared_ptr< TestPattern > TestPatternPtr;
 typedef boost::shared_ptr< WallContent > WallContentPtr;
@@ -105,6 +114,13 @@ typedef std::set< ContentWindowPtr > ContentWindowSet;
 typedef std::vector< ContentWindowPtr > ContentWindowPtrs;
 typedef std::vector< WallWindowPtr > WallWindowPtrs;
 
+/** The format of the pictures decoded from a movie. */
+enum MoviePictureFormat
+{
+    MOVIE_PICTURE_RGBA, // Converted to packed RGBA
+    MOVIE_PICTURE_YUV   // Planar YUV, converted to RGB when rendering
+};
+
 static const QRectF UNIT_RECTF( 0.0, 0.0, 1.0, 1.0 );
 static const QSize UNDEFINED_SIZE( -1, -1 );
 
@@ -150,4 +166,10 @@ bool is_ready( std::future<R> const& f )
     return f.wait_for( std::chrono::seconds( 0 )) == std::future_status::ready;
 }
 
+template<typename R>
+bool is_ready( std::shared_future<R> const& f )
+{
+    return f.wait_for( std::chrono::seconds( 0 )) == std::future_status::ready;
+}
+
 #endif
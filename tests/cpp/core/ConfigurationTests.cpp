@@ -48,6 +48,9 @@ namespace ut = boost::unit_test;
 
 #include <QDir>
 
+#include <algorithm>
+#include <thread>
+
 #define CONFIG_TEST_FILENAME "./configuration.xml"
 #define CONFIG_TEST_FILENAME_II "./configuration_default.xml"
 
@@ -82,6 +85,13 @@ void testBaseParameters( const Configuration& config )
 
     BOOST_CHECK_EQUAL( config.getTotalScreenCountX(), 2 );
     BOOST_CHECK_EQUAL( config.getTotalScreenCountY(), 3 );
+
+    const MPIWaitPolicy& policy = config.getMPIWaitPolicy();
+    BOOST_CHECK_EQUAL( policy.mode, MPI_WAIT_MODE_LATENCY_BUDGET );
+    BOOST_CHECK_EQUAL( policy.spinTime, 20u );
+    BOOST_CHECK_EQUAL( policy.maxSleep, 50u );
+
+    BOOST_CHECK( config.getPixelStreamSegmentBatching( ));
 }
 
 BOOST_AUTO_TEST_CASE( test_configuration )
@@ -100,6 +110,20 @@ BOOST_AUTO_TEST_CASE( test_wall_configuration )
     BOOST_CHECK_EQUAL( config.getHost().toStdString(), CONFIG_EXPECTED_HOST_NAME );
 
     BOOST_CHECK_EQUAL( config.getScreenCount(), 1 );
+
+    // The decoder threads of the host are shared by its 3 processes
+    BOOST_CHECK_EQUAL( config.getProcessCountForHost(), 3 );
+    BOOST_CHECK_EQUAL( config.getMovieDecoderThreads(), 4u );
+}
+
+BOOST_AUTO_TEST_CASE( test_wall_configuration_default_values )
+{
+    WallConfiguration config( CONFIG_TEST_FILENAME_II, 4 );
+
+    BOOST_CHECK_EQUAL( config.getProcessCountForHost(), 3 );
+    BOOST_CHECK_EQUAL( config.getMovieDecoderThreads(),
+                       std::max( std::thread::hardware_concurrency() / 3,
+                                 1u ));
 }
 
 BOOST_AUTO_TEST_CASE( test_master_configuration )
@@ -116,6 +140,42 @@ BOOST_AUTO_TEST_CASE( test_master_configuration )
     BOOST_CHECK_EQUAL( config.getBackgroundUri().toStdString(), CONFIG_EXPECTED_BACKGROUND );
 
     BOOST_CHECK_EQUAL( config.getAppLauncherFile().toStdString(), CONFIG_EXPECTED_APPLAUNCHER );
+
+    BOOST_CHECK( config.getPixelStreamRouting( ));
+    BOOST_CHECK( config.getPixelStreamSkipUnchanged( ));
+    BOOST_CHECK_EQUAL( config.getMaxUpdateRate(), 60u );
+
+    BOOST_CHECK( config.getPixelStreamTranscoding( ));
+    BOOST_CHECK_EQUAL( config.getPixelStreamTileSize(), 256u );
+    BOOST_CHECK_EQUAL( config.getPixelStreamQuality(), 90u );
+}
+
+BOOST_AUTO_TEST_CASE( test_master_configuration_pixel_stream_pacing )
+{
+    MasterConfiguration config( CONFIG_TEST_FILENAME );
+
+    const PixelStreamPacing& defaultPacing =
+            config.getPixelStreamPacing( "any stream" );
+    BOOST_CHECK_EQUAL( defaultPacing.mode, PACING_MAX_FPS );
+    BOOST_CHECK_EQUAL( defaultPacing.maxFps, 30u );
+
+    // Per-stream values override the defaults, unspecified ones inherit them
+    const PixelStreamPacing& streamPacing =
+            config.getPixelStreamPacing( "Movie player" );
+    BOOST_CHECK_EQUAL( streamPacing.mode, PACING_IN_ORDER );
+    BOOST_CHECK_EQUAL( streamPacing.maxFps, 30u );
+}
+
+BOOST_AUTO_TEST_CASE( test_master_configuration_wall_process_areas )
+{
+    MasterConfiguration config( CONFIG_TEST_FILENAME );
+
+    const std::vector<QRect>& areas = config.getWallProcessAreas();
+    BOOST_REQUIRE_EQUAL( areas.size(), 6u );
+
+    BOOST_CHECK( areas[0] == QRect( 0, 0, 3840, 1080 ));
+    BOOST_CHECK( areas[1] == QRect( 0, 1092, 3840, 1080 ));
+    BOOST_CHECK( areas[5] == QRect( 3854, 2184, 3840, 1080 ));
 }
 
 BOOST_AUTO_TEST_CASE( test_master_configuration_default_values )
@@ -126,6 +186,20 @@ BOOST_AUTO_TEST_CASE( test_master_configuration_default_values )
     BOOST_CHECK_EQUAL( config.getSessionsDir().toStdString(), QDir::homePath().toStdString() );
     BOOST_CHECK_EQUAL( config.getWebBrowserDefaultURL().toStdString(), CONFIG_EXPECTED_DEFAULT_URL );
     BOOST_CHECK_EQUAL( config.getAppLauncherFile().toStdString(), CONFIG_EXPECTED_DEFAULT_APPLAUNCHER );
+    BOOST_CHECK( !config.getPixelStreamRouting( ));
+    BOOST_CHECK( !config.getPixelStreamSkipUnchanged( ));
+    BOOST_CHECK_EQUAL( config.getMaxUpdateRate(), 0u );
+    BOOST_CHECK_EQUAL( config.getPixelStreamPacing( "stream" ).mode,
+                       PACING_LATEST_FRAME );
+    BOOST_CHECK( !config.getPixelStreamSegmentBatching( ));
+    BOOST_CHECK( !config.getPixelStreamTranscoding( ));
+    BOOST_CHECK_EQUAL( config.getPixelStreamTileSize(), 512u );
+    BOOST_CHECK_EQUAL( config.getPixelStreamQuality(), 75u );
+
+    const MPIWaitPolicy& policy = config.getMPIWaitPolicy();
+    BOOST_CHECK_EQUAL( policy.mode, MPI_WAIT_MODE_BACKOFF );
+    BOOST_CHECK_EQUAL( policy.spinTime, 0u );
+    BOOST_CHECK_EQUAL( policy.maxSleep, 100u );
 }
 
 BOOST_AUTO_TEST_CASE( test_save_configuration )
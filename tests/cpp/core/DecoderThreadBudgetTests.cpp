@@ -0,0 +1,106 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE DecoderThreadBudgetTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "DecoderThreadBudget.h"
+
+BOOST_AUTO_TEST_CASE( testRequestedThreadsFollowTheFrameSize )
+{
+    const unsigned int maxThreads =
+            DecoderThreadBudget::MAX_THREADS_PER_DECODER;
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads( QSize( )),
+                       1u );
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads(
+                           QSize( 640, 360 )), 1u );
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads(
+                           QSize( 1280, 720 )), 1u );
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads(
+                           QSize( 1920, 1080 )), 3u );
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads(
+                           QSize( 3840, 2160 )), 9u );
+    BOOST_CHECK_EQUAL( DecoderThreadBudget::getRequestedThreads(
+                           QSize( 16384, 16384 )), maxThreads );
+}
+
+BOOST_AUTO_TEST_CASE( testSmallMoviesDoNotStarveALargeOne )
+{
+    DecoderThreadBudget budget( 8 );
+
+    // Small movies decode in their own thread only
+    for( size_t i = 0; i < 10; ++i )
+        BOOST_CHECK_EQUAL( budget.acquire( QSize( 640, 360 )), 1u );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 0u );
+
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 3840, 2160 )), 9u );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 8u );
+}
+
+BOOST_AUTO_TEST_CASE( testThreadsAreLimitedByTheBudget )
+{
+    DecoderThreadBudget budget( 4 );
+
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 1920, 1080 )), 3u );
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 1920, 1080 )), 3u );
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 1920, 1080 )), 1u );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 4u );
+
+    // Released threads are granted again
+    budget.release( 3 );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 2u );
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 3840, 2160 )), 3u );
+
+    budget.release( 1 );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 4u );
+}
+
+BOOST_AUTO_TEST_CASE( testReducedBudgetKeepsGrantedThreads )
+{
+    DecoderThreadBudget budget( 8 );
+    const unsigned int threads = budget.acquire( QSize( 1920, 1080 ));
+    BOOST_CHECK_EQUAL( threads, 3u );
+
+    budget.setThreadCount( 1 );
+    BOOST_CHECK_EQUAL( budget.getThreadCount(), 1u );
+    BOOST_CHECK_EQUAL( budget.acquire( QSize( 1920, 1080 )), 1u );
+
+    budget.release( threads );
+    BOOST_CHECK_EQUAL( budget.getUsedThreads(), 0u );
+}
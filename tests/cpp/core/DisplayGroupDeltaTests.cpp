@@ -0,0 +1,267 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE DisplayGroupDeltaTests
+
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+#include "DisplayGroupDelta.h"
+#include "DisplayGroupDeltaBuilder.h"
+#include "SerializeBuffer.h"
+
+#include "DummyContent.h"
+
+#include <boost/make_shared.hpp>
+
+#include <cstring>
+
+namespace
+{
+const QSize wallSize( 1000, 1000 );
+const unsigned int SNAPSHOT_INTERVAL = 10;
+}
+
+ContentWindowPtr makeDummyWindow()
+{
+    ContentPtr content( new DummyContent );
+    content->setDimensions( QSize( 512, 512 ));
+    return boost::make_shared<ContentWindow>( content );
+}
+
+DisplayGroupDeltaPtr sendToWall( DisplayGroupDeltaPtr delta )
+{
+    const std::string data = SerializeBuffer::serialize( delta );
+
+    SerializeBuffer buffer;
+    buffer.setSize( data.size( ));
+    std::memcpy( buffer.data(), data.data(), data.size( ));
+
+    DisplayGroupDeltaPtr received;
+    buffer.deserialize( received );
+    return received;
+}
+
+BOOST_AUTO_TEST_CASE( testFirstUpdateIsASnapshot )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    masterGroup->addContentWindow( makeDummyWindow( ));
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupDeltaPtr delta = sendToWall( builder.update( masterGroup ));
+
+    BOOST_CHECK( delta->isSnapshot( ));
+    BOOST_CHECK_EQUAL( delta->getVersion(), 1u );
+    BOOST_CHECK_EQUAL( builder.getSnapshotCount(), 1u );
+
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    delta->apply( *wallGroup );
+
+    BOOST_REQUIRE_EQUAL( wallGroup->getContentWindows().size(), 1u );
+    BOOST_CHECK( wallGroup->getContentWindows()[0]->getID() ==
+                 masterGroup->getContentWindows()[0]->getID( ));
+}
+
+BOOST_AUTO_TEST_CASE( testDeltaOnlyContainsModifiedWindows )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    ContentWindowPtr window1 = makeDummyWindow();
+    ContentWindowPtr window2 = makeDummyWindow();
+    masterGroup->addContentWindow( window1 );
+    masterGroup->addContentWindow( window2 );
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+
+    const ContentWindowPtr wallWindow1 = wallGroup->getContentWindows()[0];
+    const ContentWindowPtr wallWindow2 = wallGroup->getContentWindows()[1];
+
+    const QRectF newCoordinates( 100.0, 200.0, 300.0, 400.0 );
+    window2->setCoordinates( newCoordinates );
+
+    DisplayGroupDeltaPtr delta = sendToWall( builder.update( masterGroup ));
+    BOOST_CHECK( !delta->isSnapshot( ));
+    BOOST_CHECK_EQUAL( delta->getVersion(), 2u );
+    BOOST_CHECK_EQUAL( delta->getNewWindowCount(), 0u );
+    BOOST_CHECK_EQUAL( delta->getChangedWindowCount(), 1u );
+
+    delta->apply( *wallGroup );
+
+    // The windows are modified in place
+    BOOST_REQUIRE_EQUAL( wallGroup->getContentWindows().size(), 2u );
+    BOOST_CHECK( wallGroup->getContentWindows()[0] == wallWindow1 );
+    BOOST_CHECK( wallGroup->getContentWindows()[1] == wallWindow2 );
+    BOOST_CHECK( wallWindow2->getCoordinates() == newCoordinates );
+}
+
+BOOST_AUTO_TEST_CASE( testDeltaResendsWindowsWithModifiedContent )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    ContentWindowPtr window1 = makeDummyWindow();
+    ContentWindowPtr window2 = makeDummyWindow();
+    masterGroup->addContentWindow( window1 );
+    masterGroup->addContentWindow( window2 );
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+    BOOST_CHECK( !window1->getContent()->isModified( ));
+    BOOST_CHECK( !window2->getContent()->isModified( ));
+
+    const QSize newDimensions( 640, 480 );
+    window1->getContent()->setDimensions( newDimensions );
+    BOOST_CHECK( window1->getContent()->isModified( ));
+
+    DisplayGroupDeltaPtr delta = sendToWall( builder.update( masterGroup ));
+    BOOST_CHECK_EQUAL( delta->getNewWindowCount(), 1u );
+    BOOST_CHECK_EQUAL( delta->getChangedWindowCount(), 0u );
+    BOOST_CHECK( !window1->getContent()->isModified( ));
+
+    delta->apply( *wallGroup );
+    BOOST_REQUIRE_EQUAL( wallGroup->getContentWindows().size(), 2u );
+    BOOST_CHECK_EQUAL( wallGroup->getContentWindows()[0]->getContent()->
+                       getDimensions(), newDimensions );
+
+    // The content is not sent again until it is modified
+    delta = builder.update( masterGroup );
+    BOOST_CHECK_EQUAL( delta->getNewWindowCount(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testDeltaAddsRemovesAndReordersWindows )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    ContentWindowPtr window1 = makeDummyWindow();
+    ContentWindowPtr window2 = makeDummyWindow();
+    masterGroup->addContentWindow( window1 );
+    masterGroup->addContentWindow( window2 );
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+
+    ContentWindowPtr window3 = makeDummyWindow();
+    masterGroup->addContentWindow( window3 );
+    masterGroup->removeContentWindow( window2 );
+    masterGroup->moveContentWindowToFront( window1 );
+    masterGroup->focus( window3->getID( ));
+
+    DisplayGroupDeltaPtr delta = sendToWall( builder.update( masterGroup ));
+    BOOST_CHECK_EQUAL( delta->getNewWindowCount(), 1u );
+
+    delta->apply( *wallGroup );
+
+    const ContentWindowPtrs& windows = wallGroup->getContentWindows();
+    BOOST_REQUIRE_EQUAL( windows.size(), 2u );
+    BOOST_CHECK( windows[0]->getID() == window3->getID( ));
+    BOOST_CHECK( windows[1]->getID() == window1->getID( ));
+
+    BOOST_CHECK( wallGroup->hasFocusedWindows( ));
+    BOOST_CHECK( windows[0]->isFocused( ));
+    BOOST_CHECK( windows[0]->getFocusedCoordinates() ==
+                 window3->getFocusedCoordinates( ));
+}
+
+BOOST_AUTO_TEST_CASE( testPeriodicSnapshot )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    masterGroup->addContentWindow( makeDummyWindow( ));
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    BOOST_CHECK( builder.update( masterGroup )->isSnapshot( ));
+    for( unsigned int i = 0; i < SNAPSHOT_INTERVAL; ++i )
+        BOOST_CHECK( !builder.update( masterGroup )->isSnapshot( ));
+    BOOST_CHECK( builder.update( masterGroup )->isSnapshot( ));
+
+    BOOST_CHECK_EQUAL( builder.getSnapshotCount(), 2u );
+    BOOST_CHECK_EQUAL( builder.getDeltaCount(), SNAPSHOT_INTERVAL );
+
+    builder.requestSnapshot();
+    BOOST_CHECK( builder.update( masterGroup )->isSnapshot( ));
+}
+
+BOOST_AUTO_TEST_CASE( testSnapshotKeepsExistingWindows )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    ContentWindowPtr window = makeDummyWindow();
+    masterGroup->addContentWindow( window );
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+    const ContentWindowPtr wallWindow = wallGroup->getContentWindows()[0];
+
+    const QRectF newCoordinates( 10.0, 20.0, 30.0, 40.0 );
+    window->setCoordinates( newCoordinates );
+    builder.requestSnapshot();
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+
+    BOOST_REQUIRE_EQUAL( wallGroup->getContentWindows().size(), 1u );
+    BOOST_CHECK( wallGroup->getContentWindows()[0] == wallWindow );
+    BOOST_CHECK( wallWindow->getCoordinates() == newCoordinates );
+}
+
+BOOST_AUTO_TEST_CASE( testSnapshotReplacesWindowsWithMissedContentChanges )
+{
+    DisplayGroupPtr masterGroup( new DisplayGroup( wallSize ));
+    ContentWindowPtr window = makeDummyWindow();
+    masterGroup->addContentWindow( window );
+
+    DisplayGroupDeltaBuilder builder( SNAPSHOT_INTERVAL );
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+    const ContentWindowPtr wallWindow = wallGroup->getContentWindows()[0];
+    BOOST_CHECK_NE( wallWindow->getContent()->getRevision(), 0u );
+
+    // The wall misses the delta which sends the modified content
+    const QSize newDimensions( 640, 480 );
+    window->getContent()->setDimensions( newDimensions );
+    BOOST_CHECK_EQUAL( window->getContent()->getRevision(), 0u );
+    builder.update( masterGroup );
+
+    builder.requestSnapshot();
+    sendToWall( builder.update( masterGroup ))->apply( *wallGroup );
+
+    BOOST_REQUIRE_EQUAL( wallGroup->getContentWindows().size(), 1u );
+    const ContentWindowPtr newWallWindow = wallGroup->getContentWindows()[0];
+    BOOST_CHECK( newWallWindow != wallWindow );
+    BOOST_CHECK_EQUAL( newWallWindow->getContent()->getDimensions(),
+                       newDimensions );
+}
@@ -0,0 +1,129 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE FFMPEGPicturePoolTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "FFMPEGPicturePool.h"
+
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+namespace
+{
+const QSize FRAME_SIZE( 64, 48 );
+}
+
+BOOST_AUTO_TEST_CASE( testReleasedPicturesAreRecycled )
+{
+    auto pool = std::make_shared<FFMPEGPicturePool>( FRAME_SIZE,
+                                                     PIX_FMT_YUV420P, 2 );
+
+    PicturePtr picture = pool->getPicture( QRect( QPoint(), FRAME_SIZE ));
+    BOOST_REQUIRE( picture );
+    const FFMPEGPicture* address = picture.get();
+    const uint8_t* data = picture->getData();
+    BOOST_CHECK_EQUAL( pool->getAllocationCount(), 1 );
+
+    picture.reset();
+    BOOST_CHECK_EQUAL( pool->getFreeCount(), 1 );
+
+    picture = pool->getPicture( QRect( QPoint(), FRAME_SIZE ));
+    BOOST_CHECK_EQUAL( picture.get(), address );
+    BOOST_CHECK_EQUAL( picture->getData(), data );
+    BOOST_CHECK_EQUAL( pool->getAllocationCount(), 1 );
+    BOOST_CHECK_EQUAL( pool->getFreeCount(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testRecycledPictureTakesNewRegion )
+{
+    auto pool = std::make_shared<FFMPEGPicturePool>( FRAME_SIZE,
+                                                     PIX_FMT_YUV420P, 1 );
+    pool->getPicture( QRect( QPoint(), FRAME_SIZE ));
+
+    const QRect region( 10, 6, 21, 13 );
+    PicturePtr picture = pool->getPicture( region );
+    BOOST_REQUIRE( picture );
+    BOOST_CHECK_EQUAL( pool->getAllocationCount(), 1 );
+    BOOST_CHECK( picture->getRegion() == region );
+
+    // The planes are tightly packed, with the chroma size rounded up
+    const AVFrame& avFrame = picture->getAVFrame();
+    BOOST_CHECK_EQUAL( avFrame.linesize[0], 21 );
+    BOOST_CHECK_EQUAL( avFrame.linesize[1], 11 );
+    BOOST_CHECK_EQUAL( avFrame.linesize[2], 11 );
+    BOOST_CHECK_EQUAL( picture->getData( 1 ), picture->getData( 0 ) + 21 * 13 );
+    BOOST_CHECK_EQUAL( picture->getData( 2 ), picture->getData( 1 ) + 11 * 7 );
+
+    picture.reset();
+    picture = pool->getPicture( QRect( ));
+    BOOST_REQUIRE( picture );
+    BOOST_CHECK( picture->getRegion().isEmpty( ));
+    BOOST_CHECK( !picture->getData( ));
+    BOOST_CHECK_EQUAL( pool->getAllocationCount(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testPoolKeepsAtMostItsCapacity )
+{
+    auto pool = std::make_shared<FFMPEGPicturePool>( FRAME_SIZE,
+                                                     PIX_FMT_RGBA, 2 );
+    {
+        std::vector<PicturePtr> pictures;
+        for( size_t i = 0; i < 4; ++i )
+            pictures.push_back( pool->getPicture( QRect( QPoint(),
+                                                         FRAME_SIZE )));
+        BOOST_CHECK_EQUAL( pool->getAllocationCount(), 4 );
+    }
+    BOOST_CHECK_EQUAL( pool->getFreeCount(), 2 );
+
+    PicturePtr picture = pool->getPicture( QRect( QPoint(), FRAME_SIZE ));
+    BOOST_CHECK_EQUAL( pool->getAllocationCount(), 4 );
+}
+
+BOOST_AUTO_TEST_CASE( testPicturesCanOutliveThePool )
+{
+    auto pool = std::make_shared<FFMPEGPicturePool>( FRAME_SIZE,
+                                                     PIX_FMT_RGBA, 2 );
+    PicturePtr picture = pool->getPicture( QRect( QPoint(), FRAME_SIZE ));
+    pool.reset();
+
+    BOOST_REQUIRE( picture );
+    BOOST_CHECK( picture->getData( ));
+    picture.reset();
+}
@@ -0,0 +1,195 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FFMPEGVideoFrameConverterTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "FFMPEGFrame.h"
+#include "FFMPEGVideoFrameConverter.h"
+#include "MovieStatistics.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+namespace
+{
+const int FRAME_WIDTH = 64;
+const int FRAME_HEIGHT = 48;
+}
+
+struct ConverterFixture
+{
+    ConverterFixture()
+        : codecContext( avcodec_alloc_context3( 0 ))
+        , frame( FRAME_WIDTH, FRAME_HEIGHT, PIX_FMT_YUV420P )
+    {
+        codecContext->width = FRAME_WIDTH;
+        codecContext->height = FRAME_HEIGHT;
+        codecContext->pix_fmt = PIX_FMT_YUV420P;
+
+        // A different value for each luma and chroma sample
+        AVFrame& avFrame = frame.getAVFrame();
+        for( int plane = 0; plane < 3; ++plane )
+        {
+            const int shift = plane == 0 ? 0 : 1;
+            for( int y = 0; y < FRAME_HEIGHT >> shift; ++y )
+                for( int x = 0; x < FRAME_WIDTH >> shift; ++x )
+                    avFrame.data[plane][y * avFrame.linesize[plane] + x] =
+                            16 + ( x * 3 + y * 5 + plane * 40 ) % 200;
+        }
+    }
+
+    ~ConverterFixture()
+    {
+        av_free( codecContext );
+    }
+
+    AVCodecContext* codecContext;
+    FFMPEGPicture frame;
+};
+
+BOOST_FIXTURE_TEST_CASE( testConvertedRegionIsAlignedToChroma,
+                         ConverterFixture )
+{
+    const FFMPEGVideoFrameConverter converter( *codecContext, PIX_FMT_RGBA );
+
+    BOOST_CHECK( converter.getConvertedRegion( QRect( 3, 5, 10, 10 )) ==
+                 QRect( 2, 4, 12, 12 ));
+    BOOST_CHECK( converter.getConvertedRegion( QRect( 60, 40, 100, 100 )) ==
+                 QRect( 60, 40, 4, 8 ));
+    BOOST_CHECK( converter.getConvertedRegion( QRect( -10, -10, 500, 500 )) ==
+                 QRect( 0, 0, FRAME_WIDTH, FRAME_HEIGHT ));
+    BOOST_CHECK( converter.getConvertedRegion( QRect( )).isEmpty( ));
+    BOOST_CHECK( converter.getConvertedRegion( QRect( 100, 0, 10, 10 ))
+                 .isEmpty( ));
+}
+
+BOOST_FIXTURE_TEST_CASE( testConvertRegion, ConverterFixture )
+{
+    FFMPEGVideoFrameConverter converter( *codecContext, PIX_FMT_RGBA );
+
+    FFMPEGPicture full( FRAME_WIDTH, FRAME_HEIGHT, PIX_FMT_RGBA );
+    BOOST_REQUIRE( converter.convert( frame, full ));
+
+    const QRect region = converter.getConvertedRegion( QRect( 10, 6, 20, 30 ));
+    FFMPEGPicture picture( region, PIX_FMT_RGBA );
+    BOOST_REQUIRE( converter.convert( frame, picture ));
+    BOOST_CHECK( picture.getRegion() == region );
+
+    // The pixels of the region are the ones of the full conversion
+    const AVFrame& fullFrame = full.getAVFrame();
+    const AVFrame& regionFrame = picture.getAVFrame();
+    int maxError = 0;
+    for( int y = 0; y < region.height(); ++y )
+    {
+        for( int x = 0; x < region.width() * 4; ++x )
+        {
+            const int expected = fullFrame.data[0][( region.y() + y ) *
+                    fullFrame.linesize[0] + region.x() * 4 + x];
+            const int value = regionFrame.data[0][y * regionFrame.linesize[0]
+                                                  + x];
+            maxError = std::max( maxError, std::abs( value - expected ));
+        }
+    }
+    BOOST_CHECK_LE( maxError, 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testConversionsAreCounted, ConverterFixture )
+{
+    FFMPEGVideoFrameConverter converter( *codecContext, PIX_FMT_RGBA );
+    MovieStatistics& statistics = MovieStatistics::global();
+    statistics.endFrame();
+
+    FFMPEGPicture picture( QRect( 0, 0, 16, 8 ), PIX_FMT_RGBA );
+    BOOST_REQUIRE( converter.convert( frame, picture ));
+    FFMPEGPicture hidden( QRect(), PIX_FMT_RGBA );
+    BOOST_REQUIRE( converter.convert( frame, hidden ));
+    statistics.endFrame();
+
+    BOOST_CHECK_EQUAL( statistics.getFrameConvertedPixels(), 16 * 8 );
+    BOOST_CHECK_EQUAL( statistics.getFrameDecodedPixels(),
+                       2 * FRAME_WIDTH * FRAME_HEIGHT );
+}
+
+BOOST_FIXTURE_TEST_CASE( testYUVRegionCopiesPlanes, ConverterFixture )
+{
+    FFMPEGVideoFrameConverter converter( *codecContext, PIX_FMT_YUV420P );
+
+    const QRect region = converter.getConvertedRegion( QRect( 9, 6, 20, 31 ));
+    BOOST_CHECK( region == QRect( 8, 6, 22, 32 ));
+    FFMPEGPicture picture( region, PIX_FMT_YUV420P );
+    BOOST_REQUIRE( converter.convert( frame, picture ));
+
+    // The chroma planes are half the size of the region, tightly packed
+    BOOST_CHECK( picture.getPlaneRegion( 0 ) == region );
+    BOOST_CHECK( picture.getPlaneRegion( 1 ) == QRect( 4, 3, 11, 16 ));
+    BOOST_CHECK( picture.getPlaneRegion( 2 ) == QRect( 4, 3, 11, 16 ));
+    BOOST_CHECK( !picture.hasFullColorRange( ));
+
+    const AVFrame& source = frame.getAVFrame();
+    for( unsigned int plane = 0; plane < 3; ++plane )
+    {
+        const QRect planeRegion = picture.getPlaneRegion( plane );
+        const uint8_t* data = picture.getData( plane );
+        for( int y = 0; y < planeRegion.height(); ++y )
+        {
+            for( int x = 0; x < planeRegion.width(); ++x )
+            {
+                const int expected = source.data[plane][
+                        ( planeRegion.y() + y ) * source.linesize[plane] +
+                        planeRegion.x() + x];
+                BOOST_REQUIRE_EQUAL( int( data[y * planeRegion.width() + x] ),
+                                     expected );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testPlaneRegionsOfOddSizes )
+{
+    const QRect region( 2, 4, 7, 5 );
+    BOOST_CHECK( FFMPEGPicture::getPlaneRegion( region, PIX_FMT_YUV420P, 1 ) ==
+                 QRect( 1, 2, 4, 3 ));
+    BOOST_CHECK( FFMPEGPicture::getPlaneRegion( region, PIX_FMT_YUV422P, 2 ) ==
+                 QRect( 1, 4, 4, 5 ));
+    BOOST_CHECK( FFMPEGPicture::getPlaneRegion( region, PIX_FMT_YUV444P, 1 ) ==
+                 region );
+}
@@ -0,0 +1,134 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FramePhaseTimerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "FramePhaseTimer.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( testInitialState )
+{
+    const FramePhaseTimer timer;
+    BOOST_CHECK_EQUAL( timer.getFrameCount(), 0 );
+    BOOST_CHECK_EQUAL( timer.getLastFrameDuration(), 0 );
+    BOOST_CHECK_EQUAL( timer.getLastDuration( FramePhaseTimer::PHASE_SYNC ),
+                       0 );
+}
+
+BOOST_AUTO_TEST_CASE( testPhaseDurations )
+{
+    FramePhaseTimer timer;
+
+    timer.startFrame();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ));
+    timer.endPhase( FramePhaseTimer::PHASE_RENDER );
+    timer.endPhase( FramePhaseTimer::PHASE_BARRIER );
+    timer.endFrame();
+
+    BOOST_CHECK_EQUAL( timer.getFrameCount(), 1 );
+
+    const int64_t render =
+            timer.getLastDuration( FramePhaseTimer::PHASE_RENDER );
+    BOOST_CHECK_GE( render, 20000 );
+    BOOST_CHECK_LT( timer.getLastDuration( FramePhaseTimer::PHASE_BARRIER ),
+                    render );
+    BOOST_CHECK_EQUAL( timer.getLastDuration( FramePhaseTimer::PHASE_SYNC ),
+                       0 );
+    BOOST_CHECK_EQUAL(
+                timer.getAverageDuration( FramePhaseTimer::PHASE_RENDER ),
+                render );
+    BOOST_CHECK_GE( timer.getLastFrameDuration(), render );
+}
+
+BOOST_AUTO_TEST_CASE( testNewFrameResetsDurations )
+{
+    FramePhaseTimer timer;
+
+    timer.startFrame();
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ));
+    timer.endPhase( FramePhaseTimer::PHASE_SWAP );
+    timer.endFrame();
+
+    timer.startFrame();
+    timer.endPhase( FramePhaseTimer::PHASE_POST );
+    timer.endFrame();
+
+    BOOST_CHECK_EQUAL( timer.getFrameCount(), 2 );
+    BOOST_CHECK_EQUAL( timer.getLastDuration( FramePhaseTimer::PHASE_SWAP ),
+                       0 );
+    BOOST_CHECK_GT( timer.getAverageDuration( FramePhaseTimer::PHASE_SWAP ),
+                    0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testPhaseNames )
+{
+    BOOST_CHECK_EQUAL( FramePhaseTimer::getName( FramePhaseTimer::PHASE_SYNC ),
+                       "sync" );
+    BOOST_CHECK_EQUAL( FramePhaseTimer::getName( FramePhaseTimer::PHASE_POST ),
+                       "post" );
+
+    const FramePhaseTimer timer;
+    BOOST_CHECK( timer.getStatistics().contains( "barrier" ));
+}
+
+BOOST_AUTO_TEST_CASE( testPhasesAreRecordedInProfiler )
+{
+    Profiler profiler( 16 );
+    FramePhaseTimer timer( &profiler );
+
+    timer.startFrame();
+    timer.endPhase( FramePhaseTimer::PHASE_SYNC );
+    timer.endPhase( FramePhaseTimer::PHASE_BARRIER );
+    timer.endFrame();
+    timer.startFrame();
+
+    const ProfileEvents events = profiler.getEvents();
+    BOOST_REQUIRE_EQUAL( events.size(), 3 );
+    BOOST_CHECK_EQUAL( events[0].name, "sync" );
+    BOOST_CHECK_EQUAL( events[0].category, PROFILE_CATEGORY_PHASE );
+    BOOST_CHECK_EQUAL( events[1].name, "barrier" );
+    BOOST_CHECK_EQUAL( events[2].name, "frame" );
+    BOOST_CHECK_EQUAL( events[2].category, PROFILE_CATEGORY_FRAME );
+    BOOST_CHECK_EQUAL( events[2].frame, 0 );
+    BOOST_CHECK_EQUAL( profiler.getFrame(), 1 );
+}
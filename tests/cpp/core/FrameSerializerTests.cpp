@@ -0,0 +1,201 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE FrameSerializerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "CopyCounter.h"
+#include "FrameSerializer.h"
+#include "SegmentChangeTracker.h"
+#include "SerializeBuffer.h"
+#include "SerializeBufferPool.h"
+
+#include <deflect/Frame.h>
+
+#include <stdexcept>
+
+namespace
+{
+const QString STREAM_URI( "stream" );
+}
+
+deflect::FramePtr createTestFrame()
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = STREAM_URI;
+    for( int i = 0; i < 3; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * 64;
+        segment.parameters.y = 32;
+        segment.parameters.width = 64;
+        segment.parameters.height = 16;
+        segment.parameters.compressed = ( i == 1 );
+        // Sizes which are not multiples of the alignment
+        segment.imageData = QByteArray( 100 + 7 * i, 'a' + i );
+        frame->segments.push_back( segment );
+    }
+    return frame;
+}
+
+BOOST_AUTO_TEST_CASE( testFrameRoundTrip )
+{
+    const deflect::FramePtr frame = createTestFrame();
+    SerializeBufferPtr buffer( new SerializeBuffer );
+    FrameSerializer::write( *frame, *buffer );
+
+    const deflect::FramePtr received = FrameSerializer::read( buffer );
+
+    BOOST_CHECK( received->uri == STREAM_URI );
+    BOOST_REQUIRE_EQUAL( received->segments.size(), frame->segments.size( ));
+    for( size_t i = 0; i < frame->segments.size(); ++i )
+    {
+        const deflect::Segment& expected = frame->segments[i];
+        const deflect::Segment& segment = received->segments[i];
+        BOOST_CHECK_EQUAL( segment.parameters.x, expected.parameters.x );
+        BOOST_CHECK_EQUAL( segment.parameters.y, expected.parameters.y );
+        BOOST_CHECK_EQUAL( segment.parameters.width,
+                           expected.parameters.width );
+        BOOST_CHECK_EQUAL( segment.parameters.height,
+                           expected.parameters.height );
+        BOOST_CHECK_EQUAL( segment.parameters.compressed,
+                           expected.parameters.compressed );
+        BOOST_CHECK( segment.imageData == expected.imageData );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testImageDataIsReadInPlace )
+{
+    const deflect::FramePtr frame = createTestFrame();
+    SerializeBufferPtr buffer( new SerializeBuffer );
+    FrameSerializer::write( *frame, *buffer );
+
+    const deflect::FramePtr received = FrameSerializer::read( buffer );
+
+    const char* begin = buffer->data();
+    const char* end = begin + buffer->size();
+    for( const deflect::Segment& segment : received->segments )
+    {
+        const char* data = segment.imageData.constData();
+        BOOST_CHECK( data >= begin && data + segment.imageData.size() <= end );
+        BOOST_CHECK_EQUAL( (size_t)data % FrameSerializer::ALIGNMENT,
+                           (size_t)begin % FrameSerializer::ALIGNMENT );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testFrameKeepsBufferAlive )
+{
+    SerializeBufferPool pool( 1 );
+    deflect::FramePtr received;
+    {
+        SerializeBufferPtr buffer = pool.acquire();
+        FrameSerializer::write( *createTestFrame(), *buffer );
+        received = FrameSerializer::read( buffer );
+    }
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 0 );
+    BOOST_CHECK( received->segments[2].imageData == QByteArray( 114, 'c' ));
+
+    received.reset();
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testEmptySegments )
+{
+    deflect::Frame frame;
+    frame.uri = STREAM_URI;
+    frame.segments.resize( 3 );
+    frame.segments[1].imageData = QByteArray( 10, 'x' );
+    SegmentChangeTracker::setUnchanged( frame.segments[2] );
+
+    SerializeBufferPtr buffer( new SerializeBuffer );
+    FrameSerializer::write( frame, *buffer );
+    const deflect::FramePtr received = FrameSerializer::read( buffer );
+
+    // Segments which are not routed stay apart from the unchanged ones
+    BOOST_REQUIRE_EQUAL( received->segments.size(), 3 );
+    BOOST_CHECK( received->segments[0].imageData.isNull( ));
+    BOOST_CHECK( !SegmentChangeTracker::isUnchanged( received->segments[0] ));
+    BOOST_CHECK( received->segments[1].imageData == QByteArray( 10, 'x' ));
+    BOOST_CHECK( !SegmentChangeTracker::isUnchanged( received->segments[1] ));
+    BOOST_CHECK( SegmentChangeTracker::isUnchanged( received->segments[2] ));
+}
+
+BOOST_AUTO_TEST_CASE( testTruncatedFrameThrows )
+{
+    SerializeBufferPtr buffer( new SerializeBuffer );
+    FrameSerializer::write( *createTestFrame(), *buffer );
+    buffer->setSize( buffer->size() / 2 );
+
+    BOOST_CHECK_THROW( FrameSerializer::read( buffer ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( testWriteCopiesImageDataOnce )
+{
+    const deflect::FramePtr frame = createTestFrame();
+    CopyCounter& counter = CopyCounter::global();
+    counter.endFrame();
+
+    SerializeBufferPtr buffer( new SerializeBuffer );
+    FrameSerializer::write( *frame, *buffer );
+    FrameSerializer::read( buffer );
+    counter.endFrame();
+
+    BOOST_CHECK_EQUAL( counter.getFrameCopyCount(), 3 );
+    BOOST_CHECK_EQUAL( counter.getFrameCopiedBytes(), 100 + 107 + 114 );
+}
+
+BOOST_AUTO_TEST_CASE( testCopyCounterFrames )
+{
+    CopyCounter counter;
+    counter.record( 10 );
+    counter.record( 20 );
+    counter.endFrame();
+
+    BOOST_CHECK_EQUAL( counter.getFrameCopyCount(), 2 );
+    BOOST_CHECK_EQUAL( counter.getFrameCopiedBytes(), 30 );
+
+    counter.record( 5 );
+    counter.endFrame();
+
+    BOOST_CHECK_EQUAL( counter.getFrameCopyCount(), 1 );
+    BOOST_CHECK_EQUAL( counter.getFrameCopiedBytes(), 5 );
+    BOOST_CHECK_EQUAL( counter.getTotalCopyCount(), 3 );
+    BOOST_CHECK_EQUAL( counter.getTotalCopiedBytes(), 35 );
+}
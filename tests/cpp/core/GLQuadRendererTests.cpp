@@ -0,0 +1,125 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE GLQuadRendererTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "GLQuad.h"
+#include "GLQuadRenderer.h"
+#include "GLTexture2D.h"
+
+#include "GlobalQtApp.h"
+
+#include <QGLWidget>
+#include <QImage>
+
+// Run with LIBGL_ALWAYS_SOFTWARE=1 to use Mesa's software rasterizer, for
+// instance in a virtual X server: xvfb-run ./GLQuadRendererTests
+
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+namespace
+{
+QImage createImage( const QRgb color )
+{
+    QImage image( 16, 16, QImage::Format_RGB32 );
+    image.fill( color );
+    return image;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testBatchedQuadsAreSortedByTexture )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTexture2D texture1;
+    GLTexture2D texture2;
+    texture1.update( createImage( 0xffff0000 ));
+    texture2.update( createImage( 0xff00ff00 ));
+
+    GLQuadRenderer& renderer = GLQuadRenderer::instance();
+    const uint64_t drawCount = renderer.getDrawCount();
+    const uint64_t stateChangeCount = renderer.getStateChangeCount();
+
+    GLQuad quad;
+    renderer.begin();
+    for( size_t i = 0; i < 8; ++i )
+    {
+        quad.setTexture( i % 2 ? texture1.getTextureId()
+                               : texture2.getTextureId( ));
+        quad.render();
+    }
+    // Nothing is drawn until the end of the batch
+    BOOST_CHECK_EQUAL( renderer.getDrawCount(), drawCount );
+    renderer.end();
+
+    BOOST_CHECK_EQUAL( renderer.getDrawCount() - drawCount, 8u );
+    BOOST_CHECK_EQUAL( renderer.getStateChangeCount() - stateChangeCount, 2u );
+    BOOST_CHECK_EQUAL( glGetError(), GLenum( GL_NO_ERROR ));
+}
+
+BOOST_AUTO_TEST_CASE( testQuadsOutsideOfABatchAreDrawnImmediately )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLQuadRenderer renderer;
+    GLQuadRenderer::Quad quad;
+    quad.renderMode = GL_LINE_LOOP;
+    renderer.draw( quad );
+    BOOST_CHECK_EQUAL( renderer.getDrawCount(), 1u );
+
+    // Nested batches are drawn at the end of the outer one
+    renderer.begin();
+    renderer.begin();
+    renderer.draw( quad );
+    renderer.end();
+    BOOST_CHECK_EQUAL( renderer.getDrawCount(), 1u );
+    renderer.end();
+    BOOST_CHECK_EQUAL( renderer.getDrawCount(), 2u );
+    BOOST_CHECK_EQUAL( glGetError(), GLenum( GL_NO_ERROR ));
+}
@@ -0,0 +1,228 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE GLTexture2DTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "GLTexture2D.h"
+#include "GLTextureUploader.h"
+#include "types.h" // operator<< for QSize and QRectF
+
+#include "GlobalQtApp.h"
+
+#include <QGLWidget>
+#include <QImage>
+
+#include <algorithm>
+#include <vector>
+
+// Run with LIBGL_ALWAYS_SOFTWARE=1 to use Mesa's software rasterizer, for
+// instance in a virtual X server: xvfb-run ./GLTexture2DTests
+
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+namespace
+{
+const QRgb RED = 0xffff0000;
+const QRgb GREEN = 0xff00ff00;
+
+QImage createImage( const int width, const int height, const QRgb color )
+{
+    QImage image( width, height, QImage::Format_RGB32 );
+    image.fill( color );
+    return image;
+}
+
+QImage readTexture( GLTexture2D& texture )
+{
+    const QSize& size = texture.getAllocatedSize();
+    QImage image( size, QImage::Format_RGB32 );
+    texture.bind();
+    glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.bits( ));
+    return image;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testSmallerImageDoesNotReallocateTexture )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTexture2D texture;
+    texture.update( createImage( 64, 64, RED ));
+    const GLuint textureId = texture.getTextureId();
+    BOOST_REQUIRE( texture.isValid( ));
+
+    texture.update( createImage( 32, 16, GREEN ));
+    BOOST_CHECK_EQUAL( texture.getTextureId(), textureId );
+    BOOST_CHECK_EQUAL( texture.getSize(), QSize( 32, 16 ));
+    BOOST_CHECK_EQUAL( texture.getAllocatedSize(), QSize( 64, 64 ));
+    BOOST_CHECK_EQUAL( texture.getTexCoords(), QRectF( 0.0, 0.0, 0.5, 0.25 ));
+
+    const QImage image = readTexture( texture );
+    BOOST_CHECK_EQUAL( image.pixel( 0, 0 ), GREEN );
+    BOOST_CHECK_EQUAL( image.pixel( 31, 15 ), GREEN );
+    BOOST_CHECK_EQUAL( image.pixel( 32, 16 ), RED );
+}
+
+BOOST_AUTO_TEST_CASE( testLargerImageReallocatesTexture )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTexture2D texture;
+    texture.update( createImage( 32, 32, RED ));
+    texture.update( createImage( 64, 16, GREEN ));
+
+    BOOST_CHECK_EQUAL( texture.getSize(), QSize( 64, 16 ));
+    BOOST_CHECK_EQUAL( texture.getAllocatedSize(), QSize( 64, 16 ));
+    BOOST_CHECK_EQUAL( texture.getTexCoords(), QRectF( 0.0, 0.0, 1.0, 1.0 ));
+    BOOST_CHECK_EQUAL( readTexture( texture ).pixel( 63, 15 ), GREEN );
+}
+
+BOOST_AUTO_TEST_CASE( testUploaderCountsUploadedBytes )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTextureUploader& uploader = GLTextureUploader::instance();
+    GLTexture2D texture;
+    texture.update( createImage( 16, 16, RED ));
+
+    const uint64_t uploaded = uploader.getUploadedBytes();
+    texture.update( createImage( 16, 16, GREEN ));
+    BOOST_CHECK_EQUAL( uploader.getUploadedBytes() - uploaded, 16 * 16 * 4 );
+    BOOST_CHECK_EQUAL( readTexture( texture ).pixel( 8, 8 ), GREEN );
+    BOOST_CHECK( uploader.getStatistics().contains( "MB/s" ));
+}
+
+BOOST_AUTO_TEST_CASE( testLuminanceUploadOfUnalignedRows )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTexture2D texture;
+    BOOST_REQUIRE( texture.init( QSize( 7, 3 ), GL_LUMINANCE, GL_LUMINANCE ));
+
+    // Rows of 5 bytes are not aligned on 4 bytes
+    std::vector<GLubyte> data( 5 * 3 );
+    for( size_t i = 0; i < data.size(); ++i )
+        data[i] = i;
+
+    GLTextureUploader& uploader = GLTextureUploader::instance();
+    const uint64_t uploaded = uploader.getUploadedBytes();
+    texture.update( data.data(), QRect( 1, 0, 5, 3 ), GL_LUMINANCE );
+    BOOST_CHECK_EQUAL( uploader.getUploadedBytes() - uploaded, data.size( ));
+
+    std::vector<GLubyte> result( 7 * 3 );
+    glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+    glGetTexImage( GL_TEXTURE_2D, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
+                   result.data( ));
+    BOOST_CHECK_EQUAL( int( result[1] ), 0 );
+    BOOST_CHECK_EQUAL( int( result[7 + 1] ), 5 );
+    BOOST_CHECK_EQUAL( int( result[2 * 7 + 5] ), 14 );
+}
+
+BOOST_AUTO_TEST_CASE( testUploadFromMappedPixelBuffer )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTextureUploader uploader;
+    if( !uploader.isSupported( ))
+        return;
+
+    GLTexture2D texture;
+    texture.update( createImage( 16, 16, RED ));
+
+    // Filled like the output of a decoding thread
+    QRgb* data = static_cast<QRgb*>( uploader.map( 8 * 8 * 4 ));
+    BOOST_REQUIRE( data );
+    BOOST_CHECK_EQUAL( uploader.getMappedCount(), 1 );
+    std::fill( data, data + 8 * 8, GREEN );
+
+    texture.bind();
+    uploader.upload( data, QSize( 8, 8 ), GL_RGBA );
+    BOOST_CHECK_EQUAL( uploader.getMappedCount(), 0 );
+
+    const QImage image = readTexture( texture );
+    BOOST_CHECK_EQUAL( image.pixel( 0, 0 ), GREEN );
+    BOOST_CHECK_EQUAL( image.pixel( 7, 7 ), GREEN );
+    BOOST_CHECK_EQUAL( image.pixel( 8, 8 ), RED );
+}
+
+BOOST_AUTO_TEST_CASE( testReleaseMappedPixelBuffer )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    GLTextureUploader uploader;
+    if( !uploader.isSupported( ))
+        return;
+
+    void* data = uploader.map( 64 );
+    BOOST_REQUIRE( data );
+    uploader.release( data );
+    BOOST_CHECK_EQUAL( uploader.getMappedCount(), 0 );
+
+    // Releasing twice is harmless
+    uploader.release( data );
+    BOOST_CHECK_EQUAL( uploader.getMappedCount(), 0 );
+
+    BOOST_CHECK( uploader.map( 128 ));
+    BOOST_CHECK_EQUAL( uploader.getMappedCount(), 1 );
+}
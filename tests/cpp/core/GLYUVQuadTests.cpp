@@ -0,0 +1,175 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE GLYUVQuadTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "GLYUVQuad.h"
+
+#include "GlobalQtApp.h"
+
+#include <QGLWidget>
+#include <QtOpenGL/QGLFramebufferObject>
+#include <QImage>
+
+#include <cstdlib>
+#include <vector>
+
+// Run with LIBGL_ALWAYS_SOFTWARE=1 to use Mesa's software rasterizer, for
+// instance in a virtual X server: xvfb-run ./GLYUVQuadTests
+
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+namespace
+{
+const QSize SIZE( 16, 16 );
+const QSize CHROMA_SIZE( 8, 8 );
+const int TOLERANCE = 3;
+
+void fill( GLYUVQuad& quad, const unsigned int plane, const QRect& region,
+           const GLubyte value )
+{
+    const std::vector<GLubyte> data( region.width() * region.height(), value );
+    quad.update( plane, data.data(), region );
+}
+
+void fill( GLYUVQuad& quad, const GLubyte y, const GLubyte u, const GLubyte v )
+{
+    fill( quad, 0, QRect( QPoint(), SIZE ), y );
+    fill( quad, 1, QRect( QPoint(), CHROMA_SIZE ), u );
+    fill( quad, 2, QRect( QPoint(), CHROMA_SIZE ), v );
+}
+
+QImage render( GLYUVQuad& quad )
+{
+    QGLFramebufferObject fbo( SIZE );
+    fbo.bind();
+    glViewport( 0, 0, SIZE.width(), SIZE.height( ));
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glOrtho( 0.0, 1.0, 0.0, 1.0, -1.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+    glClearColor( 0.f, 0.f, 1.f, 1.f );
+    glClear( GL_COLOR_BUFFER_BIT );
+
+    quad.render();
+
+    fbo.release();
+    return fbo.toImage();
+}
+
+bool isClose( const QRgb actual, const QRgb expected )
+{
+    return std::abs( qRed( actual ) - qRed( expected )) <= TOLERANCE &&
+           std::abs( qGreen( actual ) - qGreen( expected )) <= TOLERANCE &&
+           std::abs( qBlue( actual ) - qBlue( expected )) <= TOLERANCE;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testVideoRangeConversion )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+    if( !GLYUVQuad::isSupported( ))
+        return;
+
+    GLYUVQuad quad;
+    BOOST_REQUIRE( quad.init( SIZE, CHROMA_SIZE ));
+
+    // The initial content is black
+    BOOST_CHECK( isClose( render( quad ).pixel( 8, 8 ), qRgb( 0, 0, 0 )));
+
+    fill( quad, 235, 128, 128 );
+    BOOST_CHECK( isClose( render( quad ).pixel( 8, 8 ), qRgb( 255, 255, 255 )));
+
+    fill( quad, 81, 90, 240 );
+    BOOST_CHECK( isClose( render( quad ).pixel( 8, 8 ), qRgb( 255, 0, 0 )));
+    BOOST_CHECK_EQUAL( glGetError(), GLenum( GL_NO_ERROR ));
+}
+
+BOOST_AUTO_TEST_CASE( testFullRangeConversion )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+    if( !GLYUVQuad::isSupported( ))
+        return;
+
+    GLYUVQuad quad;
+    BOOST_REQUIRE( quad.init( SIZE, CHROMA_SIZE ));
+    quad.setFullColorRange( true );
+
+    fill( quad, 255, 128, 128 );
+    BOOST_CHECK( isClose( render( quad ).pixel( 8, 8 ), qRgb( 255, 255, 255 )));
+
+    fill( quad, 76, 85, 255 );
+    BOOST_CHECK( isClose( render( quad ).pixel( 8, 8 ), qRgb( 254, 0, 0 )));
+}
+
+BOOST_AUTO_TEST_CASE( testRegionUpdateAndTexCoords )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+    if( !GLYUVQuad::isSupported( ))
+        return;
+
+    GLYUVQuad quad;
+    BOOST_REQUIRE( quad.init( SIZE, CHROMA_SIZE ));
+
+    // Only the left half of the luma plane becomes white
+    fill( quad, 0, QRect( 0, 0, 8, 16 ), 235 );
+    QImage image = render( quad );
+    BOOST_CHECK( isClose( image.pixel( 2, 8 ), qRgb( 255, 255, 255 )));
+    BOOST_CHECK( isClose( image.pixel( 13, 8 ), qRgb( 0, 0, 0 )));
+
+    // Zoom on the right half
+    quad.setTexCoords( QRectF( 0.5, 0.0, 0.5, 1.0 ));
+    image = render( quad );
+    BOOST_CHECK( isClose( image.pixel( 2, 8 ), qRgb( 0, 0, 0 )));
+    BOOST_CHECK( isClose( image.pixel( 13, 8 ), qRgb( 0, 0, 0 )));
+}
@@ -0,0 +1,76 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE GeometryTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "geometry.h"
+#include "types.h" // operator<< for QRectF
+
+namespace
+{
+const QSize IMAGE_SIZE( 128, 128 );
+}
+
+BOOST_AUTO_TEST_CASE( testVisibleRegion )
+{
+    // The image is displayed twice as large, half of it on the wall area
+    const QRectF sceneRect( 1000.0, 0.0, 256.0, 256.0 );
+    const QRectF area( 0.0, 0.0, 1128.0, 1080.0 );
+
+    BOOST_CHECK_EQUAL( geometry::getVisibleRegion( IMAGE_SIZE, sceneRect,
+                                                   area ),
+                       QRect( 0, 0, 64, 128 ));
+    BOOST_CHECK_EQUAL( geometry::getVisibleRegion( IMAGE_SIZE, sceneRect,
+                                                   QRectF( 0, 0, 1000, 1080 )),
+                       QRect( ));
+}
+
+BOOST_AUTO_TEST_CASE( testVisibleRegionIsClampedToImage )
+{
+    // The rounding to whole pixels does not exceed the image
+    const QRectF sceneRect( 0.5, 0.5, 100.0, 100.0 );
+    const QRectF area( 0.0, 0.0, 200.0, 200.0 );
+
+    BOOST_CHECK_EQUAL( geometry::getVisibleRegion( IMAGE_SIZE, sceneRect,
+                                                   area ),
+                       QRect( QPoint(), IMAGE_SIZE ));
+    BOOST_CHECK( geometry::getVisibleRegion( QSize(), sceneRect,
+                                             area ).isEmpty( ));
+}
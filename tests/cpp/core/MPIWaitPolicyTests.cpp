@@ -0,0 +1,97 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#define BOOST_TEST_MODULE MPIWaitPolicyTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MPIWaitPolicy.h"
+
+BOOST_AUTO_TEST_CASE( testDefaultPolicy )
+{
+    const MPIWaitPolicy policy;
+    BOOST_CHECK_EQUAL( policy.mode, MPI_WAIT_MODE_BACKOFF );
+    BOOST_CHECK_EQUAL( policy.spinTime, 0u );
+    BOOST_CHECK_EQUAL( policy.maxSleep, 100u );
+}
+
+BOOST_AUTO_TEST_CASE( testParseMode )
+{
+    MPIWaitMode mode = MPI_WAIT_MODE_BACKOFF;
+
+    BOOST_CHECK( MPIWaitPolicy::parseMode( "budget", mode ));
+    BOOST_CHECK_EQUAL( mode, MPI_WAIT_MODE_LATENCY_BUDGET );
+
+    BOOST_CHECK( MPIWaitPolicy::parseMode( "progress", mode ));
+    BOOST_CHECK_EQUAL( mode, MPI_WAIT_MODE_PROGRESS_THREAD );
+
+    BOOST_CHECK( MPIWaitPolicy::parseMode( "backoff", mode ));
+    BOOST_CHECK_EQUAL( mode, MPI_WAIT_MODE_BACKOFF );
+
+    BOOST_CHECK( !MPIWaitPolicy::parseMode( "spin", mode ));
+    BOOST_CHECK_EQUAL( mode, MPI_WAIT_MODE_BACKOFF );
+}
+
+BOOST_AUTO_TEST_CASE( testHistogramBuckets )
+{
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( 0 ), 0u );
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( 1 ), 1u );
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( 2 ), 2u );
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( 3 ), 2u );
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( 100 ), 7u );
+    BOOST_CHECK_EQUAL( MPIWaitHistogram::getBucket( uint64_t(1) << 40 ),
+                       MPIWaitHistogram::BUCKETS - 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testHistogramAdd )
+{
+    MPIWaitHistogram histogram;
+    BOOST_CHECK_EQUAL( histogram.calls, 0u );
+    BOOST_CHECK_EQUAL( histogram.getAverage(), 0.0 );
+
+    histogram.add( 0 );
+    histogram.add( 100 );
+    histogram.add( 110 );
+
+    BOOST_CHECK_EQUAL( histogram.calls, 3u );
+    BOOST_CHECK_EQUAL( histogram.totalTime, 210u );
+    BOOST_CHECK_EQUAL( histogram.getAverage(), 70.0 );
+    BOOST_CHECK_EQUAL( histogram.counts[0], 1u );
+    BOOST_CHECK_EQUAL( histogram.counts[7], 2u );
+    BOOST_CHECK_EQUAL( histogram.toString(),
+                       "3 calls, avg 70 us | <1us: 1 | <128us: 2" );
+}
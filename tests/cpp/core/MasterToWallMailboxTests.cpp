@@ -0,0 +1,156 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#define BOOST_TEST_MODULE MasterToWallMailboxTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MasterToWallMailbox.h"
+
+#include "DisplayGroup.h"
+#include "Markers.h"
+#include "Options.h"
+
+#include "MinimalGlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( MinimalGlobalQtApp );
+
+namespace
+{
+const QSizeF wallSize( 1000, 1000 );
+
+struct Receiver
+{
+    Receiver( MasterToWallMailbox& mailbox )
+        : displayGroups( 0 ), options( 0 ), markers( 0 )
+    {
+        QObject::connect( &mailbox, &MasterToWallMailbox::sendDisplayGroup,
+                          [this]( DisplayGroupPtr group )
+                            { ++displayGroups; lastDisplayGroup = group; } );
+        QObject::connect( &mailbox, &MasterToWallMailbox::sendOptions,
+                          [this]( OptionsPtr ) { ++options; } );
+        QObject::connect( &mailbox, &MasterToWallMailbox::sendMarkers,
+                          [this]( MarkersPtr ) { ++markers; } );
+    }
+
+    size_t displayGroups;
+    size_t options;
+    size_t markers;
+    DisplayGroupPtr lastDisplayGroup;
+};
+}
+
+BOOST_AUTO_TEST_CASE( testUpdatesAreCoalescedUntilTheNextEventLoopPass )
+{
+    MasterToWallMailbox mailbox;
+    Receiver receiver( mailbox );
+
+    DisplayGroupPtr group1( new DisplayGroup( wallSize ));
+    DisplayGroupPtr group2( new DisplayGroup( wallSize ));
+    OptionsPtr options( new Options );
+
+    mailbox.post( group1 );
+    mailbox.post( options );
+    mailbox.post( group1 );
+    mailbox.post( group2 );
+
+    BOOST_CHECK( mailbox.hasPendingUpdates( ));
+    BOOST_CHECK_EQUAL( receiver.displayGroups, 0u );
+    BOOST_CHECK_EQUAL( mailbox.getCoalescedCount(
+                           MPI_MESSAGE_TYPE_DISPLAYGROUP ), 2u );
+
+    QCoreApplication::processEvents();
+
+    BOOST_CHECK( !mailbox.hasPendingUpdates( ));
+    BOOST_CHECK_EQUAL( receiver.displayGroups, 1u );
+    BOOST_CHECK_EQUAL( receiver.lastDisplayGroup, group2 );
+    BOOST_CHECK_EQUAL( receiver.options, 1u );
+    BOOST_CHECK_EQUAL( receiver.markers, 0u );
+
+    BOOST_CHECK_EQUAL( mailbox.getPostedCount( MPI_MESSAGE_TYPE_DISPLAYGROUP ),
+                       3u );
+    BOOST_CHECK_EQUAL( mailbox.getSentCount( MPI_MESSAGE_TYPE_DISPLAYGROUP ),
+                       1u );
+    BOOST_CHECK_EQUAL( mailbox.getCoalescedCount(
+                           MPI_MESSAGE_TYPE_DISPLAYGROUP ), 2u );
+    BOOST_CHECK_EQUAL( mailbox.getCoalescedCount( MPI_MESSAGE_TYPE_OPTIONS ),
+                       0u );
+    BOOST_CHECK_EQUAL( mailbox.getCoalescedCount( MPI_MESSAGE_TYPE_MARKERS ),
+                       0u );
+}
+
+BOOST_AUTO_TEST_CASE( testFlushSendsPendingUpdatesImmediately )
+{
+    MasterToWallMailbox mailbox;
+    Receiver receiver( mailbox );
+
+    MarkersPtr markers( new Markers );
+    mailbox.post( markers );
+    mailbox.post( markers );
+    mailbox.flush();
+
+    BOOST_CHECK_EQUAL( receiver.markers, 1u );
+    BOOST_CHECK( !mailbox.hasPendingUpdates( ));
+
+    // Nothing left for the scheduled flush
+    QCoreApplication::processEvents();
+    BOOST_CHECK_EQUAL( receiver.markers, 1u );
+    BOOST_CHECK_EQUAL( mailbox.getSentCount( MPI_MESSAGE_TYPE_MARKERS ), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testMaxSendRateDelaysTheNextFlush )
+{
+    MasterToWallMailbox mailbox;
+    Receiver receiver( mailbox );
+    mailbox.setMaxSendRate( 1 );
+
+    OptionsPtr options( new Options );
+    mailbox.post( options );
+    QCoreApplication::processEvents();
+    BOOST_REQUIRE_EQUAL( receiver.options, 1u );
+
+    // Within the one second interval, updates stay in the mailbox
+    mailbox.post( options );
+    mailbox.post( options );
+    QCoreApplication::processEvents();
+    BOOST_CHECK_EQUAL( receiver.options, 1u );
+    BOOST_CHECK( mailbox.hasPendingUpdates( ));
+
+    mailbox.flush();
+    BOOST_CHECK_EQUAL( receiver.options, 2u );
+    BOOST_CHECK_EQUAL( mailbox.getCoalescedCount( MPI_MESSAGE_TYPE_OPTIONS ),
+                       1u );
+}
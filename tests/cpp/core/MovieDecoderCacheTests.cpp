@@ -0,0 +1,225 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE MovieDecoderCacheTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MovieDecoderCache.h"
+#include "SharedMovieDecoder.h"
+
+#include <QByteArray>
+#include <QFile>
+
+namespace
+{
+const QString MOVIE_URI( "movie_decoder_cache.y4m" );
+const QString MISSING_MOVIE_URI( "missing_movie.y4m" );
+const int MOVIE_WIDTH = 16;
+const int MOVIE_HEIGHT = 16;
+const int MOVIE_FRAMES = 25;
+const int MOVIE_FPS = 25;
+}
+
+/**
+ * Write a short uncompressed movie which FFmpeg opens without any codec,
+ * so that the tests do not depend on a movie shipped with the resources.
+ */
+struct MovieFixture
+{
+    MovieFixture()
+    {
+        QFile file( MOVIE_URI );
+        BOOST_REQUIRE( file.open( QIODevice::WriteOnly ));
+
+        file.write( QString( "YUV4MPEG2 W%1 H%2 F%3:1 Ip A1:1 C420jpeg\n" )
+                        .arg( MOVIE_WIDTH ).arg( MOVIE_HEIGHT )
+                        .arg( MOVIE_FPS ).toLatin1( ));
+
+        const int frameSize = MOVIE_WIDTH * MOVIE_HEIGHT * 3 / 2;
+        for( int i = 0; i < MOVIE_FRAMES; ++i )
+        {
+            file.write( "FRAME\n" );
+            file.write( QByteArray( frameSize, char( i * 8 )));
+        }
+    }
+
+    ~MovieFixture()
+    {
+        QFile::remove( MOVIE_URI );
+    }
+
+    /** @return the position in seconds in the middle of a frame. */
+    double getPosition( const int64_t frameIndex ) const
+    {
+        return ( frameIndex + 0.5 ) / MOVIE_FPS;
+    }
+
+    MovieDecoderCache cache;
+};
+
+BOOST_FIXTURE_TEST_CASE( testWindowsInSyncShareADecoder, MovieFixture )
+{
+    SharedMovieDecoderPtr first = cache.getDecoder( MOVIE_URI,
+                                                    MOVIE_PICTURE_YUV,
+                                                    getPosition( 0 ));
+    BOOST_REQUIRE( first->getMovie().isValid( ));
+    SharedMovieDecoderPtr second = cache.getDecoder( MOVIE_URI,
+                                                     MOVIE_PICTURE_YUV,
+                                                     getPosition( 0 ));
+    BOOST_CHECK_EQUAL( first, second );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 1 );
+
+    const unsigned int firstUser = first->addUser();
+    const unsigned int secondUser = second->addUser();
+    BOOST_CHECK_EQUAL( first->getUserCount(), 2 );
+
+    // The frame decoded for one window is shared with the other
+    PicturePtr picture = first->getFrame( firstUser, getPosition( 0 )).get();
+    BOOST_REQUIRE( picture );
+    BOOST_CHECK_EQUAL( second->getFrame( secondUser, getPosition( 0 )).get(),
+                       picture );
+
+    // Either window may lead the decoder to the next frame
+    BOOST_CHECK( second->isInSync( secondUser, getPosition( 1 )));
+    picture = second->getFrame( secondUser, getPosition( 1 )).get();
+    BOOST_REQUIRE( picture );
+    BOOST_CHECK( first->isInSync( firstUser, getPosition( 1 )));
+    BOOST_CHECK_EQUAL( first->getFrame( firstUser, getPosition( 1 )).get(),
+                       picture );
+    BOOST_CHECK_EQUAL( first->getFrameIndex(), 1 );
+
+    // A window which opens the movie at the current frame joins the decoder
+    BOOST_CHECK_EQUAL( cache.getDecoder( MOVIE_URI, MOVIE_PICTURE_YUV,
+                                         getPosition( 1 )), first );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testDivergingWindowsForkTheDecoder, MovieFixture )
+{
+    SharedMovieDecoderPtr decoder = cache.getDecoder( MOVIE_URI,
+                                                      MOVIE_PICTURE_YUV,
+                                                      getPosition( 0 ));
+    BOOST_REQUIRE( decoder->getMovie().isValid( ));
+    const unsigned int playing = decoder->addUser();
+    const unsigned int paused = decoder->addUser();
+    decoder->getFrame( playing, getPosition( 0 )).wait();
+    decoder->getFrame( paused, getPosition( 0 )).wait();
+
+    // The playing window moves on while the other one stays on its frame
+    decoder->getFrame( playing, getPosition( 1 )).wait();
+    BOOST_CHECK( !decoder->isInSync( paused, getPosition( 0 )));
+
+    // The paused window gets a decoder of its own, as Movie does
+    SharedMovieDecoderPtr fork = cache.getDecoder( MOVIE_URI,
+                                                   MOVIE_PICTURE_YUV,
+                                                   getPosition( 0 ));
+    BOOST_REQUIRE( fork->getMovie().isValid( ));
+    BOOST_CHECK_NE( fork, decoder );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 2 );
+
+    decoder->removeUser( paused );
+    const unsigned int forked = fork->addUser();
+    BOOST_CHECK_EQUAL( decoder->getUserCount(), 1 );
+    BOOST_CHECK_EQUAL( fork->getUserCount(), 1 );
+    BOOST_CHECK( fork->getFrame( forked, getPosition( 0 )).get( ));
+    BOOST_CHECK_EQUAL( fork->getFrameIndex(), 0 );
+    BOOST_CHECK_EQUAL( decoder->getFrameIndex(), 1 );
+
+    // A window alone on its decoder is always in sync with it
+    BOOST_CHECK( decoder->isInSync( playing, getPosition( 5 )));
+    BOOST_CHECK( fork->isInSync( forked, getPosition( 3 )));
+
+    // Pictures in another format are never shared
+    SharedMovieDecoderPtr rgba = cache.getDecoder( MOVIE_URI,
+                                                   MOVIE_PICTURE_RGBA,
+                                                   getPosition( 0 ));
+    BOOST_CHECK_NE( rgba, fork );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 3 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testDecoderIsReleasedWithItsLastWindow, MovieFixture )
+{
+    SharedMovieDecoderPtr first = cache.getDecoder( MOVIE_URI,
+                                                    MOVIE_PICTURE_YUV,
+                                                    getPosition( 0 ));
+    BOOST_REQUIRE( first->getMovie().isValid( ));
+    SharedMovieDecoderPtr second = cache.getDecoder( MOVIE_URI,
+                                                     MOVIE_PICTURE_YUV,
+                                                     getPosition( 0 ));
+    const unsigned int firstUser = first->addUser();
+    const unsigned int secondUser = second->addUser();
+    first->getFrame( firstUser, getPosition( 0 )).wait();
+
+    const std::weak_ptr<SharedMovieDecoder> decoder = first;
+
+    // Closing one window keeps the decoder for the other one
+    first->removeUser( firstUser );
+    first.reset();
+    BOOST_CHECK( !decoder.expired( ));
+    BOOST_CHECK_EQUAL( second->getUserCount(), 1 );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 1 );
+
+    // The cache does not keep the decoder open after the last window
+    second->removeUser( secondUser );
+    second.reset();
+    BOOST_CHECK( decoder.expired( ));
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 0 );
+
+    // Opening the movie again starts a new decoder
+    SharedMovieDecoderPtr reopened = cache.getDecoder( MOVIE_URI,
+                                                       MOVIE_PICTURE_YUV,
+                                                       getPosition( 0 ));
+    BOOST_CHECK( reopened->getMovie().isValid( ));
+    BOOST_CHECK_EQUAL( reopened->getUserCount(), 0 );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testInvalidMovieIsNotShared, MovieFixture )
+{
+    SharedMovieDecoderPtr first = cache.getDecoder( MISSING_MOVIE_URI,
+                                                    MOVIE_PICTURE_YUV, 0.0 );
+    BOOST_CHECK( !first->getMovie().isValid( ));
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 0 );
+
+    // A later attempt may succeed, it must not reuse the failed decoder
+    SharedMovieDecoderPtr second = cache.getDecoder( MISSING_MOVIE_URI,
+                                                     MOVIE_PICTURE_YUV, 0.0 );
+    BOOST_CHECK_NE( first, second );
+    BOOST_CHECK_EQUAL( cache.getDecoderCount(), 0 );
+}
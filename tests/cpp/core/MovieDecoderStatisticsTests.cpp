@@ -0,0 +1,83 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE MovieDecoderStatisticsTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MovieDecoderStatistics.h"
+#include "MovieStatistics.h"
+#include "Profiler.h"
+
+BOOST_AUTO_TEST_CASE( testFpsAndLatencyOfTheLastSecond )
+{
+    MovieDecoderStatistics statistics( "movie.mp4", 3 );
+    BOOST_CHECK_EQUAL( statistics.getFps(), 0.0 );
+
+    // 25 frames in one second, each out of the decoder 40 ms after its packet
+    const int64_t start = Profiler::now();
+    for( int64_t i = 1; i <= 25; ++i )
+    {
+        const int64_t decodeTime = start + i * 40000;
+        statistics.recordFrame( decodeTime - 40000, decodeTime );
+    }
+
+    BOOST_CHECK_CLOSE( statistics.getFps(), 25.0, 1.0 );
+    BOOST_CHECK_CLOSE( statistics.getLatency(), 40.0, 1.0 );
+
+    const QString summary = statistics.getStatistics();
+    BOOST_CHECK( summary.startsWith( "movie.mp4: decoded" ));
+    BOOST_CHECK( summary.contains( "3 threads" ));
+}
+
+BOOST_AUTO_TEST_CASE( testDecodersAreListedWhileTheyExist )
+{
+    MovieStatistics statistics;
+    BOOST_CHECK( statistics.getDecoderStatistics().isEmpty( ));
+
+    auto first = statistics.addDecoder( "first.mp4", 1 );
+    {
+        auto second = statistics.addDecoder( "second.mp4", 4 );
+        const QString list = statistics.getDecoderStatistics();
+        BOOST_CHECK( list.contains( "first.mp4" ));
+        BOOST_CHECK( list.contains( "second.mp4" ));
+    }
+
+    BOOST_CHECK( statistics.getDecoderStatistics().startsWith( "first.mp4" ));
+    BOOST_CHECK( !statistics.getDecoderStatistics().contains( "second.mp4" ));
+}
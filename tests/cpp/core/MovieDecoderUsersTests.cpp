@@ -0,0 +1,123 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE MovieDecoderUsersTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MovieDecoderUsers.h"
+#include "types.h" // operator<< for QRectF
+
+BOOST_AUTO_TEST_CASE( testUsersInSyncShareFrames )
+{
+    MovieDecoderUsers users( 0 );
+    const unsigned int first = users.add();
+    const unsigned int second = users.add();
+    BOOST_CHECK_EQUAL( users.getCount(), 2 );
+
+    BOOST_CHECK( users.isInSync( first, 0 ));
+    BOOST_CHECK( !users.request( first, 0 ));
+    BOOST_CHECK( !users.request( second, 0 ));
+
+    // Either user can lead the decoder to the next frames
+    BOOST_CHECK( users.isInSync( first, 1 ));
+    BOOST_CHECK( users.request( first, 1 ));
+    BOOST_CHECK( users.isInSync( second, 1 ));
+    BOOST_CHECK( !users.request( second, 1 ));
+
+    BOOST_CHECK( users.isInSync( second, 3 ));
+    BOOST_CHECK( users.request( second, 3 ));
+    BOOST_CHECK( !users.request( first, 3 ));
+    BOOST_CHECK_EQUAL( users.getFrameIndex(), 3 );
+
+    // Looping back to the beginning of the movie
+    BOOST_CHECK( users.isInSync( first, 0 ));
+    BOOST_CHECK( users.request( first, 0 ));
+    BOOST_CHECK( !users.request( second, 0 ));
+}
+
+BOOST_AUTO_TEST_CASE( testUserBehindTheDecoderHasDiverged )
+{
+    MovieDecoderUsers users( 0 );
+    const unsigned int playing = users.add();
+    const unsigned int paused = users.add();
+
+    users.request( playing, 0 );
+    users.request( paused, 0 );
+    users.request( playing, 1 );
+    users.request( playing, 2 );
+
+    BOOST_CHECK( !users.isInSync( paused, 0 ));
+    BOOST_CHECK( !users.isInSync( paused, 1 ));
+    BOOST_CHECK( users.isInSync( paused, 2 ));
+
+    // Once alone, a user can request any frame
+    users.remove( playing );
+    BOOST_CHECK_EQUAL( users.getCount(), 1 );
+    BOOST_CHECK( users.isInSync( paused, 0 ));
+}
+
+BOOST_AUTO_TEST_CASE( testSameFrameRequestedAgainIsDecodedAgain )
+{
+    MovieDecoderUsers users( 5 );
+    const unsigned int user = users.add();
+
+    BOOST_CHECK( !users.request( user, 5 ));
+    BOOST_CHECK( users.request( user, 5 ));
+    BOOST_CHECK_EQUAL( users.getFrameIndex(), 5 );
+}
+
+BOOST_AUTO_TEST_CASE( testVisibleRegionCoversAllUsers )
+{
+    MovieDecoderUsers users( 0 );
+    const unsigned int first = users.add();
+    const unsigned int second = users.add();
+    BOOST_CHECK( users.getVisibleRegion().isEmpty( ));
+
+    users.setVisibleRegion( first, QRect( 0, 0, 100, 50 ));
+    users.setVisibleRegion( second, QRect( 200, 100, 100, 50 ));
+    BOOST_CHECK_EQUAL( users.getVisibleRegion(), QRect( 0, 0, 300, 150 ));
+
+    // Users which are not visible do not extend the region
+    users.setVisibleRegion( second, QRect( ));
+    BOOST_CHECK_EQUAL( users.getVisibleRegion(), QRect( 0, 0, 100, 50 ));
+
+    users.remove( first );
+    BOOST_CHECK( users.getVisibleRegion().isEmpty( ));
+}
@@ -0,0 +1,140 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamDecodePoolTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "PixelStreamDecodePool.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+const int SEGMENT_SIZE = 64;
+const int TIMEOUT_MS = 5000;
+
+deflect::Segment createInvalidSegment()
+{
+    deflect::Segment segment;
+    segment.parameters.width = SEGMENT_SIZE;
+    segment.parameters.height = SEGMENT_SIZE;
+    segment.parameters.compressed = true;
+    segment.imageData = QByteArray( 256, 'x' );
+    return segment;
+}
+
+bool waitForCompletion( const PixelStreamDecodePool& pool, const void* owner )
+{
+    for( int i = 0; i < TIMEOUT_MS; ++i )
+    {
+        if( pool.getPendingCount( owner ) == 0 )
+            return true;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+    }
+    return false;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testThreadCount )
+{
+    BOOST_CHECK_GE( PixelStreamDecodePool().getThreadCount(), 1 );
+    BOOST_CHECK_EQUAL( PixelStreamDecodePool( 3 ).getThreadCount(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( testInitialState )
+{
+    const PixelStreamDecodePool pool( 1 );
+    const int owner = 0;
+
+    BOOST_CHECK_EQUAL( pool.getPendingCount( &owner ), 0 );
+    BOOST_CHECK_EQUAL( pool.getQueueDepth(), 0 );
+    BOOST_CHECK_EQUAL( pool.getDecodedCount(), 0 );
+    BOOST_CHECK_EQUAL( pool.getThroughput(), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testAllSegmentsAreProcessed )
+{
+    PixelStreamDecodePool pool( 2 );
+    const int first = 0;
+    const int second = 0;
+
+    const deflect::Segment segment = createInvalidSegment();
+    const QRect region( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE );
+    std::vector<DecodedRegion> outputs( 8 );
+    for( size_t i = 0; i < outputs.size(); ++i )
+        pool.decode( i % 2 ? &first : &second, segment, region, outputs[i] );
+
+    BOOST_REQUIRE( waitForCompletion( pool, &first ));
+    BOOST_REQUIRE( waitForCompletion( pool, &second ));
+    BOOST_CHECK_EQUAL( pool.getQueueDepth(), 0 );
+    BOOST_CHECK_EQUAL( pool.getDecodedCount(), outputs.size( ));
+    BOOST_CHECK_GT( pool.getAverageLatency(), 0.0 );
+
+    // Invalid segments are reported with an empty region
+    for( size_t i = 0; i < outputs.size(); ++i )
+        BOOST_CHECK( outputs[i].rect.isEmpty( ));
+}
+
+BOOST_AUTO_TEST_CASE( testCancelDiscardsQueuedSegments )
+{
+    PixelStreamDecodePool pool( 1 );
+    const int owner = 0;
+
+    const deflect::Segment segment = createInvalidSegment();
+    const QRect region( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE );
+    std::vector<DecodedRegion> outputs( 64 );
+    for( size_t i = 0; i < outputs.size(); ++i )
+        pool.decode( &owner, segment, region, outputs[i] );
+
+    pool.cancel( &owner );
+    BOOST_CHECK_EQUAL( pool.getPendingCount( &owner ), 0 );
+    BOOST_CHECK_EQUAL( pool.getQueueDepth(), 0 );
+    BOOST_CHECK_LE( pool.getDecodedCount(), outputs.size( ));
+}
+
+BOOST_AUTO_TEST_CASE( testStatistics )
+{
+    const PixelStreamDecodePool pool( 2 );
+    const QString statistics = pool.getStatistics();
+
+    BOOST_CHECK( statistics.contains( "MPix/s" ));
+    BOOST_CHECK( statistics.contains( "queue 0" ));
+    BOOST_CHECK( statistics.contains( "threads 2" ));
+}
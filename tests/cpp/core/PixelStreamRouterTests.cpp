@@ -0,0 +1,198 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamRouterTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include <deflect/Frame.h>
+
+#include "ContentWindow.h"
+#include "PixelStreamContent.h"
+#include "PixelStreamRouter.h"
+#include "SegmentChangeTracker.h"
+
+#include "MinimalGlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( MinimalGlobalQtApp );
+
+namespace
+{
+const QString CONTENT_URI( "bla" );
+const QRect leftProcessArea( 0, 0, 100, 100 );
+const QRect rightProcessArea( 100, 0, 100, 100 );
+const QRectF leftWindowCoord( 0.0, 0.0, 100.0, 50.0 );
+const QRectF rightWindowCoord( 100.0, 0.0, 100.0, 50.0 );
+}
+
+std::vector<QRect> createProcessAreas()
+{
+    std::vector<QRect> areas;
+    areas.push_back( leftProcessArea );
+    areas.push_back( rightProcessArea );
+    return areas;
+}
+
+deflect::FramePtr createTestFrame()
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = CONTENT_URI;
+    for( int i = 0; i < 2; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * 50;
+        segment.parameters.width = 50;
+        segment.parameters.height = 50;
+        segment.imageData = QByteArray( 16, 'x' );
+        frame->segments.push_back( segment );
+    }
+    return frame;
+}
+
+ContentWindowPtrs createWindows( const QRectF& coordinates )
+{
+    ContentPtr content( new PixelStreamContent( CONTENT_URI ));
+    ContentWindowPtr window( new ContentWindow( content ));
+    window->setCoordinates( coordinates );
+    return ContentWindowPtrs( 1, window );
+}
+
+BOOST_AUTO_TEST_CASE( testUnknownStreamIsSentToAllProcesses )
+{
+    PixelStreamRouter router( createProcessAreas( ));
+    deflect::FramePtr frame = createTestFrame();
+
+    const std::vector<deflect::FramePtr> frames = router.route( frame );
+
+    BOOST_REQUIRE_EQUAL( frames.size(), 2u );
+    BOOST_CHECK( frames[0] == frame );
+    BOOST_CHECK( frames[1] == frame );
+    BOOST_CHECK( !router.getLastFrame( CONTENT_URI ));
+}
+
+BOOST_AUTO_TEST_CASE( testSegmentsAreOnlySentToIntersectingProcesses )
+{
+    PixelStreamRouter router( createProcessAreas( ));
+    BOOST_CHECK( router.updateWindows( createWindows( leftWindowCoord ))
+                 .isEmpty( ));
+
+    deflect::FramePtr frame = createTestFrame();
+    const std::vector<deflect::FramePtr> frames = router.route( frame );
+
+    BOOST_REQUIRE_EQUAL( frames.size(), 2u );
+    BOOST_CHECK( frames[0] == frame );
+    BOOST_CHECK( router.getLastFrame( CONTENT_URI ) == frame );
+
+    // The other process keeps the segment parameters without the image data
+    BOOST_REQUIRE_EQUAL( frames[1]->segments.size(), 2u );
+    for( size_t i = 0; i < 2; ++i )
+    {
+        BOOST_CHECK( frames[1]->segments[i].imageData.isEmpty( ));
+        BOOST_CHECK_EQUAL( frames[1]->segments[i].parameters.x,
+                           frame->segments[i].parameters.x );
+    }
+    BOOST_CHECK_EQUAL( frame->segments[0].imageData.size(), 16 );
+}
+
+BOOST_AUTO_TEST_CASE( testMovingWindowRequestsResendOfLastFrame )
+{
+    PixelStreamRouter router( createProcessAreas( ));
+    router.updateWindows( createWindows( leftWindowCoord ));
+    router.route( createTestFrame( ));
+
+    const QStringList outdated =
+            router.updateWindows( createWindows( rightWindowCoord ));
+    BOOST_REQUIRE_EQUAL( outdated.size(), 1 );
+    BOOST_CHECK_EQUAL( outdated[0].toStdString(), CONTENT_URI.toStdString( ));
+
+    // While moving, both the previous and the new processes get the segments
+    std::vector<deflect::FramePtr> frames =
+            router.route( router.getLastFrame( CONTENT_URI ));
+    BOOST_CHECK( !frames[0]->segments[0].imageData.isEmpty( ));
+    BOOST_CHECK( !frames[1]->segments[0].imageData.isEmpty( ));
+
+    // Once the move is complete, only the new process gets them
+    BOOST_CHECK( router.updateWindows( createWindows( rightWindowCoord ))
+                 .isEmpty( ));
+    frames = router.route( createTestFrame( ));
+    BOOST_CHECK( frames[0]->segments[0].imageData.isEmpty( ));
+    BOOST_CHECK( frames[0]->segments[1].imageData.isEmpty( ));
+    BOOST_CHECK( !frames[1]->segments[0].imageData.isEmpty( ));
+    BOOST_CHECK( !frames[1]->segments[1].imageData.isEmpty( ));
+}
+
+BOOST_AUTO_TEST_CASE( testUnchangedSegmentsAreSentToProcessesWithoutThem )
+{
+    PixelStreamRouter router( createProcessAreas( ));
+    SegmentChangeTracker tracker;
+    router.updateWindows( createWindows( leftWindowCoord ));
+
+    deflect::FramePtr frame = createTestFrame();
+    std::vector<deflect::FramePtr> frames =
+            router.route( frame, tracker.update( *frame ));
+    const deflect::FramePtr leftFrame = frames[0];
+
+    // The window moves to the other process while the stream is unchanged
+    router.updateWindows( createWindows( rightWindowCoord ));
+    frame = createTestFrame();
+    frames = router.route( frame, tracker.update( *frame ));
+    BOOST_REQUIRE_EQUAL( frames.size(), 2u );
+    for( size_t i = 0; i < 2; ++i )
+    {
+        // The process which has the segments is told to keep them, the other
+        // one gets their image data without waiting for a resend
+        BOOST_CHECK( SegmentChangeTracker::isUnchanged(
+                         frames[0]->segments[i] ));
+        BOOST_CHECK_EQUAL( frames[1]->segments[i].imageData.size(), 16 );
+    }
+
+    // Once the move is complete, the segments which are not routed are not
+    // mistaken for unchanged ones
+    router.updateWindows( createWindows( rightWindowCoord ));
+    frame = createTestFrame();
+    frames = router.route( frame, tracker.update( *frame ));
+    for( size_t i = 0; i < 2; ++i )
+    {
+        BOOST_CHECK( frames[0]->segments[i].imageData.isNull( ));
+        BOOST_CHECK( SegmentChangeTracker::isUnchanged(
+                         frames[1]->segments[i] ));
+    }
+    deflect::Frame notRouted( *frames[0] );
+    BOOST_CHECK_EQUAL( SegmentChangeTracker::fillUnchanged( notRouted,
+                                                            *leftFrame ), 0 );
+    BOOST_CHECK( notRouted.segments[0].imageData.isNull( ));
+}
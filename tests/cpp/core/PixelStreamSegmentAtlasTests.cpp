@@ -0,0 +1,162 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE PixelStreamSegmentAtlasTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "PixelStreamSegmentAtlas.h"
+#include "types.h" // operator<< for QSize
+
+#include "GlobalQtApp.h"
+
+#include <QGLWidget>
+#include <QImage>
+
+// Run with LIBGL_ALWAYS_SOFTWARE=1 to use Mesa's software rasterizer, for
+// instance in a virtual X server: xvfb-run ./PixelStreamSegmentAtlasTests
+
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+namespace
+{
+const QRgb RED = 0xffff0000;
+const QRgb GREEN = 0xff00ff00;
+const QRgb BLUE = 0xff0000ff;
+
+QImage createImage( const int width, const int height, const QRgb color )
+{
+    QImage image( width, height, QImage::Format_RGB32 );
+    image.fill( color );
+    return image;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testGridIsCloseToSquare )
+{
+    const QSize cellSize( 64, 64 );
+
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize( cellSize, 1,
+                                                                 8192 ),
+                       QSize( 1, 1 ));
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize( cellSize, 16,
+                                                                 8192 ),
+                       QSize( 4, 4 ));
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize( cellSize, 17,
+                                                                 8192 ),
+                       QSize( 5, 4 ));
+
+    // Wide cells are stacked in more rows than columns
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize(
+                           QSize( 256, 64 ), 16, 8192 ), QSize( 2, 8 ));
+}
+
+BOOST_AUTO_TEST_CASE( testGridIsLimitedByMaxTextureSize )
+{
+    const QSize cellSize( 128, 128 );
+
+    // 4K stream in 128x128 segments: 30x17 = 510 cells
+    const QSize grid = PixelStreamSegmentAtlas::computeGridSize( cellSize, 510,
+                                                                 4096 );
+    BOOST_CHECK_EQUAL( grid, QSize( 23, 23 ));
+
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize( cellSize, 510,
+                                                                 2048 ),
+                       QSize( ));
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize(
+                           QSize( 4096, 64 ), 2, 2048 ), QSize( ));
+    BOOST_CHECK_EQUAL( PixelStreamSegmentAtlas::computeGridSize( cellSize, 0,
+                                                                 2048 ),
+                       QSize( ));
+}
+
+BOOST_AUTO_TEST_CASE( testSegmentsAreUploadedToTheirCell )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    PixelStreamSegmentAtlas atlas;
+    BOOST_REQUIRE( atlas.resize( QSize( 32, 32 ), 4 ));
+    BOOST_CHECK_EQUAL( atlas.getCellCount(), 4u );
+    BOOST_CHECK_EQUAL( atlas.getGridSize(), QSize( 2, 2 ));
+    BOOST_CHECK( atlas.getCellPosition( 3 ) == QPoint( 32, 32 ));
+
+    // No segment has an image yet
+    std::vector<size_t> cells( 1, 0 );
+    BOOST_CHECK( !atlas.render( cells ));
+
+    atlas.update( 1, createImage( 32, 32, RED ), QRect( 32, 0, 32, 32 ));
+    atlas.update( 2, createImage( 16, 8, GREEN ), QRect( 0, 32, 16, 8 ));
+    atlas.update( 3, createImage( 64, 64, BLUE ), QRect( 32, 32, 64, 64 ));
+
+    QImage image( 64, 64, QImage::Format_RGB32 );
+    glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.bits( ));
+    BOOST_CHECK_EQUAL( image.pixel( 32, 0 ), RED );
+    BOOST_CHECK_EQUAL( image.pixel( 63, 31 ), RED );
+    BOOST_CHECK_EQUAL( image.pixel( 0, 32 ), GREEN );
+    BOOST_CHECK_EQUAL( image.pixel( 15, 39 ), GREEN );
+    // The image larger than a cell was rejected
+    BOOST_CHECK( image.pixel( 48, 48 ) != BLUE );
+
+    cells.push_back( 1 );
+    BOOST_CHECK( atlas.render( cells ));
+}
+
+BOOST_AUTO_TEST_CASE( testSameLayoutKeepsTheTexture )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGLWidget widget;
+    widget.makeCurrent();
+
+    PixelStreamSegmentAtlas atlas;
+    BOOST_REQUIRE( atlas.resize( QSize( 32, 32 ), 4 ));
+    atlas.update( 0, createImage( 32, 32, RED ), QRect( 0, 0, 32, 32 ));
+
+    BOOST_REQUIRE( atlas.resize( QSize( 32, 32 ), 4 ));
+    const std::vector<size_t> cells( 1, 0 );
+    BOOST_CHECK( atlas.render( cells ));
+
+    BOOST_REQUIRE( atlas.resize( QSize( 64, 32 ), 4 ));
+    BOOST_CHECK( !atlas.render( cells ));
+}
@@ -0,0 +1,147 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "PixelStream.h"
+
+#include "MPIChannel.h"
+#include "SwapSyncRegistry.h"
+#include "WallToWallChannel.h"
+
+#include <deflect/Frame.h>
+
+#include <boost/make_shared.hpp>
+
+namespace
+{
+const QString STREAM_URI( "stream" );
+const int SEGMENTS_COUNT = 3;
+const int SEGMENT_SIZE = 16;
+
+// A single MPI context for all the tests, MPI can only be initialized once.
+struct GlobalMPIChannel
+{
+    GlobalMPIChannel()
+    {
+        ut::master_test_suite_t& testSuite = ut::framework::master_test_suite();
+        channel = boost::make_shared<MPIChannel>( testSuite.argc,
+                                                  testSuite.argv );
+    }
+    static MPIChannelPtr channel;
+};
+MPIChannelPtr GlobalMPIChannel::channel;
+
+deflect::FramePtr createTestFrame()
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = STREAM_URI;
+    for( int i = 0; i < SEGMENTS_COUNT; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * SEGMENT_SIZE;
+        segment.parameters.y = 0;
+        segment.parameters.width = SEGMENT_SIZE;
+        segment.parameters.height = SEGMENT_SIZE;
+        segment.parameters.compressed = false;
+        segment.imageData = QByteArray( SEGMENT_SIZE * SEGMENT_SIZE * 4, 'a' );
+        frame->segments.push_back( segment );
+    }
+    return frame;
+}
+
+// Run the synchronization step of the frame loop, where the minimum of the
+// decoded frame indices of all processes is resolved.
+void preRenderSync( PixelStream& stream, WallToWallChannel& wallChannel )
+{
+    SwapSyncRegistry registry;
+    WallContent& content = stream;
+    content.preRenderSync( wallChannel, registry );
+    registry.synchronize( wallChannel );
+}
+}
+
+BOOST_GLOBAL_FIXTURE( GlobalMPIChannel );
+
+BOOST_AUTO_TEST_CASE( testBuffersAreSwappedWhenAllRanksAreReady )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    PixelStream stream( STREAM_URI );
+
+    stream.setNewFrame( createTestFrame(), 0 );
+    BOOST_CHECK( stream.hasPendingFrame( ));
+    BOOST_CHECK_EQUAL( stream.getDecodedFrameIndex(), 0 );
+
+    // Nothing is being decoded, the new frame is swapped to the front buffer
+    preRenderSync( stream, wallChannel );
+    BOOST_CHECK( !stream.hasPendingFrame( ));
+    BOOST_CHECK_EQUAL( stream.getDecodedFrameIndex(), 1 );
+    BOOST_CHECK( stream.getSegments().isEmpty( ));
+
+    // The renderers are updated once all processes have decoded it
+    stream.setNewFrame( createTestFrame(), 0 );
+    preRenderSync( stream, wallChannel );
+    BOOST_CHECK_EQUAL( stream.getSegments().size(), SEGMENTS_COUNT );
+    BOOST_CHECK( !stream.hasPendingFrame( ));
+    BOOST_CHECK_EQUAL( stream.getDecodedFrameIndex(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( testFrontBufferIsKeptWhileRanksAreNotReady )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    PixelStream stream( STREAM_URI );
+
+    stream.setNewFrame( createTestFrame(), 0 );
+    preRenderSync( stream, wallChannel );
+    BOOST_REQUIRE_EQUAL( stream.getDecodedFrameIndex(), 1 );
+
+    // Another process is still decoding the previous frame
+    stream.setNewFrame( createTestFrame(), 0 );
+    stream.syncFrame( 0 );
+    BOOST_CHECK( stream.hasPendingFrame( ));
+    BOOST_CHECK_EQUAL( stream.getDecodedFrameIndex(), 1 );
+    BOOST_CHECK( stream.getSegments().isEmpty( ));
+
+    // Until it catches up
+    stream.syncFrame( 1 );
+    BOOST_CHECK( !stream.hasPendingFrame( ));
+    BOOST_CHECK_EQUAL( stream.getDecodedFrameIndex(), 2 );
+    BOOST_CHECK_EQUAL( stream.getSegments().size(), SEGMENTS_COUNT );
+}
@@ -0,0 +1,251 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE PixelStreamTranscoderTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include <deflect/Frame.h>
+
+#include "ContentWindow.h"
+#include "PixelStreamContent.h"
+#include "PixelStreamTranscoder.h"
+#include "SegmentRegionDecoder.h"
+
+#include "MinimalGlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( MinimalGlobalQtApp );
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+const QString STREAM_URI( "stream" );
+const unsigned int TILE_SIZE = 256;
+const unsigned int QUALITY = 90;
+const int BYTES_PER_PIXEL = 4;
+}
+
+deflect::Segment createRawSegment( const QRect& rect )
+{
+    deflect::Segment segment;
+    segment.parameters.x = rect.x();
+    segment.parameters.y = rect.y();
+    segment.parameters.width = rect.width();
+    segment.parameters.height = rect.height();
+    segment.parameters.compressed = false;
+    segment.imageData = QByteArray( rect.width() * rect.height() *
+                                    BYTES_PER_PIXEL, (char)0x80 );
+    return segment;
+}
+
+deflect::FramePtr createRawFrame( const QSize& segmentSize, const int columns,
+                                  const int rows )
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = STREAM_URI;
+    for( int y = 0; y < rows; ++y )
+    {
+        for( int x = 0; x < columns; ++x )
+        {
+            const QRect rect( QPoint( x * segmentSize.width(),
+                                      y * segmentSize.height( )),
+                              segmentSize );
+            frame->segments.push_back( createRawSegment( rect ));
+        }
+    }
+    return frame;
+}
+
+/** Collect the frames emitted by the threads of a transcoder. */
+class FrameCollector
+{
+public:
+    explicit FrameCollector( PixelStreamTranscoder& transcoder )
+    {
+        QObject::connect( &transcoder, &PixelStreamTranscoder::transcoded,
+                          [this]( deflect::FramePtr frame )
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _frames.push_back( frame );
+        } );
+    }
+
+    std::vector<deflect::FramePtr> waitForFrames( const size_t count )
+    {
+        for( int i = 0; i < 5000; ++i )
+        {
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                if( _frames.size() >= count )
+                    return _frames;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+        }
+        std::lock_guard<std::mutex> lock( _mutex );
+        return _frames;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<deflect::FramePtr> _frames;
+};
+
+BOOST_AUTO_TEST_CASE( testTargetSize )
+{
+    const QSize frameSize( 7680, 4320 );
+
+    BOOST_CHECK( PixelStreamTranscoder::getTargetSize( frameSize, QSize( )) ==
+                 frameSize );
+    BOOST_CHECK( PixelStreamTranscoder::getTargetSize(
+                     frameSize, QSize( 10000, 5000 )) == frameSize );
+    BOOST_CHECK( PixelStreamTranscoder::getTargetSize(
+                     frameSize, QSize( 1920, 1080 )) == QSize( 1920, 1080 ));
+    // The aspect ratio of the frame is preserved
+    BOOST_CHECK( PixelStreamTranscoder::getTargetSize(
+                     frameSize, QSize( 1920, 2000 )) == QSize( 1920, 1080 ));
+}
+
+BOOST_AUTO_TEST_CASE( testCompressedFrameIsForwardedUnchanged )
+{
+    deflect::FramePtr frame = createRawFrame( QSize( 64, 64 ), 2, 1 );
+    for( deflect::Segment& segment : frame->segments )
+        segment.parameters.compressed = true;
+
+    PixelStreamTranscoder transcoder( TILE_SIZE, QUALITY, 2 );
+    FrameCollector collector( transcoder );
+    transcoder.transcode( frame );
+
+    const std::vector<deflect::FramePtr> frames = collector.waitForFrames( 1 );
+    BOOST_REQUIRE_EQUAL( frames.size(), 1u );
+    BOOST_CHECK( frames[0] == frame );
+    BOOST_CHECK_EQUAL( transcoder.getSavedBytes(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testRawSegmentsAreCompressed )
+{
+    const deflect::FramePtr frame = createRawFrame( QSize( 128, 64 ), 3, 2 );
+
+    PixelStreamTranscoder transcoder( TILE_SIZE, QUALITY, 2 );
+    FrameCollector collector( transcoder );
+    transcoder.transcode( frame );
+
+    const std::vector<deflect::FramePtr> frames = collector.waitForFrames( 1 );
+    BOOST_REQUIRE_EQUAL( frames.size(), 1u );
+    const deflect::Frame& output = *frames[0];
+
+    BOOST_CHECK( output.uri == STREAM_URI );
+    BOOST_REQUIRE_EQUAL( output.segments.size(), frame->segments.size( ));
+    SegmentRegionDecoder decoder;
+    for( size_t i = 0; i < output.segments.size(); ++i )
+    {
+        const deflect::Segment& segment = output.segments[i];
+        BOOST_CHECK( segment.parameters.compressed );
+        BOOST_CHECK_EQUAL( segment.parameters.x,
+                           frame->segments[i].parameters.x );
+        BOOST_CHECK_EQUAL( segment.parameters.y,
+                           frame->segments[i].parameters.y );
+        BOOST_CHECK( segment.imageData.size() <
+                     frame->segments[i].imageData.size( ));
+
+        DecodedRegion decoded;
+        decoder.decode( segment, QRect( 0, 0, 128, 64 ), decoded );
+        BOOST_CHECK( decoded.rect == QRect( 0, 0, 128, 64 ));
+        BOOST_CHECK_CLOSE( (double)(uchar)decoded.imageData[0], 128.0, 2.0 );
+    }
+    BOOST_CHECK( transcoder.getSavedBytes() > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testOversizedSegmentIsSplitIntoTiles )
+{
+    const deflect::FramePtr frame = createRawFrame( QSize( 600, 300 ), 1, 1 );
+
+    PixelStreamTranscoder transcoder( TILE_SIZE, QUALITY, 2 );
+    FrameCollector collector( transcoder );
+    transcoder.transcode( frame );
+
+    const std::vector<deflect::FramePtr> frames = collector.waitForFrames( 1 );
+    BOOST_REQUIRE_EQUAL( frames.size(), 1u );
+    const deflect::Frame& output = *frames[0];
+
+    // 3 x 2 tiles of at most TILE_SIZE
+    BOOST_REQUIRE_EQUAL( output.segments.size(), 6u );
+    BOOST_CHECK( output.computeDimensions() == QSize( 600, 300 ));
+    for( const deflect::Segment& segment : output.segments )
+    {
+        BOOST_CHECK( segment.parameters.compressed );
+        BOOST_CHECK( segment.parameters.width <= TILE_SIZE );
+        BOOST_CHECK( segment.parameters.height <= TILE_SIZE );
+    }
+    BOOST_CHECK_EQUAL( output.segments[2].parameters.x, 512 );
+    BOOST_CHECK_EQUAL( output.segments[2].parameters.width, 88 );
+    BOOST_CHECK_EQUAL( output.segments[5].parameters.height, 44 );
+}
+
+BOOST_AUTO_TEST_CASE( testFrameIsDownscaledToItsWindow )
+{
+    ContentPtr content( new PixelStreamContent( STREAM_URI ));
+    ContentWindowPtr window( new ContentWindow( content ));
+    window->setCoordinates( QRectF( 0.0, 0.0, 200.0, 100.0 ));
+
+    PixelStreamTranscoder transcoder( TILE_SIZE, QUALITY, 2 );
+    transcoder.updateWindows( ContentWindowPtrs( 1, window ));
+    FrameCollector collector( transcoder );
+    transcoder.transcode( createRawFrame( QSize( 200, 100 ), 4, 4 ));
+
+    const std::vector<deflect::FramePtr> frames = collector.waitForFrames( 1 );
+    BOOST_REQUIRE_EQUAL( frames.size(), 1u );
+    BOOST_CHECK( frames[0]->computeDimensions() == QSize( 200, 100 ));
+    BOOST_CHECK_EQUAL( frames[0]->segments.size(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testFramesOfAStreamAreEmittedInOrder )
+{
+    PixelStreamTranscoder transcoder( TILE_SIZE, QUALITY, 4 );
+    FrameCollector collector( transcoder );
+    transcoder.transcode( createRawFrame( QSize( 64, 64 ), 8, 8 ));
+    transcoder.transcode( createRawFrame( QSize( 32, 32 ), 1, 1 ));
+
+    const std::vector<deflect::FramePtr> frames = collector.waitForFrames( 2 );
+    BOOST_REQUIRE_EQUAL( frames.size(), 2u );
+    BOOST_CHECK_EQUAL( frames[0]->segments.size(), 64u );
+    BOOST_CHECK_EQUAL( frames[1]->segments.size(), 1u );
+    BOOST_CHECK_EQUAL( transcoder.getFrameCount(), 2u );
+}
@@ -0,0 +1,304 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamUpdaterTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "PixelStreamUpdater.h"
+
+#include "MPIChannel.h"
+#include "PixelStream.h"
+#include "SwapSyncRegistry.h"
+#include "WallToWallChannel.h"
+
+#include <deflect/Frame.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+const QString STREAM_URI( "stream" );
+const int SEGMENT_SIZE = 16;
+
+// A single MPI context for all the tests, MPI can only be initialized once.
+struct GlobalMPIChannel
+{
+    GlobalMPIChannel()
+    {
+        ut::master_test_suite_t& testSuite = ut::framework::master_test_suite();
+        channel = boost::make_shared<MPIChannel>( testSuite.argc,
+                                                  testSuite.argv );
+    }
+    static MPIChannelPtr channel;
+};
+MPIChannelPtr GlobalMPIChannel::channel;
+
+// The frames are identified by their number of segments
+deflect::FramePtr createTestFrame( const int segmentCount )
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = STREAM_URI;
+    for( int i = 0; i < segmentCount; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * SEGMENT_SIZE;
+        segment.parameters.width = SEGMENT_SIZE;
+        segment.parameters.height = SEGMENT_SIZE;
+        segment.parameters.compressed = false;
+        segment.imageData = QByteArray( SEGMENT_SIZE * SEGMENT_SIZE * 4, 'a' );
+        frame->segments.push_back( segment );
+    }
+    return frame;
+}
+
+struct UpdaterFixture
+{
+    UpdaterFixture()
+        : wallChannel( GlobalMPIChannel::channel )
+        , stream( boost::make_shared<PixelStream>( STREAM_URI ))
+        , requests( 0 )
+    {
+        QObject::connect( &updater, &PixelStreamUpdater::requestFrame,
+                          [this]( QString ) { ++requests; } );
+    }
+
+    void open( const PixelStreamPacingMode mode,
+               const unsigned int maxFps = 0 )
+    {
+        PixelStreamPacing pacing;
+        pacing.mode = mode;
+        pacing.maxFps = maxFps;
+        updater.addPixelStream( STREAM_URI, stream, pacing );
+    }
+
+    void receive( const int segmentCount )
+    {
+        updater.updatePixelStream( createTestFrame( segmentCount ));
+    }
+
+    // Swap the frames which all processes have received, like the
+    // RenderController before each frame
+    void synchronize()
+    {
+        SwapSyncRegistry registry;
+        wallChannel.synchronizeClock( registry );
+        updater.synchronizeFramesSwap( registry, wallChannel );
+        registry.synchronize( wallChannel );
+    }
+
+    // Process the frame set by the updater: the first sync swaps it to the
+    // front buffer and the second one updates the segments.
+    int display()
+    {
+        stream->syncFrame( stream->getDecodedFrameIndex( ));
+        stream->syncFrame( stream->getDecodedFrameIndex( ));
+        return stream->getSegments().size();
+    }
+
+    bool hasStatistics( const QString& counter ) const
+    {
+        return stream->getFrameStatistics().contains( counter );
+    }
+
+    WallToWallChannel wallChannel;
+    PixelStreamUpdater updater;
+    PixelStreamPtr stream;
+    int requests;
+};
+
+// Two processes in a single one, whose frames are swapped with the values
+// reduced as by the collective of SwapSyncRegistry::synchronize()
+struct TwoProcessesFixture
+{
+    void open( const PixelStreamPacingMode mode )
+    {
+        first.open( mode );
+        second.open( mode );
+    }
+
+    void synchronize()
+    {
+        SwapSyncRegistry firstRegistry;
+        SwapSyncRegistry secondRegistry;
+        first.updater.synchronizeFramesSwap( firstRegistry,
+                                             first.wallChannel );
+        second.updater.synchronizeFramesSwap( secondRegistry,
+                                              second.wallChannel );
+
+        const std::vector<uint64_t>& firstValues =
+                firstRegistry.getPendingValues();
+        const std::vector<uint64_t>& secondValues =
+                secondRegistry.getPendingValues();
+        BOOST_REQUIRE_EQUAL( firstValues.size(), secondValues.size( ));
+
+        std::vector<uint64_t> minValues, maxValues;
+        for( size_t i = 0; i < firstValues.size(); ++i )
+        {
+            minValues.push_back( std::min( firstValues[i], secondValues[i] ));
+            maxValues.push_back( std::max( firstValues[i], secondValues[i] ));
+        }
+        firstRegistry.resolve( minValues, maxValues );
+        secondRegistry.resolve( minValues, maxValues );
+    }
+
+    UpdaterFixture first;
+    UpdaterFixture second;
+};
+}
+
+BOOST_GLOBAL_FIXTURE( GlobalMPIChannel );
+
+BOOST_FIXTURE_TEST_CASE( testLatestFrameDropsOlderFrames, UpdaterFixture )
+{
+    open( PACING_LATEST_FRAME );
+    receive( 1 );
+    receive( 2 );
+    receive( 3 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+    BOOST_CHECK_EQUAL( display(), 3 );
+    BOOST_CHECK( hasStatistics( "received 3," ));
+    BOOST_CHECK( hasStatistics( "dropped 2," ));
+
+    // Nothing new to swap
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+    BOOST_CHECK( !stream->hasPendingFrame( ));
+}
+
+BOOST_FIXTURE_TEST_CASE( testInOrderSwapsEveryFrame, UpdaterFixture )
+{
+    open( PACING_IN_ORDER );
+    receive( 1 );
+    receive( 2 );
+    receive( 3 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+
+    // The next frame waits until the stream has processed the previous one
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+    BOOST_CHECK_EQUAL( display(), 1 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 2 );
+    BOOST_CHECK_EQUAL( display(), 2 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 3 );
+    BOOST_CHECK_EQUAL( display(), 3 );
+
+    BOOST_CHECK( hasStatistics( "received 3," ));
+    BOOST_CHECK( hasStatistics( "dropped 0," ));
+}
+
+BOOST_FIXTURE_TEST_CASE( testMaxFpsSkipsFramesUntilTheNextInterval,
+                         UpdaterFixture )
+{
+    open( PACING_MAX_FPS, 10 );
+    receive( 1 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+    BOOST_CHECK_EQUAL( display(), 1 );
+
+    // Less than 100 ms since the last swap
+    receive( 2 );
+    receive( 3 );
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 1 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 120 ));
+    synchronize();
+    BOOST_CHECK_EQUAL( requests, 2 );
+    BOOST_CHECK_EQUAL( display(), 3 );
+
+    BOOST_CHECK( hasStatistics( "received 3," ));
+    BOOST_CHECK( hasStatistics( "dropped 1," ));
+}
+
+BOOST_FIXTURE_TEST_CASE( testInOrderStartsAtTheSameFrameOnAllProcesses,
+                         TwoProcessesFixture )
+{
+    // Until the window is opened, each process keeps its latest frame, which
+    // depends on when the frames arrived
+    first.receive( 1 );
+    first.receive( 2 );
+    first.receive( 3 );
+    second.receive( 1 );
+    open( PACING_IN_ORDER );
+
+    // The first frame that both processes can swap is the third one
+    second.receive( 2 );
+    synchronize();
+    BOOST_CHECK_EQUAL( first.requests, 0 );
+    BOOST_CHECK_EQUAL( second.requests, 0 );
+
+    second.receive( 3 );
+    synchronize();
+    BOOST_CHECK_EQUAL( first.requests, 1 );
+    BOOST_CHECK_EQUAL( second.requests, 1 );
+    BOOST_CHECK_EQUAL( first.display(), 3 );
+    BOOST_CHECK_EQUAL( second.display(), 3 );
+
+    // Then both processes swap every frame in order, in sync
+    first.receive( 4 );
+    first.receive( 5 );
+    second.receive( 4 );
+    synchronize();
+    BOOST_CHECK_EQUAL( first.display(), 4 );
+    BOOST_CHECK_EQUAL( second.display(), 4 );
+
+    synchronize();
+    BOOST_CHECK_EQUAL( first.requests, 2 );
+    BOOST_CHECK_EQUAL( second.requests, 2 );
+
+    second.receive( 5 );
+    synchronize();
+    BOOST_CHECK_EQUAL( first.requests, 3 );
+    BOOST_CHECK_EQUAL( second.requests, 3 );
+    BOOST_CHECK_EQUAL( first.display(), 5 );
+    BOOST_CHECK_EQUAL( second.display(), 5 );
+}
@@ -0,0 +1,98 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ProfileTraceTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ProfileTrace.h"
+
+#include <sstream>
+
+namespace
+{
+ProfileEvents makeEvents( const char* name )
+{
+    Profiler profiler( 4 );
+    profiler.setFrame( 2 );
+    profiler.record( PROFILE_CATEGORY_PHASE, name, 1000, 250 );
+    return profiler.getEvents();
+}
+}
+
+BOOST_AUTO_TEST_CASE( testCollectProfiles )
+{
+    ProfileTrace trace;
+    trace.start( 2 );
+    BOOST_CHECK( !trace.isComplete( ));
+
+    trace.add( 1, makeEvents( "sync" ));
+    BOOST_CHECK( !trace.isComplete( ));
+
+    trace.add( 2, makeEvents( "render" ));
+    BOOST_CHECK( trace.isComplete( ));
+    BOOST_CHECK_EQUAL( trace.getProcessCount(), 2 );
+    BOOST_CHECK_EQUAL( trace.getEventCount(), 2 );
+
+    trace.start( 1 );
+    BOOST_CHECK_EQUAL( trace.getProcessCount(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testWriteChromeTrace )
+{
+    ProfileTrace trace;
+    trace.start( 2 );
+    trace.add( 1, makeEvents( "barrier" ));
+    trace.add( 2, makeEvents( "say \"hi\"\\" ));
+
+    std::ostringstream output;
+    trace.writeChromeTrace( output );
+    const std::string json = output.str();
+
+    BOOST_CHECK_EQUAL( json.find( "{\"displayTimeUnit\"" ), 0 );
+    BOOST_CHECK( json.find( "\"args\":{\"name\":\"rank 1\"}" ) !=
+                 std::string::npos );
+    BOOST_CHECK( json.find( "\"args\":{\"name\":\"rank 2\"}" ) !=
+                 std::string::npos );
+    BOOST_CHECK( json.find( "{\"name\":\"barrier\",\"cat\":\"phase\","
+                            "\"ph\":\"X\",\"ts\":1000,\"dur\":250,\"pid\":1,"
+                            "\"tid\":0,\"args\":{\"frame\":2}}" ) !=
+                 std::string::npos );
+    BOOST_CHECK( json.find( "\"say \\\"hi\\\"\\\\\"" ) != std::string::npos );
+    BOOST_CHECK_EQUAL( json.substr( json.size() - 3 ), "]}\n" );
+}
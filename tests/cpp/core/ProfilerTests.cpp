@@ -0,0 +1,158 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ProfilerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "Profiler.h"
+#include "SerializeBuffer.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( testCapacityIsRoundedToPowerOfTwo )
+{
+    BOOST_CHECK_EQUAL( Profiler( 1000 ).getCapacity(), 1024 );
+    BOOST_CHECK_EQUAL( Profiler( 16 ).getCapacity(), 16 );
+    BOOST_CHECK_EQUAL( Profiler( 0 ).getCapacity(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testRecordEvents )
+{
+    Profiler profiler( 16 );
+    profiler.setFrame( 3 );
+    profiler.record( PROFILE_CATEGORY_PHASE, "render", 100, 20 );
+    profiler.record( PROFILE_CATEGORY_MPI, "globalBarrier", 120, 5 );
+
+    const ProfileEvents events = profiler.getEvents();
+    BOOST_REQUIRE_EQUAL( events.size(), 2 );
+    BOOST_CHECK_EQUAL( events[0].name, "render" );
+    BOOST_CHECK_EQUAL( events[0].category, PROFILE_CATEGORY_PHASE );
+    BOOST_CHECK_EQUAL( events[0].frame, 3 );
+    BOOST_CHECK_EQUAL( events[0].start, 100 );
+    BOOST_CHECK_EQUAL( events[0].duration, 20 );
+    BOOST_CHECK_EQUAL( events[1].name, "globalBarrier" );
+    BOOST_CHECK_EQUAL( events[1].getCategoryName(), "mpi" );
+}
+
+BOOST_AUTO_TEST_CASE( testOldestEventsAreOverwritten )
+{
+    Profiler profiler( 4 );
+    for( int i = 0; i < 10; ++i )
+        profiler.record( PROFILE_CATEGORY_PHASE, "phase", i, 1 );
+
+    BOOST_CHECK_EQUAL( profiler.getRecordedCount(), 10 );
+
+    const ProfileEvents events = profiler.getEvents();
+    BOOST_REQUIRE_EQUAL( events.size(), 4 );
+    for( size_t i = 0; i < events.size(); ++i )
+        BOOST_CHECK_EQUAL( events[i].start, 6 + i );
+}
+
+BOOST_AUTO_TEST_CASE( testLongNamesAreTruncated )
+{
+    Profiler profiler( 4 );
+    const std::string name( 2 * PROFILE_NAME_SIZE, 'x' );
+    profiler.record( PROFILE_CATEGORY_CONTENT, name.c_str(), 0, 0 );
+
+    const ProfileEvents events = profiler.getEvents();
+    BOOST_REQUIRE_EQUAL( events.size(), 1 );
+    BOOST_CHECK_EQUAL( std::strlen( events[0].name ), PROFILE_NAME_SIZE - 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testProfileScope )
+{
+    Profiler profiler( 4 );
+    {
+        ProfileScope scope( PROFILE_CATEGORY_GL, "glFinish", profiler );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ));
+    }
+    const ProfileEvents events = profiler.getEvents();
+    BOOST_REQUIRE_EQUAL( events.size(), 1 );
+    BOOST_CHECK_EQUAL( events[0].name, "glFinish" );
+    BOOST_CHECK_GE( events[0].duration, 5000 );
+    BOOST_CHECK_LE( events[0].start + events[0].duration, Profiler::now( ));
+}
+
+BOOST_AUTO_TEST_CASE( testConcurrentReadsOnlyReturnCompleteEvents )
+{
+    Profiler profiler( 64 );
+    const int64_t count = 100000;
+
+    std::thread writer( [&profiler, count]()
+    {
+        for( int64_t i = 0; i < count; ++i )
+            profiler.record( PROFILE_CATEGORY_PHASE, "phase", i, i );
+    });
+
+    bool consistent = true;
+    while( profiler.getRecordedCount() < uint64_t(count) )
+    {
+        for( const ProfileEvent& event : profiler.getEvents( ))
+            consistent = consistent && event.start == event.duration &&
+                         std::strcmp( event.name, "phase" ) == 0;
+    }
+    writer.join();
+
+    BOOST_CHECK( consistent );
+    BOOST_CHECK_EQUAL( profiler.getEvents().size(), profiler.getCapacity( ));
+}
+
+BOOST_AUTO_TEST_CASE( testSerializeEvents )
+{
+    Profiler profiler( 4 );
+    profiler.setFrame( 42 );
+    profiler.record( PROFILE_CATEGORY_CONTENT, "Movie sample.mp4", 7, 3 );
+
+    const std::string& serialized =
+            SerializeBuffer::serialize( profiler.getEvents( ));
+    SerializeBuffer buffer;
+    buffer.setSize( serialized.size( ));
+    std::memcpy( buffer.data(), serialized.data(), serialized.size( ));
+
+    ProfileEvents events;
+    buffer.deserialize( events );
+    BOOST_REQUIRE_EQUAL( events.size(), 1 );
+    BOOST_CHECK_EQUAL( events[0].name, "Movie sample.mp4" );
+    BOOST_CHECK_EQUAL( events[0].category, PROFILE_CATEGORY_CONTENT );
+    BOOST_CHECK_EQUAL( events[0].frame, 42 );
+    BOOST_CHECK_EQUAL( events[0].start, 7 );
+    BOOST_CHECK_EQUAL( events[0].duration, 3 );
+}
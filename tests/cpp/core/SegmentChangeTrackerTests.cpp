@@ -0,0 +1,230 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SegmentChangeTrackerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "CopyCounter.h"
+#include "SegmentChangeTracker.h"
+
+#include <deflect/Frame.h>
+
+#include <algorithm>
+
+namespace
+{
+const QString STREAM_URI( "stream" );
+const size_t SEGMENTS_COUNT = 3;
+}
+
+deflect::FramePtr createTestFrame( const char fill = 'a' )
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = STREAM_URI;
+    for( size_t i = 0; i < SEGMENTS_COUNT; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * 64;
+        segment.parameters.width = 64;
+        segment.parameters.height = 64;
+        segment.imageData = QByteArray( 100 + 7 * i, fill + i );
+        frame->segments.push_back( segment );
+    }
+    return frame;
+}
+
+size_t countChanged( const std::vector<bool>& changed )
+{
+    return std::count( changed.begin(), changed.end(), true );
+}
+
+BOOST_AUTO_TEST_CASE( testFirstFrameIsComplete )
+{
+    SegmentChangeTracker tracker;
+    const std::vector<bool> changed = tracker.update( *createTestFrame( ));
+
+    BOOST_CHECK_EQUAL( changed.size(), SEGMENTS_COUNT );
+    BOOST_CHECK_EQUAL( countChanged( changed ), SEGMENTS_COUNT );
+    BOOST_CHECK_EQUAL( tracker.getUnchangedCount(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testDetectUnchangedSegments )
+{
+    SegmentChangeTracker tracker;
+    tracker.update( *createTestFrame( ));
+
+    deflect::FramePtr frame = createTestFrame();
+    frame->segments[1].imageData = QByteArray( 107, 'z' );
+    const std::vector<bool> changed = tracker.update( *frame );
+
+    BOOST_REQUIRE_EQUAL( changed.size(), SEGMENTS_COUNT );
+    BOOST_CHECK( !changed[0] );
+    BOOST_CHECK( changed[1] );
+    BOOST_CHECK( !changed[2] );
+    BOOST_CHECK_EQUAL( tracker.getSegmentCount(), 2 * SEGMENTS_COUNT );
+    BOOST_CHECK_EQUAL( tracker.getUnchangedCount(), 2 );
+    BOOST_CHECK_EQUAL( tracker.getUnchangedBytes(), 100 + 114 );
+}
+
+BOOST_AUTO_TEST_CASE( testLayoutChangeSendsCompleteFrame )
+{
+    SegmentChangeTracker tracker;
+    tracker.update( *createTestFrame( ));
+
+    deflect::FramePtr frame = createTestFrame();
+    frame->segments[2].parameters.y = 64;
+    BOOST_CHECK_EQUAL( countChanged( tracker.update( *frame )),
+                       SEGMENTS_COUNT );
+
+    frame->segments.pop_back();
+    BOOST_CHECK_EQUAL( countChanged( tracker.update( *frame )),
+                       SEGMENTS_COUNT - 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testPeriodicKeyframe )
+{
+    SegmentChangeTracker tracker;
+    const deflect::FramePtr frame = createTestFrame();
+    tracker.update( *frame );
+    for( size_t i = 1; i < SegmentChangeTracker::KEYFRAME_INTERVAL; ++i )
+        BOOST_CHECK_EQUAL( countChanged( tracker.update( *frame )), 0 );
+
+    BOOST_CHECK_EQUAL( countChanged( tracker.update( *frame )),
+                       SEGMENTS_COUNT );
+}
+
+BOOST_AUTO_TEST_CASE( testStreamsAreIndependent )
+{
+    SegmentChangeTracker tracker;
+    tracker.update( *createTestFrame( ));
+
+    deflect::FramePtr otherStream = createTestFrame();
+    otherStream->uri = "otherStream";
+    BOOST_CHECK_EQUAL( countChanged( tracker.update( *otherStream )),
+                       SEGMENTS_COUNT );
+
+    tracker.removeStream( STREAM_URI );
+    BOOST_CHECK_EQUAL( countChanged( tracker.update( *createTestFrame( ))),
+                       SEGMENTS_COUNT );
+}
+
+BOOST_AUTO_TEST_CASE( testRemoveUnchangedCopiesFrame )
+{
+    const deflect::FramePtr frame = createTestFrame();
+
+    std::vector<bool> changed( SEGMENTS_COUNT, true );
+    BOOST_CHECK( SegmentChangeTracker::removeUnchanged( frame, changed ) ==
+                 frame );
+    BOOST_CHECK( SegmentChangeTracker::removeUnchanged(
+                     frame, std::vector<bool>( )) == frame );
+
+    changed[0] = false;
+    const deflect::FramePtr stripped =
+            SegmentChangeTracker::removeUnchanged( frame, changed );
+    BOOST_REQUIRE( stripped != frame );
+    BOOST_CHECK( SegmentChangeTracker::isUnchanged( stripped->segments[0] ));
+    BOOST_CHECK( !SegmentChangeTracker::isUnchanged( stripped->segments[1] ));
+    BOOST_CHECK( stripped->segments[1].imageData.constData() ==
+                 frame->segments[1].imageData.constData( ));
+    BOOST_CHECK( !frame->segments[0].imageData.isEmpty( ));
+}
+
+BOOST_AUTO_TEST_CASE( testFillUnchangedFromPreviousFrame )
+{
+    const deflect::FramePtr previous = createTestFrame();
+    deflect::FramePtr frame = createTestFrame( 'x' );
+    SegmentChangeTracker::setUnchanged( frame->segments[0] );
+    SegmentChangeTracker::setUnchanged( frame->segments[2] );
+
+    BOOST_CHECK_EQUAL( SegmentChangeTracker::fillUnchanged( *frame,
+                                                            *previous ), 2 );
+    BOOST_CHECK( frame->segments[0].imageData ==
+                 previous->segments[0].imageData );
+    BOOST_CHECK( frame->segments[0].imageData.constData() !=
+                 previous->segments[0].imageData.constData( ));
+    BOOST_CHECK( frame->segments[1].imageData == QByteArray( 107, 'y' ));
+    BOOST_CHECK( frame->segments[2].imageData ==
+                 previous->segments[2].imageData );
+
+    SegmentChangeTracker::setUnchanged( frame->segments[0] );
+    frame->segments[0].parameters.compressed = true;
+    BOOST_CHECK_EQUAL( SegmentChangeTracker::fillUnchanged( *frame,
+                                                            *previous ), 0 );
+    BOOST_CHECK( frame->segments[0].imageData.isEmpty( ));
+}
+
+BOOST_AUTO_TEST_CASE( testFillUnchangedIgnoresSegmentsNotRouted )
+{
+    const deflect::FramePtr previous = createTestFrame();
+    deflect::FramePtr frame = createTestFrame( 'x' );
+    frame->segments[0].imageData = QByteArray();
+    SegmentChangeTracker::setUnchanged( frame->segments[1] );
+
+    CopyCounter::global().endFrame();
+    BOOST_CHECK_EQUAL( SegmentChangeTracker::fillUnchanged( *frame,
+                                                            *previous ), 1 );
+    CopyCounter::global().endFrame();
+
+    BOOST_CHECK( frame->segments[0].imageData.isNull( ));
+    BOOST_CHECK( frame->segments[1].imageData ==
+                 previous->segments[1].imageData );
+    BOOST_CHECK_EQUAL( CopyCounter::global().getFrameCopyCount(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testHash )
+{
+    const QByteArray data( 1000, 'a' );
+    BOOST_CHECK_EQUAL( SegmentChangeTracker::hash( data ),
+                       SegmentChangeTracker::hash( QByteArray( 1000, 'a' )));
+    BOOST_CHECK( SegmentChangeTracker::hash( data ) !=
+                 SegmentChangeTracker::hash( QByteArray( 999, 'a' )));
+
+    // A change in any byte, including in the tail, changes the hash
+    for( int i = 0; i < data.size(); i += 37 )
+    {
+        QByteArray modified( data.constData(), data.size( ));
+        modified[i] = 'b';
+        BOOST_CHECK( SegmentChangeTracker::hash( modified ) !=
+                     SegmentChangeTracker::hash( data ));
+    }
+    QByteArray modified( data.constData(), data.size( ));
+    modified[data.size() - 1] = 'b';
+    BOOST_CHECK( SegmentChangeTracker::hash( modified ) !=
+                 SegmentChangeTracker::hash( data ));
+}
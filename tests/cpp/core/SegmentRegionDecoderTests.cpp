@@ -0,0 +1,206 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SegmentRegionDecoderTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "SegmentRegionDecoder.h"
+#include "types.h" // operator<< for QRectF
+
+#include <QBuffer>
+#include <QImage>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const int SEGMENT_SIZE = 128;
+const int MCU_SIZE = 16;
+
+deflect::Segment createSegment()
+{
+    QImage image( SEGMENT_SIZE, SEGMENT_SIZE, QImage::Format_RGB32 );
+    for( int y = 0; y < SEGMENT_SIZE; ++y )
+        for( int x = 0; x < SEGMENT_SIZE; ++x )
+            image.setPixel( x, y, qRgb( 2 * x, 2 * y, ( x * y ) % 256 ));
+
+    deflect::Segment segment;
+    segment.parameters.width = SEGMENT_SIZE;
+    segment.parameters.height = SEGMENT_SIZE;
+    segment.parameters.compressed = true;
+
+    QBuffer buffer( &segment.imageData );
+    buffer.open( QIODevice::WriteOnly );
+    image.save( &buffer, "JPG", 90 );
+    return segment;
+}
+
+const char* getPixel( const DecodedRegion& decoded, const int x, const int y )
+{
+    const int i = ( y - decoded.rect.y( )) * decoded.rect.width() +
+                  x - decoded.rect.x();
+    return decoded.getData() + 4 * i;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeWholeSegment )
+{
+    const deflect::Segment segment = createSegment();
+    BOOST_REQUIRE( !segment.imageData.isEmpty( ));
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion decoded;
+    decoder.decode( segment, QRect( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE ),
+                    decoded );
+
+    BOOST_CHECK_EQUAL( decoded.rect, QRect( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE ));
+    BOOST_CHECK_EQUAL( decoded.imageData.size(),
+                       SEGMENT_SIZE * SEGMENT_SIZE * 4 );
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeRegionMatchesWholeSegment )
+{
+    const deflect::Segment segment = createSegment();
+    const QRect region( 37, 50, 20, 30 );
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion whole;
+    decoder.decode( segment, QRect( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE ),
+                    whole );
+    DecodedRegion decoded;
+    decoder.decode( segment, region, decoded );
+
+    // Less than a MCU column and row are added around the region
+    BOOST_CHECK( decoded.rect.contains( region ));
+    BOOST_CHECK_EQUAL( decoded.rect.x() % 8, 0 );
+    BOOST_CHECK_LT( decoded.rect.width(), region.width() + MCU_SIZE + 2 );
+    BOOST_CHECK_LT( decoded.rect.height(), region.height() + 4 );
+    BOOST_REQUIRE_EQUAL( decoded.imageData.size(),
+                         decoded.rect.width() * decoded.rect.height() * 4 );
+
+    for( int y = region.top(); y <= region.bottom(); ++y )
+        for( int x = region.left(); x <= region.right(); ++x )
+            BOOST_REQUIRE_EQUAL( memcmp( getPixel( decoded, x, y ),
+                                         getPixel( whole, x, y ), 4 ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeRegionIntoBuffer )
+{
+    const deflect::Segment segment = createSegment();
+    const QSize size( SEGMENT_SIZE, SEGMENT_SIZE );
+    const QRect region( 37, 50, 20, 30 );
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion expected;
+    decoder.decode( segment, region, expected );
+    BOOST_CHECK( !expected.buffered );
+
+    std::vector<char> buffer( SegmentRegionDecoder::getMaxOutputSize( size,
+                                                                      region ));
+    DecodedRegion decoded;
+    decoded.buffer = buffer.data();
+    decoded.bufferSize = buffer.size();
+    decoder.decode( segment, region, decoded );
+
+    BOOST_CHECK( decoded.buffered );
+    BOOST_CHECK( decoded.imageData.isEmpty( ));
+    BOOST_CHECK_EQUAL( decoded.getData(), buffer.data( ));
+    BOOST_REQUIRE_EQUAL( decoded.rect, expected.rect );
+    BOOST_CHECK_EQUAL( memcmp( decoded.getData(), expected.getData(),
+                               expected.imageData.size( )), 0 );
+
+    // A buffer which is too small is not used
+    decoded.bufferSize = 16;
+    decoder.decode( segment, region, decoded );
+    BOOST_CHECK( !decoded.buffered );
+    BOOST_CHECK_EQUAL( decoded.imageData, expected.imageData );
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeRegionIsClampedToSegment )
+{
+    const deflect::Segment segment = createSegment();
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion decoded;
+    decoder.decode( segment, QRect( 100, 100, 200, 200 ), decoded );
+    BOOST_CHECK( QRect( 0, 0, SEGMENT_SIZE, SEGMENT_SIZE ).contains(
+                     decoded.rect ));
+    BOOST_CHECK_EQUAL( decoded.rect.bottom(), SEGMENT_SIZE - 1 );
+
+    decoder.decode( segment, QRect( 200, 200, 10, 10 ), decoded );
+    BOOST_CHECK( decoded.rect.isEmpty( ));
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeInvalidSegmentThrows )
+{
+    deflect::Segment segment;
+    segment.parameters.width = SEGMENT_SIZE;
+    segment.parameters.height = SEGMENT_SIZE;
+    segment.imageData = QByteArray( 256, 'x' );
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion decoded;
+    BOOST_CHECK_THROW( decoder.decode( segment, QRect( 0, 0, 8, 8 ), decoded ),
+                       std::runtime_error );
+    BOOST_CHECK( decoded.rect.isEmpty( ));
+
+    // The decoder can be used again after an error
+    decoder.decode( createSegment(), QRect( 0, 0, 8, 8 ), decoded );
+    BOOST_CHECK( decoded.rect.contains( QRect( 0, 0, 8, 8 )));
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeTruncatedSegmentThrows )
+{
+    deflect::Segment segment = createSegment();
+    const QByteArray imageData = segment.imageData;
+    segment.imageData = QByteArray( imageData.constData(),
+                                    imageData.size() / 2 );
+
+    SegmentRegionDecoder decoder;
+    DecodedRegion decoded;
+    BOOST_CHECK_THROW( decoder.decode( segment, QRect( 0, 0, SEGMENT_SIZE,
+                                                       SEGMENT_SIZE ),
+                                       decoded ), std::runtime_error );
+    BOOST_CHECK( decoded.rect.isEmpty( ));
+
+    // The rows above the truncation can still be decoded
+    decoder.decode( segment, QRect( 0, 0, SEGMENT_SIZE, 8 ), decoded );
+    BOOST_CHECK( decoded.rect.contains( QRect( 0, 0, SEGMENT_SIZE, 8 )));
+}
@@ -0,0 +1,109 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#define BOOST_TEST_MODULE SerializeBufferPoolTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "SerializeBufferPool.h"
+#include "SerializeBuffer.h"
+
+#include <boost/serialization/vector.hpp>
+
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( testReleasedBuffersAreReused )
+{
+    SerializeBufferPool pool( 2 );
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 0u );
+
+    SerializeBuffer* storage = 0;
+    {
+        SerializeBufferPtr buffer = pool.acquire();
+        buffer->write( std::vector<char>( 1000, 'a' ));
+        storage = buffer.get();
+    }
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 1u );
+
+    SerializeBufferPtr buffer = pool.acquire();
+    BOOST_CHECK_EQUAL( buffer.get(), storage );
+    BOOST_CHECK_GE( buffer->capacity(), 1000u );
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 0u );
+    BOOST_CHECK_EQUAL( pool.getAllocatedCount(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testPoolKeepsAtMostMaxIdleBuffers )
+{
+    SerializeBufferPool pool( 2 );
+    {
+        std::vector<SerializeBufferPtr> buffers;
+        for( size_t i = 0; i < 5; ++i )
+            buffers.push_back( pool.acquire( ));
+        BOOST_CHECK_EQUAL( pool.getAllocatedCount(), 5u );
+    }
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 2u );
+}
+
+BOOST_AUTO_TEST_CASE( testBuffersCanBeReleasedInAnotherThread )
+{
+    SerializeBufferPool pool( 1 );
+
+    SerializeBufferPtr buffer = pool.acquire();
+    buffer->write( 42 );
+
+    std::thread thread( [&buffer]()
+    {
+        int value = 0;
+        buffer->deserialize( value );
+        BOOST_CHECK_EQUAL( value, 42 );
+        buffer.reset();
+    });
+    thread.join();
+
+    BOOST_CHECK_EQUAL( pool.getIdleCount(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testBuffersCanOutliveThePool )
+{
+    SerializeBufferPtr buffer;
+    {
+        SerializeBufferPool pool( 1 );
+        buffer = pool.acquire();
+    }
+    buffer->write( 42 );
+    buffer.reset();
+}
@@ -44,6 +44,9 @@ namespace ut = boost::unit_test;
 
 #include "SerializeBuffer.h"
 
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
 
 BOOST_AUTO_TEST_CASE( testSerializeBufferConstruction )
 {
@@ -103,3 +106,70 @@ BOOST_AUTO_TEST_CASE( testSerializeMultipleData )
     BOOST_CHECK_EQUAL( dataBool, newDataBool );
     BOOST_CHECK_EQUAL( dataFloat, newDataFloat );
 }
+
+BOOST_AUTO_TEST_CASE( testWriteMatchesSerialize )
+{
+    const std::string data( "hello world" );
+
+    SerializeBuffer buffer;
+    buffer.write( data );
+
+    const std::string& serialized = SerializeBuffer::serialize( data );
+    BOOST_REQUIRE_EQUAL( buffer.size(), serialized.size( ));
+    BOOST_CHECK( std::equal( serialized.begin(), serialized.end(),
+                             buffer.data( )));
+}
+
+BOOST_AUTO_TEST_CASE( testWriteAndDeserializeInPlace )
+{
+    std::vector<int> data( 1000 );
+    for( size_t i = 0; i < data.size(); ++i )
+        data[i] = i;
+
+    SerializeBuffer buffer;
+    buffer.write( data );
+
+    std::vector<int> newData;
+    buffer.deserialize( newData );
+    BOOST_CHECK_EQUAL_COLLECTIONS( data.begin(), data.end(),
+                                   newData.begin(), newData.end( ));
+}
+
+BOOST_AUTO_TEST_CASE( testWriteReusesStorage )
+{
+    const std::vector<char> bigData( 1000000, 'a' );
+    const std::vector<char> smallData( 10, 'b' );
+
+    SerializeBuffer buffer;
+    buffer.write( bigData );
+    const size_t bigSize = buffer.size();
+    const size_t capacity = buffer.capacity();
+    const char* storage = buffer.data();
+    BOOST_CHECK_GE( capacity, bigSize );
+
+    buffer.write( smallData );
+    BOOST_CHECK_LT( buffer.size(), bigSize );
+
+    buffer.write( bigData );
+    BOOST_CHECK_EQUAL( buffer.size(), bigSize );
+    BOOST_CHECK_EQUAL( buffer.capacity(), capacity );
+    BOOST_CHECK( buffer.data() == storage );
+
+    std::vector<char> newData;
+    buffer.deserialize( newData );
+    BOOST_CHECK( newData == bigData );
+}
+
+BOOST_AUTO_TEST_CASE( testDeserializeOnlyReadsSize )
+{
+    SerializeBuffer buffer;
+    buffer.write( std::string( 1000, 'x' ));
+    buffer.write( std::string( "short" ));
+
+    // The end of the previous, longer message is still in the storage
+    BOOST_CHECK_GT( buffer.capacity(), buffer.size( ));
+
+    std::string newData;
+    buffer.deserialize( newData );
+    BOOST_CHECK_EQUAL( newData, "short" );
+}
@@ -159,3 +159,35 @@ BOOST_AUTO_TEST_CASE( testUpdateAndSyncAlwaysWithCallback )
     BOOST_REQUIRE( syncObject.sync( boost::bind( &alwaysSync, _1 )));
     BOOST_CHECK_EQUAL( *result.getResult(), *ptr );
 }
+
+BOOST_AUTO_TEST_CASE( testVersionIncrementsOnUpdate )
+{
+    typedef boost::shared_ptr< int > IntPtr;
+
+    SwapSyncObject< IntPtr > syncObject;
+    BOOST_CHECK_EQUAL( syncObject.getVersion(), 0 );
+
+    syncObject.update( IntPtr( new int( 1 )));
+    syncObject.update( IntPtr( new int( 2 )));
+    BOOST_CHECK_EQUAL( syncObject.getVersion(), 2 );
+
+    BOOST_CHECK( syncObject.sync( boost::bind( &alwaysSync, _1 )));
+    BOOST_CHECK_EQUAL( syncObject.getVersion(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( testTrySwap )
+{
+    typedef boost::shared_ptr< int > IntPtr;
+    IntPtr ptr( new int( 5 ));
+
+    SwapSyncObject< IntPtr > syncObject;
+    syncObject.update( ptr );
+
+    BOOST_CHECK( !syncObject.trySwap( false ));
+    BOOST_CHECK_EQUAL( syncObject.get(), IntPtr( ));
+
+    BOOST_CHECK( syncObject.trySwap( true ));
+    BOOST_CHECK_EQUAL( syncObject.get(), ptr );
+
+    BOOST_CHECK( !syncObject.trySwap( true ));
+}
@@ -0,0 +1,221 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SwapSyncRegistryTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "SwapSyncRegistry.h"
+
+#include "MPIChannel.h"
+#include "WallToWallChannel.h"
+
+#include <boost/make_shared.hpp>
+
+#include <limits>
+
+namespace
+{
+// A single MPI context for all the tests, MPI can only be initialized once.
+struct GlobalMPIChannel
+{
+    GlobalMPIChannel()
+    {
+        ut::master_test_suite_t& testSuite = ut::framework::master_test_suite();
+        channel = boost::make_shared<MPIChannel>( testSuite.argc,
+                                                  testSuite.argv );
+    }
+    static MPIChannelPtr channel;
+};
+MPIChannelPtr GlobalMPIChannel::channel;
+
+struct ResolveResult
+{
+    ResolveResult() : called( false ), inSync( false ) {}
+
+    void resolve( const bool value )
+    {
+        called = true;
+        inSync = value;
+    }
+
+    bool called;
+    bool inSync;
+};
+
+struct ValueResult
+{
+    ValueResult() : minValue( 0 ), maxValue( 0 ) {}
+
+    void resolve( const uint64_t min, const uint64_t max )
+    {
+        minValue = min;
+        maxValue = max;
+    }
+
+    uint64_t minValue;
+    uint64_t maxValue;
+};
+}
+
+BOOST_GLOBAL_FIXTURE( GlobalMPIChannel );
+
+BOOST_AUTO_TEST_CASE( testRegistryResolvesAllObjectsInOneCollective )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    SwapSyncRegistry registry;
+
+    SwapSyncObject<int> first( 0 );
+    SwapSyncObject<int> second( 0 );
+    first.update( 1 );
+    second.update( 2 );
+
+    ResolveResult result;
+    registry.add( first );
+    registry.add( second );
+    registry.add( 42, boost::bind( &ResolveResult::resolve, &result, _1 ));
+    BOOST_CHECK_EQUAL( registry.getPendingCount(), 3 );
+
+    registry.synchronize( wallChannel );
+    registry.endFrame();
+
+    BOOST_CHECK_EQUAL( registry.getPendingCount(), 0 );
+    BOOST_CHECK_EQUAL( registry.getLastObjectCount(), 3 );
+    BOOST_CHECK_EQUAL( registry.getLastCollectiveCount(), 1 );
+    BOOST_CHECK_EQUAL( first.get(), 1 );
+    BOOST_CHECK_EQUAL( second.get(), 2 );
+    BOOST_CHECK( result.called );
+    BOOST_CHECK( result.inSync );
+}
+
+BOOST_AUTO_TEST_CASE( testRegistryResolvesValuesWithMinAndMax )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    SwapSyncRegistry registry;
+
+    ValueResult result;
+    registry.addValue( 7, boost::bind( &ValueResult::resolve, &result,
+                                       _1, _2 ));
+    registry.synchronize( wallChannel );
+
+    BOOST_CHECK_EQUAL( result.minValue, 7 );
+    BOOST_CHECK_EQUAL( result.maxValue, 7 );
+}
+
+BOOST_AUTO_TEST_CASE( testFrameStatisticsAccumulateAllCollectives )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    SwapSyncRegistry registry;
+
+    ValueResult result;
+    registry.addValue( 1, boost::bind( &ValueResult::resolve, &result,
+                                       _1, _2 ));
+    registry.synchronize( wallChannel );
+    registry.addValue( 2, boost::bind( &ValueResult::resolve, &result,
+                                       _1, _2 ));
+    registry.addValue( 3, boost::bind( &ValueResult::resolve, &result,
+                                       _1, _2 ));
+    registry.synchronize( wallChannel );
+
+    // An empty registry does not use a collective
+    registry.synchronize( wallChannel );
+    registry.endFrame();
+
+    BOOST_CHECK_EQUAL( registry.getLastObjectCount(), 3 );
+    BOOST_CHECK_EQUAL( registry.getLastCollectiveCount(), 2 );
+    BOOST_CHECK_EQUAL( result.maxValue, 3 );
+
+    registry.endFrame();
+    BOOST_CHECK_EQUAL( registry.getLastObjectCount(), 0 );
+    BOOST_CHECK_EQUAL( registry.getLastCollectiveCount(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testClockIsSynchronizedInTheRegistry )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    SwapSyncRegistry registry;
+
+    const boost::posix_time::ptime before =
+            boost::posix_time::microsec_clock::universal_time();
+
+    wallChannel.synchronizeClock( registry );
+    BOOST_CHECK_EQUAL( registry.getPendingCount(), 1 );
+    registry.synchronize( wallChannel );
+
+    const boost::posix_time::ptime after =
+            boost::posix_time::microsec_clock::universal_time();
+
+    BOOST_CHECK( wallChannel.getTime() >= before );
+    BOOST_CHECK( wallChannel.getTime() <= after );
+}
+
+BOOST_AUTO_TEST_CASE( testVersionsAreInSyncOnSingleProcess )
+{
+    WallToWallChannel wallChannel( GlobalMPIChannel::channel );
+    SwapSyncRegistry registry;
+
+    std::vector<uint64_t> versions;
+    versions.push_back( 0 );
+    versions.push_back( 17 );
+    versions.push_back( std::numeric_limits<uint64_t>::max( ));
+
+    std::vector<ResolveResult> results( versions.size( ));
+    for( size_t i = 0; i < versions.size(); ++i )
+        registry.add( versions[i], boost::bind( &ResolveResult::resolve,
+                                                &results[i], _1 ));
+    registry.synchronize( wallChannel );
+
+    for( size_t i = 0; i < results.size(); ++i )
+    {
+        BOOST_CHECK( results[i].called );
+        BOOST_CHECK( results[i].inSync );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testChannelCountsBytesOfCollectives )
+{
+    MPIChannel& channel = *GlobalMPIChannel::channel;
+    const uint64_t sent = channel.getSentBytes();
+    const uint64_t received = channel.getReceivedBytes();
+
+    channel.globalMax( std::vector<uint64_t>( 3, 1 ));
+
+    BOOST_CHECK_EQUAL( channel.getSentBytes() - sent, 3 * sizeof(uint64_t));
+    BOOST_CHECK_EQUAL( channel.getReceivedBytes() - received,
+                       3 * sizeof(uint64_t));
+}
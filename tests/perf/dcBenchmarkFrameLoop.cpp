@@ -0,0 +1,610 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimer>
+
+#include <deflect/Frame.h>
+
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+#include "DisplayGroupDelta.h"
+#include "FramePhaseTimer.h"
+#include "MasterFromWallChannel.h"
+#include "MasterToWallChannel.h"
+#include "MPIChannel.h"
+#include "PixelStream.h"
+#include "PixelStreamContent.h"
+#include "PixelStreamUpdater.h"
+#include "SceneSynchronizer.h"
+#include "TextureContent.h"
+#include "WallFromMasterChannel.h"
+#include "WallToMasterChannel.h"
+#include "WallToWallChannel.h"
+
+#define KILOBYTE 1000
+
+// Example ways to run this program:
+// mpirun -n 5 ./dcBenchmarkFrameLoop
+// mpirun -n 9 ./dcBenchmarkFrameLoop --windows 20 --streams 4 --duration 30
+// mpirun -n 5 ./dcBenchmarkFrameLoop --streams 1 --streamwidth 7680
+//                                    --streamheight 4320 --compression 1
+//
+// Runs the frame loop of DisplayCluster headless, with one master process
+// (rank 0) and N-1 wall processes. The master moves windows of a synthetic
+// DisplayGroup at --updaterate and serves synthetic pixel stream frames as
+// fast as the wall processes request them. The wall processes synchronize
+// them with the SceneSynchronizer of the RenderController, without rendering.
+//
+// Each process reports its frame rate, the percentiles of each phase of the
+// frame loop and the number of bytes it sent and received over MPI.
+
+namespace
+{
+const QSizeF WALL_SIZE( 7680, 4320 );
+const QString STREAM_URI( "benchmark_stream_%1" );
+const QString TEXTURE_URI( "benchmark_texture_%1.png" );
+const int RANK0 = 0;
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "duration", po::value<int>()->default_value( 10 ),
+              "duration of the benchmark [s]" )
+            ( "windows", po::value<int>()->default_value( 10 ),
+              "number of static (texture) windows in the DisplayGroup" )
+            ( "streams", po::value<int>()->default_value( 2 ),
+              "number of pixel stream windows in the DisplayGroup" )
+            ( "moves", po::value<int>()->default_value( 1 ),
+              "number of windows moved by each DisplayGroup update" )
+            ( "updaterate", po::value<int>()->default_value( 60 ),
+              "rate of the DisplayGroup updates [Hz], 0 to disable" )
+            ( "streamwidth", po::value<int>()->default_value( 3840 ),
+              "width of the streams [pixels]" )
+            ( "streamheight", po::value<int>()->default_value( 2160 ),
+              "height of the streams [pixels]" )
+            ( "segmentsize", po::value<int>()->default_value( 512 ),
+              "nominal size of the stream segments [pixels]" )
+            ( "compression", po::value<int>()->default_value( 10 ),
+              "compression ratio of the segments (1: uncompressed)" )
+            ( "rendertime", po::value<int>()->default_value( 0 ),
+              "simulated rendering time of the wall processes [us]" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+deflect::FramePtr createFrame( const BenchmarkOptions& options,
+                               const QString& uri )
+{
+    deflect::FramePtr frame = boost::make_shared<deflect::Frame>();
+    frame->uri = uri;
+
+    const int width = options.get( "streamwidth" );
+    const int height = options.get( "streamheight" );
+    const int segmentSize = options.get( "segmentsize" );
+    const int compression = std::max( options.get( "compression" ), 1 );
+
+    for( int y = 0; y < height; y += segmentSize )
+    {
+        for( int x = 0; x < width; x += segmentSize )
+        {
+            deflect::Segment segment;
+            segment.parameters.x = x;
+            segment.parameters.y = y;
+            segment.parameters.width = std::min( segmentSize, width - x );
+            segment.parameters.height = std::min( segmentSize, height - y );
+            segment.parameters.compressed = compression > 1;
+
+            const int imageSize = segment.parameters.width *
+                                  segment.parameters.height * 4 / compression;
+            segment.imageData = QByteArray( imageSize, 'x' );
+            frame->segments.push_back( segment );
+        }
+    }
+    return frame;
+}
+
+ContentWindowPtr createWindow( ContentPtr content, const int index )
+{
+    ContentWindowPtr window = boost::make_shared<ContentWindow>( content );
+    window->setCoordinates( QRectF( 100 + ( index % 8 ) * 800,
+                                    100 + ( index / 8 % 4 ) * 800,
+                                    1280, 720 ));
+    return window;
+}
+
+std::string toKB( const uint64_t bytes )
+{
+    std::ostringstream os;
+    os << std::fixed << std::setprecision( 1 ) << (double)bytes / KILOBYTE;
+    return os.str();
+}
+
+int64_t percentile( std::vector<int64_t> values, const int percent )
+{
+    if( values.empty( ))
+        return 0;
+    const size_t index = ( values.size() - 1 ) * percent / 100;
+    std::nth_element( values.begin(), values.begin() + index, values.end( ));
+    return values[index];
+}
+
+/** Print the output of each process in turn, in rank order. */
+template< typename F >
+void printInRankOrder( MPIChannel& worldChannel, const F& print )
+{
+    for( int rank = 0; rank < worldChannel.getSize(); ++rank )
+    {
+        if( rank == worldChannel.getRank( ))
+        {
+            print();
+            std::cout << std::flush;
+        }
+        worldChannel.globalBarrier();
+    }
+}
+
+/**
+ * Master process: send the DisplayGroup updates and the stream frames.
+ */
+void runMaster( const BenchmarkOptions& options, MPIChannelPtr worldChannel )
+{
+    MasterToWallChannel toWallChannel( worldChannel );
+    MasterFromWallChannel fromWallChannel( worldChannel );
+    QThread sendThread;
+    QThread receiveThread;
+    toWallChannel.moveToThread( &sendThread );
+    fromWallChannel.moveToThread( &receiveThread );
+
+    DisplayGroupPtr displayGroup = boost::make_shared<DisplayGroup>(
+                                       WALL_SIZE );
+    std::map<QString, deflect::FramePtr> frames;
+
+    int index = 0;
+    for( int i = 0; i < options.get( "windows" ); ++i )
+    {
+        ContentPtr content( new TextureContent( TEXTURE_URI.arg( i )));
+        displayGroup->addContentWindow( createWindow( content, index++ ));
+    }
+    for( int i = 0; i < options.get( "streams" ); ++i )
+    {
+        const QString uri = STREAM_URI.arg( i );
+        ContentPtr content( new PixelStreamContent( uri ));
+        displayGroup->addContentWindow( createWindow( content, index++ ));
+        frames[uri] = createFrame( options, uri );
+    }
+
+    // Serve a new frame as soon as a stream requests it, like a streamer
+    // which is never the bottleneck.
+    size_t framesSent = 0;
+    QObject::connect( &fromWallChannel,
+                      &MasterFromWallChannel::receivedRequestFrame,
+                      &toWallChannel, [&]( const QString uri )
+    {
+        toWallChannel.send( frames.at( uri ));
+        ++framesSent;
+    });
+
+    QObject::connect( &receiveThread, &QThread::started,
+                      &fromWallChannel,
+                      &MasterFromWallChannel::processMessages );
+    sendThread.start();
+    receiveThread.start();
+
+    toWallChannel.sendAsync( displayGroup );
+    for( const auto& frame : frames )
+        QMetaObject::invokeMethod( &toWallChannel, "send",
+                                   Qt::QueuedConnection,
+                                   Q_ARG( deflect::FramePtr, frame.second ));
+
+    size_t updatesSent = 1;
+    size_t nextWindow = 0;
+    QTimer updateTimer;
+    QObject::connect( &updateTimer, &QTimer::timeout, [&]()
+    {
+        const ContentWindowPtrs& windows = displayGroup->getContentWindows();
+        for( int i = 0; i < options.get( "moves" ) && !windows.empty(); ++i )
+        {
+            ContentWindow& window = *windows[nextWindow++ % windows.size()];
+            const QRectF& coord = window.getCoordinates();
+            const qreal offset = ( updatesSent / 100 ) % 2 ? -4.0 : 4.0;
+            window.setCoordinates( coord.translated( offset, 0.0 ));
+        }
+        toWallChannel.sendAsync( displayGroup );
+        ++updatesSent;
+    });
+    if( options.get( "updaterate" ) > 0 )
+        updateTimer.start( 1000 / options.get( "updaterate" ));
+
+    QTimer::singleShot( options.get( "duration" ) * 1000,
+                        QCoreApplication::instance(), SLOT( quit( )));
+    QCoreApplication::exec();
+    updateTimer.stop();
+
+    // Broadcasts must be issued from the send thread, in order
+    QMetaObject::invokeMethod( &toWallChannel, "sendQuit",
+                               Qt::BlockingQueuedConnection );
+    sendThread.quit();
+    sendThread.wait();
+
+    // Returns when the first wall process has acknowledged the quit message
+    receiveThread.quit();
+    receiveThread.wait();
+
+    const size_t segmentsCount =
+            frames.empty() ? 0 : frames.begin()->second->segments.size();
+    printInRankOrder( *worldChannel, [&]()
+    {
+        std::cout << "Master: " << options.get( "windows" ) << " windows, "
+                  << frames.size() << " streams of " << segmentsCount
+                  << " segments" << std::endl;
+        std::cout << "  DisplayGroup updates sent: " << updatesSent
+                  << ", stream frames sent: " << framesSent << std::endl;
+        std::cout << "  MPI [kB]: sent " << toKB( worldChannel->getSentBytes())
+                  << ", received " << toKB( worldChannel->getReceivedBytes())
+                  << std::endl;
+    });
+}
+
+/**
+ * Headless wall process: the scene objects are synchronized by the same
+ * SceneSynchronizer as the RenderController, but nothing is rendered.
+ */
+class WallFrameLoop
+{
+public:
+    WallFrameLoop( const BenchmarkOptions& options,
+                   MPIChannelPtr worldChannel, MPIChannelPtr wallMPIChannel )
+        : _options( options )
+        , _worldChannel( worldChannel )
+        , _wallMPIChannel( wallMPIChannel )
+        , _wallChannel( wallMPIChannel )
+        , _fromMasterChannel( worldChannel )
+        , _toMasterChannel( worldChannel )
+        , _displayGroup( boost::make_shared<DisplayGroup>( WALL_SIZE ))
+        , _framesSwapped( 0 )
+        , _elapsed( 0 )
+    {
+        _fromMasterChannel.moveToThread( &_receiveThread );
+        _toMasterChannel.moveToThread( &_sendThread );
+
+        _sceneSynchronizer.setDisplayGroupCallback(
+                    boost::bind( &WallFrameLoop::_applyDisplayGroupDelta,
+                                 this, _1 ));
+
+        // Queued to the main thread, which processes the events between frames
+        QCoreApplication* app = QCoreApplication::instance();
+        PixelStreamUpdater& pixelStreamUpdater =
+                _sceneSynchronizer.getPixelStreamUpdater();
+        QObject::connect( &_fromMasterChannel,
+                          &WallFromMasterChannel::receivedQuit,
+                          app, [this]() { _sceneSynchronizer.updateQuit(); } );
+        QObject::connect( &_fromMasterChannel,
+                          static_cast<void (WallFromMasterChannel::*)
+                          ( DisplayGroupDeltaPtr )>(
+                              &WallFromMasterChannel::received ),
+                          app, [this]( DisplayGroupDeltaPtr delta )
+        {
+            _sceneSynchronizer.updateDisplayGroup( delta );
+        });
+        QObject::connect( &_fromMasterChannel,
+                          static_cast<void (WallFromMasterChannel::*)
+                          ( deflect::FramePtr )>(
+                              &WallFromMasterChannel::received ),
+                          &pixelStreamUpdater,
+                          &PixelStreamUpdater::updatePixelStream );
+
+        // Only one process requests the next frame, like the WallApplication
+        QObject::connect( &pixelStreamUpdater,
+                          &PixelStreamUpdater::requestFrame,
+                          [this]( const QString uri )
+        {
+            ++_framesSwapped;
+            if( _wallMPIChannel->getRank() == 0 )
+                QMetaObject::invokeMethod( &_toMasterChannel,
+                                           "sendRequestFrame",
+                                           Qt::QueuedConnection,
+                                           Q_ARG( QString, uri ));
+        });
+
+        QObject::connect( &_receiveThread, &QThread::started,
+                          &_fromMasterChannel,
+                          &WallFromMasterChannel::processMessages );
+        _receiveThread.start();
+        _sendThread.start();
+    }
+
+    ~WallFrameLoop()
+    {
+        _receiveThread.quit();
+        _receiveThread.wait();
+        _sendThread.quit();
+        _sendThread.wait();
+    }
+
+    void run()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while( !_sceneSynchronizer.quitRendering( ))
+        {
+            QCoreApplication::processEvents();
+            _renderFrame();
+        }
+        _elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start ).count();
+
+        // Only one process acknowledges, like the requests for frames
+        if( _wallMPIChannel->getRank() == 0 )
+            QMetaObject::invokeMethod( &_toMasterChannel, "sendQuit",
+                                       Qt::BlockingQueuedConnection );
+    }
+
+    void printResults() const
+    {
+        const uint64_t frames = _frameTimer.getFrameCount();
+        const double seconds = _elapsed / 1000000.0;
+
+        std::cout << "Rank " << _worldChannel->getRank() << ": " << frames
+                  << " frames in " << std::setprecision( 3 ) << seconds
+                  << " s, " << frames / std::max( seconds, 1e-6 )
+                  << " fps, stream frames swapped: " << _framesSwapped
+                  << std::endl;
+
+        std::cout << "  phase [us]\tp50\tp90\tp99\tmax" << std::endl;
+        for( int i = 0; i <= FramePhaseTimer::PHASE_COUNT; ++i )
+        {
+            const std::vector<int64_t>& values = _durations[i];
+            const char* name = i == FramePhaseTimer::PHASE_COUNT ? "frame" :
+                           FramePhaseTimer::getName( FramePhaseTimer::Phase(i));
+            std::cout << "  " << name << "\t\t" << percentile( values, 50 )
+                      << "\t" << percentile( values, 90 ) << "\t"
+                      << percentile( values, 99 ) << "\t"
+                      << percentile( values, 100 ) << std::endl;
+        }
+
+        const uint64_t sent = _worldChannel->getSentBytes() +
+                              _wallMPIChannel->getSentBytes();
+        const uint64_t received = _worldChannel->getReceivedBytes() +
+                                  _wallMPIChannel->getReceivedBytes();
+        std::cout << "  MPI [kB]: sent " << toKB( sent ) << ", received "
+                  << toKB( received ) << " (wall-to-wall: sent "
+                  << toKB( _wallMPIChannel->getSentBytes( )) << ", received "
+                  << toKB( _wallMPIChannel->getReceivedBytes( )) << ")"
+                  << std::endl;
+        std::cout << "  MPI per frame [kB]: received "
+                  << toKB( received / std::max( frames, uint64_t(1) ))
+                  << std::endl;
+    }
+
+private:
+    const BenchmarkOptions& _options;
+    MPIChannelPtr _worldChannel;
+    MPIChannelPtr _wallMPIChannel;
+    WallToWallChannel _wallChannel;
+    WallFromMasterChannel _fromMasterChannel;
+    WallToMasterChannel _toMasterChannel;
+    QThread _receiveThread;
+    QThread _sendThread;
+
+    DisplayGroupPtr _displayGroup;
+    SceneSynchronizer _sceneSynchronizer;
+    std::map<QString, PixelStreamPtr> _streams;
+
+    FramePhaseTimer _frameTimer;
+    std::vector<int64_t> _durations[FramePhaseTimer::PHASE_COUNT + 1];
+    size_t _framesSwapped;
+    int64_t _elapsed;
+
+    void _renderFrame()
+    {
+        _frameTimer.startFrame();
+
+        _sceneSynchronizer.synchronizeObjects( _wallChannel );
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_SYNC );
+
+        // The decoding status of each PixelStream, as in
+        // RenderController::preRenderUpdate(). The windows have no visible
+        // area, so nothing is decoded.
+        SwapSyncRegistry& registry = _sceneSynchronizer.getSyncRegistry();
+        for( auto& stream : _streams )
+        {
+            WallContent& content = *stream.second;
+            content.preRenderSync( _wallChannel, registry );
+        }
+        registry.synchronize( _wallChannel );
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_CONTENT );
+
+        if( _options.get( "rendertime" ) > 0 )
+            std::this_thread::sleep_for( std::chrono::microseconds(
+                                             _options.get( "rendertime" )));
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_RENDER );
+
+        _wallChannel.globalBarrier();
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_BARRIER );
+
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_SWAP );
+
+        registry.endFrame();
+        _frameTimer.endPhase( FramePhaseTimer::PHASE_POST );
+
+        _frameTimer.endFrame();
+        for( int i = 0; i < FramePhaseTimer::PHASE_COUNT; ++i )
+            _durations[i].push_back( _frameTimer.getLastDuration(
+                                         FramePhaseTimer::Phase( i )));
+        _durations[FramePhaseTimer::PHASE_COUNT].push_back(
+                    _frameTimer.getLastFrameDuration( ));
+    }
+
+    void _applyDisplayGroupDelta( const DisplayGroupDelta& delta )
+    {
+        delta.apply( *_displayGroup );
+
+        // Open and close the streams like the windows of the
+        // DisplayGroupRenderer
+        PixelStreamUpdater& pixelStreamUpdater =
+                _sceneSynchronizer.getPixelStreamUpdater();
+        std::map<QString, PixelStreamPtr> streams;
+        for( ContentWindowPtr window : _displayGroup->getContentWindows( ))
+        {
+            if( window->getContent()->getType() != CONTENT_TYPE_PIXEL_STREAM )
+                continue;
+
+            ContentPtr content = window->getContent();
+            const PixelStreamContent& streamContent =
+                    static_cast<const PixelStreamContent&>( *content );
+            const QString& uri = content->getURI();
+            if( _streams.count( uri ))
+                streams[uri] = _streams[uri];
+            else
+            {
+                streams[uri] = boost::make_shared<PixelStream>( uri );
+                pixelStreamUpdater.addPixelStream( uri, streams[uri],
+                                                   streamContent.getPacing( ));
+            }
+        }
+        for( const auto& stream : _streams )
+        {
+            if( !streams.count( stream.first ))
+                pixelStreamUpdater.removePixelStream( stream.first );
+        }
+        _streams.swap( streams );
+    }
+};
+}
+
+/**
+ * Measure the frame rate and the MPI traffic of the wall processes for a
+ * synthetic DisplayGroup and synthetic pixel streams.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    MPIChannelPtr worldChannel( new MPIChannel( argc, argv ));
+    const int rank = worldChannel->getRank();
+    if( worldChannel->getSize() < 2 )
+    {
+        std::cerr << "Requires at least 2 processes: "
+                  << "mpirun -n N ./dcBenchmarkFrameLoop" << std::endl;
+        return -1;
+    }
+    if( !worldChannel->isThreadSafe( ))
+    {
+        std::cerr << "MPI implementation must support MPI_THREAD_MULTIPLE"
+                  << std::endl;
+        return -1;
+    }
+    MPIChannelPtr wallChannel( new MPIChannel( *worldChannel, rank > 0,
+                                               rank ));
+
+    QCoreApplication app( argc, argv );
+    qRegisterMetaType< deflect::FramePtr >( "deflect::FramePtr" );
+
+    if( rank == RANK0 )
+        runMaster( options, worldChannel );
+    else
+    {
+        WallFrameLoop wall( options, worldChannel, wallChannel );
+        wall.run();
+        printInRankOrder( *worldChannel, [&]() { wall.printResults(); } );
+    }
+    return 0;
+}
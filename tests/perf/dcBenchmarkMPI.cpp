@@ -40,13 +40,16 @@
 #include <string>
 #include <iostream>
 
+#include <boost/make_shared.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/program_options.hpp>
 
 #include "MPIChannel.h"
+#include "MPINospin.h"
 #include "SerializeBuffer.h"
 
+#define KILOBYTE 1000
 #define MEGABYTE 1000000
 #define MICROSEC 1000000
 
@@ -56,9 +59,17 @@
 // mpirun -n 6 -H localhost ./dcBenchmarkMPI --datasize 60 --packets 100
 //
 //Object size [Mbytes]: 60
+//Mode: blocking
 //Time to send 100 objects: 3.445
 //Time per object: 0.03445
 //Throughput [Mbytes/sec]: 1741.66
+//Latency [ms]: 35.1
+//
+// Without --datasize, payloads from 1 KB to 100 MB are benchmarked in turn.
+// --mode selects the blocking broadcast (header loop + MPI_Bcast), the
+// nonblocking broadcast (MPI_Ibcast pipeline) or both.
+// --waitmode, --spintime and --maxsleep select the MPI wait policy, whose
+// wait-time histograms are printed for the first receiving process.
 
 namespace
 {
@@ -78,7 +89,7 @@ public:
     float elapsed()
     {
         const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
-        return (float)(now - lastTime_).total_milliseconds();
+        return (float)(now - lastTime_).total_microseconds() / 1000.f;
     }
 private:
     boost::posix_time::ptime lastTime_;
@@ -92,6 +103,7 @@ struct BenchmarkOptions
         , getHelp_(true)
         , dataSize_(0)
         , packetsCount_(0)
+        , pending_(2)
     {
         initDesc();
         parseCommandLineArguments(argc, argv);
@@ -107,9 +119,19 @@ struct BenchmarkOptions
         desc_.add_options()
             ("help", "produce help message")
             ("datasize", boost::program_options::value<float>()->default_value(0),
-                     "Size of each data packet [MB]")
+                     "Size of each data packet [MB], 0 for 1 KB to 100 MB")
             ("packets", boost::program_options::value<unsigned int>()->default_value(0),
                      "number of packets to transmitt")
+            ("mode", boost::program_options::value<std::string>()->default_value("both"),
+                     "broadcast mode: blocking, nonblocking or both")
+            ("pending", boost::program_options::value<unsigned int>()->default_value(2),
+                     "max number of nonblocking broadcasts in flight")
+            ("waitmode", boost::program_options::value<std::string>()->default_value("backoff"),
+                     "MPI wait mode: backoff, budget or progress")
+            ("spintime", boost::program_options::value<unsigned int>()->default_value(0),
+                     "MPI wait busy polling time [us]")
+            ("maxsleep", boost::program_options::value<unsigned int>()->default_value(100),
+                     "MPI wait max sleep time [us]")
         ;
     }
 
@@ -133,6 +155,12 @@ struct BenchmarkOptions
         getHelp_ = vm.count("help");
         dataSize_ = vm["datasize"].as<float>() * MEGABYTE;
         packetsCount_ = vm["packets"].as<unsigned int>();
+        mode_ = vm["mode"].as<std::string>();
+        pending_ = vm["pending"].as<unsigned int>();
+        getHelp_ = getHelp_ || !MPIWaitPolicy::parseMode(vm["waitmode"].as<std::string>(),
+                                                         waitPolicy_.mode);
+        waitPolicy_.spinTime = vm["spintime"].as<unsigned int>();
+        waitPolicy_.maxSleep = vm["maxsleep"].as<unsigned int>();
     }
 
     boost::program_options::options_description desc_;
@@ -140,59 +168,131 @@ struct BenchmarkOptions
     bool getHelp_;
     unsigned int dataSize_;
     unsigned int packetsCount_;
+    std::string mode_;
+    unsigned int pending_;
+    MPIWaitPolicy waitPolicy_;
 };
-}
 
-/**
- * Send data via MPI to benchmark the effective link speed at application level.
- */
-int main(int argc, char **argv)
+void transmit(MPIChannel& mpiChannel, const bool nonblocking,
+              SerializeBufferPtr sendBuffer, SerializeBuffer& receiveBuffer)
 {
-    BenchmarkOptions options(argc, argv);
-    if (options.getHelp_)
+    if (mpiChannel.getRank() == RANK0)
     {
-        options.showSyntax();
-        return 0;
+        if (nonblocking)
+            mpiChannel.broadcastNonblocking(MPI_MESSAGE_TYPE_NONE, sendBuffer);
+        else
+            mpiChannel.broadcast(MPI_MESSAGE_TYPE_NONE, *sendBuffer);
+        return;
     }
 
-    MPIChannel mpiChannel(argc, argv);
+    if (nonblocking)
+    {
+        const MPIHeader header = mpiChannel.receiveBroadcastHeader(RANK0);
+        receiveBuffer.setSize(header.size);
+        mpiChannel.receiveNonblockingBroadcast(receiveBuffer.data(),
+                                               header.size, RANK0);
+    }
+    else
+    {
+        const MPIHeader header = mpiChannel.receiveHeader(RANK0);
+        receiveBuffer.setSize(header.size);
+        mpiChannel.receiveBroadcast(receiveBuffer.data(), header.size, RANK0);
+    }
+}
+
+void benchmark(MPIChannel& mpiChannel, const bool nonblocking,
+               const size_t dataSize, const size_t packetsCount)
+{
+    if (packetsCount == 0)
+        return;
 
     // Send buffer
-    std::vector<char> noiseBuffer(options.dataSize_);
+    std::vector<char> noiseBuffer(dataSize);
     for (std::vector<char>::iterator it = noiseBuffer.begin(); it != noiseBuffer.end(); ++it)
         *it = rand();
-    const std::string serializedData = SerializeBuffer::serialize(noiseBuffer);
+    SerializeBufferPtr sendBuffer = boost::make_shared<SerializeBuffer>();
+    sendBuffer->write(noiseBuffer);
 
     // Receive buffer
     SerializeBuffer buffer;
     Timer timer;
-    size_t counter = 0;
 
+    // Throughput: back-to-back messages, which may overlap when nonblocking
     mpiChannel.globalBarrier();
     timer.start();
+    for (size_t i = 0; i < packetsCount; ++i)
+        transmit(mpiChannel, nonblocking, sendBuffer, buffer);
+    if (nonblocking)
+        mpiChannel.waitForBroadcasts();
+    mpiChannel.globalBarrier();
+    const float time = timer.elapsed() / 1000.f;
 
-    while(counter < options.packetsCount_)
+    // Latency: one message at a time, until all processes have received it
+    timer.start();
+    for (size_t i = 0; i < packetsCount; ++i)
     {
-        if (mpiChannel.getRank() == RANK0)
-            mpiChannel.broadcast(MPI_MESSAGE_TYPE_NONE, serializedData);
-        else
-        {
-            const MPIHeader header = mpiChannel.receiveHeader(RANK0);
-            buffer.setSize(header.size);
-            mpiChannel.receiveBroadcast(buffer.data(), header.size, RANK0);
-        }
-        ++counter;
+        transmit(mpiChannel, nonblocking, sendBuffer, buffer);
+        if (nonblocking)
+            mpiChannel.waitForBroadcasts();
+        mpiChannel.globalBarrier();
     }
+    const float latency = timer.elapsed() / packetsCount;
 
-    const float time = timer.elapsed() / 1000.f;
+    if (mpiChannel.getRank() == RANK0)
+    {
+        const size_t size = sendBuffer->size();
+        std::cout << "Object size [Kbytes]: " << (float)size / KILOBYTE << std::endl;
+        std::cout << "Mode: " << (nonblocking ? "nonblocking" : "blocking") << std::endl;
+        std::cout << "Time to send " << packetsCount << " objects: " << time << std::endl;
+        std::cout << "Time per object: " << time / packetsCount << std::endl;
+        std::cout << "Throughput [Mbytes/sec]: " << packetsCount * size / time / MEGABYTE << std::endl;
+        std::cout << "Latency [ms]: " << latency << std::endl;
+    }
+}
+}
+
+/**
+ * Send data via MPI to benchmark the effective link speed at application level.
+ */
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options(argc, argv);
+    if (options.getHelp_)
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    MPIChannel mpiChannel(argc, argv);
+    mpiChannel.setMaxPendingBroadcasts(options.pending_);
+    MPI_Nospin_SetWaitPolicy(options.waitPolicy_);
 
     if (mpiChannel.getRank() == RANK0)
+        std::cout << "Processes: " << mpiChannel.getSize() << std::endl;
+
+    std::vector<size_t> sizes;
+    if (options.dataSize_ > 0)
+        sizes.push_back(options.dataSize_);
+    else
     {
-        std::cout << "Object size [Mbytes]: " << (float)serializedData.size() / MEGABYTE << std::endl;
-        std::cout << "Time to send " << counter << " objects: " << time << std::endl;
-        std::cout << "Time per object: " << time / counter << std::endl;
-        std::cout << "Throughput [Mbytes/sec]: " << counter * serializedData.size() / time / MEGABYTE << std::endl;
+        for (size_t size = KILOBYTE; size <= 100 * MEGABYTE; size *= 10)
+            sizes.push_back(size);
     }
 
+    const bool blocking = options.mode_ != "nonblocking";
+    const bool nonblocking = options.mode_ != "blocking";
+
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        if (blocking)
+            benchmark(mpiChannel, false, sizes[i], options.packetsCount_);
+        if (nonblocking)
+            benchmark(mpiChannel, true, sizes[i], options.packetsCount_);
+    }
+
+    mpiChannel.globalBarrier();
+    if (mpiChannel.getRank() == RANK0 + 1)
+        std::cout << MPI_Nospin_GetStatistics() << std::endl;
+
     return 0;
 }
@@ -0,0 +1,306 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#include <boost/program_options.hpp>
+
+#include <QElapsedTimer>
+
+#include <deflect/MTQueue.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "FFMPEGFrame.h"
+#include "FFMPEGMovie.h"
+#include "FFMPEGPicturePool.h"
+#include "FFMPEGVideoFrameConverter.h"
+
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+// Example ways to run this program:
+// ./dcBenchmarkMoviePlayback --frames 500
+// ./dcBenchmarkMoviePlayback --movie movie.mp4
+//
+// Simulates the playback of 4K YUV 4:2:0 movies: a decoding thread converts
+// frames into pictures which it queues for a consuming thread, as FFMPEGMovie
+// does. The pictures are first allocated for each frame, then recycled
+// through a FFMPEGPicturePool. Reports the number of picture allocations, the
+// page faults, the resident memory and the time per frame. If a movie file is
+// given, it is also played and the pictures allocated by FFMPEGMovie are
+// reported.
+
+namespace
+{
+const size_t QUEUE_SIZE = 4;
+const size_t POOL_SIZE = QUEUE_SIZE + 4;
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "frames", po::value<int>()->default_value( 300 ),
+              "number of frames played per measure" )
+            ( "movie", po::value<std::string>(),
+              "movie file to play in addition to the simulation" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+/** The memory usage of the process. */
+struct MemoryUsage
+{
+    MemoryUsage()
+    {
+        rusage usage;
+        getrusage( RUSAGE_SELF, &usage );
+        pageFaults = usage.ru_minflt + usage.ru_majflt;
+
+        long pages = 0;
+        FILE* statm = fopen( "/proc/self/statm", "r" );
+        if( !statm || fscanf( statm, "%*d %ld", &pages ) != 1 )
+            pages = 0;
+        if( statm )
+            fclose( statm );
+        residentBytes = uint64_t( pages ) * sysconf( _SC_PAGESIZE );
+    }
+
+    uint64_t pageFaults;
+    uint64_t residentBytes;
+};
+
+/** A decoded YUV 4:2:0 frame with its codec context, as from a decoder. */
+struct SourceFrame
+{
+    explicit SourceFrame( const QSize& size )
+        : codecContext( avcodec_alloc_context3( 0 ))
+        , picture( size.width(), size.height(), PIX_FMT_YUV420P )
+    {
+        codecContext->width = size.width();
+        codecContext->height = size.height();
+        codecContext->pix_fmt = PIX_FMT_YUV420P;
+
+        AVFrame& avFrame = picture.getAVFrame();
+        for( unsigned int plane = 0; plane < 3; ++plane )
+        {
+            const QRect region = picture.getPlaneRegion( plane );
+            for( int y = 0; y < region.height(); ++y )
+                for( int x = 0; x < region.width(); ++x )
+                    avFrame.data[plane][y * avFrame.linesize[plane] + x] =
+                            16 + ( x + y + plane * 64 ) % 220;
+        }
+    }
+
+    ~SourceFrame()
+    {
+        av_free( codecContext );
+    }
+
+    AVCodecContext* codecContext;
+    FFMPEGPicture picture;
+};
+
+struct PlaybackResult
+{
+    size_t allocations;
+    uint64_t pageFaults;
+    uint64_t residentBytes;
+    qint64 frameTime;
+};
+
+/**
+ * Play the frames through a queue between a decoding and a consuming thread.
+ * @param poolSize The number of pictures recycled, 0 to allocate each one
+ */
+PlaybackResult play( SourceFrame& source, const size_t poolSize,
+                     const int frames )
+{
+    const QSize size( source.codecContext->width,
+                      source.codecContext->height );
+    auto pool = std::make_shared<FFMPEGPicturePool>( size, PIX_FMT_YUV420P,
+                                                     poolSize );
+    FFMPEGVideoFrameConverter converter( *source.codecContext,
+                                         PIX_FMT_YUV420P );
+    deflect::MTQueue<PicturePtr> queue( QUEUE_SIZE );
+
+    const MemoryUsage before;
+    QElapsedTimer timer;
+    timer.start();
+
+    std::thread decoder( [&]
+    {
+        for( int i = 0; i < frames; ++i )
+        {
+            PicturePtr picture = pool->getPicture( QRect( QPoint(), size ));
+            converter.convert( source.picture, *picture );
+            queue.enqueue( picture );
+        }
+    });
+    for( int i = 0; i < frames; ++i )
+        queue.dequeue();
+    decoder.join();
+
+    const qint64 elapsed = timer.nsecsElapsed();
+    const MemoryUsage after;
+
+    PlaybackResult result;
+    result.allocations = pool->getAllocationCount();
+    result.pageFaults = after.pageFaults - before.pageFaults;
+    result.residentBytes = after.residentBytes;
+    result.frameTime = elapsed / std::max( frames, 1 );
+    return result;
+}
+
+void printResult( const char* name, const PlaybackResult& result )
+{
+    std::cout << name << "\t\t" << result.allocations << "\t\t"
+              << result.pageFaults << "\t\t"
+              << result.residentBytes / 1048576.f << "\t\t"
+              << result.frameTime / 1000000.f << std::endl;
+}
+
+void playMovie( const std::string& filename, const int frames )
+{
+    FFMPEGMovie movie( QString::fromStdString( filename ),
+                       MOVIE_PICTURE_YUV );
+    if( !movie.isValid( ))
+    {
+        std::cerr << "Could not open movie: " << filename << std::endl;
+        return;
+    }
+
+    const MemoryUsage before;
+    movie.startDecoding();
+    int played = 0;
+    for( ; played < frames && !movie.isAtEOF(); ++played )
+    {
+        try
+        {
+            movie.getFrame( played * movie.getFrameDuration( )).get();
+        }
+        catch( const std::runtime_error& )
+        {
+            break;
+        }
+    }
+    movie.stopDecoding();
+    const MemoryUsage after;
+
+    std::cout << "Movie: " << filename << ", " << played << " frames played, "
+              << movie.getAllocatedPictures() << " pictures allocated, "
+              << after.pageFaults - before.pageFaults << " page faults, "
+              << after.residentBytes / 1048576.f << " MB resident"
+              << std::endl;
+}
+}
+
+/**
+ * Compare the allocations and memory usage of movie playback with pictures
+ * allocated for each frame and with pictures recycled through a pool.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    const int frames = options.vm_["frames"].as<int>();
+    SourceFrame source( QSize( 3840, 2160 ));
+
+    std::cout << "Frames: " << frames << ", frame size: 3840x2160" << std::endl;
+    std::cout << "Mode\t\tAllocations\tPage faults\tResident [MB]\tFrame [ms]"
+              << std::endl;
+    const PlaybackResult allocated = play( source, 0, frames );
+    printResult( "Allocated", allocated );
+    const PlaybackResult pooled = play( source, POOL_SIZE, frames );
+    printResult( "Pooled", pooled );
+
+    std::cout << "Page fault reduction: "
+              << (float)allocated.pageFaults /
+                 std::max( pooled.pageFaults, uint64_t(1) ) << "x"
+              << std::endl;
+
+    if( options.vm_.count( "movie" ))
+        playMovie( options.vm_["movie"].as<std::string>(), frames );
+
+    return 0;
+}
@@ -0,0 +1,298 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGLWidget>
+#include <QImage>
+
+#include "FFMPEGFrame.h"
+#include "FFMPEGVideoFrameConverter.h"
+#include "GLTexture2D.h"
+#include "GLTextureUploader.h"
+#include "GLYUVQuad.h"
+
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+// Example ways to run this program:
+// ./dcBenchmarkMovieUpload --frames 50
+// xvfb-run ./dcBenchmarkMovieUpload
+//
+// Converts YUV 4:2:0 movie frames of 1080p and 4K resolutions to RGBA on the
+// CPU and uploads them to a texture, then does the same with the YUV planes
+// uploaded as they are and converted by the GLYUVQuad shader. Reports the CPU
+// time spent converting and uploading and the amount of data uploaded per
+// frame. An X display is required for the OpenGL context.
+
+namespace
+{
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "frames", po::value<int>()->default_value( 100 ),
+              "number of frames converted and uploaded per measure" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+/** A decoded YUV 4:2:0 frame with its codec context, as from a decoder. */
+struct SourceFrame
+{
+    explicit SourceFrame( const QSize& size )
+        : codecContext( avcodec_alloc_context3( 0 ))
+        , picture( size.width(), size.height(), PIX_FMT_YUV420P )
+    {
+        codecContext->width = size.width();
+        codecContext->height = size.height();
+        codecContext->pix_fmt = PIX_FMT_YUV420P;
+
+        AVFrame& avFrame = picture.getAVFrame();
+        for( unsigned int plane = 0; plane < 3; ++plane )
+        {
+            const QRect region = picture.getPlaneRegion( plane );
+            for( int y = 0; y < region.height(); ++y )
+                for( int x = 0; x < region.width(); ++x )
+                    avFrame.data[plane][y * avFrame.linesize[plane] + x] =
+                            16 + ( x + y + plane * 64 ) % 220;
+        }
+    }
+
+    ~SourceFrame()
+    {
+        av_free( codecContext );
+    }
+
+    AVCodecContext* codecContext;
+    FFMPEGPicture picture;
+};
+
+struct UploadResult
+{
+    UploadResult() : convertTime( 0 ), uploadTime( 0 ), uploadedBytes( 0 ) {}
+
+    qint64 convertTime;
+    qint64 uploadTime;
+    uint64_t uploadedBytes;
+};
+
+/**
+ * Convert the source frame to the target format and upload the pictures,
+ * measuring the time spent on the CPU for each step. The upload time includes
+ * the end of the transfers (glFinish).
+ */
+template< typename UploadFunction >
+UploadResult uploadFrames( SourceFrame& source, const PixelFormat format,
+                           UploadFunction upload, const int frames )
+{
+    FFMPEGVideoFrameConverter converter( *source.codecContext, format );
+    const QRect region( 0, 0, source.codecContext->width,
+                        source.codecContext->height );
+
+    GLTextureUploader& uploader = GLTextureUploader::instance();
+    const uint64_t uploaded = uploader.getUploadedBytes();
+
+    UploadResult result;
+    glFinish();
+
+    for( int i = 0; i < frames; ++i )
+    {
+        QElapsedTimer timer;
+        timer.start();
+        FFMPEGPicture picture( region, format );
+        converter.convert( source.picture, picture );
+        result.convertTime += timer.nsecsElapsed();
+
+        timer.restart();
+        upload( picture );
+        glFinish();
+        result.uploadTime += timer.nsecsElapsed();
+    }
+
+    const qint64 count = std::max( frames, 1 );
+    result.convertTime /= count;
+    result.uploadTime /= count;
+    result.uploadedBytes = ( uploader.getUploadedBytes() - uploaded ) / count;
+    return result;
+}
+
+struct UploadRGBA
+{
+    GLTexture2D& texture;
+
+    void operator()( const FFMPEGPicture& picture ) const
+    {
+        texture.update( picture.getData(), picture.getRegion(), GL_RGBA );
+    }
+};
+
+struct UploadYUV
+{
+    GLYUVQuad& quad;
+
+    void operator()( const FFMPEGPicture& picture ) const
+    {
+        for( unsigned int i = 0; i < GLYUVQuad::PLANE_COUNT; ++i )
+            quad.update( i, picture.getData( i ), picture.getPlaneRegion( i ));
+    }
+};
+
+void printResult( const char* name, const UploadResult& result )
+{
+    std::cout << name << "\t\t" << result.convertTime / 1000000.f << "\t\t"
+              << result.uploadTime / 1000000.f << "\t\t"
+              << result.uploadedBytes / 1048576.f << std::endl;
+}
+}
+
+/**
+ * Compare the CPU time and the amount of data uploaded per frame for movies
+ * converted to RGBA on the CPU and for YUV planes converted on the GPU.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    QApplication app( argc, argv );
+    QGLWidget widget;
+    widget.makeCurrent();
+    if( !widget.isValid( ))
+    {
+        std::cerr << "Could not create an OpenGL context" << std::endl;
+        return 1;
+    }
+
+    const bool yuvSupported = GLYUVQuad::isSupported();
+    if( !yuvSupported )
+        std::cerr << "The YUV shader is not supported, only the RGBA "
+                     "conversion is measured" << std::endl;
+
+    const int frames = options.get( "frames" );
+    const QSize sizes[] = { QSize( 1920, 1080 ), QSize( 3840, 2160 ) };
+    for( const QSize& size : sizes )
+    {
+        SourceFrame source( size );
+
+        QImage image( size, QImage::Format_RGB32 );
+        image.fill( 0 );
+        GLTexture2D texture;
+        texture.init( image );
+        const UploadRGBA uploadRGBA = { texture };
+        const UploadResult rgba = uploadFrames( source, PIX_FMT_RGBA,
+                                                uploadRGBA, frames );
+
+        std::cout << "Frame size: " << size.width() << "x" << size.height()
+                  << std::endl;
+        std::cout << "Mode\tConvert [ms]\tUpload [ms]\tUploaded [MB]"
+                  << std::endl;
+        printResult( "RGBA", rgba );
+
+        if( !yuvSupported )
+            continue;
+
+        GLYUVQuad quad;
+        quad.init( size, source.picture.getPlaneRegion( 1 ).size( ));
+        const UploadYUV uploadYUV = { quad };
+        const UploadResult yuv = uploadFrames( source, PIX_FMT_YUV420P,
+                                               uploadYUV, frames );
+        printResult( "YUV", yuv );
+
+        const qint64 rgbaTime = rgba.convertTime + rgba.uploadTime;
+        const qint64 yuvTime = yuv.convertTime + yuv.uploadTime;
+        std::cout << "CPU time reduction: "
+                  << (float)rgbaTime / std::max( yuvTime, qint64(1) )
+                  << "x, upload reduction: "
+                  << (float)rgba.uploadedBytes /
+                     std::max( yuv.uploadedBytes, uint64_t(1) )
+                  << "x" << std::endl;
+    }
+
+    return 0;
+}
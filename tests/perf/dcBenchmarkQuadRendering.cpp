@@ -0,0 +1,359 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include <cmath>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGLWidget>
+#include <QImage>
+
+#include "GLQuad.h"
+#include "GLQuadRenderer.h"
+#include "GLTexture2D.h"
+
+// Example ways to run this program:
+// xvfb-run ./dcBenchmarkQuadRendering
+// ./dcBenchmarkQuadRendering --windows 4 --tiles 256 --hardware
+//
+// Renders the tiles of several windows, each tile being a textured quad, with
+// the former immediate-mode quads (glBegin/glEnd and attributes pushed for each
+// quad) and with the GLQuadRenderer, quad by quad and batched per window.
+// Reports the draw calls, state changes and time per frame. Mesa's software
+// rasterizer is used unless --hardware is given, so that the CPU cost of the
+// draw calls is visible.
+
+namespace
+{
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "windows", po::value<int>()->default_value( 16 ),
+              "number of windows" )
+            ( "tiles", po::value<int>()->default_value( 64 ),
+              "number of tiles (quads) per window" )
+            ( "textures", po::value<int>()->default_value( 8 ),
+              "number of textures per window, used in turn by the tiles" )
+            ( "frames", po::value<int>()->default_value( 100 ),
+              "number of frames rendered to measure the time" )
+            ( "hardware", "use the hardware OpenGL driver" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+enum RenderMode
+{
+    RENDER_IMMEDIATE,
+    RENDER_UNBATCHED,
+    RENDER_BATCHED
+};
+
+struct Tile
+{
+    GLuint textureId;
+    QRectF rect;
+};
+
+typedef std::vector<Tile> Tiles;
+typedef boost::shared_ptr<GLTexture2D> GLTexture2DPtr;
+
+/** The textured quad as drawn before the GLQuadRenderer. */
+void renderImmediateQuad( const GLuint textureId )
+{
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT );
+
+    glEnable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, textureId );
+
+    glBegin( GL_QUADS );
+    glTexCoord2f( 0.f, 0.f );
+    glVertex2f( 0.f, 0.f );
+    glTexCoord2f( 1.f, 0.f );
+    glVertex2f( 1.f, 0.f );
+    glTexCoord2f( 1.f, 1.f );
+    glVertex2f( 1.f, 1.f );
+    glTexCoord2f( 0.f, 1.f );
+    glVertex2f( 0.f, 1.f );
+    glEnd();
+
+    glPopAttrib();
+}
+
+/** Create the tiles of the windows, side by side in normalized coordinates. */
+std::vector<Tiles> createWindows( const BenchmarkOptions& options,
+                                  std::vector<GLTexture2DPtr>& textures )
+{
+    const int windowCount = options.get( "windows" );
+    const int tileCount = options.get( "tiles" );
+    const int textureCount = std::max( options.get( "textures" ), 1 );
+    const int tilesPerRow = std::ceil( std::sqrt( double( tileCount )));
+
+    std::vector<Tiles> windows( windowCount );
+    for( int i = 0; i < windowCount; ++i )
+    {
+        const size_t firstTexture = textures.size();
+        for( int j = 0; j < textureCount; ++j )
+        {
+            QImage image( 256, 256, QImage::Format_RGB32 );
+            image.fill( qRgb( i * 16 % 256, j * 32 % 256, 128 ));
+            textures.push_back( GLTexture2DPtr( new GLTexture2D ));
+            textures.back()->update( image );
+        }
+
+        const qreal windowWidth = 1.0 / windowCount;
+        const qreal tileSize = 1.0 / tilesPerRow;
+        for( int j = 0; j < tileCount; ++j )
+        {
+            Tile tile;
+            tile.textureId =
+                    textures[firstTexture + j % textureCount]->getTextureId();
+            const int column = j % tilesPerRow;
+            const int row = j / tilesPerRow;
+            tile.rect = QRectF( windowWidth * ( i + column * tileSize ),
+                                row * tileSize,
+                                windowWidth * tileSize, tileSize );
+            windows[i].push_back( tile );
+        }
+    }
+    return windows;
+}
+
+void renderTile( const Tile& tile, GLQuad& quad, const RenderMode mode )
+{
+    glPushMatrix();
+    glTranslatef( tile.rect.x(), tile.rect.y(), 0.f );
+    glScalef( tile.rect.width(), tile.rect.height(), 1.f );
+
+    if( mode == RENDER_IMMEDIATE )
+        renderImmediateQuad( tile.textureId );
+    else
+    {
+        quad.setTexture( tile.textureId );
+        quad.render();
+    }
+
+    glPopMatrix();
+}
+
+void renderWindows( const std::vector<Tiles>& windows, const RenderMode mode )
+{
+    GLQuad quad;
+    for( size_t i = 0; i < windows.size(); ++i )
+    {
+        // Like the ContentItem of each window
+        if( mode == RENDER_BATCHED )
+            GLQuadRenderer::instance().begin();
+
+        for( size_t j = 0; j < windows[i].size(); ++j )
+            renderTile( windows[i][j], quad, mode );
+
+        if( mode == RENDER_BATCHED )
+            GLQuadRenderer::instance().end();
+    }
+}
+
+struct RenderResult
+{
+    RenderResult() : drawCalls( 0 ), stateChanges( 0 ), submitTime( 0 ),
+                     frameTime( 0 ) {}
+
+    uint64_t drawCalls;
+    uint64_t stateChanges;
+    qint64 submitTime;
+    qint64 frameTime;
+};
+
+/**
+ * Render the frames and measure the time spent submitting the draw calls
+ * (CPU) and until they have been executed (glFinish).
+ */
+RenderResult renderFrames( const std::vector<Tiles>& windows,
+                           const RenderMode mode, const int frames )
+{
+    const GLQuadRenderer& renderer = GLQuadRenderer::instance();
+    const uint64_t drawCount = renderer.getDrawCount();
+    const uint64_t stateChangeCount = renderer.getStateChangeCount();
+
+    RenderResult result;
+    glFinish();
+
+    for( int i = 0; i < frames; ++i )
+    {
+        glClear( GL_COLOR_BUFFER_BIT );
+
+        QElapsedTimer timer;
+        timer.start();
+        renderWindows( windows, mode );
+        result.submitTime += timer.nsecsElapsed();
+        glFinish();
+        result.frameTime += timer.nsecsElapsed();
+    }
+
+    const int count = std::max( frames, 1 );
+    if( mode == RENDER_IMMEDIATE )
+    {
+        // One draw and one texture bind per tile
+        for( size_t i = 0; i < windows.size(); ++i )
+            result.drawCalls += windows[i].size();
+        result.stateChanges = result.drawCalls;
+    }
+    else
+    {
+        result.drawCalls = ( renderer.getDrawCount() - drawCount ) / count;
+        result.stateChanges =
+                ( renderer.getStateChangeCount() - stateChangeCount ) / count;
+    }
+    result.submitTime /= count;
+    result.frameTime /= count;
+    return result;
+}
+
+void printResult( const char* name, const RenderResult& result )
+{
+    std::cout << name << "\t" << result.drawCalls << "\t\t"
+              << result.stateChanges << "\t\t"
+              << result.submitTime / 1000000.f << "\t\t"
+              << result.frameTime / 1000000.f << std::endl;
+}
+}
+
+/**
+ * Compare the draw calls, state changes and time to render textured quads in
+ * immediate mode and with the GLQuadRenderer.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    if( !options.vm_.count( "hardware" ))
+        qputenv( "LIBGL_ALWAYS_SOFTWARE", "1" );
+
+    QApplication app( argc, argv );
+    QGLWidget widget;
+    widget.resize( 1920, 1080 );
+    widget.makeCurrent();
+    if( !widget.isValid( ))
+    {
+        std::cerr << "Could not create an OpenGL context" << std::endl;
+        return 1;
+    }
+
+    std::vector<GLTexture2DPtr> textures;
+    const std::vector<Tiles> windows = createWindows( options, textures );
+    const int frames = options.get( "frames" );
+
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glOrtho( 0.0, 1.0, 1.0, 0.0, -1.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+
+    const RenderResult immediate = renderFrames( windows, RENDER_IMMEDIATE,
+                                                 frames );
+    const RenderResult unbatched = renderFrames( windows, RENDER_UNBATCHED,
+                                                 frames );
+    const RenderResult batched = renderFrames( windows, RENDER_BATCHED,
+                                               frames );
+
+    std::cout << "Renderer: " << glGetString( GL_RENDERER ) << std::endl;
+    std::cout << "Mode\t\tDraw calls\tState changes\tSubmit [ms]\tFrame [ms]"
+              << std::endl;
+    printResult( "immediate", immediate );
+    printResult( "unbatched", unbatched );
+    printResult( "batched\t", batched );
+    std::cout << "CPU submit time reduction: "
+              << (float)immediate.submitTime /
+                 std::max( batched.submitTime, qint64(1) )
+              << "x" << std::endl;
+
+    return 0;
+}
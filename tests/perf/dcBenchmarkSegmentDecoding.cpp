@@ -0,0 +1,320 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#include <boost/program_options.hpp>
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QImage>
+
+#include "geometry.h"
+#include "SegmentRegionDecoder.h"
+
+#define MEGAPIXEL 1000000
+
+// Example ways to run this program:
+// ./dcBenchmarkSegmentDecoding --columns 4 --rows 4
+// ./dcBenchmarkSegmentDecoding --windowx 0 --windowy 0 --windowwidth 7680
+//
+// Simulates a wall with one process per screen and reports the number of
+// pixels decoded by each process for a frame of a pixel stream, when the
+// visible segments are decoded entirely and when only their visible region is
+// decoded.
+
+namespace
+{
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "columns", po::value<int>()->default_value( 4 ),
+              "number of screens horizontally (one process per screen)" )
+            ( "rows", po::value<int>()->default_value( 4 ),
+              "number of screens vertically" )
+            ( "screenwidth", po::value<int>()->default_value( 1920 ),
+              "width of a screen [pixels]" )
+            ( "screenheight", po::value<int>()->default_value( 1080 ),
+              "height of a screen [pixels]" )
+            ( "streamwidth", po::value<int>()->default_value( 3840 ),
+              "width of the stream [pixels]" )
+            ( "streamheight", po::value<int>()->default_value( 2160 ),
+              "height of the stream [pixels]" )
+            ( "segmentsize", po::value<int>()->default_value( 512 ),
+              "nominal size of the stream segments [pixels]" )
+            ( "quality", po::value<int>()->default_value( 75 ),
+              "JPEG quality of the segments" )
+            ( "windowx", po::value<int>()->default_value( 960 ),
+              "position of the window on the wall [pixels]" )
+            ( "windowy", po::value<int>()->default_value( 540 ),
+              "position of the window on the wall [pixels]" )
+            ( "windowwidth", po::value<int>()->default_value( 5760 ),
+              "width of the window on the wall [pixels]" )
+            ( "windowheight", po::value<int>()->default_value( 3240 ),
+              "height of the window on the wall [pixels]" )
+            ( "repetitions", po::value<int>()->default_value( 10 ),
+              "number of times each frame is decoded to measure the time" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+std::vector<QRect> createWallProcessAreas( const BenchmarkOptions& options )
+{
+    std::vector<QRect> areas;
+    for( int y = 0; y < options.get( "rows" ); ++y )
+    {
+        for( int x = 0; x < options.get( "columns" ); ++x )
+        {
+            const int width = options.get( "screenwidth" );
+            const int height = options.get( "screenheight" );
+            areas.push_back( QRect( x * width, y * height, width, height ));
+        }
+    }
+    return areas;
+}
+
+QByteArray compressImage( const QSize& size, const int quality )
+{
+    QImage image( size, QImage::Format_RGB32 );
+    for( int y = 0; y < size.height(); ++y )
+        for( int x = 0; x < size.width(); ++x )
+            image.setPixel( x, y, qRgb( x % 256, y % 256, ( x ^ y ) % 256 ));
+
+    QByteArray jpeg;
+    QBuffer buffer( &jpeg );
+    buffer.open( QIODevice::WriteOnly );
+    image.save( &buffer, "JPG", quality );
+    return jpeg;
+}
+
+deflect::Segments createSegments( const BenchmarkOptions& options )
+{
+    const int width = options.get( "streamwidth" );
+    const int height = options.get( "streamheight" );
+    const int segmentSize = options.get( "segmentsize" );
+
+    // The segments on the borders of the stream may be smaller
+    std::map<std::pair<int, int>, QByteArray> images;
+
+    deflect::Segments segments;
+    for( int y = 0; y < height; y += segmentSize )
+    {
+        for( int x = 0; x < width; x += segmentSize )
+        {
+            deflect::Segment segment;
+            segment.parameters.x = x;
+            segment.parameters.y = y;
+            segment.parameters.width = std::min( segmentSize, width - x );
+            segment.parameters.height = std::min( segmentSize, height - y );
+            segment.parameters.compressed = true;
+
+            QByteArray& image = images[std::make_pair(
+                    segment.parameters.width, segment.parameters.height )];
+            if( image.isEmpty( ))
+                image = compressImage( QSize( segment.parameters.width,
+                                              segment.parameters.height ),
+                                       options.get( "quality" ));
+            segment.imageData = image;
+            segments.push_back( segment );
+        }
+    }
+    return segments;
+}
+
+QRectF getSceneRect( const deflect::SegmentParameters& params,
+                     const QSize& frameSize, const QRectF& windowArea )
+{
+    const qreal scaleX = windowArea.width() / frameSize.width();
+    const qreal scaleY = windowArea.height() / frameSize.height();
+
+    return QRectF( windowArea.x() + params.x * scaleX,
+                   windowArea.y() + params.y * scaleY,
+                   params.width * scaleX, params.height * scaleY );
+}
+
+struct DecodeResult
+{
+    DecodeResult() : segments( 0 ), pixels( 0 ), time( 0 ) {}
+
+    size_t segments;
+    uint64_t pixels;
+    qint64 time;
+};
+
+/** Decode the segments visible in an area, entirely or only their region. */
+DecodeResult decode( const deflect::Segments& segments, const QSize& frameSize,
+                     const QRectF& window, const QRectF& area,
+                     const bool regionOnly, const int repetitions )
+{
+    SegmentRegionDecoder decoder;
+    DecodedRegion output;
+    DecodeResult result;
+
+    QElapsedTimer timer;
+    timer.start();
+    for( int i = 0; i < repetitions; ++i )
+    {
+        result.segments = 0;
+        result.pixels = 0;
+        for( size_t j = 0; j < segments.size(); ++j )
+        {
+            const deflect::SegmentParameters& params = segments[j].parameters;
+            const QSize size( params.width, params.height );
+            const QRect region = geometry::getVisibleRegion(
+                        size, getSceneRect( params, frameSize, window ), area );
+            if( region.isEmpty( ))
+                continue;
+
+            decoder.decode( segments[j], regionOnly ? region
+                                                    : QRect( QPoint(), size ),
+                            output );
+            ++result.segments;
+            result.pixels += output.rect.width() * output.rect.height();
+        }
+    }
+    result.time = timer.nsecsElapsed() / std::max( repetitions, 1 );
+    return result;
+}
+}
+
+/**
+ * Compare the number of pixels decoded by each wall process and the time it
+ * takes, with and without partial-region decoding.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    const std::vector<QRect> areas = createWallProcessAreas( options );
+    const deflect::Segments segments = createSegments( options );
+    const QSize frameSize( options.get( "streamwidth" ),
+                           options.get( "streamheight" ));
+    const QRectF window( options.get( "windowx" ), options.get( "windowy" ),
+                         options.get( "windowwidth" ),
+                         options.get( "windowheight" ));
+    const int repetitions = options.get( "repetitions" );
+
+    uint64_t fullTotal = 0;
+    uint64_t regionTotal = 0;
+    uint64_t fullMax = 0;
+    uint64_t regionMax = 0;
+
+    std::cout << "Segments per frame: " << segments.size() << std::endl;
+    std::cout << "Rank\tSegments\tFull [MPix]\tRegion [MPix]\t"
+              << "Full [ms]\tRegion [ms]" << std::endl;
+    for( size_t i = 0; i < areas.size(); ++i )
+    {
+        const DecodeResult full = decode( segments, frameSize, window, areas[i],
+                                          false, repetitions );
+        const DecodeResult region = decode( segments, frameSize, window,
+                                            areas[i], true, repetitions );
+        fullTotal += full.pixels;
+        regionTotal += region.pixels;
+        fullMax = std::max( fullMax, full.pixels );
+        regionMax = std::max( regionMax, region.pixels );
+
+        std::cout << i + 1 << "\t" << full.segments << "\t\t"
+                  << (float)full.pixels / MEGAPIXEL << "\t\t"
+                  << (float)region.pixels / MEGAPIXEL << "\t\t"
+                  << full.time / 1000000.f << "\t\t"
+                  << region.time / 1000000.f << std::endl;
+    }
+
+    std::cout << "Total per frame [MPix]: full "
+              << (float)fullTotal / MEGAPIXEL << ", region "
+              << (float)regionTotal / MEGAPIXEL << std::endl;
+    std::cout << "Max per rank per frame [MPix]: full "
+              << (float)fullMax / MEGAPIXEL << ", region "
+              << (float)regionMax / MEGAPIXEL << std::endl;
+    std::cout << "Decoded pixels reduction: "
+              << (float)fullTotal / std::max( regionTotal, uint64_t(1) )
+              << "x" << std::endl;
+
+    return 0;
+}
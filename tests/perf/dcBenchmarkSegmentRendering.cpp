@@ -0,0 +1,312 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGLWidget>
+#include <QImage>
+
+#include <deflect/SegmentParameters.h>
+
+#include "PixelStreamSegmentAtlas.h"
+#include "PixelStreamSegmentRenderer.h"
+
+// Example ways to run this program:
+// ./dcBenchmarkSegmentRendering --segmentsize 64
+// xvfb-run ./dcBenchmarkSegmentRendering --streamwidth 7680 --frames 50
+//
+// Renders all the segments of a pixel stream, each with its own texture and
+// draw call as well as from a single atlas texture in one draw call, and
+// reports the number of draw calls and the time spent per frame. An X display
+// is required for the OpenGL context.
+
+namespace
+{
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "streamwidth", po::value<int>()->default_value( 3840 ),
+              "width of the stream [pixels]" )
+            ( "streamheight", po::value<int>()->default_value( 2160 ),
+              "height of the stream [pixels]" )
+            ( "segmentsize", po::value<int>()->default_value( 128 ),
+              "nominal size of the stream segments [pixels]" )
+            ( "frames", po::value<int>()->default_value( 100 ),
+              "number of frames rendered to measure the time" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+std::vector<deflect::SegmentParameters>
+createSegments( const BenchmarkOptions& options )
+{
+    const int width = options.get( "streamwidth" );
+    const int height = options.get( "streamheight" );
+    const int segmentSize = options.get( "segmentsize" );
+
+    // The segments on the borders of the stream may be smaller
+    std::vector<deflect::SegmentParameters> segments;
+    for( int y = 0; y < height; y += segmentSize )
+    {
+        for( int x = 0; x < width; x += segmentSize )
+        {
+            deflect::SegmentParameters params;
+            params.x = x;
+            params.y = y;
+            params.width = std::min( segmentSize, width - x );
+            params.height = std::min( segmentSize, height - y );
+            segments.push_back( params );
+        }
+    }
+    return segments;
+}
+
+QImage createImage( const deflect::SegmentParameters& params )
+{
+    QImage image( params.width, params.height, QImage::Format_RGB32 );
+    image.fill( qRgb( params.x % 256, params.y % 256, 128 ));
+    return image;
+}
+
+struct RenderResult
+{
+    RenderResult() : drawCalls( 0 ), submitTime( 0 ), frameTime( 0 ) {}
+
+    size_t drawCalls;
+    qint64 submitTime;
+    qint64 frameTime;
+};
+
+void setStreamMatrices( const QSize& streamSize )
+{
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glOrtho( 0.0, 1.0, 1.0, 0.0, -1.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+    glScalef( 1.f / streamSize.width(), 1.f / streamSize.height(), 0.f );
+}
+
+/**
+ * Render the frames and measure the time spent submitting the draw calls
+ * (CPU) and until they have been executed (glFinish).
+ */
+template< typename RenderFunction >
+RenderResult renderFrames( RenderFunction renderFrame, const int frames )
+{
+    RenderResult result;
+    glFinish();
+
+    for( int i = 0; i < frames; ++i )
+    {
+        glClear( GL_COLOR_BUFFER_BIT );
+
+        QElapsedTimer timer;
+        timer.start();
+        result.drawCalls = renderFrame();
+        result.submitTime += timer.nsecsElapsed();
+        glFinish();
+        result.frameTime += timer.nsecsElapsed();
+    }
+
+    result.submitTime /= std::max( frames, 1 );
+    result.frameTime /= std::max( frames, 1 );
+    return result;
+}
+
+struct RenderSegments
+{
+    typedef boost::shared_ptr<PixelStreamSegmentRenderer> RendererPtr;
+    std::vector<RendererPtr>& renderers;
+
+    size_t operator()() const
+    {
+        size_t drawCalls = 0;
+        for( size_t i = 0; i < renderers.size(); ++i )
+            drawCalls += renderers[i]->render() ? 1 : 0;
+        return drawCalls;
+    }
+};
+
+struct RenderAtlas
+{
+    PixelStreamSegmentAtlas& atlas;
+    const std::vector<size_t>& cells;
+
+    size_t operator()() const
+    {
+        return atlas.render( cells ) ? 1 : 0;
+    }
+};
+
+void printResult( const char* name, const RenderResult& result )
+{
+    std::cout << name << "\t" << result.drawCalls << "\t\t"
+              << result.submitTime / 1000000.f << "\t\t"
+              << result.frameTime / 1000000.f << std::endl;
+}
+}
+
+/**
+ * Compare the draw calls and the time to render the segments of a stream with
+ * one texture per segment and with a single atlas texture.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    QApplication app( argc, argv );
+    QGLWidget widget;
+    widget.resize( 1920, 1080 );
+    widget.makeCurrent();
+    if( !widget.isValid( ))
+    {
+        std::cerr << "Could not create an OpenGL context" << std::endl;
+        return 1;
+    }
+
+    const QSize streamSize( options.get( "streamwidth" ),
+                            options.get( "streamheight" ));
+    const std::vector<deflect::SegmentParameters> segments =
+            createSegments( options );
+    const int frames = options.get( "frames" );
+
+    RenderSegments::RendererPtr renderer;
+    std::vector<RenderSegments::RendererPtr> renderers;
+    PixelStreamSegmentAtlas atlas;
+    std::vector<size_t> cells;
+
+    const int segmentSize = options.get( "segmentsize" );
+    const QSize cellSize = QSize( segmentSize, segmentSize ).boundedTo(
+                               streamSize );
+    if( !atlas.resize( cellSize, segments.size( )))
+    {
+        std::cerr << "The segments do not fit in the maximum texture size"
+                  << std::endl;
+        return 1;
+    }
+
+    for( size_t i = 0; i < segments.size(); ++i )
+    {
+        const QImage image = createImage( segments[i] );
+        const QRect rect( segments[i].x, segments[i].y, segments[i].width,
+                          segments[i].height );
+
+        renderer.reset( new PixelStreamSegmentRenderer );
+        renderer->setParameters( segments[i] );
+        renderer->updateTexture( image );
+        renderers.push_back( renderer );
+
+        atlas.update( i, image, rect );
+        cells.push_back( i );
+    }
+
+    setStreamMatrices( streamSize );
+
+    const RenderSegments renderSegments = { renderers };
+    const RenderAtlas renderAtlas = { atlas, cells };
+    const RenderResult perSegment = renderFrames( renderSegments, frames );
+    const RenderResult batched = renderFrames( renderAtlas, frames );
+
+    std::cout << "Segments per frame: " << segments.size() << ", atlas grid: "
+              << atlas.getGridSize().width() << "x"
+              << atlas.getGridSize().height() << std::endl;
+    std::cout << "Mode\t\tDraw calls\tSubmit [ms]\tFrame [ms]" << std::endl;
+    printResult( "per segment", perSegment );
+    printResult( "atlas\t", batched );
+    std::cout << "CPU submit time reduction: "
+              << (float)perSegment.submitTime /
+                 std::max( batched.submitTime, qint64(1) )
+              << "x" << std::endl;
+
+    return 0;
+}
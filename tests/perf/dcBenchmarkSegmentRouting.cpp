@@ -0,0 +1,243 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include <algorithm>
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include <deflect/Frame.h>
+
+#include "ContentWindow.h"
+#include "PixelStreamContent.h"
+#include "PixelStreamRouter.h"
+#include "SerializeBuffer.h"
+
+#define KILOBYTE 1000
+
+// Example ways to run this program:
+// ./dcBenchmarkSegmentRouting --columns 6 --rows 4
+// ./dcBenchmarkSegmentRouting --windowwidth 11520 --windowheight 4320
+//
+// Simulates a wall with one process per screen and reports the serialized
+// size of a pixel stream frame received by each process, when the frame is
+// broadcast to all processes and when its segments are routed.
+
+namespace
+{
+const QString STREAM_URI( "benchmark" );
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "columns", po::value<int>()->default_value( 6 ),
+              "number of screens horizontally (one process per screen)" )
+            ( "rows", po::value<int>()->default_value( 4 ),
+              "number of screens vertically" )
+            ( "screenwidth", po::value<int>()->default_value( 1920 ),
+              "width of a screen [pixels]" )
+            ( "screenheight", po::value<int>()->default_value( 1080 ),
+              "height of a screen [pixels]" )
+            ( "streamwidth", po::value<int>()->default_value( 3840 ),
+              "width of the stream [pixels]" )
+            ( "streamheight", po::value<int>()->default_value( 2160 ),
+              "height of the stream [pixels]" )
+            ( "segmentsize", po::value<int>()->default_value( 512 ),
+              "nominal size of the stream segments [pixels]" )
+            ( "compression", po::value<int>()->default_value( 10 ),
+              "compression ratio of the segments (1: uncompressed)" )
+            ( "windowx", po::value<int>()->default_value( 0 ),
+              "position of the window on the wall [pixels]" )
+            ( "windowy", po::value<int>()->default_value( 0 ),
+              "position of the window on the wall [pixels]" )
+            ( "windowwidth", po::value<int>()->default_value( 3840 ),
+              "width of the window on the wall [pixels]" )
+            ( "windowheight", po::value<int>()->default_value( 1080 ),
+              "height of the window on the wall [pixels]" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+std::vector<QRect> createWallProcessAreas( const BenchmarkOptions& options )
+{
+    std::vector<QRect> areas;
+    for( int y = 0; y < options.get( "rows" ); ++y )
+    {
+        for( int x = 0; x < options.get( "columns" ); ++x )
+        {
+            const int width = options.get( "screenwidth" );
+            const int height = options.get( "screenheight" );
+            areas.push_back( QRect( x * width, y * height, width, height ));
+        }
+    }
+    return areas;
+}
+
+deflect::FramePtr createFrame( const BenchmarkOptions& options )
+{
+    deflect::FramePtr frame = boost::make_shared<deflect::Frame>();
+    frame->uri = STREAM_URI;
+
+    const int width = options.get( "streamwidth" );
+    const int height = options.get( "streamheight" );
+    const int segmentSize = options.get( "segmentsize" );
+    const int compression = std::max( options.get( "compression" ), 1 );
+
+    for( int y = 0; y < height; y += segmentSize )
+    {
+        for( int x = 0; x < width; x += segmentSize )
+        {
+            deflect::Segment segment;
+            segment.parameters.x = x;
+            segment.parameters.y = y;
+            segment.parameters.width = std::min( segmentSize, width - x );
+            segment.parameters.height = std::min( segmentSize, height - y );
+            segment.parameters.compressed = compression > 1;
+
+            const int imageSize = segment.parameters.width *
+                                  segment.parameters.height * 4 / compression;
+            segment.imageData = QByteArray( imageSize, 'x' );
+            frame->segments.push_back( segment );
+        }
+    }
+    return frame;
+}
+}
+
+/**
+ * Compare the amount of pixel stream data received by each wall process with
+ * and without segment routing.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    const std::vector<QRect> areas = createWallProcessAreas( options );
+    const deflect::FramePtr frame = createFrame( options );
+
+    ContentPtr content( new PixelStreamContent( STREAM_URI ));
+    ContentWindowPtr window = boost::make_shared<ContentWindow>( content );
+    window->setCoordinates( QRectF( options.get( "windowx" ),
+                                    options.get( "windowy" ),
+                                    options.get( "windowwidth" ),
+                                    options.get( "windowheight" )));
+
+    PixelStreamRouter router( areas );
+    router.updateWindows( ContentWindowPtrs( 1, window ));
+    const std::vector<deflect::FramePtr> frames = router.route( frame );
+
+    const size_t broadcastSize = SerializeBuffer::serialize( frame ).size();
+    size_t routedTotal = 0;
+    size_t routedMax = 0;
+
+    std::cout << "Segments per frame: " << frame->segments.size() << std::endl;
+    std::cout << "Rank\tBroadcast [kB]\tRouted [kB]" << std::endl;
+    for( size_t i = 0; i < frames.size(); ++i )
+    {
+        const size_t routedSize =
+                SerializeBuffer::serialize( frames[i] ).size();
+        routedTotal += routedSize;
+        routedMax = std::max( routedMax, routedSize );
+
+        std::cout << i + 1 << "\t" << (float)broadcastSize / KILOBYTE << "\t"
+                  << (float)routedSize / KILOBYTE << std::endl;
+    }
+
+    const size_t broadcastTotal = broadcastSize * frames.size();
+    std::cout << "Total per frame [kB]: broadcast "
+              << (float)broadcastTotal / KILOBYTE << ", routed "
+              << (float)routedTotal / KILOBYTE << std::endl;
+    std::cout << "Max per rank per frame [kB]: broadcast "
+              << (float)broadcastSize / KILOBYTE << ", routed "
+              << (float)routedMax / KILOBYTE << std::endl;
+    std::cout << "Bandwidth reduction: "
+              << (float)broadcastTotal / std::max( routedTotal, size_t(1) )
+              << "x" << std::endl;
+
+    return 0;
+}
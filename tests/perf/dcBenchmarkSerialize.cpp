@@ -0,0 +1,250 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include <deflect/Frame.h>
+
+#include "FrameSerializer.h"
+#include "SerializeBuffer.h"
+#include "SerializeBufferPool.h"
+
+#define MEGABYTE 1000000
+
+// Example ways to run this program:
+// ./dcBenchmarkSerialize --streamwidth 7680 --streamheight 4320
+// ./dcBenchmarkSerialize --compression 1 --frames 50
+//
+// Serializes a pixel stream frame repeatedly and reports the throughput of:
+// - the std::string path: serialize() then copy into a queued signal argument
+// - the pooled path: write() into a reused buffer handed over without copy
+// - deserialization directly from the receive buffer
+// - the FrameSerializer, which reads the image data in place
+
+namespace
+{
+typedef std::chrono::high_resolution_clock Clock;
+
+struct BenchmarkOptions
+{
+    BenchmarkOptions( int& argc, char** argv )
+        : desc_( "Allowed options" )
+        , getHelp_( false )
+    {
+        initDesc();
+        parseCommandLineArguments( argc, argv );
+    }
+
+    void showSyntax() const
+    {
+        std::cout << desc_;
+    }
+
+    void initDesc()
+    {
+        namespace po = boost::program_options;
+        desc_.add_options()
+            ( "help", "produce help message" )
+            ( "streamwidth", po::value<int>()->default_value( 3840 ),
+              "width of the stream [pixels]" )
+            ( "streamheight", po::value<int>()->default_value( 2160 ),
+              "height of the stream [pixels]" )
+            ( "segmentsize", po::value<int>()->default_value( 512 ),
+              "nominal size of the stream segments [pixels]" )
+            ( "compression", po::value<int>()->default_value( 10 ),
+              "compression ratio of the segments (1: uncompressed)" )
+            ( "frames", po::value<int>()->default_value( 100 ),
+              "number of frames to serialize" )
+        ;
+    }
+
+    void parseCommandLineArguments( int& argc, char** argv )
+    {
+        try
+        {
+            boost::program_options::store(
+                boost::program_options::parse_command_line( argc, argv,
+                                                            desc_ ), vm_ );
+            boost::program_options::notify( vm_ );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << std::endl;
+            getHelp_ = true;
+            return;
+        }
+        getHelp_ = vm_.count( "help" );
+    }
+
+    int get( const char* option ) const
+    {
+        return vm_[option].as<int>();
+    }
+
+    boost::program_options::options_description desc_;
+    boost::program_options::variables_map vm_;
+    bool getHelp_;
+};
+
+deflect::FramePtr createFrame( const BenchmarkOptions& options )
+{
+    deflect::FramePtr frame = boost::make_shared<deflect::Frame>();
+    frame->uri = "benchmark";
+
+    const int width = options.get( "streamwidth" );
+    const int height = options.get( "streamheight" );
+    const int segmentSize = options.get( "segmentsize" );
+    const int compression = std::max( options.get( "compression" ), 1 );
+
+    for( int y = 0; y < height; y += segmentSize )
+    {
+        for( int x = 0; x < width; x += segmentSize )
+        {
+            deflect::Segment segment;
+            segment.parameters.x = x;
+            segment.parameters.y = y;
+            segment.parameters.width = std::min( segmentSize, width - x );
+            segment.parameters.height = std::min( segmentSize, height - y );
+            segment.parameters.compressed = compression > 1;
+
+            const int imageSize = segment.parameters.width *
+                                  segment.parameters.height * 4 / compression;
+            segment.imageData = QByteArray( imageSize, 'x' );
+            frame->segments.push_back( segment );
+        }
+    }
+    return frame;
+}
+
+float getElapsedSeconds( const Clock::time_point& start )
+{
+    return std::chrono::duration<float>( Clock::now() - start ).count();
+}
+
+void printResult( const char* name, const size_t bytes, const float time )
+{
+    std::cout << name << ": " << time << " s, throughput [Mbytes/sec]: "
+              << bytes / time / MEGABYTE << std::endl;
+}
+}
+
+/**
+ * Measure the throughput of the different (de)serialization paths used to
+ * send pixel stream frames from the master to the wall processes.
+ */
+int main( int argc, char** argv )
+{
+    BenchmarkOptions options( argc, argv );
+    if( options.getHelp_ )
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    const deflect::FramePtr frame = createFrame( options );
+    const int count = options.get( "frames" );
+    const size_t frameSize = SerializeBuffer::serialize( frame ).size();
+    const size_t totalSize = frameSize * count;
+
+    std::cout << "Serialized frame size [Mbytes]: "
+              << (float)frameSize / MEGABYTE << std::endl;
+
+    Clock::time_point start = Clock::now();
+    for( int i = 0; i < count; ++i )
+    {
+        const std::string serialized = SerializeBuffer::serialize( frame );
+        const std::string queuedCopy = serialized;
+        if( queuedCopy.size() != frameSize )
+            return 1;
+    }
+    printResult( "std::string serialize + copy", totalSize,
+                 getElapsedSeconds( start ));
+
+    SerializeBufferPool pool( 1 );
+    start = Clock::now();
+    for( int i = 0; i < count; ++i )
+    {
+        SerializeBufferPtr buffer = pool.acquire();
+        buffer->write( frame );
+        if( buffer->size() != frameSize )
+            return 1;
+    }
+    printResult( "pooled buffer write", totalSize, getElapsedSeconds( start ));
+
+    SerializeBuffer buffer;
+    buffer.write( frame );
+    start = Clock::now();
+    for( int i = 0; i < count; ++i )
+    {
+        deflect::FramePtr received;
+        buffer.deserialize( received );
+        if( received->segments.size() != frame->segments.size( ))
+            return 1;
+    }
+    printResult( "in-place deserialize", totalSize,
+                 getElapsedSeconds( start ));
+
+    start = Clock::now();
+    for( int i = 0; i < count; ++i )
+    {
+        SerializeBufferPtr frameBuffer = pool.acquire();
+        FrameSerializer::write( *frame, *frameBuffer );
+        if( frameBuffer->size() < frameSize / 2 )
+            return 1;
+    }
+    printResult( "frame serializer write", totalSize,
+                 getElapsedSeconds( start ));
+
+    SerializeBufferPtr frameBuffer = pool.acquire();
+    FrameSerializer::write( *frame, *frameBuffer );
+    start = Clock::now();
+    for( int i = 0; i < count; ++i )
+    {
+        const deflect::FramePtr received = FrameSerializer::read( frameBuffer );
+        if( received->segments.size() != frame->segments.size( ))
+            return 1;
+    }
+    printResult( "frame serializer in-place read", totalSize,
+                 getElapsedSeconds( start ));
+
+    return 0;
+}